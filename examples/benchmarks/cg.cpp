@@ -69,6 +69,13 @@ void sparseConjugateGradient(void) {
     }
 }
 
+void librarySparseConjugateGradient(void) {
+    // A zero tolerance runs all maxIter iterations like the loops above
+    array x = sparseSolve(spA, b, AF_SPARSE_SOLVER_CG, AF_PRECONDITIONER_NONE,
+                          0, maxIter);
+    x.eval();
+}
+
 void denseConjugateGradient(void) {
     array x = constant(0, b.dims(), f32);
     array r = b - matmul(A, x);
@@ -127,5 +134,9 @@ int main(int, char **) {
     std::cout << "Sparse Conjugate Gradient Time: "
               << timeit(sparseConjugateGradient) * 1000 << "ms" << std::endl;
 
+    std::cout << "Library Sparse Conjugate Gradient Time: "
+              << timeit(librarySparseConjugateGradient) * 1000 << "ms"
+              << std::endl;
+
     return 0;
 }
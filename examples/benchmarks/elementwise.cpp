@@ -0,0 +1,118 @@
+/*******************************************************
+ * Copyright (c) 2026, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+// Measures the throughput of single elementwise operations for each
+// floating point type. Every operation is evaluated on its own so the
+// numbers show the cost of the operation rather than of a fused expression.
+//
+// Usage: elementwise_<backend> [device] [log2(elements)]
+
+#include <arrayfire.h>
+#include <stdio.h>
+#include <cstdlib>
+
+using namespace af;
+
+static array A, B;  // populated for each type
+static array (*unaryFn)(const array&);
+static array (*binaryFn)(const array&, const array&);
+
+static void runUnary() {
+    array C = unaryFn(A);
+    C.eval();
+}
+
+static void runBinary() {
+    array C = binaryFn(A, B);
+    C.eval();
+}
+
+static array add(const array& a, const array& b) { return a + b; }
+static array mul(const array& a, const array& b) { return a * b; }
+static array divide(const array& a, const array& b) { return a / b; }
+static array lt(const array& a, const array& b) { return a < b; }
+static array maxOf(const array& a, const array& b) { return max(a, b); }
+static array sigmoidOf(const array& a) { return sigmoid(a); }
+
+struct UnaryOp {
+    const char* name;
+    array (*fn)(const array&);
+};
+
+struct BinaryOp {
+    const char* name;
+    array (*fn)(const array&, const array&);
+};
+
+int main(int argc, char** argv) {
+    try {
+        int device = argc > 1 ? atoi(argv[1]) : 0;
+        int logn   = argc > 2 ? atoi(argv[2]) : 22;
+        setDevice(device);
+        info();
+
+        const dim_t n = (dim_t)1 << logn;
+
+        const BinaryOp binaryOps[] = {
+            {"add", add}, {"mul", mul}, {"div", divide},
+            {"lt", lt},   {"max", maxOf},
+        };
+        const UnaryOp unaryOps[] = {
+            {"sqrt", sqrt}, {"exp", exp},   {"log", log},
+            {"sin", sin},   {"cos", cos},   {"tanh", tanh},
+            {"sigmoid", sigmoidOf},
+        };
+        const int nbinary = sizeof(binaryOps) / sizeof(binaryOps[0]);
+        const int nunary  = sizeof(unaryOps) / sizeof(unaryOps[0]);
+
+        const dtype types[]     = {f32, f64, f16};
+        const char* typeNames[] = {"f32", "f64", "f16"};
+
+        printf("Benchmark elementwise operations on %lld elements (Gelem/s)\n",
+               (long long)n);
+        printf("%8s", "");
+        for (int t = 0; t < 3; t++) printf("%10s", typeNames[t]);
+        printf("\n");
+
+        for (int i = 0; i < nbinary + nunary; i++) {
+            const bool binary = i < nbinary;
+            printf("%8s", binary ? binaryOps[i].name
+                                 : unaryOps[i - nbinary].name);
+            for (int t = 0; t < 3; t++) {
+                if ((types[t] == f64 && !isDoubleAvailable(device)) ||
+                    (types[t] == f16 && !isHalfAvailable(device))) {
+                    printf("%10s", "-");
+                    continue;
+                }
+                // Inputs in (0.5, 1.5) are valid for every operation
+                A = (randu(n) + 0.5f).as(types[t]);
+                B = (randu(n) + 0.5f).as(types[t]);
+                A.eval();
+                B.eval();
+
+                double time;
+                if (binary) {
+                    binaryFn = binaryOps[i].fn;
+                    time     = timeit(runBinary);
+                } else {
+                    unaryFn = unaryOps[i - nbinary].fn;
+                    time    = timeit(runUnary);
+                }
+                printf("%10.3f", n / (time * 1e9));
+                fflush(stdout);
+            }
+            printf("\n");
+        }
+    } catch (af::exception& e) {
+        fprintf(stderr, "%s\n", e.what());
+        throw;
+    }
+
+    return 0;
+}
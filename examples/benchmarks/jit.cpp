@@ -0,0 +1,75 @@
+/*******************************************************
+ * Copyright (c) 2026, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+// Measures the throughput of fused elementwise (JIT) expressions.
+//
+// On the CPU backend the number of threads used to evaluate the expressions
+// is controlled by the AF_CPU_NUM_THREADS environment variable. Run the
+// benchmark with increasing values to see how the evaluation scales, e.g.
+//
+//   for t in 1 2 4 8 16; do AF_CPU_NUM_THREADS=$t ./jit_cpu; done
+//
+// Setting AF_CPU_JIT_COMPILE=1 compares the compiled JIT engine with the
+// interpreted one. The first run includes the compilation of the kernels.
+
+#include <arrayfire.h>
+#include <math.h>
+#include <stdio.h>
+#include <cstdlib>
+
+using namespace af;
+
+// create a small wrapper to benchmark
+static array A, B, C;  // populated before each timing
+static void fn() {
+    array D = A * B + C;  // fused multiply add
+    D.eval();
+}
+
+static void fn_transcendental() {
+    array D = exp(A) * sin(B) + sqrt(C);
+    D.eval();
+}
+
+int main(int argc, char** argv) {
+    double peak = 0;
+    try {
+        int device = argc > 1 ? atoi(argv[1]) : 0;
+        setDevice(device);
+        info();
+
+        printf("Benchmark elementwise expressions at f32\n");
+        for (dim_t n = 1 << 16; n <= (1 << 27); n <<= 1) {
+            A = randu(n);
+            B = randu(n);
+            C = randu(n);
+
+            // three reads and one write per element
+            double bytes = 4.0 * n * sizeof(float);
+
+            double time = timeit(fn);  // time in seconds
+            double gbps = bytes / (time * 1e9);
+            if (gbps > peak) peak = gbps;
+
+            double ttime = timeit(fn_transcendental);
+            double gelem = n / (ttime * 1e9);
+
+            printf("%10lld elements: A*B+C %6.2f GB/s, ", (long long)n, gbps);
+            printf("exp/sin/sqrt %6.3f Gelem/s\n", gelem);
+            fflush(stdout);
+        }
+    } catch (af::exception& e) {
+        fprintf(stderr, "%s\n", e.what());
+        throw;
+    }
+
+    printf(" ### peak %g GB/s\n", peak);
+
+    return 0;
+}
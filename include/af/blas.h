@@ -41,10 +41,13 @@ namespace af
         \note This function can be used with one sparse input. The sparse input
               must always be the \p lhs and the dense matrix must be \p rhs.
         \note The sparse array can only be of \ref AF_STORAGE_CSR format.
-        \note The returned array is always dense.
+        \note The returned array is dense unless both inputs are sparse.
         \note \p optLhs an only be one of \ref AF_MAT_NONE, \ref AF_MAT_TRANS,
               \ref AF_MAT_CTRANS.
         \note \p optRhs can only be \ref AF_MAT_NONE.
+        \note On the CPU backend \p rhs can also be a sparse \ref
+              AF_STORAGE_CSR matrix, in which case a sparse \ref
+              AF_STORAGE_CSR array is returned.
 
         \ingroup blas_func_matmul
 
@@ -297,10 +300,13 @@ extern "C" {
         \note This function can be used with one sparse input. The sparse input
               must always be the \p lhs and the dense matrix must be \p rhs.
         \note The sparse array can only be of \ref AF_STORAGE_CSR format.
-        \note The returned array is always dense.
+        \note The returned array is dense unless both inputs are sparse.
         \note \p optLhs an only be one of \ref AF_MAT_NONE, \ref AF_MAT_TRANS,
               \ref AF_MAT_CTRANS.
         \note \p optRhs can only be \ref AF_MAT_NONE.
+        \note On the CPU backend \p rhs can also be a sparse \ref
+              AF_STORAGE_CSR matrix, in which case a sparse \ref
+              AF_STORAGE_CSR array is returned.
 
         \ingroup blas_func_matmul
      */
@@ -543,6 +543,21 @@ typedef enum {
 } af_conv_gradient_type;
 #endif
 
+#if AF_API_VERSION >= 39
+typedef enum {
+    AF_SPARSE_SOLVER_CG       = 0,  ///< Conjugate gradient, for Hermitian positive definite matrices
+    AF_SPARSE_SOLVER_BICGSTAB = 1,  ///< Stabilized biconjugate gradient
+    AF_SPARSE_SOLVER_GMRES    = 2,  ///< Restarted generalized minimal residual
+    AF_SPARSE_SOLVER_DEFAULT  = 0   ///< Default is conjugate gradient
+} af_sparse_solver;
+
+typedef enum {
+    AF_PRECONDITIONER_NONE   = 0,  ///< No preconditioning
+    AF_PRECONDITIONER_JACOBI = 1,  ///< Inverse of the diagonal of the matrix
+    AF_PRECONDITIONER_ILU0   = 2   ///< Incomplete LU factorization without fill in
+} af_preconditioner;
+#endif
+
 #ifdef __cplusplus
 namespace af
 {
@@ -598,6 +613,10 @@ namespace af
     typedef af_inverse_deconv_algo inverseDeconvAlgo;
     typedef af_conv_gradient_type convGradientType;
 #endif
+#if AF_API_VERSION >= 39
+    typedef af_sparse_solver sparseSolver;
+    typedef af_preconditioner preconditioner;
+#endif
 }
 
 #endif
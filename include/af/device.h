@@ -289,6 +289,28 @@ namespace af
     ///
     /// \ingroup device_func_mem
     AFAPI size_t getMemStepSize();
+
+#if AF_API_VERSION >= 39
+    /// \brief Sets the number of threads used by the kernels of the CPU
+    /// backend
+    ///
+    /// Takes precedence over the AF_CPU_NUM_THREADS environment variable.
+    /// Waits for the CPU kernel that is currently running, if any. Only
+    /// supported by the CPU backend.
+    ///
+    /// \param[in] nthreads The number of threads. Values less than one
+    ///                     restore the default.
+    /// \ingroup device_func_set
+    AFAPI void setCpuNumThreads(const int nthreads);
+
+    /// \brief Returns the number of threads used by the kernels of the CPU
+    /// backend
+    ///
+    /// Only supported by the CPU backend.
+    ///
+    /// \ingroup device_func_set
+    AFAPI int getCpuNumThreads();
+#endif
 }
 #endif
 
@@ -619,6 +641,38 @@ extern "C" {
 
 #endif
 
+#if AF_API_VERSION >= 39
+    /**
+       Sets the number of threads used by the kernels of the CPU backend
+
+       The CPU backend splits the work of its kernels between a pool of
+       threads. This function takes precedence over the AF_CPU_NUM_THREADS
+       environment variable. It waits for the CPU kernel that is currently
+       running, if any.
+
+       \param[in] nthreads The number of threads. Values less than one restore
+                           the default, which is the value of
+                           AF_CPU_NUM_THREADS or the number of hardware
+                           threads of the host.
+       \returns AF_SUCCESS if the number of threads is set.
+                AF_ERR_NOT_SUPPORTED if the active backend is not the CPU
+                backend.
+       \ingroup device_func_set
+    */
+    AFAPI af_err af_set_cpu_num_threads(const int nthreads);
+
+    /**
+       Gets the number of threads used by the kernels of the CPU backend
+
+       \param[out] nthreads The number of threads
+       \returns AF_SUCCESS if \p nthreads is set.
+                AF_ERR_NOT_SUPPORTED if the active backend is not the CPU
+                backend.
+       \ingroup device_func_set
+    */
+    AFAPI af_err af_get_cpu_num_threads(int *nthreads);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -10,6 +10,23 @@
 #pragma once
 #include <af/defines.h>
 
+#if AF_API_VERSION >= 39
+/**
+   Called by \ref af_sparse_solve after every iteration.
+
+   \param[in] user_data is the pointer given to \ref af_sparse_solve
+   \param[in] iteration is the number of iterations done so far
+   \param[in] residuals holds the residual norm of every right hand side
+              divided by the norm of that right hand side
+   \param[in] nrhs is the number of right hand sides
+   \return zero to continue iterating, any other value to stop
+
+   \ingroup sparse_func_solve
+*/
+typedef int (*af_sparse_solve_callback)(void *user_data, int iteration,
+                                        const double *residuals, int nrhs);
+#endif
+
 #ifdef __cplusplus
 namespace af
 {
@@ -174,6 +191,36 @@ namespace af
      */
     AFAPI af::storage sparseGetStorage(const array in);
 #endif
+
+#if AF_API_VERSION >= 39
+    /**
+       Solves the sparse linear system A X = B with an iterative method.
+
+       \param[in] a is the square sparse matrix A in CSR format
+       \param[in] b is the dense matrix B. Every column is a right hand side
+                  that is solved for independently.
+       \param[in] solver is the iterative method
+       \param[in] precond is the preconditioner
+       \param[in] tol is the residual norm, relative to the norm of the right
+                  hand side, at which a column has converged
+       \param[in] maxIter is the maximum number of iterations
+       \param[in] restart is the number of GMRES iterations between restarts
+       \param[in] callback is called after every iteration when not NULL
+       \param[in] userData is passed to \p callback
+       \param[out] iterations is set to the number of iterations done when not
+                   NULL
+       \return the solution X, of the same size as \p b
+
+       \ingroup sparse_func_solve
+     */
+    AFAPI array sparseSolve(const array &a, const array &b,
+                            const sparseSolver solver = AF_SPARSE_SOLVER_DEFAULT,
+                            const preconditioner precond = AF_PRECONDITIONER_NONE,
+                            const double tol = 1e-6, const int maxIter = 1000,
+                            const int restart = 30,
+                            af_sparse_solve_callback callback = NULL,
+                            void *userData = NULL, int *iterations = NULL);
+#endif
 }
 #endif
 
@@ -362,6 +409,40 @@ extern "C" {
     AFAPI af_err af_sparse_get_storage(af_storage *out, const af_array in);
 #endif
 
+#if AF_API_VERSION >= 39
+    /**
+       Solves the sparse linear system A X = B with an iterative method.
+
+       \param[out] out is the solution X, of the same size as \p b
+       \param[out] iterations is set to the number of iterations done when not
+                   NULL
+       \param[in] a is the square sparse matrix A in CSR format
+       \param[in] b is the dense matrix B. Every column is a right hand side
+                  that is solved for independently.
+       \param[in] solver is the iterative method
+       \param[in] precond is the preconditioner
+       \param[in] tol is the residual norm, relative to the norm of the right
+                  hand side, at which a column has converged
+       \param[in] max_iter is the maximum number of iterations
+       \param[in] restart is the number of GMRES iterations between restarts
+       \param[in] callback is called after every iteration when not NULL
+       \param[in] user_data is passed to \p callback
+
+       \return \ref AF_SUCCESS if the execution completes properly. Reaching
+               \p max_iter before converging is not an error.
+
+       \ingroup sparse_func_solve
+     */
+    AFAPI af_err af_sparse_solve(af_array *out, int *iterations,
+                                 const af_array a, const af_array b,
+                                 const af_sparse_solver solver,
+                                 const af_preconditioner precond,
+                                 const double tol, const int max_iter,
+                                 const int restart,
+                                 af_sparse_solve_callback callback,
+                                 void *user_data);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -326,6 +326,46 @@ AFAPI T corrcoef(const array& X, const array& Y);
 AFAPI void topk(array &values, array &indices, const array& in, const int k,
                 const int dim = -1, const topkFunction order = AF_TOPK_MAX);
 #endif
+
+#if AF_API_VERSION >= 39
+/**
+   C++ Interface for quantiles
+
+   The quantiles are linearly interpolated between the two closest elements
+   of the sorted input. The quantile for probability p is the element at
+   position p * (n - 1) of the sorted input, where n is the number of
+   elements along \p dim.
+
+   \param[in] in    is the input array
+   \param[in] probs are the probabilities in [0, 1] of the quantiles
+   \param[in] dim   the dimension along which the quantiles are extracted
+   \return    the quantiles of the input array along dimension \p dim. Its
+              dimension \p dim has one element for each element of \p probs.
+
+   \ingroup stat_func_quantile
+
+   \note \p dim is -1 by default. -1 denotes the first non-singleton dimension.
+*/
+AFAPI array quantile(const array& in, const array& probs, const dim_t dim=-1);
+
+/**
+   C++ Interface for percentiles
+
+   Same as \ref quantile with the probabilities given in percent.
+
+   \param[in] in       is the input array
+   \param[in] percents are the percentages in [0, 100] of the percentiles
+   \param[in] dim      the dimension along which the percentiles are
+                       extracted
+   \return    the percentiles of the input array along dimension \p dim
+
+   \ingroup stat_func_quantile
+
+   \note \p dim is -1 by default. -1 denotes the first non-singleton dimension.
+*/
+AFAPI array percentile(const array& in, const array& percents,
+                       const dim_t dim=-1);
+#endif
 }
 #endif
 
@@ -680,6 +720,42 @@ AFAPI af_err af_topk(af_array *values, af_array *indices, const af_array in,
                      const int k, const int dim, const af_topk_function order);
 #endif
 
+#if AF_API_VERSION >= 39
+/**
+   C Interface for quantiles
+
+   \param[out] out   will contain the quantiles of the input array along
+                     dimension \p dim. Its dimension \p dim has one element
+                     for each element of \p probs.
+   \param[in]  in    is the input array
+   \param[in]  probs are the probabilities in [0, 1] of the quantiles
+   \param[in]  dim   the dimension along which the quantiles are extracted
+   \return     \ref AF_SUCCESS if the operation is successful,
+   otherwise an appropriate error code is returned.
+
+   \ingroup stat_func_quantile
+*/
+AFAPI af_err af_quantile(af_array *out, const af_array in,
+                         const af_array probs, const dim_t dim);
+
+/**
+   C Interface for percentiles
+
+   \param[out] out      will contain the percentiles of the input array along
+                        dimension \p dim
+   \param[in]  in       is the input array
+   \param[in]  percents are the percentages in [0, 100] of the percentiles
+   \param[in]  dim      the dimension along which the percentiles are
+                        extracted
+   \return     \ref AF_SUCCESS if the operation is successful,
+   otherwise an appropriate error code is returned.
+
+   \ingroup stat_func_quantile
+*/
+AFAPI af_err af_percentile(af_array *out, const af_array in,
+                           const af_array percents, const dim_t dim);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
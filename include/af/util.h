@@ -92,6 +92,29 @@ namespace af
     AFAPI int readArrayCheck(const char *filename, const char *key);
 #endif
 
+#if AF_API_VERSION >= 39
+    /**
+        Reads the elements [\p first, \p last] along dimension \p dim of an
+        array without reading the rest of the array from the file
+
+        \param[in] filename is the path to the location on disk
+        \param[in] index is the 0-based sequential location of the array to be read
+        \param[in] dim is the dimension along which the range is read
+        \param[in] first is the index of the first element read along \p dim
+        \param[in] last is the index of the last element read along \p dim
+
+        \returns array with the dimensions of the stored array, except
+        \p last - \p first + 1 along \p dim
+
+        \note This function will throw an exception if the index is out of bounds
+
+        \ingroup stream_func_read
+    */
+    AFAPI array readArray(const char *filename, const unsigned index,
+                          const unsigned dim, const dim_t first,
+                          const dim_t last);
+#endif
+
 #if AF_API_VERSION >= 31
     /**
         \param[out] output is the pointer to the c-string that will hold the data. The memory for
@@ -235,6 +258,27 @@ extern "C" {
     AFAPI af_err af_read_array_key_check(int *index, const char *filename, const char* key);
 #endif
 
+#if AF_API_VERSION >= 39
+    /**
+        Reads the elements [\p first, \p last] along dimension \p dim of an
+        array without reading the rest of the array from the file
+
+        \param[out] out is the array read from index
+        \param[in] filename is the path to the location on disk
+        \param[in] index is the 0-based sequential location of the array to be read
+        \param[in] dim is the dimension along which the range is read
+        \param[in] first is the index of the first element read along \p dim
+        \param[in] last is the index of the last element read along \p dim
+
+        \note This function will throw an exception if the index is out of bounds
+
+        \ingroup stream_func_read
+    */
+    AFAPI af_err af_read_array_range(af_array *out, const char *filename,
+                                     const unsigned index, const unsigned dim,
+                                     const dim_t first, const dim_t last);
+#endif
+
 #if AF_API_VERSION >= 31
     /**
         \param[out] output is the pointer to the c-string that will hold the data. The memory for
@@ -11,6 +11,10 @@
 #include <af/defines.h>
 #include <af/features.h>
 
+#if AF_API_VERSION >= 39
+typedef void * af_ann_index;
+#endif
+
 #ifdef __cplusplus
 namespace af
 {
@@ -337,6 +341,103 @@ AFAPI void homography(array& H, int& inliers, const array& x_src, const array& y
                       const float inlier_thr=3.f, const unsigned iterations=1000, const dtype otype=f32);
 #endif
 
+#if AF_API_VERSION >= 39
+/// An approximate nearest neighbour index over a set of training points
+///
+/// \ingroup arrayfire_class
+/// \ingroup cv_func_ann_index
+class AFAPI annIndex {
+private:
+    af_ann_index index;
+
+public:
+    /**
+       Builds an index over the points in \p train
+
+       \param[in] train     is the array containing the points to index. The
+                            points must be described along dim0 and listed
+                            along dim1 if \p dist_dim is 0, or vice versa if
+                            \p dist_dim is 1.
+       \param[in] dist_dim  indicates the dimension along which the
+                            coordinates of a point are stored
+       \param[in] n_lists   is the number of lists the points are grouped
+                            into. 0 picks the square root of the number of
+                            points.
+       \param[in] dist_type is the distance computation type, \ref AF_SAD,
+                            \ref AF_SSD or \ref AF_SHD
+    */
+    annIndex(const array &train, const dim_t dist_dim = 0,
+             const unsigned n_lists = 0,
+             const af_match_type dist_type = AF_SSD);
+
+    /// Creates an annIndex object from a C af_ann_index handle
+    explicit annIndex(af_ann_index handle);
+
+    ~annIndex();
+
+    /// Copy constructor
+    annIndex(const annIndex &other);
+
+    /// Copy assignment operator
+    annIndex &operator=(const annIndex &other);
+
+#if AF_COMPILER_CXX_RVALUE_REFERENCES
+    /// Move constructor
+    annIndex(annIndex &&other);
+
+    /// Move assignment operator
+    annIndex &operator=(annIndex &&other);
+#endif
+
+    /// Returns the underlying C af_ann_index handle
+    af_ann_index get() const;
+};
+
+/**
+   C++ Interface for approximate nearest neighbour search
+
+   \param[out] idx     is an array of \p n_dist \f$\times\f$ the number of
+                       queries with the indices of the nearest training points
+                       of every query, nearest first
+   \param[out] dist    is an array of the same size as \p idx with the
+                       distances to the points in \p idx
+   \param[in]  query   is the array containing the points to be queried, with
+                       the same data layout as the training points of
+                       \p index
+   \param[in]  index   is the index of the training points
+   \param[in]  n_dist  is the number of nearest neighbour points to return
+                       (currently only values <= 256 are supported)
+   \param[in]  n_probe is the number of lists of the index that are searched
+                       for every query (currently only values <= 256 are
+                       supported)
+
+   \ingroup cv_func_ann_index
+ */
+AFAPI void annSearch(array &idx, array &dist, const array &query,
+                     const annIndex &index, const unsigned n_dist = 1,
+                     const unsigned n_probe = 8);
+
+/**
+   C++ Interface for saving an approximate nearest neighbour index
+
+   \param[in] filename is the path of the file the index is written to
+   \param[in] index    is the index to save
+
+   \ingroup cv_func_ann_index
+ */
+AFAPI void saveAnnIndex(const char *filename, const annIndex &index);
+
+/**
+   C++ Interface for reading an approximate nearest neighbour index
+
+   \param[in] filename is the path of a file written by \ref saveAnnIndex
+   \return    the index stored in the file
+
+   \ingroup cv_func_ann_index
+ */
+AFAPI annIndex readAnnIndex(const char *filename);
+#endif
+
 }
 #endif
 
@@ -669,6 +770,102 @@ AFAPI af_err af_nearest_neighbour(af_array* idx, af_array* dist,
                                const unsigned iterations, const af_dtype otype);
 #endif
 
+#if AF_API_VERSION >= 39
+    /**
+       C Interface for building an approximate nearest neighbour index
+
+       \param[out] index     is the new index
+       \param[in]  train     is the array containing the points to index.
+                             The points must be described along dim0 and
+                             listed along dim1 if \p dist_dim is 0, or vice
+                             versa if \p dist_dim is 1.
+       \param[in]  dist_dim  indicates the dimension along which the
+                             coordinates of a point are stored
+       \param[in]  n_lists   is the number of lists the points are grouped
+                             into. 0 picks the square root of the number of
+                             points.
+       \param[in]  dist_type is the distance computation type, \ref AF_SAD,
+                             \ref AF_SSD or \ref AF_SHD
+       \return     \ref AF_SUCCESS if the index is built successfully,
+                   otherwise an appropriate error code is returned.
+
+       \ingroup cv_func_ann_index
+    */
+    AFAPI af_err af_create_ann_index(af_ann_index *index, const af_array train,
+                                     const dim_t dist_dim,
+                                     const unsigned n_lists,
+                                     const af_match_type dist_type);
+
+    /**
+       Increases the reference count of the arrays of an index
+
+       \param[out] out   is the new handle to the index
+       \param[in]  index is the index to retain
+
+       \ingroup cv_func_ann_index
+    */
+    AFAPI af_err af_retain_ann_index(af_ann_index *out,
+                                     const af_ann_index index);
+
+    /**
+       Releases an index and reduces the reference count of its arrays
+
+       \param[in] index is the index to release
+
+       \ingroup cv_func_ann_index
+    */
+    AFAPI af_err af_release_ann_index(af_ann_index index);
+
+    /**
+       C Interface for approximate nearest neighbour search
+
+       \param[out] idx     is an array of \p n_dist \f$\times\f$ the number
+                           of queries with the indices of the nearest training
+                           points of every query, nearest first
+       \param[out] dist    is an array of the same size as \p idx with the
+                           distances to the points in \p idx
+       \param[in]  query   is the array containing the points to be queried,
+                           with the same data layout as the training points
+                           of \p index
+       \param[in]  index   is the index of the training points
+       \param[in]  n_dist  is the number of nearest neighbour points to
+                           return (currently only values <= 256 are
+                           supported)
+       \param[in]  n_probe is the number of lists of the index that are
+                           searched for every query (currently only values
+                           <= 256 are supported)
+       \return     \ref AF_SUCCESS if the search is successful, otherwise an
+                   appropriate error code is returned.
+
+       \ingroup cv_func_ann_index
+    */
+    AFAPI af_err af_ann_search(af_array *idx, af_array *dist,
+                               const af_array query, const af_ann_index index,
+                               const unsigned n_dist, const unsigned n_probe);
+
+    /**
+       C Interface for saving an approximate nearest neighbour index
+
+       \param[in] filename is the path of the file the index is written to
+       \param[in] index    is the index to save
+
+       \ingroup cv_func_ann_index
+    */
+    AFAPI af_err af_save_ann_index(const char *filename,
+                                   const af_ann_index index);
+
+    /**
+       C Interface for reading an approximate nearest neighbour index
+
+       \param[out] index    is the index stored in the file
+       \param[in]  filename is the path of a file written by
+                            \ref af_save_ann_index
+
+       \ingroup cv_func_ann_index
+    */
+    AFAPI af_err af_read_ann_index(af_ann_index *index, const char *filename);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
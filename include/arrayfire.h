@@ -219,6 +219,9 @@
         The dense matrix on the right hand side cannot be used with any transpose
         options.
 
+        Sparse linear systems are solved with the iterative methods of
+        \ref af::sparseSolve.
+
         Most functions cannot use sparse arrays and will throw an error with
         \ref AF_ERR_ARG if a sparse array is given as input.
 
@@ -0,0 +1,496 @@
+/*******************************************************
+ * Copyright (c) 2026, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <ann_index.hpp>
+#include <backend.hpp>
+#include <common/err_common.hpp>
+#include <copy.hpp>
+#include <handle.hpp>
+#include <lookup.hpp>
+#include <nearest_neighbour.hpp>
+#include <transpose.hpp>
+#include <af/defines.h>
+#include <af/dim4.hpp>
+#include <af/util.h>
+#include <af/vision.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+using af::dim4;
+using detail::Array;
+using detail::copyData;
+using detail::createEmptyArray;
+using detail::createHostDataArray;
+using detail::createSubArray;
+using detail::intl;
+using detail::lookup;
+using detail::nearest_neighbour;
+using detail::transpose;
+using detail::uchar;
+using detail::uint;
+using detail::uintl;
+using detail::ushort;
+using std::min;
+using std::numeric_limits;
+using std::pair;
+using std::vector;
+
+namespace {
+
+/// The number of training points per list that k-means is run on
+constexpr dim_t kTrainPointsPerList = 64;
+/// The number of k-means iterations used to place the centroids
+constexpr int kKMeansIterations = 10;
+
+constexpr const char *kCentroidsKey = "ann_index.centroids";
+constexpr const char *kDataKey      = "ann_index.data";
+constexpr const char *kIdsKey       = "ann_index.ids";
+constexpr const char *kOffsetsKey   = "ann_index.offsets";
+constexpr const char *kParamsKey    = "ann_index.params";
+
+/// Returns the points of \p in as columns
+template<typename T>
+Array<T> pointsAsColumns(const af_array in, const dim_t dist_dim) {
+    const Array<T> points = getArray<T>(in);
+    return dist_dim == 0 ? points : transpose(points, false);
+}
+
+/// Returns \p count column indices spread evenly over \p total columns
+vector<uint> spreadColumns(const dim_t count, const dim_t total) {
+    vector<uint> out(count);
+    for (dim_t i = 0; i < count; ++i) {
+        out[i] = static_cast<uint>(i * total / count);
+    }
+    return out;
+}
+
+template<typename T>
+Array<T> columns(const Array<T> &points, const vector<uint> &cols) {
+    const Array<uint> idx =
+        createHostDataArray(dim4(static_cast<dim_t>(cols.size())), cols.data());
+    return lookup(points, idx, 1);
+}
+
+/// Returns the index of the nearest centroid of every point
+template<typename T, typename To>
+vector<uint> nearestCentroids(const Array<T> &points,
+                              const Array<T> &centroids,
+                              const af_match_type dist_type) {
+    Array<uint> idx = createEmptyArray<uint>(dim4());
+    Array<To> dist  = createEmptyArray<To>(dim4());
+    nearest_neighbour<T, To>(idx, dist, points, centroids, 0, 1, dist_type);
+    vector<uint> out(points.dims()[1]);
+    copyData(out.data(), idx);
+    return out;
+}
+
+/// Moves every centroid to the mean of the points assigned to it. Centroids
+/// without points keep their position.
+template<typename T>
+void moveCentroids(vector<T> &centroids, const vector<T> &points,
+                   const vector<uint> &assigned, const dim_t nfeat) {
+    vector<double> sums(centroids.size(), 0.0);
+    vector<dim_t> counts(centroids.size() / nfeat, 0);
+    for (size_t p = 0; p < assigned.size(); ++p) {
+        const T *point = &points[p * nfeat];
+        double *sum    = &sums[assigned[p] * nfeat];
+        for (dim_t f = 0; f < nfeat; ++f) {
+            sum[f] += static_cast<double>(point[f]);
+        }
+        counts[assigned[p]]++;
+    }
+    for (size_t c = 0; c < counts.size(); ++c) {
+        if (counts[c] == 0) { continue; }
+        for (dim_t f = 0; f < nfeat; ++f) {
+            const double mean = sums[c * nfeat + f] / counts[c];
+            centroids[c * nfeat + f] =
+                std::is_integral<T>::value ? static_cast<T>(std::round(mean))
+                                           : static_cast<T>(mean);
+        }
+    }
+}
+
+/// Builds an inverted file index.
+///
+/// The centroids start at evenly spaced training points and are refined with
+/// k-means on an evenly spaced subset of the points. Hamming distances have
+/// no mean, so their centroids stay at the training points. Every point is
+/// then assigned to its nearest centroid and the points are stored list by
+/// list.
+template<typename T, typename To>
+af_ann_index_t createIndex(const af_array train, const dim_t dist_dim,
+                           const dim_t nlists, const af_match_type dist_type) {
+    const Array<T> points = pointsAsColumns<T>(train, dist_dim);
+    const dim_t nfeat     = points.dims()[0];
+    const dim_t npoints   = points.dims()[1];
+    const dim4 cDims(nfeat, nlists);
+
+    vector<T> centroids(nfeat * nlists);
+    copyData(centroids.data(), columns(points, spreadColumns(nlists, npoints)));
+
+    if (dist_type != AF_SHD) {
+        const dim_t nsample = min(npoints, nlists * kTrainPointsPerList);
+        const Array<T> sample =
+            columns(points, spreadColumns(nsample, npoints));
+        vector<T> sampleData(nfeat * nsample);
+        copyData(sampleData.data(), sample);
+        for (int iter = 0; iter < kKMeansIterations; ++iter) {
+            const Array<T> current =
+                createHostDataArray(cDims, centroids.data());
+            const vector<uint> assigned =
+                nearestCentroids<T, To>(sample, current, dist_type);
+            moveCentroids(centroids, sampleData, assigned, nfeat);
+        }
+    }
+    const Array<T> cArray = createHostDataArray(cDims, centroids.data());
+
+    // Counting sort of the points by list
+    const vector<uint> assigned =
+        nearestCentroids<T, To>(points, cArray, dist_type);
+    vector<uint> offsets(nlists + 1, 0);
+    for (uint list : assigned) { offsets[list + 1]++; }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    vector<uint> next(offsets.begin(), offsets.end() - 1);
+    vector<uint> ids(npoints);
+    for (dim_t p = 0; p < npoints; ++p) {
+        ids[next[assigned[p]]++] = static_cast<uint>(p);
+    }
+
+    const Array<T> data       = columns(points, ids);
+    const Array<uint> idArray = createHostDataArray(dim4(npoints), ids.data());
+    const Array<uint> offArray =
+        createHostDataArray(dim4(nlists + 1), offsets.data());
+
+    af_ann_index_t index;
+    index.centroids = getHandle(cArray);
+    index.data      = getHandle(data);
+    index.ids       = getHandle(idArray);
+    index.offsets   = getHandle(offArray);
+    index.dist_dim  = dist_dim;
+    index.dist_type = dist_type;
+    return index;
+}
+
+template<typename T>
+T farthest() {
+    return numeric_limits<T>::has_infinity ? numeric_limits<T>::infinity()
+                                           : numeric_limits<T>::max();
+}
+
+/// Searches the \p n_probe lists with the nearest centroids of every query.
+///
+/// The queries are grouped by list, so every list is searched once with a
+/// batched brute force search of its queries. Each query collects up to
+/// \p n_dist candidates from every list it probes and keeps the nearest
+/// \p n_dist of them. If the probed lists hold fewer points, the remaining
+/// results have the index UINT_MAX and the largest distance of the type.
+template<typename T, typename To>
+void searchIndex(af_array *idx, af_array *dist, const af_ann_index_t &index,
+                 const af_array query, const uint n_dist, const uint n_probe) {
+    const Array<T> queries   = pointsAsColumns<T>(query, index.dist_dim);
+    const Array<T> centroids = getArray<T>(index.centroids);
+    const Array<T> data      = getArray<T>(index.data);
+    const Array<uint> ids    = getArray<uint>(index.ids);
+    const dim_t nquery       = queries.dims()[1];
+    const dim_t nlists       = centroids.dims()[1];
+    const uint nprobe        = static_cast<uint>(min<dim_t>(n_probe, nlists));
+
+    vector<uint> offsets(nlists + 1);
+    copyData(offsets.data(), getArray<uint>(index.offsets));
+
+    Array<uint> probeIdx = createEmptyArray<uint>(dim4());
+    Array<To> probeDist  = createEmptyArray<To>(dim4());
+    nearest_neighbour<T, To>(probeIdx, probeDist, queries, centroids, 0,
+                             nprobe, index.dist_type);
+    vector<uint> probes(nprobe * nquery);
+    copyData(probes.data(), probeIdx);
+
+    // The queries that probe every list and the position of the list among
+    // the probes of the query
+    vector<vector<uint>> listQueries(nlists);
+    vector<vector<uint>> listSlots(nlists);
+    for (dim_t q = 0; q < nquery; ++q) {
+        for (uint s = 0; s < nprobe; ++s) {
+            const uint list = probes[q * nprobe + s];
+            listQueries[list].push_back(static_cast<uint>(q));
+            listSlots[list].push_back(s);
+        }
+    }
+
+    using Candidate = pair<To, uint>;
+    const Candidate none(farthest<To>(), numeric_limits<uint>::max());
+    const dim_t perQuery = static_cast<dim_t>(nprobe) * n_dist;
+    vector<Candidate> candidates(nquery * perQuery, none);
+
+    vector<uint> found;
+    vector<To> foundDist;
+    for (dim_t list = 0; list < nlists; ++list) {
+        const vector<uint> &lq = listQueries[list];
+        const dim_t size       = offsets[list + 1] - offsets[list];
+        if (lq.empty() || size == 0) { continue; }
+
+        const af_seq range = {static_cast<double>(offsets[list]),
+                              static_cast<double>(offsets[list + 1] - 1), 1};
+        const Array<T> members = createSubArray(data, {af_span, range}, false);
+        const Array<uint> memberIds = createSubArray(ids, {range}, false);
+        const uint k = static_cast<uint>(min<dim_t>(n_dist, size));
+
+        Array<uint> nnIdx = createEmptyArray<uint>(dim4());
+        Array<To> nnDist  = createEmptyArray<To>(dim4());
+        nearest_neighbour<T, To>(nnIdx, nnDist, columns(queries, lq), members,
+                                 0, k, index.dist_type);
+
+        found.resize(k * lq.size());
+        foundDist.resize(k * lq.size());
+        copyData(found.data(), lookup(memberIds, nnIdx, 0));
+        copyData(foundDist.data(), nnDist);
+
+        for (size_t j = 0; j < lq.size(); ++j) {
+            Candidate *out =
+                &candidates[lq[j] * perQuery + listSlots[list][j] * n_dist];
+            for (uint r = 0; r < k; ++r) {
+                out[r] = Candidate(foundDist[j * k + r], found[j * k + r]);
+            }
+        }
+    }
+
+    vector<uint> outIdx(n_dist * nquery);
+    vector<To> outDist(n_dist * nquery);
+    for (dim_t q = 0; q < nquery; ++q) {
+        Candidate *c = &candidates[q * perQuery];
+        std::partial_sort(c, c + n_dist, c + perQuery);
+        for (uint r = 0; r < n_dist; ++r) {
+            outDist[q * n_dist + r] = c[r].first;
+            outIdx[q * n_dist + r]  = c[r].second;
+        }
+    }
+
+    const dim4 oDims(n_dist, nquery);
+    *idx  = getHandle(createHostDataArray(oDims, outIdx.data()));
+    *dist = getHandle(createHostDataArray(oDims, outDist.data()));
+}
+
+/// Calls FUNC<T, To> with the output type that af_nearest_neighbour uses for
+/// the distances of \p type and \p dist_type
+#define ANN_TYPE_SWITCH(FUNC, type, dist_type, ...)                       \
+    if (dist_type == AF_SHD) {                                            \
+        switch (type) {                                                   \
+            case u8: return FUNC<uchar, uint>(__VA_ARGS__);               \
+            case u16: return FUNC<ushort, uint>(__VA_ARGS__);             \
+            case u32: return FUNC<uint, uint>(__VA_ARGS__);               \
+            case u64: return FUNC<uintl, uint>(__VA_ARGS__);              \
+            default: TYPE_ERROR(1, type);                                 \
+        }                                                                 \
+    } else {                                                              \
+        switch (type) {                                                   \
+            case f32: return FUNC<float, float>(__VA_ARGS__);             \
+            case f64: return FUNC<double, double>(__VA_ARGS__);           \
+            case s32: return FUNC<int, int>(__VA_ARGS__);                 \
+            case u32: return FUNC<uint, uint>(__VA_ARGS__);               \
+            case s64: return FUNC<intl, intl>(__VA_ARGS__);               \
+            case u64: return FUNC<uintl, uintl>(__VA_ARGS__);             \
+            case s16: return FUNC<short, int>(__VA_ARGS__);               \
+            case u16: return FUNC<ushort, uint>(__VA_ARGS__);             \
+            case u8: return FUNC<uchar, uint>(__VA_ARGS__);               \
+            default: TYPE_ERROR(1, type);                                 \
+        }                                                                 \
+    }
+
+af_ann_index_t createIndex(const af_array train, const dim_t dist_dim,
+                           const dim_t nlists, const af_match_type dist_type) {
+    const af_dtype type = getInfo(train).getType();
+    ANN_TYPE_SWITCH(createIndex, type, dist_type, train, dist_dim, nlists,
+                    dist_type);
+}
+
+void searchIndex(af_array *idx, af_array *dist, const af_ann_index_t &index,
+                 const af_array query, const uint n_dist, const uint n_probe) {
+    const af_dtype type = getInfo(query).getType();
+    ANN_TYPE_SWITCH(searchIndex, type, index.dist_type, idx, dist, index,
+                    query, n_dist, n_probe);
+}
+
+#undef ANN_TYPE_SWITCH
+
+void releaseArrays(const af_ann_index_t &index) {
+    for (af_array arr :
+         {index.centroids, index.data, index.ids, index.offsets}) {
+        if (arr != 0) { AF_CHECK(af_release_array(arr)); }
+    }
+}
+
+}  // namespace
+
+af_ann_index getAnnIndexHandle(const af_ann_index_t index) {
+    auto *handle = new af_ann_index_t;
+    *handle      = index;
+    return static_cast<af_ann_index>(handle);
+}
+
+af_ann_index_t getAnnIndex(const af_ann_index handle) {
+    return *static_cast<af_ann_index_t *>(handle);
+}
+
+af_err af_create_ann_index(af_ann_index *index, const af_array train,
+                           const dim_t dist_dim, const unsigned n_lists,
+                           const af_match_type dist_type) {
+    try {
+        const ArrayInfo &tInfo = getInfo(train);
+        const af_dtype tType   = tInfo.getType();
+        const dim4 &tDims      = tInfo.dims();
+
+        DIM_ASSERT(1, tDims[2] == 1 && tDims[3] == 1);
+        DIM_ASSERT(2, (dist_dim == 0 || dist_dim == 1));
+        const dim_t npoints = tDims[dist_dim == 0 ? 1 : 0];
+        DIM_ASSERT(1, npoints > 0 && tDims[dist_dim] > 0);
+        ARG_ASSERT(3, n_lists <= npoints);
+        ARG_ASSERT(4, dist_type == AF_SAD || dist_type == AF_SSD ||
+                          dist_type == AF_SHD);
+        if (dist_type == AF_SHD) {
+            TYPE_ASSERT(tType == u8 || tType == u16 || tType == u32 ||
+                        tType == u64);
+        }
+
+        const dim_t nlists =
+            n_lists > 0
+                ? n_lists
+                : std::max<dim_t>(1, std::llround(std::sqrt(npoints)));
+
+        *index = getAnnIndexHandle(
+            createIndex(train, dist_dim, nlists, dist_type));
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_retain_ann_index(af_ann_index *out, const af_ann_index index) {
+    try {
+        const af_ann_index_t in = getAnnIndex(index);
+        af_ann_index_t result   = in;
+        AF_CHECK(af_retain_array(&result.centroids, in.centroids));
+        AF_CHECK(af_retain_array(&result.data, in.data));
+        AF_CHECK(af_retain_array(&result.ids, in.ids));
+        AF_CHECK(af_retain_array(&result.offsets, in.offsets));
+        *out = getAnnIndexHandle(result);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_release_ann_index(af_ann_index index) {
+    try {
+        releaseArrays(getAnnIndex(index));
+        delete static_cast<af_ann_index_t *>(index);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_ann_search(af_array *idx, af_array *dist, const af_array query,
+                     const af_ann_index index, const unsigned n_dist,
+                     const unsigned n_probe) {
+    try {
+        const af_ann_index_t ann = getAnnIndex(index);
+        const ArrayInfo &qInfo   = getInfo(query);
+        const ArrayInfo &cInfo   = getInfo(ann.centroids);
+        const dim4 &qDims        = qInfo.dims();
+
+        DIM_ASSERT(2, qDims[2] == 1 && qDims[3] == 1);
+        DIM_ASSERT(2, qDims[ann.dist_dim] == cInfo.dims()[0]);
+        TYPE_ASSERT(qInfo.getType() == cInfo.getType());
+        ARG_ASSERT(4, n_dist > 0 && n_dist <= 256);
+        ARG_ASSERT(5, n_probe > 0 && n_probe <= 256);
+
+        af_array oIdx;
+        af_array oDist;
+        searchIndex(&oIdx, &oDist, ann, query, n_dist, n_probe);
+        std::swap(*idx, oIdx);
+        std::swap(*dist, oDist);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_save_ann_index(const char *filename, const af_ann_index index) {
+    try {
+        ARG_ASSERT(0, filename != nullptr);
+        const af_ann_index_t ann = getAnnIndex(index);
+
+        // The arrays are stored with af_save_array under their own keys,
+        // so the file can be inspected with af_read_array_key
+        int pos = 0;
+        AF_CHECK(af_save_array(&pos, kCentroidsKey, ann.centroids, filename,
+                               false));
+        AF_CHECK(af_save_array(&pos, kDataKey, ann.data, filename, true));
+        AF_CHECK(af_save_array(&pos, kIdsKey, ann.ids, filename, true));
+        AF_CHECK(
+            af_save_array(&pos, kOffsetsKey, ann.offsets, filename, true));
+
+        const int params[] = {static_cast<int>(ann.dist_dim),
+                              static_cast<int>(ann.dist_type)};
+        af_array paramArray =
+            getHandle(createHostDataArray(dim4(2), params));
+        const af_err err =
+            af_save_array(&pos, kParamsKey, paramArray, filename, true);
+        AF_CHECK(af_release_array(paramArray));
+        AF_CHECK(err);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
+
+af_err af_read_ann_index(af_ann_index *index, const char *filename) {
+    af_ann_index_t ann = {0, 0, 0, 0, 0, AF_SSD};
+    af_array paramArray = 0;
+    try {
+        ARG_ASSERT(1, filename != nullptr);
+        AF_CHECK(af_read_array_key(&ann.centroids, filename, kCentroidsKey));
+        AF_CHECK(af_read_array_key(&ann.data, filename, kDataKey));
+        AF_CHECK(af_read_array_key(&ann.ids, filename, kIdsKey));
+        AF_CHECK(af_read_array_key(&ann.offsets, filename, kOffsetsKey));
+        AF_CHECK(af_read_array_key(&paramArray, filename, kParamsKey));
+
+        const ArrayInfo &cInfo = getInfo(ann.centroids);
+        const ArrayInfo &dInfo = getInfo(ann.data);
+        const ArrayInfo &pInfo = getInfo(paramArray);
+        ARG_ASSERT(1, cInfo.getType() == dInfo.getType());
+        ARG_ASSERT(1, cInfo.dims()[0] == dInfo.dims()[0]);
+        ARG_ASSERT(1, getInfo(ann.ids).getType() == u32 &&
+                          getInfo(ann.ids).elements() == dInfo.dims()[1]);
+        ARG_ASSERT(1, getInfo(ann.offsets).getType() == u32 &&
+                          getInfo(ann.offsets).elements() ==
+                              cInfo.dims()[1] + 1);
+        ARG_ASSERT(1, pInfo.getType() == s32 && pInfo.elements() == 2);
+
+        int params[2];
+        copyData(params, getArray<int>(paramArray));
+        ann.dist_dim  = params[0];
+        ann.dist_type = static_cast<af_match_type>(params[1]);
+        ARG_ASSERT(1, ann.dist_dim == 0 || ann.dist_dim == 1);
+        ARG_ASSERT(1, ann.dist_type == AF_SAD || ann.dist_type == AF_SSD ||
+                          ann.dist_type == AF_SHD);
+
+        AF_CHECK(af_release_array(paramArray));
+        *index = getAnnIndexHandle(ann);
+    } catch (...) {
+        // Release the arrays read before the error
+        if (paramArray != 0) { af_release_array(paramArray); }
+        for (af_array arr : {ann.centroids, ann.data, ann.ids, ann.offsets}) {
+            if (arr != 0) { af_release_array(arr); }
+        }
+        return processException();
+    }
+    return AF_SUCCESS;
+}
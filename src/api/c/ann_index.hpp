@@ -0,0 +1,33 @@
+/*******************************************************
+ * Copyright (c) 2026, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+#pragma once
+#include <af/array.h>
+#include <af/vision.h>
+
+/// An inverted file index. The training points are grouped into lists by
+/// their nearest centroid and stored list by list.
+typedef struct {
+    /// The centroids of the lists, one point per column
+    af_array centroids;
+    /// The training points, one point per column, grouped by list
+    af_array data;
+    /// The index in the training array of every column of data (u32)
+    af_array ids;
+    /// The first column of every list in data followed by the number of
+    /// points (u32)
+    af_array offsets;
+    /// The dimension along which the coordinates of the training points
+    /// were stored
+    dim_t dist_dim;
+    af_match_type dist_type;
+} af_ann_index_t;
+
+af_ann_index getAnnIndexHandle(const af_ann_index_t index);
+
+af_ann_index_t getAnnIndex(const af_ann_index handle);
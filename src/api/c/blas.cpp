@@ -39,6 +39,17 @@ static inline af_array sparseMatmul(const af_array lhs, const af_array rhs,
         matmul<T>(getSparseArray<T>(lhs), getArray<T>(rhs), optLhs, optRhs));
 }
 
+#if defined(AF_CPU)
+template<typename T>
+static inline af_array sparseSparseMatmul(const af_array lhs,
+                                          const af_array rhs,
+                                          af_mat_prop optLhs,
+                                          af_mat_prop optRhs) {
+    return getHandle(matmul<T>(getSparseArray<T>(lhs), getSparseArray<T>(rhs),
+                               optLhs, optRhs));
+}
+#endif
+
 template<typename T>
 static inline void gemm(af_array *out, af_mat_prop optLhs, af_mat_prop optRhs,
                         const T *alpha, const af_array lhs, const af_array rhs,
@@ -58,10 +69,20 @@ af_err af_sparse_matmul(af_array *out, const af_array lhs, const af_array rhs,
                         const af_mat_prop optLhs, const af_mat_prop optRhs) {
     try {
         const SparseArrayBase lhsBase = getSparseArrayBase(lhs);
-        const ArrayInfo &rhsInfo      = getInfo(rhs);
-
-        ARG_ASSERT(2,
-                   lhsBase.isSparse() == true && rhsInfo.isSparse() == false);
+        const ArrayInfo &rhsInfo      = getInfo(rhs, false);
+
+#if defined(AF_CPU)
+        // The CPU backend multiplies two CSR matrices into a CSR matrix
+        const bool sparseRhs = rhsInfo.isSparse();
+        if (sparseRhs) {
+            ARG_ASSERT(2, getSparseArrayBase(rhs).getStorage() ==
+                              AF_STORAGE_CSR);
+        }
+#else
+        const bool sparseRhs = false;
+#endif
+        ARG_ASSERT(2, lhsBase.isSparse() == true &&
+                          rhsInfo.isSparse() == sparseRhs);
 
         af_dtype lhs_type = lhsBase.getType();
         af_dtype rhs_type = rhsInfo.getType();
@@ -95,6 +116,32 @@ af_err af_sparse_matmul(af_array *out, const af_array lhs, const af_array rhs,
         DIM_ASSERT(1, ldims[lColDim] == rhsInfo.dims()[rRowDim]);
 
         af_array output = 0;
+#if defined(AF_CPU)
+        if (sparseRhs) {
+            switch (lhs_type) {
+                case f32:
+                    output =
+                        sparseSparseMatmul<float>(lhs, rhs, optLhs, optRhs);
+                    break;
+                case c32:
+                    output =
+                        sparseSparseMatmul<cfloat>(lhs, rhs, optLhs, optRhs);
+                    break;
+                case f64:
+                    output =
+                        sparseSparseMatmul<double>(lhs, rhs, optLhs, optRhs);
+                    break;
+                case c64:
+                    output =
+                        sparseSparseMatmul<cdouble>(lhs, rhs, optLhs, optRhs);
+                    break;
+                default: TYPE_ERROR(1, lhs_type);
+            }
+            std::swap(*out, output);
+            return AF_SUCCESS;
+        }
+#endif
+
         switch (lhs_type) {
             case f32:
                 output = sparseMatmul<float>(lhs, rhs, optLhs, optRhs);
@@ -215,11 +262,12 @@ af_err af_matmul(af_array *out, const af_array lhs, const af_array rhs,
                  const af_mat_prop optLhs, const af_mat_prop optRhs) {
     try {
         const ArrayInfo &lhsInfo = getInfo(lhs, false, true);
-        const ArrayInfo &rhsInfo = getInfo(rhs, true, true);
+        const ArrayInfo &rhsInfo = getInfo(rhs, false, true);
 
         if (lhsInfo.isSparse()) {
             return af_sparse_matmul(out, lhs, rhs, optLhs, optRhs);
         }
+        ARG_ASSERT(2, rhsInfo.isSparse() == false);
 
         const int aRowDim = (optLhs == AF_MAT_NONE) ? 0 : 1;
         const int bColDim = (optRhs == AF_MAT_NONE) ? 1 : 0;
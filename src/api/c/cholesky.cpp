@@ -36,9 +36,11 @@ af_err af_cholesky(af_array *out, int *info, const af_array in,
     try {
         const ArrayInfo &i_info = getInfo(in);
 
+#if !defined(AF_CPU)
         if (i_info.ndims() > 2) {
             AF_ERROR("cholesky can not be used in batch mode", AF_ERR_BATCH);
         }
+#endif
 
         af_dtype type = i_info.getType();
 
@@ -68,9 +70,11 @@ af_err af_cholesky_inplace(int *info, af_array in, const bool is_upper) {
     try {
         const ArrayInfo &i_info = getInfo(in);
 
+#if !defined(AF_CPU)
         if (i_info.ndims() > 2) {
             AF_ERROR("cholesky can not be used in batch mode", AF_ERR_BATCH);
         }
+#endif
 
         af_dtype type = i_info.getType();
         if (i_info.ndims() == 0) { return AF_SUCCESS; }
@@ -24,6 +24,10 @@
 #include <mkl_service.h>
 #endif
 
+#if defined(AF_CPU)
+#include <parallel.hpp>
+#endif
+
 #include <cstring>
 #include <string>
 
@@ -406,3 +410,31 @@ af_err af_set_kernel_cache_directory(const char* path, int override_env) {
     CATCHALL
     return AF_SUCCESS;
 }
+
+af_err af_set_cpu_num_threads(const int nthreads) {
+    try {
+#if defined(AF_CPU)
+        detail::setNumThreads(nthreads);
+#else
+        UNUSED(nthreads);
+        AF_ERROR("The number of threads can only be set on the CPU backend",
+                 AF_ERR_NOT_SUPPORTED);
+#endif
+    }
+    CATCHALL
+    return AF_SUCCESS;
+}
+
+af_err af_get_cpu_num_threads(int* nthreads) {
+    try {
+        ARG_ASSERT(nthreads != nullptr, 0);
+#if defined(AF_CPU)
+        *nthreads = detail::getNumThreads();
+#else
+        AF_ERROR("The number of threads is only available on the CPU backend",
+                 AF_ERR_NOT_SUPPORTED);
+#endif
+    }
+    CATCHALL
+    return AF_SUCCESS;
+}
@@ -7,67 +7,64 @@
  * http://arrayfire.com/licenses/BSD-3-Clause
  ********************************************************/
 
-#include <arith.hpp>
 #include <backend.hpp>
 #include <cast.hpp>
 #include <common/err_common.hpp>
+#include <copy.hpp>
 #include <handle.hpp>
 #include <lookup.hpp>
-#include <reduce.hpp>
-#include <scan.hpp>
-#include <af/data.h>
 #include <af/defines.h>
 #include <af/image.h>
-#include <af/index.h>
 
-using af::dim4;
-using detail::arithOp;
+#include <algorithm>
+#include <vector>
+
 using detail::Array;
 using detail::cast;
-using detail::createValueArray;
+using detail::copyData;
+using detail::createHostDataArray;
 using detail::intl;
 using detail::lookup;
-using detail::reduce_all;
-using detail::scan;
 using detail::uchar;
 using detail::uint;
 using detail::uintl;
 using detail::ushort;
+using std::minmax_element;
+using std::vector;
 
 template<typename T, typename hType>
 static af_array hist_equal(const af_array& in, const af_array& hist) {
-    const Array<T> input = getArray<T>(in);
-
-    af_array vInput = 0;
-    AF_CHECK(af_flat(&vInput, in));
-
-    Array<float> fHist = cast<float>(getArray<hType>(hist));
-
-    const dim4& hDims = fHist.dims();
-    dim_t grayLevels  = fHist.elements();
-
-    Array<float> cdf = scan<af_add_t, float, float>(fHist, 0);
+    const Array<T> input       = getArray<T>(in);
+    const Array<hType> histArr = getArray<hType>(hist);
+
+    // The histogram is small, so its normalized cdf is computed on the host
+    // in a single pass instead of with separate scan, reduction and
+    // arithmetic kernels. Only the lookup of the input runs on the device.
+    const dim_t grayLevels = histArr.elements();
+    vector<hType> counts(grayLevels);
+    copyData(counts.data(), histArr);
+
+    vector<float> cdf(grayLevels);
+    float sum = 0;
+    for (dim_t i = 0; i < grayLevels; ++i) {
+        sum += static_cast<float>(counts[i]);
+        cdf[i] = sum;
+    }
 
-    float minCdf = reduce_all<af_min_t, float, float>(cdf);
-    float maxCdf = reduce_all<af_max_t, float, float>(cdf);
-    float factor = static_cast<float>(grayLevels - 1) / (maxCdf - minCdf);
+    const auto range   = minmax_element(cdf.begin(), cdf.end());
+    const float minCdf = *range.first;
+    const float maxCdf = *range.second;
+    const float factor = static_cast<float>(grayLevels - 1) / (maxCdf - minCdf);
+    for (float& value : cdf) { value = (value - minCdf) * factor; }
 
-    // constant array of min value from cdf
-    Array<float> minCnst = createValueArray<float>(hDims, minCdf);
-    // constant array of factor variable
-    Array<float> facCnst = createValueArray<float>(hDims, factor);
-    // cdf(i) - min for all elements
-    Array<float> diff = arithOp<float, af_sub_t>(cdf, minCnst, hDims);
-    // multiply factor with difference
-    Array<float> normCdf = arithOp<float, af_mul_t>(diff, facCnst, hDims);
+    const Array<float> normCdf =
+        createHostDataArray<float>(histArr.dims(), cdf.data());
     // index input array with normalized cdf array
-    Array<float> idxArr = lookup<float, T>(normCdf, getArray<T>(vInput), 0);
+    Array<float> idxArr = lookup<float, T>(normCdf, flat(input), 0);
 
     Array<T> result = cast<T>(idxArr);
     result          = modDims(result, input.dims());
 
-    AF_CHECK(af_release_array(vInput));
-
     return getHandle<T>(result);
 }
 
@@ -28,9 +28,11 @@ af_err af_inverse(af_array* out, const af_array in, const af_mat_prop options) {
     try {
         const ArrayInfo& i_info = getInfo(in);
 
+#if !defined(AF_CPU)
         if (i_info.ndims() > 2) {
             AF_ERROR("solve can not be used in batch mode", AF_ERR_BATCH);
         }
+#endif
 
         af_dtype type = i_info.getType();
 
@@ -47,9 +47,11 @@ af_err af_lu(af_array *lower, af_array *upper, af_array *pivot,
     try {
         const ArrayInfo &i_info = getInfo(in);
 
+#if !defined(AF_CPU)
         if (i_info.ndims() > 2) {
             AF_ERROR("lu can not be used in batch mode", AF_ERR_BATCH);
         }
+#endif
 
         af_dtype type = i_info.getType();
 
@@ -83,9 +85,11 @@ af_err af_lu_inplace(af_array *pivot, af_array in, const bool is_lapack_piv) {
         const ArrayInfo &i_info = getInfo(in);
         af_dtype type           = i_info.getType();
 
+#if !defined(AF_CPU)
         if (i_info.ndims() > 2) {
             AF_ERROR("lu can not be used in batch mode", AF_ERR_BATCH);
         }
+#endif
 
         ARG_ASSERT(1, i_info.isFloating());  // Only floating and complex types
         ARG_ASSERT(0, pivot != nullptr);
@@ -8,76 +8,57 @@
  ********************************************************/
 
 #include <backend.hpp>
-#include <cast.hpp>
 #include <common/err_common.hpp>
+#include <copy.hpp>
 #include <handle.hpp>
-#include <math.hpp>
-#include <sort.hpp>
-#include <af/arith.h>
-#include <af/data.h>
+#include <platform.hpp>
+#include <quantile.hpp>
 #include <af/defines.h>
 #include <af/dim4.hpp>
-#include <af/index.h>
 #include <af/statistics.h>
 
+#include <type_traits>
+#include <vector>
+
 using af::dim4;
 using detail::Array;
-using detail::division;
+using detail::copyArray;
+using detail::copyData;
+using detail::getActiveDeviceId;
+using detail::intl;
+using detail::isDoubleSupported;
+using detail::quantile;
 using detail::uchar;
 using detail::uint;
+using detail::uintl;
 using detail::ushort;
-using std::sort;
+using std::vector;
 
+/// Floating point inputs keep their type. Other types return floats.
 template<typename T>
-static double median(const af_array& in) {
-    dim_t nElems = getInfo(in).elements();
-    dim4 dims(nElems, 1, 1, 1);
-    ARG_ASSERT(0, nElems > 0);
-
-    af_array temp = 0;
-    AF_CHECK(af_moddims(&temp, in, 1, dims.get()));
-    const Array<T> input = getArray<T>(temp);
-
-    // Shortcut cases for 1 or 2 elements
-    if (nElems == 1) {
-        T result;
-        AF_CHECK(af_get_data_ptr((void*)&result, in));
-        return result;
-    }
-    if (nElems == 2) {
-        T result[2];
-        AF_CHECK(af_get_data_ptr((void*)&result, in));
-        return division(
-            (static_cast<double>(result[0]) + static_cast<double>(result[1])),
-            2.0);
-    }
-
-    double mid       = static_cast<double>(nElems + 1) / 2.0;
-    af_seq mdSpan[1] = {af_make_seq(mid - 1, mid, 1)};
+using quantile_t =
+    typename std::conditional<std::is_same<T, double>::value, double,
+                              float>::type;
 
-    Array<T> sortedArr = sort<T>(input, 0, true);
+template<typename T, typename To>
+static double median(const Array<T>& input) {
+    const Array<To> result = quantile<T, To>(flat(input), {0.5}, 0);
 
-    af_array sarrHandle = getHandle<T>(sortedArr);
-
-    double result;
-    T resPtr[2];
-    af_array res = 0;
-    AF_CHECK(af_index(&res, sarrHandle, 1, mdSpan));
-    AF_CHECK(af_get_data_ptr((void*)&resPtr, res));
+    To median;
+    copyData(&median, result);
+    return static_cast<double>(median);
+}
 
-    AF_CHECK(af_release_array(res));
-    AF_CHECK(af_release_array(sarrHandle));
-    AF_CHECK(af_release_array(temp));
+template<typename T>
+static double median(const af_array& in) {
+    const Array<T> input = getArray<T>(in);
+    ARG_ASSERT(0, input.elements() > 0);
 
-    if (nElems % 2 == 1) {
-        result = resPtr[0];
-    } else {
-        result = division(
-            static_cast<double>(resPtr[0]) + static_cast<double>(resPtr[1]),
-            2.0);
+    // Devices without double precision support interpolate in floats
+    if (isDoubleSupported(getActiveDeviceId())) {
+        return median<T, double>(input);
     }
-
-    return result;
+    return median<T, float>(input);
 }
 
 template<typename T>
@@ -90,68 +71,80 @@ static af_array median(const af_array& in, const dim_t dim) {
         return getHandle<T>(result);
     }
 
-    Array<T> sortedIn = sort<T>(input, dim, true);
-
-    size_t dimLength = input.dims()[dim];
-    double mid       = static_cast<double>(dimLength + 1) / 2.0;
-    af_array left    = 0;
+    return getHandle(
+        quantile<T, quantile_t<T>>(input, {0.5}, static_cast<int>(dim)));
+}
 
-    af_seq slices[4] = {af_span, af_span, af_span, af_span};
-    slices[dim]      = af_make_seq(mid - 1.0, mid - 1.0, 1.0);
+template<typename T>
+static af_array quantile(const af_array in, const vector<double>& probs,
+                         const dim_t dim) {
+    return getHandle(quantile<T, quantile_t<T>>(getArray<T>(in), probs,
+                                                static_cast<int>(dim)));
+}
 
-    af_array sortedIn_handle = getHandle<T>(sortedIn);
-    AF_CHECK(af_index(&left, sortedIn_handle, input.ndims(), slices));
+/// Copies \p probs to the host in its own type and converts the values to
+/// double there, so devices without double support can read them
+template<typename T>
+static vector<double> readProbabilities(const Array<T>& probs) {
+    vector<T> host(probs.elements());
+    copyData(host.data(), probs);
+    return vector<double>(host.begin(), host.end());
+}
 
-    af_array out = nullptr;
-    if (dimLength % 2 == 1) {
-        // mid-1 is our guy
-        if (input.isFloating()) {
-            AF_CHECK(af_release_array(sortedIn_handle));
-            return left;
-        }
+/// Returns the probabilities in \p probs divided by \p scale
+static vector<double> getProbabilities(const af_array probs, double scale) {
+    const ArrayInfo& info = getInfo(probs);
+    if (info.isComplex()) { TYPE_ERROR(2, info.getType()); }
+    ARG_ASSERT(2, info.elements() > 0);
+
+    vector<double> values;
+    switch (info.getType()) {
+        case f64: values = readProbabilities(getArray<double>(probs)); break;
+        case f32: values = readProbabilities(getArray<float>(probs)); break;
+        case s32: values = readProbabilities(getArray<int>(probs)); break;
+        case u32: values = readProbabilities(getArray<uint>(probs)); break;
+        case s64: values = readProbabilities(getArray<intl>(probs)); break;
+        case u64: values = readProbabilities(getArray<uintl>(probs)); break;
+        case s16: values = readProbabilities(getArray<short>(probs)); break;
+        case u16: values = readProbabilities(getArray<ushort>(probs)); break;
+        case u8: values = readProbabilities(getArray<uchar>(probs)); break;
+        case b8: values = readProbabilities(getArray<char>(probs)); break;
+        default:
+            values = readProbabilities(castArray<float>(probs));
+            break;
+    }
+    for (double& value : values) {
+        value /= scale;
+        ARG_ASSERT(2, value >= 0.0 && value <= 1.0);
+    }
+    return values;
+}
 
-        // Return as floats for consistency
-        af_array out;
-        AF_CHECK(af_cast(&out, left, f32));
-        AF_CHECK(af_release_array(left));
-        AF_CHECK(af_release_array(sortedIn_handle));
-        return out;
-    } else {
-        // ((mid-1)+mid)/2 is our guy
-        dim4 dims      = input.dims();
-        af_array right = 0;
-        slices[dim]    = af_make_seq(mid, mid, 1.0);
-
-        AF_CHECK(af_index(&right, sortedIn_handle, dims.ndims(), slices));
-
-        af_array sumarr = 0;
-        af_array carr   = 0;
-
-        dim4 cdims = dims;
-        cdims[dim] = 1;
-        AF_CHECK(af_constant(&carr, 0.5, cdims.ndims(), cdims.get(),
-                             input.isDouble() ? f64 : f32));
-
-        if (!input.isFloating()) {
-            af_array lleft, rright;
-            AF_CHECK(af_cast(&lleft, left, f32));
-            AF_CHECK(af_cast(&rright, right, f32));
-            AF_CHECK(af_release_array(left));
-            AF_CHECK(af_release_array(right));
-            left  = lleft;
-            right = rright;
-        }
+static af_err quantile(af_array* out, const af_array in, const af_array probs,
+                       const dim_t dim, double scale) {
+    try {
+        ARG_ASSERT(3, (dim >= 0 && dim < AF_MAX_DIMS));
 
-        AF_CHECK(af_add(&sumarr, left, right, false));
-        AF_CHECK(af_mul(&out, sumarr, carr, false));
+        const ArrayInfo& info = getInfo(in);
+        ARG_ASSERT(1, info.elements() > 0);
+        const vector<double> values = getProbabilities(probs, scale);
 
-        AF_CHECK(af_release_array(left));
-        AF_CHECK(af_release_array(right));
-        AF_CHECK(af_release_array(sumarr));
-        AF_CHECK(af_release_array(carr));
-        AF_CHECK(af_release_array(sortedIn_handle));
+        af_array output = 0;
+        af_dtype type   = info.getType();
+        switch (type) {
+            case f64: output = quantile<double>(in, values, dim); break;
+            case f32: output = quantile<float>(in, values, dim); break;
+            case s32: output = quantile<int>(in, values, dim); break;
+            case u32: output = quantile<uint>(in, values, dim); break;
+            case s16: output = quantile<short>(in, values, dim); break;
+            case u16: output = quantile<ushort>(in, values, dim); break;
+            case u8: output = quantile<uchar>(in, values, dim); break;
+            default: TYPE_ERROR(1, type);
+        }
+        std::swap(*out, output);
     }
-    return out;
+    CATCHALL;
+    return AF_SUCCESS;
 }
 
 af_err af_median_all(double* realVal, double* imagVal,  // NOLINT
@@ -201,3 +194,13 @@ af_err af_median(af_array* out, const af_array in, const dim_t dim) {
     CATCHALL;
     return AF_SUCCESS;
 }
+
+af_err af_quantile(af_array* out, const af_array in, const af_array probs,
+                   const dim_t dim) {
+    return quantile(out, in, probs, dim, 1.0);
+}
+
+af_err af_percentile(af_array* out, const af_array in, const af_array percents,
+                     const dim_t dim) {
+    return quantile(out, in, percents, dim, 100.0);
+}
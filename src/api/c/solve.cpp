@@ -34,9 +34,11 @@ af_err af_solve(af_array* out, const af_array a, const af_array b,
         const ArrayInfo& a_info = getInfo(a);
         const ArrayInfo& b_info = getInfo(b);
 
+#if !defined(AF_CPU)
         if (a_info.ndims() > 2 || b_info.ndims() > 2) {
             AF_ERROR("solve can not be used in batch mode", AF_ERR_BATCH);
         }
+#endif
 
         af_dtype a_type = a_info.getType();
         af_dtype b_type = b_info.getType();
@@ -102,9 +104,11 @@ af_err af_solve_lu(af_array* out, const af_array a, const af_array piv,
         const ArrayInfo& a_info = getInfo(a);
         const ArrayInfo& b_info = getInfo(b);
 
+#if !defined(AF_CPU)
         if (a_info.ndims() > 2 || b_info.ndims() > 2) {
             AF_ERROR("solveLU can not be used in batch mode", AF_ERR_BATCH);
         }
+#endif
 
         af_dtype a_type = a_info.getType();
         af_dtype b_type = b_info.getType();
@@ -125,6 +129,9 @@ af_err af_solve_lu(af_array* out, const af_array a, const af_array piv,
         DIM_ASSERT(1, bdims[2] == adims[2]);
         DIM_ASSERT(1, bdims[3] == adims[3]);
 
+        const dim4 pdims = getInfo(piv).dims();
+        DIM_ASSERT(2, pdims[2] == adims[2] && pdims[3] == adims[3]);
+
         if (options != AF_MAT_NONE) {
             AF_ERROR("Using this property is not yet supported in solveLU",
                      AF_ERR_NOT_SUPPORTED);
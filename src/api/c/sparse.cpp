@@ -223,9 +223,13 @@ af_array createSparseArrayFromDense(const af_array _in,
         case AF_STORAGE_COO:
             return getHandle(
                 sparseConvertDenseToStorage<T, AF_STORAGE_COO>(in));
+#if defined(AF_CPU)
         case AF_STORAGE_CSC:
-            // return getHandle(sparseConvertDenseToStorage<T,
-            // AF_STORAGE_CSC>(in));
+            return getHandle(
+                detail::sparseConvertStorageToStorage<T, AF_STORAGE_CSC,
+                                                      AF_STORAGE_CSR>(
+                    sparseConvertDenseToStorage<T, AF_STORAGE_CSR>(in)));
+#endif
         default:
             AF_ERROR("Storage type is out of range/unsupported", AF_ERR_ARG);
     }
@@ -274,11 +278,60 @@ af_err af_create_sparse_array_from_dense(af_array *out, const af_array in,
     return AF_SUCCESS;
 }
 
+#if defined(AF_CPU)
+// Conversions from and to CSC go through CSR, which holds the same arrays as
+// the CSC storage of the transposed matrix
+template<typename T>
+af_array sparseConvertCSC(const SparseArray<T> &in,
+                          const af_storage destStorage) {
+    if (in.getStorage() == AF_STORAGE_CSC) {
+        const SparseArray<T> csr =
+            detail::sparseConvertStorageToStorage<T, AF_STORAGE_CSR,
+                                                  AF_STORAGE_CSC>(in);
+        switch (destStorage) {
+            case AF_STORAGE_DENSE:
+                return getHandle(
+                    detail::sparseConvertStorageToDense<T, AF_STORAGE_CSR>(
+                        csr));
+            case AF_STORAGE_CSR: return getHandle(csr);
+            case AF_STORAGE_COO:
+                return getHandle(
+                    detail::sparseConvertStorageToStorage<T, AF_STORAGE_COO,
+                                                          AF_STORAGE_CSR>(csr));
+            default:
+                AF_ERROR("Invalid storage type of output array", AF_ERR_ARG);
+        }
+    }
+
+    switch (in.getStorage()) {
+        case AF_STORAGE_CSR:
+            return getHandle(
+                detail::sparseConvertStorageToStorage<T, AF_STORAGE_CSC,
+                                                      AF_STORAGE_CSR>(in));
+        case AF_STORAGE_COO:
+            return getHandle(
+                detail::sparseConvertStorageToStorage<T, AF_STORAGE_CSC,
+                                                      AF_STORAGE_CSR>(
+                    detail::sparseConvertStorageToStorage<T, AF_STORAGE_CSR,
+                                                          AF_STORAGE_COO>(
+                        in)));
+        default:
+            AF_ERROR("Invalid storage type of input array", AF_ERR_ARG);
+    }
+}
+#endif
+
 template<typename T>
 af_array sparseConvertStorage(const af_array in_,
                               const af_storage destStorage) {
     const SparseArray<T> in = getSparseArray<T>(in_);
 
+#if defined(AF_CPU)
+    if (in.getStorage() == AF_STORAGE_CSC || destStorage == AF_STORAGE_CSC) {
+        return sparseConvertCSC<T>(in, destStorage);
+    }
+#endif
+
     if (destStorage == AF_STORAGE_DENSE) {
         // Returns a regular af_array, not sparse
         switch (in.getStorage()) {
@@ -333,12 +386,14 @@ af_err af_sparse_convert_to(af_array *out, const af_array in,
         const SparseArrayBase &base = getSparseArrayBase(in);
 
         // Dense not allowed as input -> Should never happen with
-        // SparseArrayBase CSC is currently not supported
-        ARG_ASSERT(1, base.getStorage() != AF_STORAGE_DENSE &&
-                          base.getStorage() != AF_STORAGE_CSC);
+        // SparseArrayBase
+        ARG_ASSERT(1, base.getStorage() != AF_STORAGE_DENSE);
 
-        // Conversion to and from CSC is not supported
+#if !defined(AF_CPU)
+        // Conversion to and from CSC is only supported on the CPU backend
+        ARG_ASSERT(1, base.getStorage() != AF_STORAGE_CSC);
         ARG_ASSERT(2, destStorage != AF_STORAGE_CSC);
+#endif
 
         if (base.getStorage() == destStorage) {
             // Return a reference
@@ -0,0 +1,647 @@
+/*******************************************************
+ * Copyright (c) 2026, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <arith.hpp>
+#include <backend.hpp>
+#include <common/ArrayInfo.hpp>
+#include <common/SparseArray.hpp>
+#include <common/err_common.hpp>
+#include <complex.hpp>
+#include <copy.hpp>
+#include <handle.hpp>
+#include <math.hpp>
+#include <optypes.hpp>
+#include <reduce.hpp>
+#include <sparse_blas.hpp>
+#include <sparse_handle.hpp>
+#include <af/defines.h>
+#include <af/dim4.hpp>
+#include <af/sparse.h>
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <utility>
+#include <vector>
+
+using af::dim4;
+using common::SparseArray;
+using common::SparseArrayBase;
+using detail::arithOp;
+using detail::Array;
+using detail::cdouble;
+using detail::cfloat;
+using detail::copyData;
+using detail::createEmptyArray;
+using detail::createHostDataArray;
+using detail::createValueArray;
+using detail::matmul;
+using detail::reduce;
+using std::abs;
+using std::vector;
+
+// Krylov solvers for sparse systems. Every column of the right hand side is
+// solved for independently, but the columns share the sparse products and
+// the vector operations of an iteration. The few scalars of every iteration
+// are computed on the host in double precision, one per column, which is also
+// where the convergence of every column is tracked. A column that converges
+// has its scalars set to zero so that its solution stops changing while the
+// others continue.
+
+namespace {
+
+/// The host type with the memory layout of the backend type T
+template<typename T>
+struct HostType {
+    using type = T;
+};
+template<>
+struct HostType<cfloat> {
+    using type = std::complex<float>;
+};
+template<>
+struct HostType<cdouble> {
+    using type = std::complex<double>;
+};
+
+/// One scalar per right hand side
+using Scalar  = std::complex<double>;
+using Scalars = vector<Scalar>;
+
+inline void assign(float &out, Scalar in) {
+    out = static_cast<float>(in.real());
+}
+inline void assign(double &out, Scalar in) { out = in.real(); }
+inline void assign(std::complex<float> &out, Scalar in) {
+    out = std::complex<float>(in);
+}
+inline void assign(std::complex<double> &out, Scalar in) { out = in; }
+
+template<typename T>
+Scalars toScalars(const Array<T> &in) {
+    vector<typename HostType<T>::type> host(in.elements());
+    copyData(reinterpret_cast<T *>(host.data()), in);
+    return Scalars(host.begin(), host.end());
+}
+
+/// Returns a 1 x n array that broadcasts \p in over the rows of an array
+template<typename T>
+Array<T> fromScalars(const Scalars &in) {
+    vector<typename HostType<T>::type> host(in.size());
+    for (size_t i = 0; i < in.size(); ++i) { assign(host[i], in[i]); }
+    return createHostDataArray(dim4(1, static_cast<dim_t>(in.size())),
+                               reinterpret_cast<const T *>(host.data()));
+}
+
+template<typename T>
+Array<T> conjugate(const Array<T> &in) {
+    return in;
+}
+template<>
+Array<cfloat> conjugate(const Array<cfloat> &in) {
+    return detail::conj(in);
+}
+template<>
+Array<cdouble> conjugate(const Array<cdouble> &in) {
+    return detail::conj(in);
+}
+
+/// The dot product of every column of \p x with the same column of \p y
+template<typename T>
+Scalars dot(const Array<T> &x, const Array<T> &y) {
+    return toScalars(reduce<af_add_t, T, T>(
+        arithOp<T, af_mul_t>(conjugate(x), y, x.dims()), 0));
+}
+
+/// The norm of every column of \p x
+template<typename T>
+vector<double> norms(const Array<T> &x) {
+    const Scalars xx = dot(x, x);
+    vector<double> out(xx.size());
+    for (size_t i = 0; i < xx.size(); ++i) {
+        out[i] = std::sqrt(std::max(xx[i].real(), 0.0));
+    }
+    return out;
+}
+
+/// Returns y + a x, with one scalar of \p a per column
+template<typename T>
+Array<T> axpy(const Array<T> &y, const Scalars &a, const Array<T> &x) {
+    Array<T> out = arithOp<T, af_add_t>(
+        y, arithOp<T, af_mul_t>(fromScalars<T>(a), x, x.dims()), y.dims());
+    out.eval();
+    return out;
+}
+
+/// Returns a x, with one scalar of \p a per column
+template<typename T>
+Array<T> scale(const Scalars &a, const Array<T> &x) {
+    Array<T> out = arithOp<T, af_mul_t>(fromScalars<T>(a), x, x.dims());
+    out.eval();
+    return out;
+}
+
+template<typename T>
+Array<T> spmv(const SparseArray<T> &a, const Array<T> &x) {
+    return matmul(a, x, AF_MAT_NONE, AF_MAT_NONE);
+}
+
+/// Returns \p num / \p den, or zero when \p den is zero
+inline Scalar divide(Scalar num, Scalar den) {
+    return den == Scalar(0) ? Scalar(0) : num / den;
+}
+
+/// Applies the inverse of an approximation of A. The Jacobi preconditioner
+/// scales the rows on the device. ILU(0) is factorized and applied on the
+/// host because its triangular solves are sequential.
+template<typename T>
+class Preconditioner {
+   public:
+    Preconditioner(const SparseArray<T> &a, const af_preconditioner type)
+        : type_(type), invDiag_(createEmptyArray<T>(dim4())) {
+        if (type_ == AF_PRECONDITIONER_NONE) { return; }
+
+        const dim_t n = a.dims()[0];
+        rowPtr_.resize(n + 1);
+        colIdx_.resize(a.getNNZ());
+        values_.resize(a.getNNZ());
+        copyData(rowPtr_.data(), a.getRowIdx());
+        copyData(colIdx_.data(), a.getColIdx());
+        copyData(reinterpret_cast<T *>(values_.data()), a.getValues());
+        sortRows();
+        findDiagonal();
+
+        if (type_ == AF_PRECONDITIONER_JACOBI) {
+            vector<H> inv(n);
+            for (dim_t i = 0; i < n; ++i) {
+                inv[i] = H(1) / values_[diag_[i]];
+            }
+            invDiag_ = createHostDataArray(
+                dim4(n), reinterpret_cast<const T *>(inv.data()));
+        } else {
+            factorize();
+        }
+    }
+
+    Array<T> apply(const Array<T> &r) const {
+        switch (type_) {
+            case AF_PRECONDITIONER_JACOBI: {
+                Array<T> out =
+                    arithOp<T, af_mul_t>(invDiag_, r, r.dims());
+                out.eval();
+                return out;
+            }
+            case AF_PRECONDITIONER_ILU0: return solveLU(r);
+            default: return r;
+        }
+    }
+
+   private:
+    using H = typename HostType<T>::type;
+
+    /// Sorts the column indices of every row, which the factorization needs
+    void sortRows() {
+        vector<std::pair<int, H>> row;
+        for (size_t i = 0; i + 1 < rowPtr_.size(); ++i) {
+            row.clear();
+            for (int k = rowPtr_[i]; k < rowPtr_[i + 1]; ++k) {
+                row.emplace_back(colIdx_[k], values_[k]);
+            }
+            std::sort(row.begin(), row.end(),
+                      [](const std::pair<int, H> &l,
+                         const std::pair<int, H> &r) {
+                          return l.first < r.first;
+                      });
+            for (size_t k = 0; k < row.size(); ++k) {
+                colIdx_[rowPtr_[i] + k] = row[k].first;
+                values_[rowPtr_[i] + k] = row[k].second;
+            }
+        }
+    }
+
+    void findDiagonal() {
+        const int n = static_cast<int>(rowPtr_.size()) - 1;
+        diag_.resize(n);
+        for (int i = 0; i < n; ++i) {
+            const int *first = colIdx_.data() + rowPtr_[i];
+            const int *last  = colIdx_.data() + rowPtr_[i + 1];
+            const int *d     = std::lower_bound(first, last, i);
+            if (d == last || *d != i ||
+                values_[d - colIdx_.data()] == H(0)) {
+                AF_ERROR("Preconditioner needs a nonzero diagonal",
+                         AF_ERR_ARG);
+            }
+            diag_[i] = static_cast<int>(d - colIdx_.data());
+        }
+    }
+
+    /// Computes L and U in place of A, keeping the sparsity of A. L has a
+    /// unit diagonal which is not stored.
+    void factorize() {
+        const int n = static_cast<int>(diag_.size());
+        vector<int> pos(n, -1);
+        for (int i = 0; i < n; ++i) {
+            for (int k = rowPtr_[i]; k < rowPtr_[i + 1]; ++k) {
+                pos[colIdx_[k]] = k;
+            }
+            for (int k = rowPtr_[i]; k < diag_[i]; ++k) {
+                const int c = colIdx_[k];
+                values_[k] /= values_[diag_[c]];
+                for (int j = diag_[c] + 1; j < rowPtr_[c + 1]; ++j) {
+                    if (pos[colIdx_[j]] >= 0) {
+                        values_[pos[colIdx_[j]]] -= values_[k] * values_[j];
+                    }
+                }
+            }
+            for (int k = rowPtr_[i]; k < rowPtr_[i + 1]; ++k) {
+                pos[colIdx_[k]] = -1;
+            }
+            if (values_[diag_[i]] == H(0)) {
+                AF_ERROR("ILU(0) preconditioner has a zero pivot", AF_ERR_ARG);
+            }
+        }
+    }
+
+    Array<T> solveLU(const Array<T> &r) const {
+        const int n = static_cast<int>(diag_.size());
+        vector<H> x(r.elements());
+        copyData(reinterpret_cast<T *>(x.data()), r);
+        for (dim_t c = 0; c < r.dims()[1]; ++c) {
+            H *xc = x.data() + c * n;
+            for (int i = 0; i < n; ++i) {
+                H sum = xc[i];
+                for (int k = rowPtr_[i]; k < diag_[i]; ++k) {
+                    sum -= values_[k] * xc[colIdx_[k]];
+                }
+                xc[i] = sum;
+            }
+            for (int i = n - 1; i >= 0; --i) {
+                H sum = xc[i];
+                for (int k = diag_[i] + 1; k < rowPtr_[i + 1]; ++k) {
+                    sum -= values_[k] * xc[colIdx_[k]];
+                }
+                xc[i] = sum / values_[diag_[i]];
+            }
+        }
+        return createHostDataArray(r.dims(),
+                                   reinterpret_cast<const T *>(x.data()));
+    }
+
+    af_preconditioner type_;
+    Array<T> invDiag_;
+    vector<int> rowPtr_;
+    vector<int> colIdx_;
+    vector<int> diag_;
+    vector<H> values_;
+};
+
+/// Tracks which columns have converged and calls the user callback
+class Monitor {
+   public:
+    Monitor(const vector<double> &bNorms, const double tol, const int maxIter,
+            af_sparse_solve_callback callback, void *userData)
+        : bNorms_(bNorms)
+        , tol_(tol)
+        , maxIter_(maxIter)
+        , callback_(callback)
+        , userData_(userData)
+        , active_(bNorms.size(), true)
+        , residuals_(bNorms.size(), 0.0) {}
+
+    /// Records the residual norms \p rNorms. Returns true when every column
+    /// has converged or stopped.
+    bool check(const vector<double> &rNorms) {
+        bool done = true;
+        for (size_t c = 0; c < rNorms.size(); ++c) {
+            if (!active_[c]) { continue; }
+            residuals_[c] =
+                bNorms_[c] > 0 ? rNorms[c] / bNorms_[c] : rNorms[c];
+            if (residuals_[c] <= tol_ || !std::isfinite(residuals_[c])) {
+                active_[c] = false;
+            }
+            done = done && !active_[c];
+        }
+        return done;
+    }
+
+    /// Records the residual norms after \p iteration iterations. Returns true
+    /// when the solver should stop.
+    bool update(const int iteration, const vector<double> &rNorms) {
+        bool done = check(rNorms);
+        if (callback_ &&
+            callback_(userData_, iteration, residuals_.data(),
+                      static_cast<int>(residuals_.size())) != 0) {
+            done = true;
+        }
+        return done || iteration >= maxIter_;
+    }
+
+    /// Stops updating column \p c, when its method breaks down
+    void stop(const size_t c) { active_[c] = false; }
+
+    bool active(const size_t c) const { return active_[c]; }
+
+    /// Returns \p s for the active columns and zero for the others
+    Scalars mask(Scalars s) const {
+        for (size_t c = 0; c < s.size(); ++c) {
+            if (!active_[c]) { s[c] = 0; }
+        }
+        return s;
+    }
+
+   private:
+    vector<double> bNorms_;
+    double tol_;
+    int maxIter_;
+    af_sparse_solve_callback callback_;
+    void *userData_;
+    vector<bool> active_;
+    vector<double> residuals_;
+};
+
+/// Preconditioned conjugate gradient
+template<typename T>
+int cg(Array<T> &x, const SparseArray<T> &a, const Array<T> &b,
+       const Preconditioner<T> &precond, Monitor &monitor) {
+    Array<T> r  = b;
+    Array<T> z  = precond.apply(r);
+    Array<T> p  = z;
+    Scalars rz  = dot(r, z);
+    const int K = static_cast<int>(rz.size());
+
+    for (int iter = 1;; ++iter) {
+        const Array<T> ap  = spmv(a, p);
+        const Scalars pap  = dot(p, ap);
+        Scalars alpha(K), minusAlpha(K);
+        for (int c = 0; c < K; ++c) {
+            alpha[c]      = divide(rz[c], pap[c]);
+            minusAlpha[c] = -alpha[c];
+        }
+        alpha = monitor.mask(alpha);
+        x     = axpy(x, alpha, p);
+        r     = axpy(r, monitor.mask(minusAlpha), ap);
+        if (monitor.update(iter, norms(r))) { return iter; }
+
+        z                  = precond.apply(r);
+        const Scalars rzNew = dot(r, z);
+        Scalars beta(K);
+        for (int c = 0; c < K; ++c) { beta[c] = divide(rzNew[c], rz[c]); }
+        p  = axpy(z, monitor.mask(beta), p);
+        rz = rzNew;
+    }
+}
+
+/// Preconditioned stabilized biconjugate gradient
+template<typename T>
+int bicgstab(Array<T> &x, const SparseArray<T> &a, const Array<T> &b,
+             const Preconditioner<T> &precond, Monitor &monitor) {
+    const Array<T> rHat = b;
+    Array<T> r          = b;
+    Array<T> p          = b;
+    Array<T> v          = b;
+    Scalars rho         = dot(rHat, r);
+    const int K         = static_cast<int>(rho.size());
+    Scalars omega(K, 0.0);
+
+    for (int iter = 1;; ++iter) {
+        const Array<T> pHat = precond.apply(p);
+        v                   = spmv(a, pHat);
+        const Scalars rv    = dot(rHat, v);
+        Scalars alpha(K), minusAlpha(K);
+        for (int c = 0; c < K; ++c) {
+            if (monitor.active(c) && rv[c] == Scalar(0)) { monitor.stop(c); }
+            alpha[c]      = divide(rho[c], rv[c]);
+            minusAlpha[c] = -alpha[c];
+        }
+        alpha               = monitor.mask(alpha);
+        const Array<T> s    = axpy(r, monitor.mask(minusAlpha), v);
+        const Array<T> sHat = precond.apply(s);
+        const Array<T> t    = spmv(a, sHat);
+        const Scalars ts    = dot(t, s);
+        const Scalars tt    = dot(t, t);
+        Scalars minusOmega(K);
+        for (int c = 0; c < K; ++c) {
+            omega[c]      = divide(ts[c], tt[c]);
+            minusOmega[c] = -omega[c];
+        }
+        omega = monitor.mask(omega);
+        x     = axpy(axpy(x, alpha, pHat), omega, sHat);
+        r     = axpy(s, monitor.mask(minusOmega), t);
+        if (monitor.update(iter, norms(r))) { return iter; }
+
+        const Scalars rhoNew = dot(rHat, r);
+        Scalars beta(K);
+        for (int c = 0; c < K; ++c) {
+            if (monitor.active(c) &&
+                (rhoNew[c] == Scalar(0) || omega[c] == Scalar(0))) {
+                monitor.stop(c);
+            }
+            beta[c]       = divide(rhoNew[c], rho[c]) * alpha[c];
+            beta[c]       = divide(beta[c], omega[c]);
+            minusOmega[c] = -omega[c] * beta[c];
+        }
+        // p = r + beta (p - omega v)
+        p   = axpy(axpy(r, monitor.mask(beta), p), monitor.mask(minusOmega),
+                   v);
+        rho = rhoNew;
+    }
+}
+
+/// Right preconditioned GMRES restarted every \p restart iterations. The
+/// Hessenberg matrix of every column is reduced with Givens rotations as it
+/// is built, which gives the residual norm of every iteration for free.
+template<typename T>
+int gmres(Array<T> &x, const SparseArray<T> &a, const Array<T> &b,
+          const Preconditioner<T> &precond, Monitor &monitor,
+          const int restart) {
+    const int K  = static_cast<int>(b.dims()[1]);
+    const int ld = restart + 1;
+    Array<T> r   = b;
+    int iter     = 0;
+
+    for (;;) {
+        const vector<double> beta = norms(r);
+        Scalars inv(K);
+        for (int c = 0; c < K; ++c) { inv[c] = divide(1.0, beta[c]); }
+
+        vector<Array<T>> V(1, scale(monitor.mask(inv), r));
+        vector<Array<T>> Z;
+        // Per column: the reduced Hessenberg matrix, the rotations, the
+        // rotated residual and the number of basis vectors used
+        vector<Scalars> H(K, Scalars(ld * restart));
+        vector<vector<double>> cs(K, vector<double>(restart));
+        vector<Scalars> sn(K, Scalars(restart));
+        vector<Scalars> g(K, Scalars(ld));
+        vector<int> steps(K, 0);
+        for (int c = 0; c < K; ++c) { g[c][0] = beta[c]; }
+
+        bool done = false;
+        for (int j = 0; j < restart && !done; ++j) {
+            Z.push_back(precond.apply(V[j]));
+            Array<T> w = spmv(a, Z[j]);
+            for (int i = 0; i <= j; ++i) {
+                const Scalars h = dot(V[i], w);
+                Scalars minusH(K);
+                for (int c = 0; c < K; ++c) {
+                    H[c][i + j * ld] = h[c];
+                    minusH[c]        = -h[c];
+                }
+                w = axpy(w, minusH, V[i]);
+            }
+            const vector<double> hNext = norms(w);
+
+            vector<double> res(K, 0.0);
+            for (int c = 0; c < K; ++c) {
+                if (!monitor.active(c)) { continue; }
+                Scalar *h = &H[c][j * ld];
+                for (int i = 0; i < j; ++i) {
+                    const Scalar t = cs[c][i] * h[i] + sn[c][i] * h[i + 1];
+                    h[i + 1] =
+                        -std::conj(sn[c][i]) * h[i] + cs[c][i] * h[i + 1];
+                    h[i] = t;
+                }
+                const double ha = abs(h[j]);
+                const double nu = std::hypot(ha, hNext[c]);
+                if (nu == 0) {
+                    cs[c][j] = 1;
+                    sn[c][j] = 0;
+                } else if (ha == 0) {
+                    cs[c][j] = 0;
+                    sn[c][j] = 1;
+                } else {
+                    cs[c][j] = ha / nu;
+                    sn[c][j] = h[j] / ha * hNext[c] / nu;
+                }
+                h[j]        = cs[c][j] * h[j] + sn[c][j] * hNext[c];
+                g[c][j + 1] = -std::conj(sn[c][j]) * g[c][j];
+                g[c][j]     = cs[c][j] * g[c][j];
+                res[c]      = abs(g[c][j + 1]);
+                steps[c]    = j + 1;
+                inv[c]      = divide(1.0, hNext[c]);
+            }
+            done = monitor.update(++iter, res);
+            V.push_back(scale(monitor.mask(inv), w));
+        }
+
+        // Solve the triangular systems and update the solutions
+        const int m = *std::max_element(steps.begin(), steps.end());
+        vector<Scalars> y(m, Scalars(K, 0.0));
+        for (int c = 0; c < K; ++c) {
+            for (int i = steps[c] - 1; i >= 0; --i) {
+                Scalar sum = g[c][i];
+                for (int l = i + 1; l < steps[c]; ++l) {
+                    sum -= H[c][i + l * ld] * y[l][c];
+                }
+                y[i][c] = divide(sum, H[c][i + i * ld]);
+            }
+        }
+        for (int j = 0; j < m; ++j) { x = axpy(x, y[j], Z[j]); }
+        if (done) { return iter; }
+
+        // Restart from the true residual, which the rotated one only
+        // approximates in floating point
+        r = arithOp<T, af_sub_t>(b, spmv(a, x), b.dims());
+        r.eval();
+        if (monitor.check(norms(r))) { return iter; }
+    }
+}
+
+template<typename T>
+af_array sparseSolve(int *iterations, const af_array a, const af_array b,
+                     const af_sparse_solver solver,
+                     const af_preconditioner precond, const double tol,
+                     const int maxIter, const int restart,
+                     af_sparse_solve_callback callback, void *userData) {
+    const SparseArray<T> A = getSparseArray<T>(a);
+    const Array<T> B       = getArray<T>(b);
+
+    Array<T> x = createValueArray<T>(B.dims(), detail::scalar<T>(0));
+    int iter   = 0;
+    if (B.elements() > 0 && maxIter > 0) {
+        const Preconditioner<T> M(A, precond);
+        Monitor monitor(norms(B), tol, maxIter, callback, userData);
+        if (!monitor.check(norms(B))) {
+            switch (solver) {
+                case AF_SPARSE_SOLVER_BICGSTAB:
+                    iter = bicgstab(x, A, B, M, monitor);
+                    break;
+                case AF_SPARSE_SOLVER_GMRES:
+                    iter = gmres(x, A, B, M, monitor, restart);
+                    break;
+                default: iter = cg(x, A, B, M, monitor); break;
+            }
+        }
+    }
+    if (iterations) { *iterations = iter; }
+    return getHandle(x);
+}
+
+}  // namespace
+
+af_err af_sparse_solve(af_array *out, int *iterations, const af_array a,
+                       const af_array b, const af_sparse_solver solver,
+                       const af_preconditioner precond, const double tol,
+                       const int max_iter, const int restart,
+                       af_sparse_solve_callback callback, void *user_data) {
+    try {
+        const SparseArrayBase &aBase = getSparseArrayBase(a);
+        const ArrayInfo &bInfo       = getInfo(b);
+
+        ARG_ASSERT(2, aBase.getStorage() == AF_STORAGE_CSR);
+        ARG_ASSERT(4, solver == AF_SPARSE_SOLVER_CG ||
+                          solver == AF_SPARSE_SOLVER_BICGSTAB ||
+                          solver == AF_SPARSE_SOLVER_GMRES);
+        ARG_ASSERT(5, precond == AF_PRECONDITIONER_NONE ||
+                          precond == AF_PRECONDITIONER_JACOBI ||
+                          precond == AF_PRECONDITIONER_ILU0);
+        ARG_ASSERT(6, tol >= 0);
+        ARG_ASSERT(7, max_iter >= 0);
+        ARG_ASSERT(8, restart > 0 || solver != AF_SPARSE_SOLVER_GMRES);
+
+        const af_dtype type = aBase.getType();
+        TYPE_ASSERT(type == bInfo.getType());
+
+        const dim4 &aDims = aBase.dims();
+        const dim4 &bDims = bInfo.dims();
+        DIM_ASSERT(2, aDims[0] == aDims[1]);
+        DIM_ASSERT(3, bDims[0] == aDims[0]);
+        if (bDims[2] > 1 || bDims[3] > 1) {
+            AF_ERROR("Sparse solve can not be used in batch mode",
+                     AF_ERR_BATCH);
+        }
+
+        af_array output = 0;
+        switch (type) {
+            case f32:
+                output = sparseSolve<float>(iterations, a, b, solver, precond,
+                                            tol, max_iter, restart, callback,
+                                            user_data);
+                break;
+            case f64:
+                output = sparseSolve<double>(iterations, a, b, solver,
+                                             precond, tol, max_iter, restart,
+                                             callback, user_data);
+                break;
+            case c32:
+                output = sparseSolve<cfloat>(iterations, a, b, solver,
+                                             precond, tol, max_iter, restart,
+                                             callback, user_data);
+                break;
+            case c64:
+                output = sparseSolve<cdouble>(iterations, a, b, solver,
+                                              precond, tol, max_iter, restart,
+                                              callback, user_data);
+                break;
+            default: TYPE_ERROR(2, type);
+        }
+        std::swap(*out, output);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
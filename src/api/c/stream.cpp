@@ -9,121 +9,375 @@
 
 #include <backend.hpp>
 #include <common/ArrayInfo.hpp>
+#include <common/dispatch.hpp>
 #include <common/err_common.hpp>
+#include <copy.hpp>
 #include <handle.hpp>
 #include <type_util.hpp>
 
 #include <af/array.h>
 #include <af/index.h>
 
+#include <algorithm>
 #include <fstream>
-#include <iomanip>
+#include <future>
+#include <memory>
+#include <string>
 #include <vector>
 
 using std::string;
+using std::unique_ptr;
 using std::vector;
 
 using af::dim4;
+using detail::Array;
 using detail::cdouble;
 using detail::cfloat;
+using detail::copyData;
 using detail::createHostDataArray;
+using detail::createSubArray;
 using detail::intl;
 using detail::uchar;
 using detail::uint;
 using detail::uintl;
 using detail::ushort;
 
-#define STREAM_FORMAT_VERSION 0x1
+// Version 2
+// (char     )   Version (Once)
+// (int      )   No. of Arrays (Once)
+// (intl     )   Offset of the table of contents (Once)
+// (T        )   data of every array (x elements), each starting at a
+//               multiple of kStreamAlignment bytes
+// Table of contents, for every array:
+// (int    )   Length of the key
+// (cstring)   Key
+// (char   )   Type
+// (intl   )   dim4 (x 4)
+// (intl   )   Offset of the data
+// Appending an array leaves the previous table of contents unused in front
+// of the data of the new array
+//
+// Version 1, which is still read and appended to
+// (char     )   Version (Once)
+// (int      )   No. of Arrays (Once)
+// For every array:
+// (int    )   Length of the key
+// (cstring)   Key
+// (intl   )   Offset bytes to next array (type + dims + data)
+// (char   )   Type
+// (intl   )   dim4 (x 4)
+// (T      )   data (x elements)
+#define STREAM_FORMAT_VERSION 0x2
 static const char sfv_char = STREAM_FORMAT_VERSION;
 
-template<typename T>
-static int save(const char *key, const af_array arr, const char *filename,
-                const bool append = false) {
-    // (char     )   Version (Once)
-    // (int      )   No. of Arrays (Once)
-    // (int    )   Length of the key
-    // (cstring)   Key
-    // (intl   )   Offset bytes to next array (type + dims + data)
-    // (char   )   Type
-    // (intl   )   dim4 (x 4)
-    // (T      )   data (x elements)
-    // Setup all the data structures that need to be written to file
-    ///////////////////////////////////////////////////////////////////////////
-    std::string k(key);
-    int klen = k.size();
+namespace {
+
+/// The data of every array in a version 2 file starts at a multiple of this
+/// many bytes
+constexpr intl kStreamAlignment = 64;
+
+/// The number of bytes af_save_array copies to the host at a time. Every
+/// chunk is written to the file while the next one is copied.
+constexpr intl kStreamChunkBytes = intl(64) << 20;
+
+/// An array listed in the table of contents of a file
+struct StreamEntry {
+    string key;
+    af_dtype type;
+    dim4 dims;
+    /// The position of the first element of the array in the file
+    intl offset;
+};
+
+struct StreamContents {
+    char version;
+    /// The end of the data of the last array
+    intl end;
+    /// The end of the file contents. This is the end of the table of contents
+    /// of version 2 files.
+    intl tail;
+    vector<StreamEntry> entries;
+};
+
+template<typename S>
+void readValue(std::istream &fs, S &value) {
+    fs.read(reinterpret_cast<char *>(&value), sizeof(S));
+}
 
-    const ArrayInfo &info = getInfo(arr);
-    std::vector<T> data(info.elements());
+template<typename S>
+void writeValue(std::ostream &fs, const S &value) {
+    fs.write(reinterpret_cast<const char *>(&value), sizeof(S));
+}
+
+void openStream(std::fstream &fs, const char *filename,
+                std::ios_base::openmode mode) {
+    fs.open(filename, mode | std::fstream::binary);
+
+    // Throw exception if file is not open
+    if (!fs.is_open()) {
+        std::string errStr = "Failed to open: " + std::string(filename);
+        AF_ERROR(errStr.c_str(), AF_ERR_ARG);
+    }
+}
 
-    AF_CHECK(af_get_data_ptr(&data.front(), arr));
+void readKey(std::istream &fs, StreamEntry &entry) {
+    int klen = -1;
+    readValue(fs, klen);
+    if (!fs || klen < 0) { AF_ERROR("Invalid file contents", AF_ERR_ARG); }
+    entry.key.resize(klen);
+    fs.read(&entry.key[0], klen);
+}
 
-    char type = info.getType();
+void readTypeAndDims(std::istream &fs, StreamEntry &entry) {
+    char type = -1;
+    intl dims[4];
+    readValue(fs, type);
+    readValue(fs, dims);
 
-    intl odims[4];
-    for (int i = 0; i < 4; i++) { odims[i] = info.dims()[i]; }
+    entry.type = static_cast<af_dtype>(type);
+    for (int i = 0; i < 4; i++) { entry.dims[i] = dims[i]; }
+}
 
-    intl offset = sizeof(char) + 4 * sizeof(intl) + info.elements() * sizeof(T);
-    ///////////////////////////////////////////////////////////////////////////
+void writeKey(std::ostream &fs, const StreamEntry &entry) {
+    const int klen = static_cast<int>(entry.key.size());
+    writeValue(fs, klen);
+    fs.write(entry.key.c_str(), klen);
+}
 
-    std::fstream fs;
+void writeTypeAndDims(std::ostream &fs, const StreamEntry &entry) {
+    const char type = static_cast<char>(entry.type);
+    intl dims[4];
+    for (int i = 0; i < 4; i++) { dims[i] = entry.dims[i]; }
+
+    writeValue(fs, type);
+    writeValue(fs, dims);
+}
+
+/// Reads the version and the table of contents of \p fs. The arrays of
+/// version 1 files are listed by walking through the file.
+StreamContents readContents(std::istream &fs, const char *filename) {
+    if (fs.peek() == std::istream::traits_type::eof()) {
+        std::string errStr = std::string(filename) + " is empty";
+        AF_ERROR(errStr.c_str(), AF_ERR_ARG);
+    }
+
+    StreamContents contents{0, 0, 0, {}};
     int n_arrays = 0;
+    readValue(fs, contents.version);
+    readValue(fs, n_arrays);
+
+    switch (contents.version) {  // NOLINT(hicpp-multiway-paths-covered)
+        case 1: {
+            contents.entries.resize(n_arrays);
+            for (StreamEntry &entry : contents.entries) {
+                readKey(fs, entry);
+                intl offset = -1;
+                readValue(fs, offset);
+                const intl start = fs.tellg();
+                readTypeAndDims(fs, entry);
+                entry.offset = fs.tellg();
+
+                // Skip data
+                contents.end = start + offset;
+                fs.seekg(contents.end);
+            }
+        } break;
+        case 2: {
+            readValue(fs, contents.end);
+            fs.seekg(contents.end);
+            contents.entries.resize(n_arrays);
+            for (StreamEntry &entry : contents.entries) {
+                readKey(fs, entry);
+                readTypeAndDims(fs, entry);
+                readValue(fs, entry.offset);
+            }
+        } break;
+        default: AF_ERROR("Invalid version", AF_ERR_ARG);
+    }
+
+    if (!fs) { AF_ERROR("Invalid file contents", AF_ERR_ARG); }
+    contents.tail = contents.version == 1 ? contents.end : intl(fs.tellg());
+    return contents;
+}
+
+/// Writes the elements of \p in to \p fs. The array is copied to the host in
+/// chunks of its last dimension, and every chunk is written to the file on
+/// another thread while the next one is copied.
+template<typename T>
+void writeData(std::ostream &fs, const Array<T> &in) {
+    if (in.elements() == 0) { return; }
+
+    const dim4 dims      = in.dims();
+    const int last       = dims.ndims() - 1;
+    const dim_t nslices  = dims[last];
+    const dim_t sliceLen = dims.elements() / nslices;
+    const dim_t perChunk = std::min(
+        nslices,
+        std::max<dim_t>(1, kStreamChunkBytes / (sliceLen * sizeof(T))));
+
+    unique_ptr<T[]> buffers[2];
+    std::future<void> pending;
+    for (dim_t first = 0, c = 0; first < nslices; first += perChunk, c++) {
+        const dim_t n = std::min(perChunk, nslices - first);
+        unique_ptr<T[]> &buffer = buffers[c % 2];
+        if (!buffer) { buffer.reset(new T[perChunk * sliceLen]); }
+
+        if (n == nslices) {
+            copyData(buffer.get(), in);
+        } else {
+            vector<af_seq> index(4, af_span);
+            index[last] = {static_cast<double>(first),
+                           static_cast<double>(first + n - 1), 1};
+            copyData(buffer.get(), createSubArray(in, index, false));
+        }
 
-    if (append) {
-        std::ifstream checkIfExists(filename);
-        bool exists = checkIfExists.good();
-        checkIfExists.close();
-        if (exists) {
-            fs.open(filename, std::fstream::in | std::fstream::out |
-                                  std::fstream::binary);
+        if (pending.valid()) { pending.get(); }
+        const char *bytes = reinterpret_cast<const char *>(buffer.get());
+        const std::streamsize size = n * sliceLen * sizeof(T);
+        if (first + n < nslices) {
+            pending = std::async(std::launch::async,
+                                 [&fs, bytes, size] { fs.write(bytes, size); });
         } else {
-            fs.open(filename, std::fstream::out | std::fstream::binary);
+            fs.write(bytes, size);
         }
+    }
+}
 
-        // Throw exception if file is not open
-        if (!fs.is_open()) { AF_ERROR("File failed to open", AF_ERR_ARG); }
+template<typename T>
+int save(const char *key, const af_array arr, const char *filename,
+         const bool append) {
+    const ArrayInfo &info = getInfo(arr);
+    StreamEntry entry{key, info.getType(), info.dims(), -1};
 
-        // Assert Version
+    const intl header = sizeof(char) + sizeof(int) + sizeof(intl);
+    StreamContents contents{sfv_char, header, header, {}};
+    std::fstream fs;
+    if (append && std::ifstream(filename).good()) {
+        openStream(fs, filename, std::fstream::in | std::fstream::out);
         if (fs.peek() == std::fstream::traits_type::eof()) {
             // File is empty
             fs.clear();
         } else {
-            char prev_version = 0;
-            fs.read(&prev_version, sizeof(char));
-
-            AF_ASSERT(
-                prev_version == sfv_char,
-                "ArrayFire data format has changed. Can't append to file");
-
-            fs.read(reinterpret_cast<char *>(&n_arrays), sizeof(int));
+            contents = readContents(fs, filename);
         }
     } else {
-        fs.open(filename,
-                std::fstream::out | std::fstream::binary | std::fstream::trunc);
-
-        // Throw exception if file is not open
-        if (!fs.is_open()) { AF_ERROR("File failed to open", AF_ERR_ARG); }
+        openStream(fs, filename, std::fstream::out | std::fstream::trunc);
     }
 
-    n_arrays++;
+    if (contents.version == 1) {
+        // Write array to end of file
+        const intl offset =
+            sizeof(char) + 4 * sizeof(intl) + info.elements() * sizeof(T);
+        fs.seekp(contents.end);
+        writeKey(fs, entry);
+        writeValue(fs, offset);
+        writeTypeAndDims(fs, entry);
+        writeData(fs, getArray<T>(arr));
+    } else {
+        // The data and the new table of contents are written after the old
+        // table of contents, which stays valid until the header is updated
+        entry.offset =
+            divup(contents.tail, kStreamAlignment) * kStreamAlignment;
+        fs.seekp(contents.tail);
+        const vector<char> padding(entry.offset - contents.tail, 0);
+        fs.write(padding.data(), padding.size());
+        writeData(fs, getArray<T>(arr));
+        contents.end = entry.offset + info.elements() * sizeof(T);
+    }
+    contents.entries.push_back(entry);
+
+    if (contents.version != 1) {
+        fs.seekp(contents.end);
+        for (const StreamEntry &e : contents.entries) {
+            writeKey(fs, e);
+            writeTypeAndDims(fs, e);
+            writeValue(fs, e.offset);
+        }
+    }
 
-    // Write version and n_arrays to top of file
+    // Write version, n_arrays and the table of contents offset to top of
+    // file once everything they refer to is written
+    fs.flush();
+    const int n_arrays = static_cast<int>(contents.entries.size());
     fs.seekp(0);
-    fs.write(&sfv_char, 1);
-    fs.write(reinterpret_cast<char *>(&n_arrays), sizeof(int));
-
-    // Write array to end of file. Irrespective of new or append
-    fs.seekp(0, std::ios_base::end);
-    fs.write(reinterpret_cast<char *>(&klen), sizeof(int));
-    fs.write(k.c_str(), klen);
-    fs.write(reinterpret_cast<char *>(&offset), sizeof(intl));
-    fs.write(&type, sizeof(char));
-    fs.write(reinterpret_cast<char *>(&odims), sizeof(intl) * 4);
-    fs.write(reinterpret_cast<char *>(&data.front()), sizeof(T) * data.size());
+    writeValue(fs, contents.version);
+    writeValue(fs, n_arrays);
+    if (contents.version != 1) { writeValue(fs, contents.end); }
+
+    if (!fs) {
+        std::string errStr = "Failed to write: " + std::string(filename);
+        AF_ERROR(errStr.c_str(), AF_ERR_RUNTIME);
+    }
     fs.close();
 
     return n_arrays - 1;
 }
 
+/// Reads the elements [\p first, \p last] along \p dim of \p entry. The
+/// elements are read as contiguous runs straight into a single host buffer.
+template<typename T>
+af_array readDataToArray(std::istream &fs, const StreamEntry &entry,
+                         const unsigned dim, const dim_t first,
+                         const dim_t last) {
+    const dim4 &dims = entry.dims;
+    dim4 odims       = dims;
+    odims[dim]       = last - first + 1;
+
+    dim_t run = 1;
+    for (unsigned i = 0; i < dim; i++) { run *= dims[i]; }
+    dim_t nruns = 1;
+    for (unsigned i = dim + 1; i < 4; i++) { nruns *= dims[i]; }
+    const dim_t stride = run * dims[dim];
+    const dim_t start  = run * first;
+    run *= odims[dim];
+    if (odims[dim] == dims[dim]) {
+        run *= nruns;
+        nruns = 1;
+    }
+
+    unique_ptr<T[]> data(new T[odims.elements()]);
+    for (dim_t r = 0; r < nruns; r++) {
+        fs.seekg(entry.offset + (r * stride + start) * sizeof(T));
+        fs.read(reinterpret_cast<char *>(data.get() + r * run),
+                run * sizeof(T));
+    }
+    if (!fs) { AF_ERROR("Invalid file contents", AF_ERR_ARG); }
+
+    return getHandle(createHostDataArray<T>(odims, data.get()));
+}
+
+af_array readEntry(std::istream &fs, const StreamEntry &entry,
+                   const unsigned dim, const dim_t first, const dim_t last) {
+    switch (entry.type) {
+        case f32: return readDataToArray<float>(fs, entry, dim, first, last);
+        case c32: return readDataToArray<cfloat>(fs, entry, dim, first, last);
+        case f64: return readDataToArray<double>(fs, entry, dim, first, last);
+        case c64: return readDataToArray<cdouble>(fs, entry, dim, first, last);
+        case b8: return readDataToArray<char>(fs, entry, dim, first, last);
+        case s32: return readDataToArray<int>(fs, entry, dim, first, last);
+        case u32: return readDataToArray<uint>(fs, entry, dim, first, last);
+        case u8: return readDataToArray<uchar>(fs, entry, dim, first, last);
+        case s64: return readDataToArray<intl>(fs, entry, dim, first, last);
+        case u64: return readDataToArray<uintl>(fs, entry, dim, first, last);
+        case s16: return readDataToArray<short>(fs, entry, dim, first, last);
+        case u16: return readDataToArray<ushort>(fs, entry, dim, first, last);
+        default: TYPE_ERROR(1, entry.type);
+    }
+}
+
+af_array readEntry(std::istream &fs, const StreamEntry &entry) {
+    return readEntry(fs, entry, 3, 0, entry.dims[3] - 1);
+}
+
+int findKey(const StreamContents &contents, const char *key) {
+    for (size_t i = 0; i < contents.entries.size(); i++) {
+        if (contents.entries[i].key == key) { return static_cast<int>(i); }
+    }
+    return -1;
+}
+
+}  // namespace
+
 af_err af_save_array(int *index, const char *key, const af_array arr,
                      const char *filename, const bool append) {
     try {
@@ -154,176 +408,10 @@ af_err af_save_array(int *index, const char *key, const af_array arr,
     return AF_SUCCESS;
 }
 
-template<typename T>
-static af_array readDataToArray(std::fstream &fs) {
-    intl dims[4];
-    fs.read(reinterpret_cast<char *>(&dims), 4 * sizeof(intl));
-
-    dim4 d;
-    for (int i = 0; i < 4; i++) { d[i] = dims[i]; }
-
-    intl size = d.elements();
-
-    std::vector<T> data(size);
-    fs.read(reinterpret_cast<char *>(&data.front()), size * sizeof(T));
-
-    return getHandle(createHostDataArray<T>(d, &data.front()));
-}
-
-static af_array readArrayV1(const char *filename, const unsigned index) {
-    char version = 0;
-    int n_arrays = 0;
-
-    std::fstream fs(filename, std::fstream::in | std::fstream::binary);
-
-    // Throw exception if file is not open
-    if (!fs.is_open()) { AF_ERROR("File failed to open", AF_ERR_ARG); }
-
-    if (fs.peek() == std::fstream::traits_type::eof()) {
-        AF_ERROR("File is empty", AF_ERR_ARG);
-    }
-
-    fs.read(&version, sizeof(char));
-    fs.read(reinterpret_cast<char *>(&n_arrays), sizeof(int));
-
-    AF_ASSERT((int)index < n_arrays, "Index out of bounds");
-
-    for (unsigned i = 0; i < index; i++) {
-        // (int    )   Length of the key
-        // (cstring)   Key
-        // (intl   )   Offset bytes to next array (type + dims + data)
-        // (char   )   Type
-        // (intl   )   dim4 (x 4)
-        // (T      )   data (x elements)
-        int klen = -1;
-        fs.read(reinterpret_cast<char *>(&klen), sizeof(int));
-
-        // char* key = new char[klen];
-        // fs.read((char*)&key, klen * sizeof(char));
-
-        // Skip the array name tag
-        fs.seekg(klen, std::ios_base::cur);
-
-        // Read data offset
-        intl offset = -1;
-        fs.read(reinterpret_cast<char *>(&offset), sizeof(intl));
-
-        // Skip data
-        fs.seekg(offset, std::ios_base::cur);
-    }
-
-    int klen = -1;
-    fs.read(reinterpret_cast<char *>(&klen), sizeof(int));
-
-    // char* key = new char[klen];
-    // fs.read((char*)&key, klen * sizeof(char));
-
-    // Skip the array name tag
-    fs.seekg(klen, std::ios_base::cur);
-
-    // Read data offset
-    intl offset = -1;
-    fs.read(reinterpret_cast<char *>(&offset), sizeof(intl));
-
-    // Read type and dims
-    char type_ = -1;
-    fs.read(&type_, sizeof(char));
-
-    auto type = static_cast<af_dtype>(type_);
-
-    af_array out;
-    switch (type) {
-        case f32: out = readDataToArray<float>(fs); break;
-        case c32: out = readDataToArray<cfloat>(fs); break;
-        case f64: out = readDataToArray<double>(fs); break;
-        case c64: out = readDataToArray<cdouble>(fs); break;
-        case b8: out = readDataToArray<char>(fs); break;
-        case s32: out = readDataToArray<int>(fs); break;
-        case u32: out = readDataToArray<uint>(fs); break;
-        case u8: out = readDataToArray<uchar>(fs); break;
-        case s64: out = readDataToArray<intl>(fs); break;
-        case u64: out = readDataToArray<uintl>(fs); break;
-        case s16: out = readDataToArray<short>(fs); break;
-        case u16: out = readDataToArray<ushort>(fs); break;
-        default: TYPE_ERROR(1, type);
-    }
-    fs.close();
-
-    return out;
-}
-
-static af_array checkVersionAndRead(const char *filename,
-                                    const unsigned index) {
-    char version = 0;
-
-    std::string filenameStr = std::string(filename);
-    std::fstream fs(filenameStr, std::fstream::in | std::fstream::binary);
-    // Throw exception if file is not open
-    if (!fs.is_open()) {
-        std::string errStr = "Failed to open: " + filenameStr;
-        AF_ERROR(errStr.c_str(), AF_ERR_ARG);
-    }
-
-    if (fs.peek() == std::fstream::traits_type::eof()) {
-        std::string errStr = filenameStr + " is empty";
-        AF_ERROR(errStr.c_str(), AF_ERR_ARG);
-    } else {
-        fs.read(&version, sizeof(char));
-    }
-    fs.close();
-
-    switch (version) {  // NOLINT(hicpp-multiway-paths-covered)
-        case 1: return readArrayV1(filename, index);
-        default: AF_ERROR("Invalid version", AF_ERR_ARG);
-    }
-}
-
 int checkVersionAndFindIndex(const char *filename, const char *k) {
-    char version = 0;
-    std::string key(k);
-    std::string filenameStr(filename);
-    std::ifstream fs(filenameStr, std::ifstream::in | std::ifstream::binary);
-
-    // Throw exception if file is not open
-    if (!fs.is_open()) {
-        std::string errStr = "Failed to open: " + filenameStr;
-        AF_ERROR(errStr.c_str(), AF_ERR_ARG);
-    }
-
-    if (fs.peek() == std::ifstream::traits_type::eof()) {
-        std::string errStr = filenameStr + " is empty";
-        AF_ERROR(errStr.c_str(), AF_ERR_ARG);
-    } else {
-        fs.read(&version, sizeof(char));
-    }
-
-    int index = -1;
-    if (version == 1) {
-        int n_arrays = -1;
-        fs.read(reinterpret_cast<char *>(&n_arrays), sizeof(int));
-        for (int i = 0; i < n_arrays; i++) {
-            int klen = -1;
-            fs.read(reinterpret_cast<char *>(&klen), sizeof(int));
-            string readKey;
-            readKey.resize(klen);
-            fs.read(&readKey.front(), klen);
-
-            if (key == readKey) {
-                // Ket matches, break
-                index = i;
-                break;
-            }
-            // Key doesn't match. Skip the data
-            intl offset = -1;
-            fs.read(reinterpret_cast<char *>(&offset), sizeof(intl));
-            fs.seekg(offset, std::ios_base::cur);
-        }
-    } else {
-        AF_ERROR("Invalid version", AF_ERR_ARG);
-    }
-    fs.close();
-
-    return index;
+    std::fstream fs;
+    openStream(fs, filename, std::fstream::in);
+    return findKey(readContents(fs, filename), k);
 }
 
 af_err af_read_array_index(af_array *out, const char *filename,
@@ -333,7 +421,12 @@ af_err af_read_array_index(af_array *out, const char *filename,
 
         ARG_ASSERT(1, filename != NULL);
 
-        af_array output = checkVersionAndRead(filename, index);
+        std::fstream fs;
+        openStream(fs, filename, std::fstream::in);
+        const StreamContents contents = readContents(fs, filename);
+        AF_ASSERT(index < contents.entries.size(), "Index out of bounds");
+
+        af_array output = readEntry(fs, contents.entries[index]);
         std::swap(*out, output);
     }
     CATCHALL;
@@ -346,12 +439,14 @@ af_err af_read_array_key(af_array *out, const char *filename, const char *key) {
         ARG_ASSERT(1, filename != NULL);
         ARG_ASSERT(2, key != NULL);
 
-        // Find index of key. Then call read by index
-        int index = checkVersionAndFindIndex(filename, key);
+        std::fstream fs;
+        openStream(fs, filename, std::fstream::in);
+        const StreamContents contents = readContents(fs, filename);
+        const int index               = findKey(contents, key);
 
         if (index == -1) { AF_ERROR("Key not found", AF_ERR_INVALID_ARRAY); }
 
-        af_array output = checkVersionAndRead(filename, index);
+        af_array output = readEntry(fs, contents.entries[index]);
         std::swap(*out, output);
     }
     CATCHALL;
@@ -373,3 +468,27 @@ af_err af_read_array_key_check(int *index, const char *filename,
     CATCHALL;
     return AF_SUCCESS;
 }
+
+af_err af_read_array_range(af_array *out, const char *filename,
+                           const unsigned index, const unsigned dim,
+                           const dim_t first, const dim_t last) {
+    try {
+        AF_CHECK(af_init());
+        ARG_ASSERT(1, filename != NULL);
+        ARG_ASSERT(3, dim < 4);
+
+        std::fstream fs;
+        openStream(fs, filename, std::fstream::in);
+        const StreamContents contents = readContents(fs, filename);
+        AF_ASSERT(index < contents.entries.size(), "Index out of bounds");
+
+        const StreamEntry &entry = contents.entries[index];
+        ARG_ASSERT(4, first >= 0 && first <= last);
+        ARG_ASSERT(5, last < entry.dims[dim]);
+
+        af_array output = readEntry(fs, entry, dim, first, last);
+        std::swap(*out, output);
+    }
+    CATCHALL;
+    return AF_SUCCESS;
+}
@@ -11,6 +11,8 @@
 #include <common/err_common.hpp>
 #include <common/half.hpp>
 #include <handle.hpp>
+#include <sparse.hpp>
+#include <sparse_handle.hpp>
 #include <transpose.hpp>
 #include <af/arith.h>
 #include <af/blas.h>
@@ -34,12 +36,42 @@ static inline af_array trs(const af_array in, const bool conjugate) {
     return getHandle<T>(detail::transpose<T>(getArray<T>(in), conjugate));
 }
 
+#if defined(AF_CPU)
+template<typename T>
+static inline af_array sparseTrs(const af_array in, const bool conjugate) {
+    return getHandle(
+        detail::sparseTranspose<T>(getSparseArray<T>(in), conjugate));
+}
+#endif
+
 af_err af_transpose(af_array* out, af_array in, const bool conjugate) {
     try {
+#if defined(AF_CPU)
+        const ArrayInfo& info = getInfo(in, false);
+#else
         const ArrayInfo& info = getInfo(in);
+#endif
         af_dtype type         = info.getType();
         af::dim4 dims         = info.dims();
 
+#if defined(AF_CPU)
+        // CSR matrices are transposed into CSR storage
+        if (info.isSparse()) {
+            ARG_ASSERT(1,
+                       getSparseArrayBase(in).getStorage() == AF_STORAGE_CSR);
+            af_array output;
+            switch (type) {
+                case f32: output = sparseTrs<float>(in, conjugate); break;
+                case c32: output = sparseTrs<cfloat>(in, conjugate); break;
+                case f64: output = sparseTrs<double>(in, conjugate); break;
+                case c64: output = sparseTrs<cdouble>(in, conjugate); break;
+                default: TYPE_ERROR(1, type);
+            }
+            std::swap(*out, output);
+            return AF_SUCCESS;
+        }
+#endif
+
         if (dims.elements() == 0) { return af_retain_array(out, in); }
 
         if (dims[0] == 1 || dims[1] == 1) {
@@ -0,0 +1,77 @@
+/*******************************************************
+ * Copyright (c) 2026, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <af/array.h>
+#include <af/vision.h>
+#include "error.hpp"
+
+#include <utility>
+
+namespace af {
+
+annIndex::annIndex(const array& train, const dim_t dist_dim,
+                   const unsigned n_lists, const af_match_type dist_type)
+    : index(nullptr) {
+    AF_THROW(
+        af_create_ann_index(&index, train.get(), dist_dim, n_lists, dist_type));
+}
+
+annIndex::annIndex(af_ann_index handle) : index(handle) {}
+
+annIndex::annIndex(const annIndex& other) : index(nullptr) {
+    AF_THROW(af_retain_ann_index(&index, other.get()));
+}
+
+annIndex& annIndex::operator=(const annIndex& other) {
+    if (this != &other) {
+        af_ann_index tmp = nullptr;
+        AF_THROW(af_retain_ann_index(&tmp, other.get()));
+        if (index) { AF_THROW(af_release_ann_index(index)); }
+        index = tmp;
+    }
+    return *this;
+}
+
+annIndex::annIndex(annIndex&& other)
+    : index(std::exchange(other.index, nullptr)) {}
+
+annIndex& annIndex::operator=(annIndex&& other) {
+    std::swap(index, other.index);
+    return *this;
+}
+
+annIndex::~annIndex() {
+    // THOU SHALL NOT THROW IN DESTRUCTORS
+    if (index) { af_release_ann_index(index); }
+}
+
+af_ann_index annIndex::get() const { return index; }
+
+void annSearch(array& idx, array& dist, const array& query,
+               const annIndex& index, const unsigned n_dist,
+               const unsigned n_probe) {
+    af_array temp_idx  = 0;
+    af_array temp_dist = 0;
+    AF_THROW(af_ann_search(&temp_idx, &temp_dist, query.get(), index.get(),
+                           n_dist, n_probe));
+    idx  = array(temp_idx);
+    dist = array(temp_dist);
+}
+
+void saveAnnIndex(const char* filename, const annIndex& index) {
+    AF_THROW(af_save_ann_index(filename, index.get()));
+}
+
+annIndex readAnnIndex(const char* filename) {
+    af_ann_index handle = nullptr;
+    AF_THROW(af_read_ann_index(&handle, filename));
+    return annIndex(handle);
+}
+
+}  // namespace af
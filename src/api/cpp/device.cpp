@@ -171,6 +171,16 @@ size_t getMemStepSize() {
     return size_bytes;
 }
 
+void setCpuNumThreads(const int nthreads) {
+    AF_THROW(af_set_cpu_num_threads(nthreads));
+}
+
+int getCpuNumThreads() {
+    int nthreads = 0;
+    AF_THROW(af_get_cpu_num_threads(&nthreads));
+    return nthreads;
+}
+
 AF_DEPRECATED_WARNINGS_OFF
 #define INSTANTIATE(T)                                                        \
     template<>                                                                \
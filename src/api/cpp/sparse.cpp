@@ -101,4 +101,16 @@ af::storage sparseGetStorage(const array in) {
     AF_THROW(af_sparse_get_storage(&out, in.get()));
     return out;
 }
+
+array sparseSolve(const array &a, const array &b, const sparseSolver solver,
+                  const preconditioner precond, const double tol,
+                  const int maxIter, const int restart,
+                  af_sparse_solve_callback callback, void *userData,
+                  int *iterations) {
+    af_array out = 0;
+    AF_THROW(af_sparse_solve(&out, iterations, a.get(), b.get(), solver,
+                             precond, tol, maxIter, restart, callback,
+                             userData));
+    return array(out);
+}
 }  // namespace af
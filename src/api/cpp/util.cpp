@@ -42,6 +42,13 @@ array readArray(const char *filename, const char *key) {
     return array(out);
 }
 
+array readArray(const char *filename, const unsigned index,
+                const unsigned dim, const dim_t first, const dim_t last) {
+    af_array out = 0;
+    AF_THROW(af_read_array_range(&out, filename, index, dim, first, last));
+    return array(out);
+}
+
 int readArrayCheck(const char *filename, const char *key) {
     int out = -1;
     AF_THROW(af_read_array_key_check(&out, filename, key));
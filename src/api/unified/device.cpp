@@ -187,3 +187,11 @@ af_err af_set_kernel_cache_directory(const char *path, int override_eval) {
 af_err af_get_kernel_cache_directory(size_t *length, char *path) {
     CALL(af_get_kernel_cache_directory, length, path);
 }
+
+af_err af_set_cpu_num_threads(const int nthreads) {
+    CALL(af_set_cpu_num_threads, nthreads);
+}
+
+af_err af_get_cpu_num_threads(int *nthreads) {
+    CALL(af_get_cpu_num_threads, nthreads);
+}
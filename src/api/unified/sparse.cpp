@@ -74,3 +74,13 @@ af_err af_sparse_get_storage(af_storage *out, const af_array in) {
     CHECK_ARRAYS(in);
     CALL(af_sparse_get_storage, out, in);
 }
+
+af_err af_sparse_solve(af_array *out, int *iterations, const af_array a,
+                       const af_array b, const af_sparse_solver solver,
+                       const af_preconditioner precond, const double tol,
+                       const int max_iter, const int restart,
+                       af_sparse_solve_callback callback, void *user_data) {
+    CHECK_ARRAYS(a, b);
+    CALL(af_sparse_solve, out, iterations, a, b, solver, precond, tol,
+         max_iter, restart, callback, user_data);
+}
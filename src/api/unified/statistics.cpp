@@ -140,3 +140,15 @@ af_err af_stdev_all_v2(double *real, double *imag, const af_array in,
     CHECK_ARRAYS(in);
     CALL(af_stdev_all_v2, real, imag, in, bias);
 }
+
+af_err af_quantile(af_array *out, const af_array in, const af_array probs,
+                   const dim_t dim) {
+    CHECK_ARRAYS(in, probs);
+    CALL(af_quantile, out, in, probs, dim);
+}
+
+af_err af_percentile(af_array *out, const af_array in, const af_array percents,
+                     const dim_t dim) {
+    CHECK_ARRAYS(in, percents);
+    CALL(af_percentile, out, in, percents, dim);
+}
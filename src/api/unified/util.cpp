@@ -42,6 +42,12 @@ af_err af_read_array_key_check(int *index, const char *filename,
     CALL(af_read_array_key_check, index, filename, key);
 }
 
+af_err af_read_array_range(af_array *out, const char *filename,
+                           const unsigned index, const unsigned dim,
+                           const dim_t first, const dim_t last) {
+    CALL(af_read_array_range, out, filename, index, dim, first, last);
+}
+
 af_err af_array_to_string(char **output, const char *exp, const af_array arr,
                           const int precision, const bool transpose) {
     CHECK_ARRAYS(arr);
@@ -72,6 +72,36 @@ af_err af_nearest_neighbour(af_array *idx, af_array *dist, const af_array query,
          dist_type);
 }
 
+af_err af_create_ann_index(af_ann_index *index, const af_array train,
+                           const dim_t dist_dim, const unsigned n_lists,
+                           const af_match_type dist_type) {
+    CHECK_ARRAYS(train);
+    CALL(af_create_ann_index, index, train, dist_dim, n_lists, dist_type);
+}
+
+af_err af_retain_ann_index(af_ann_index *out, const af_ann_index index) {
+    CALL(af_retain_ann_index, out, index);
+}
+
+af_err af_release_ann_index(af_ann_index index) {
+    CALL(af_release_ann_index, index);
+}
+
+af_err af_ann_search(af_array *idx, af_array *dist, const af_array query,
+                     const af_ann_index index, const unsigned n_dist,
+                     const unsigned n_probe) {
+    CHECK_ARRAYS(query);
+    CALL(af_ann_search, idx, dist, query, index, n_dist, n_probe);
+}
+
+af_err af_save_ann_index(const char *filename, const af_ann_index index) {
+    CALL(af_save_ann_index, filename, index);
+}
+
+af_err af_read_ann_index(af_ann_index *index, const char *filename) {
+    CALL(af_read_ann_index, index, filename);
+}
+
 af_err af_match_template(af_array *out, const af_array search_img,
                          const af_array template_img,
                          const af_match_type m_type) {
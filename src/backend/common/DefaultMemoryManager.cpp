@@ -33,9 +33,27 @@ DefaultMemoryManager::getCurrentMemoryInfo() {
     return memory[this->getActiveDeviceId()];
 }
 
+void DefaultMemoryManager::createPools() {
+    if (!this->size_classes || this->debug_mode) { return; }
+    for (auto &info : memory) {
+        if (!info.pool) {
+            info.pool = std::make_unique<SizeClassPool>(this->split_buffers);
+        }
+    }
+}
+
 void DefaultMemoryManager::cleanDeviceMemoryManager(int device) {
     if (this->debug_mode) { return; }
 
+    if (memory[device].pool) {
+        vector<void *> segments;
+        const size_t bytes_freed = memory[device].pool->collect(segments);
+        AF_TRACE("GC: Clearing {} segments {}", segments.size(),
+                 bytesToString(bytes_freed));
+        for (auto *ptr : segments) { this->nativeFree(ptr); }
+        return;
+    }
+
     // This vector is used to store the pointers which will be deleted by
     // the memory manager. We are using this to avoid calling free while
     // the lock is being held because the CPU backend calls sync.
@@ -69,10 +87,13 @@ void DefaultMemoryManager::cleanDeviceMemoryManager(int device) {
 }
 
 DefaultMemoryManager::DefaultMemoryManager(int num_devices,
-                                           unsigned max_buffers, bool debug)
+                                           unsigned max_buffers, bool debug,
+                                           bool split_buffers)
     : mem_step_size(1024)
     , max_buffers(max_buffers)
     , debug_mode(debug)
+    , size_classes(false)
+    , split_buffers(split_buffers)
     , memory(num_devices) {
     // Check for environment variables
 
@@ -84,6 +105,11 @@ DefaultMemoryManager::DefaultMemoryManager(int num_devices,
     // Max Buffer count
     env_var = getEnvVar("AF_MAX_BUFFERS");
     if (!env_var.empty()) { this->max_buffers = max(1, stoi(env_var)); }
+
+    // Size classes
+    env_var = getEnvVar("AF_MEM_SIZE_CLASSES");
+    if (!env_var.empty()) { this->size_classes = env_var[0] != '0'; }
+    createPools();
 }
 
 void DefaultMemoryManager::initialize() { this->setMaxMemorySize(); }
@@ -99,6 +125,7 @@ void DefaultMemoryManager::addMemoryManagement(int device) {
     // current_size + device + 1 +1 is to account for device being 0-based
     // index of devices
     memory.resize(memory.size() + device + 1);
+    createPools();
 }
 
 void DefaultMemoryManager::removeMemoryManagement(int device) {
@@ -125,8 +152,15 @@ void DefaultMemoryManager::setMaxMemorySize() {
 }
 
 float DefaultMemoryManager::getMemoryPressure() {
-    lock_guard_t lock(this->memory_mutex);
     memory_info &current = this->getCurrentMemoryInfo();
+    if (current.pool) {
+        return current.pool->lockBytes() > current.max_bytes ||
+                       current.pool->lockBuffers() > max_buffers
+                   ? 1.0
+                   : 0.0;
+    }
+
+    lock_guard_t lock(this->memory_mutex);
     if (current.lock_bytes > current.max_bytes ||
         current.lock_buffers > max_buffers) {
         return 1.0;
@@ -136,8 +170,10 @@ float DefaultMemoryManager::getMemoryPressure() {
 }
 
 bool DefaultMemoryManager::jitTreeExceedsMemoryPressure(size_t bytes) {
-    lock_guard_t lock(this->memory_mutex);
     memory_info &current = this->getCurrentMemoryInfo();
+    if (current.pool) { return 2 * bytes > current.pool->lockBytes(); }
+
+    lock_guard_t lock(this->memory_mutex);
     return 2 * bytes > current.lock_bytes;
 }
 
@@ -146,14 +182,32 @@ void *DefaultMemoryManager::alloc(bool user_lock, const unsigned ndims,
     size_t bytes = element_size;
     for (unsigned i = 0; i < ndims; ++i) { bytes *= dims[i]; }
 
+    memory_info &current = this->getCurrentMemoryInfo();
+    if (current.pool) {
+        if (bytes == 0) { return nullptr; }
+        if (current.pool->lockBytes() >= current.max_bytes ||
+            current.pool->totalBuffers() >= this->max_buffers) {
+            this->signalMemoryCleanup();
+        }
+        return current.pool->alloc(user_lock, bytes, [this](size_t n) {
+            // If out of memory, run garbage collect and try again
+            try {
+                return this->nativeAlloc(n);
+            } catch (const AfError &ex) {
+                if (ex.getError() != AF_ERR_NO_MEM) { throw; }
+                this->signalMemoryCleanup();
+                return this->nativeAlloc(n);
+            }
+        });
+    }
+
     void *ptr          = nullptr;
     size_t alloc_bytes = this->debug_mode
                              ? bytes
                              : (divup(bytes, mem_step_size) * mem_step_size);
 
     if (bytes > 0) {
-        memory_info &current = this->getCurrentMemoryInfo();
-        locked_info info     = {!user_lock, user_lock, alloc_bytes};
+        locked_info info = {!user_lock, user_lock, alloc_bytes};
 
         // There is no memory cache in debug mode
         if (!this->debug_mode) {
@@ -206,7 +260,9 @@ void *DefaultMemoryManager::alloc(bool user_lock, const unsigned ndims,
 size_t DefaultMemoryManager::allocated(void *ptr) {
     if (!ptr) { return 0; }
     memory_info &current = this->getCurrentMemoryInfo();
-    auto locked_iter     = current.locked_map.find(ptr);
+    if (current.pool) { return current.pool->allocated(ptr); }
+
+    auto locked_iter = current.locked_map.find(ptr);
     if (locked_iter == current.locked_map.end()) { return 0; }
     return (locked_iter->second).bytes;
 }
@@ -217,9 +273,17 @@ void DefaultMemoryManager::unlock(void *ptr, bool user_unlock) {
 
     // Frees the pointer outside the lock.
     uptr_t freed_ptr(nullptr, [this](void *p) { this->nativeFree(p); });
+
+    memory_info &current = this->getCurrentMemoryInfo();
+    if (current.pool) {
+        // Pointer not found in the pool. Probably came from user, just free
+        // it
+        if (!current.pool->unlock(ptr, user_unlock)) { freed_ptr.reset(ptr); }
+        return;
+    }
+
     {
         lock_guard_t lock(this->memory_mutex);
-        memory_info &current = this->getCurrentMemoryInfo();
 
         auto locked_buffer_iter = current.locked_map.find(ptr);
         if (locked_buffer_iter == current.locked_map.end()) {
@@ -274,6 +338,11 @@ void DefaultMemoryManager::printInfo(const char *msg, const int device) {
         "|     POINTER      |    SIZE    |  AF LOCK  | USER LOCK |\n"
         "---------------------------------------------------------\n");
 
+    if (current.pool) {
+        current.pool->printInfo();
+        return;
+    }
+
     lock_guard_t lock(this->memory_mutex);
     for (const auto &kv : current.locked_map) {
         const char *status_mngr = "Yes";
@@ -318,6 +387,14 @@ void DefaultMemoryManager::printInfo(const char *msg, const int device) {
 void DefaultMemoryManager::usageInfo(size_t *alloc_bytes, size_t *alloc_buffers,
                                      size_t *lock_bytes, size_t *lock_buffers) {
     const memory_info &current = this->getCurrentMemoryInfo();
+    if (current.pool) {
+        if (alloc_bytes) { *alloc_bytes = current.pool->totalBytes(); }
+        if (alloc_buffers) { *alloc_buffers = current.pool->totalBuffers(); }
+        if (lock_bytes) { *lock_bytes = current.pool->lockBytes(); }
+        if (lock_buffers) { *lock_buffers = current.pool->lockBuffers(); }
+        return;
+    }
+
     lock_guard_t lock(this->memory_mutex);
     if (alloc_bytes) { *alloc_bytes = current.total_bytes; }
     if (alloc_buffers) { *alloc_buffers = current.total_buffers; }
@@ -327,6 +404,10 @@ void DefaultMemoryManager::usageInfo(size_t *alloc_bytes, size_t *alloc_buffers,
 
 void DefaultMemoryManager::userLock(const void *ptr) {
     memory_info &current = this->getCurrentMemoryInfo();
+    if (current.pool) {
+        current.pool->userLock(ptr);
+        return;
+    }
 
     lock_guard_t lock(this->memory_mutex);
 
@@ -346,6 +427,8 @@ void DefaultMemoryManager::userUnlock(const void *ptr) {
 
 bool DefaultMemoryManager::isUserLocked(const void *ptr) {
     memory_info &current = this->getCurrentMemoryInfo();
+    if (current.pool) { return current.pool->isUserLocked(ptr); }
+
     lock_guard_t lock(this->memory_mutex);
     auto locked_iter = current.locked_map.find(const_cast<void *>(ptr));
     if (locked_iter == current.locked_map.end()) { return false; }
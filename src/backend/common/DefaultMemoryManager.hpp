@@ -10,9 +10,11 @@
 #pragma once
 
 #include <common/MemoryManagerBase.hpp>
+#include <common/SizeClassPool.hpp>
 #include <common/defines.hpp>
 
 #include <functional>
+#include <memory>
 #include <unordered_map>
 #include <vector>
 
@@ -29,6 +31,12 @@ class DefaultMemoryManager final : public common::memory::MemoryManagerBase {
 
     bool debug_mode;
 
+    // Buffers are cached in size classes when AF_MEM_SIZE_CLASSES is set.
+    // split_buffers is true when the native buffers are plain pointers that
+    // can be split.
+    bool size_classes;
+    bool split_buffers;
+
     struct locked_info {
         bool manager_lock;
         bool user_lock;
@@ -42,6 +50,9 @@ class DefaultMemoryManager final : public common::memory::MemoryManagerBase {
         locked_t locked_map;
         free_t free_map;
 
+        // Replaces the maps and counters in the size class mode
+        std::unique_ptr<SizeClassPool> pool;
+
         size_t max_bytes;
         size_t total_bytes;
         size_t total_buffers;
@@ -65,8 +76,11 @@ class DefaultMemoryManager final : public common::memory::MemoryManagerBase {
 
     memory_info &getCurrentMemoryInfo();
 
+    void createPools();
+
    public:
-    DefaultMemoryManager(int num_devices, unsigned max_buffers, bool debug);
+    DefaultMemoryManager(int num_devices, unsigned max_buffers, bool debug,
+                         bool split_buffers = false);
 
     // Initializes the memory manager
     virtual void initialize() override;
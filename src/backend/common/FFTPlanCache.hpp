@@ -8,65 +8,134 @@
  ********************************************************/
 
 #pragma once
-#include <deque>
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <list>
 #include <memory>
-#include <string>
+#include <unordered_map>
 #include <utility>
 
 namespace common {
-// FFTPlanCache caches backend specific fft plans in FIFO order
+/// Describes the transform of an FFT plan. Fields that a backend doesn't use
+/// are left at zero.
+struct FFTPlanKey {
+    int rank    = 0;
+    int type    = 0;  ///< Backend specific transform type and precision
+    int flags   = 0;  ///< Backend specific planner options and data layouts
+    int threads = 0;  ///< Threads the plan runs on if the backend uses it
+    long long batch = 0;
+    long long n[3]  = {0, 0, 0};
+    /// Embedding or strides of the input and output dimensions
+    long long inembed[3] = {0, 0, 0};
+    long long onembed[3] = {0, 0, 0};
+    long long istride    = 0;
+    long long idist      = 0;
+    long long ostride    = 0;
+    long long odist      = 0;
+
+    bool operator==(const FFTPlanKey& other) const {
+        return rank == other.rank && type == other.type &&
+               flags == other.flags && threads == other.threads &&
+               batch == other.batch && std::equal(n, n + 3, other.n) &&
+               std::equal(inembed, inembed + 3, other.inembed) &&
+               std::equal(onembed, onembed + 3, other.onembed) &&
+               istride == other.istride && idist == other.idist &&
+               ostride == other.ostride && odist == other.odist;
+    }
+};
+
+struct FFTPlanKeyHash {
+    std::size_t operator()(const FFTPlanKey& key) const {
+        std::size_t seed = 0;
+        auto combine     = [&seed](long long v) {
+            seed ^= std::hash<long long>()(v) + 0x9e3779b9 + (seed << 6) +
+                    (seed >> 2);
+        };
+        combine(key.rank);
+        combine(key.type);
+        combine(key.flags);
+        combine(key.threads);
+        combine(key.batch);
+        for (int i = 0; i < 3; ++i) {
+            combine(key.n[i]);
+            combine(key.inembed[i]);
+            combine(key.onembed[i]);
+        }
+        combine(key.istride);
+        combine(key.idist);
+        combine(key.ostride);
+        combine(key.odist);
+        return seed;
+    }
+};
+
+// FFTPlanCache caches backend specific fft plans in least recently used
+// order
 //
-// new plan |--> IF number of plans cached is at limit, pop the oldest entry and
-// push new plan.
+// new plan |--> IF number of plans cached is at limit, drop the least
+// recently used entry and push new plan.
 //          |
 //          |--> ELSE just push the plan
-// existing plan -> reuse a plan
+// existing plan -> reuse a plan and mark it as the most recently used
 template<typename T, typename P>
 class FFTPlanCache {
     using plan_t       = typename std::shared_ptr<P>;
-    using plan_pair_t  = typename std::pair<std::string, plan_t>;
-    using plan_cache_t = typename std::deque<plan_pair_t>;
+    using plan_pair_t  = typename std::pair<FFTPlanKey, plan_t>;
+    using plan_cache_t = typename std::list<plan_pair_t>;
+    using plan_index_t =
+        std::unordered_map<FFTPlanKey, typename plan_cache_t::iterator,
+                           FFTPlanKeyHash>;
 
    public:
     FFTPlanCache() : mMaxCacheSize(5) {}
 
     void setMaxCacheSize(size_t size) {
         mMaxCacheSize = size;
-        while (mCache.size() > mMaxCacheSize) mCache.pop_back();
+        evict();
     }
 
     size_t getMaxCacheSize() const { return mMaxCacheSize; }
 
-    // iterates through plan cache from front to back
-    // of the cache(queue)
     // A valid shared_ptr of the plan in the cache is returned
-    // if found, and empty share_ptr otherwise.
-    plan_t find(const std::string& key) const {
-        std::shared_ptr<P> res;
-
-        for (unsigned i = 0; i < mCache.size(); ++i) {
-            if (key == mCache[i].first) {
-                res = mCache[i].second;
-                break;
-            }
-        }
+    // if found, and empty share_ptr otherwise. A plan that is found becomes
+    // the most recently used one.
+    plan_t find(const FFTPlanKey& key) {
+        auto it = mIndex.find(key);
+        if (it == mIndex.end()) { return plan_t(); }
 
-        return res;
+        mCache.splice(mCache.begin(), mCache, it->second);
+        return it->second->second;
     }
 
     // pushes plan to the front of cache(queue)
-    void push(const std::string key, plan_t plan) {
-        if (mCache.size() >= mMaxCacheSize) mCache.pop_back();
+    void push(const FFTPlanKey& key, plan_t plan) {
+        auto it = mIndex.find(key);
+        if (it != mIndex.end()) {
+            mCache.erase(it->second);
+            mIndex.erase(it);
+        }
+        if (mMaxCacheSize == 0) { return; }
 
         mCache.push_front(plan_pair_t(key, plan));
+        mIndex.emplace(key, mCache.begin());
+        evict();
     }
 
    protected:
     FFTPlanCache(FFTPlanCache const&);
     void operator=(FFTPlanCache const&);
 
+    void evict() {
+        while (mCache.size() > mMaxCacheSize) {
+            mIndex.erase(mCache.back().first);
+            mCache.pop_back();
+        }
+    }
+
     size_t mMaxCacheSize;
 
     plan_cache_t mCache;
+    plan_index_t mIndex;
 };
 }  // namespace common
@@ -0,0 +1,347 @@
+/*******************************************************
+ * Copyright (c) 2026, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <common/Logger.hpp>
+#include <common/SizeClassPool.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+using std::max;
+using std::string;
+using std::vector;
+
+namespace common {
+
+constexpr size_t SizeClassPool::MIN_CLASS;
+constexpr size_t SizeClassPool::SEGMENT_BYTES;
+constexpr unsigned SizeClassPool::NUM_SHARDS;
+constexpr int SizeClassPool::NUM_BINS;
+
+namespace {
+
+int log2Floor(size_t value) {
+    int k = 0;
+    while (value >>= 1) { ++k; }
+    return k;
+}
+
+/// Threads are assigned to the pool shards in turn
+unsigned threadShard() {
+    static std::atomic<unsigned> next_shard{0};
+    thread_local const unsigned shard =
+        next_shard++ % SizeClassPool::NUM_SHARDS;
+    return shard;
+}
+
+void printBuffer(const void *ptr, size_t bytes, const char *status_mngr,
+                 const char *status_user) {
+    const char *unit = "KB";
+    double size      = static_cast<double>(bytes) / 1024;
+    if (size >= 1024) {
+        size = size / 1024;
+        unit = "MB";
+    }
+    printf("|  %14p  |  %6.f %s | %9s | %9s |\n", ptr, size, unit, status_mngr,
+           status_user);
+}
+
+}  // namespace
+
+SizeClassPool::SizeClassPool(bool split)
+    : split(split)
+    , total_bytes(0)
+    , total_buffers(0)
+    , lock_bytes(0)
+    , lock_buffers(0)
+    , reused(0)
+    , allocated_count(0) {}
+
+SizeClassPool::~SizeClassPool() {
+    // The native buffers are freed by the memory manager. Only the
+    // bookkeeping is released here.
+    for (auto &shard : shards) {
+        for (block *head : shard.segments) {
+            while (head) {
+                block *next = head->next;
+                delete head;
+                head = next;
+            }
+        }
+    }
+}
+
+size_t SizeClassPool::classSize(size_t bytes) {
+    if (bytes <= MIN_CLASS) { return MIN_CLASS; }
+    const size_t grid = size_t(1) << (log2Floor(bytes - 1) - 2);
+    return (bytes + grid - 1) / grid * grid;
+}
+
+int SizeClassPool::binOf(size_t bytes) {
+    const int k = log2Floor(bytes);
+    return 4 * (k - 10) + static_cast<int>(bytes >> (k - 2)) - 4;
+}
+
+SizeClassPool::lock_shard &SizeClassPool::lockShardOf(const void *ptr) {
+    // Buffers are at least 256 byte aligned
+    const auto p = reinterpret_cast<std::uintptr_t>(ptr) >> 8;
+    return lock_shards[(p ^ (p >> 5) ^ (p >> 13)) % NUM_SHARDS];
+}
+
+void SizeClassPool::addToBin(pool_shard &shard, block *blk) {
+    blk->bin     = binOf(blk->bytes);
+    auto &bin    = shard.bins[blk->bin];
+    blk->bin_pos = bin.size();
+    bin.push_back(blk);
+}
+
+void SizeClassPool::removeFromBin(pool_shard &shard, block *blk) {
+    auto &bin           = shard.bins[blk->bin];
+    bin[blk->bin_pos]   = bin.back();
+    bin.back()->bin_pos = blk->bin_pos;
+    bin.pop_back();
+    blk->bin = -1;
+}
+
+SizeClassPool::block *SizeClassPool::take(pool_shard &shard, size_t bytes) {
+    // Without splitting, every buffer in the bin of the request has exactly
+    // the size of the request. With splitting, any larger buffer is used.
+    const int first = binOf(bytes);
+    const int last  = split ? NUM_BINS : first + 1;
+    for (int b = first; b < last; ++b) {
+        if (shard.bins[b].empty()) { continue; }
+        block *blk = shard.bins[b].back();
+        removeFromBin(shard, blk);
+
+        if (split && blk->bytes - bytes >= MIN_CLASS) {
+            auto *rest = new block{blk->ptr + bytes, blk->bytes - bytes, blk,
+                                   blk->next,        blk->shard,         -1,
+                                   0};
+            if (blk->next) { blk->next->prev = rest; }
+            blk->next  = rest;
+            blk->bytes = bytes;
+            addToBin(shard, rest);
+        }
+        return blk;
+    }
+    return nullptr;
+}
+
+void SizeClassPool::release(block *blk) {
+    pool_shard &shard = shards[blk->shard];
+    if (split) {
+        block *prev = blk->prev;
+        if (prev && prev->bin >= 0) {
+            removeFromBin(shard, prev);
+            prev->bytes += blk->bytes;
+            prev->next = blk->next;
+            if (blk->next) { blk->next->prev = prev; }
+            delete blk;
+            blk = prev;
+        }
+        block *next = blk->next;
+        if (next && next->bin >= 0) {
+            removeFromBin(shard, next);
+            blk->bytes += next->bytes;
+            blk->next = next->next;
+            if (next->next) { next->next->prev = blk; }
+            delete next;
+        }
+    }
+    addToBin(shard, blk);
+}
+
+void *SizeClassPool::alloc(bool user_lock, size_t bytes,
+                           const native_alloc_t &nativeAlloc) {
+    const size_t alloc_bytes = classSize(bytes);
+    const unsigned home      = threadShard();
+
+    // The shard of this thread is searched first. The other shards hold the
+    // buffers released by other threads.
+    block *blk = nullptr;
+    for (unsigned i = 0; i < NUM_SHARDS && !blk; ++i) {
+        pool_shard &shard = shards[(home + i) % NUM_SHARDS];
+        lock_guard_t lock(shard.mutex);
+        blk = take(shard, alloc_bytes);
+    }
+
+    if (blk) {
+        ++reused;
+    } else {
+        const size_t segment_bytes =
+            split ? max(alloc_bytes, SEGMENT_BYTES) : alloc_bytes;
+        void *ptr = nativeAlloc(segment_bytes);
+        total_bytes += segment_bytes;
+        ++total_buffers;
+        ++allocated_count;
+
+        blk = new block{static_cast<char *>(ptr), segment_bytes, nullptr,
+                        nullptr, home, -1, 0};
+        pool_shard &shard = shards[home];
+        lock_guard_t lock(shard.mutex);
+        shard.segments.push_back(blk);
+        if (segment_bytes > alloc_bytes) {
+            addToBin(shard, blk);
+            blk = take(shard, alloc_bytes);
+        }
+    }
+
+    lock_bytes += blk->bytes;
+    ++lock_buffers;
+
+    lock_shard &ls = lockShardOf(blk->ptr);
+    lock_guard_t lock(ls.mutex);
+    ls.map[blk->ptr] = {!user_lock, user_lock, blk};
+    return blk->ptr;
+}
+
+bool SizeClassPool::unlock(void *ptr, bool user_unlock) {
+    block *blk = nullptr;
+    {
+        lock_shard &ls = lockShardOf(ptr);
+        lock_guard_t lock(ls.mutex);
+        auto iter = ls.map.find(ptr);
+        if (iter == ls.map.end()) { return false; }
+
+        locked_entry &entry = iter->second;
+        if (user_unlock) {
+            entry.user_lock = false;
+        } else {
+            entry.manager_lock = false;
+        }
+        if (entry.user_lock || entry.manager_lock) { return true; }
+
+        blk = entry.blk;
+        ls.map.erase(iter);
+    }
+
+    // Buffers that only the user locked don't belong to the pool
+    if (!blk) { return true; }
+
+    lock_bytes -= blk->bytes;
+    --lock_buffers;
+
+    lock_guard_t lock(shards[blk->shard].mutex);
+    release(blk);
+    return true;
+}
+
+void SizeClassPool::userLock(const void *ptr) {
+    lock_shard &ls = lockShardOf(ptr);
+    lock_guard_t lock(ls.mutex);
+    auto iter = ls.map.find(ptr);
+    if (iter != ls.map.end()) {
+        iter->second.user_lock = true;
+    } else {
+        ls.map[ptr] = {false, true, nullptr};
+    }
+}
+
+bool SizeClassPool::isUserLocked(const void *ptr) {
+    lock_shard &ls = lockShardOf(ptr);
+    lock_guard_t lock(ls.mutex);
+    auto iter = ls.map.find(ptr);
+    return iter != ls.map.end() && iter->second.user_lock;
+}
+
+size_t SizeClassPool::allocated(const void *ptr) {
+    lock_shard &ls = lockShardOf(ptr);
+    lock_guard_t lock(ls.mutex);
+    auto iter = ls.map.find(ptr);
+    if (iter == ls.map.end() || !iter->second.blk) { return 0; }
+    return iter->second.blk->bytes;
+}
+
+size_t SizeClassPool::collect(vector<void *> &segments) {
+    size_t bytes_freed   = 0;
+    size_t buffers_freed = 0;
+    for (auto &shard : shards) {
+        lock_guard_t lock(shard.mutex);
+        auto &heads = shard.segments;
+        for (size_t i = 0; i < heads.size();) {
+            block *head = heads[i];
+            if (head->next || head->bin < 0) {
+                ++i;
+                continue;
+            }
+            removeFromBin(shard, head);
+            segments.push_back(head->ptr);
+            bytes_freed += head->bytes;
+            ++buffers_freed;
+            delete head;
+            heads[i] = heads.back();
+            heads.pop_back();
+        }
+    }
+    total_bytes -= bytes_freed;
+    total_buffers -= buffers_freed;
+    return bytes_freed;
+}
+
+SizeClassPool::stats SizeClassPool::getStats() {
+    stats s{};
+    for (auto &shard : shards) {
+        lock_guard_t lock(shard.mutex);
+        for (const auto &bin : shard.bins) {
+            for (const block *blk : bin) {
+                s.free_bytes += blk->bytes;
+                s.largest_free = max(s.largest_free, blk->bytes);
+            }
+            s.free_buffers += bin.size();
+        }
+    }
+    s.total_bytes   = total_bytes;
+    s.total_buffers = total_buffers;
+    s.lock_bytes    = lock_bytes;
+    s.lock_buffers  = lock_buffers;
+    s.reused        = reused;
+    s.allocated     = allocated_count;
+    return s;
+}
+
+void SizeClassPool::printInfo() {
+    for (auto &ls : lock_shards) {
+        lock_guard_t lock(ls.mutex);
+        for (const auto &kv : ls.map) {
+            printBuffer(kv.first, kv.second.blk ? kv.second.blk->bytes : 0,
+                        kv.second.manager_lock ? "Yes" : " No",
+                        kv.second.user_lock ? "Yes" : " No");
+        }
+    }
+    for (auto &shard : shards) {
+        lock_guard_t lock(shard.mutex);
+        for (const auto &bin : shard.bins) {
+            for (const block *blk : bin) {
+                printBuffer(blk->ptr, blk->bytes, "No", "No");
+            }
+        }
+    }
+    printf("---------------------------------------------------------\n");
+
+    // Fragmentation is the share of the free memory outside the largest
+    // free buffer, which can't serve a request for all of the free memory
+    const stats s = getStats();
+    const double fragmentation =
+        s.free_bytes ? 100.0 * (s.free_bytes - s.largest_free) / s.free_bytes
+                     : 0.0;
+    const size_t requests = s.reused + s.allocated;
+    const double reuse    = requests ? 100.0 * s.reused / requests : 0.0;
+    printf("Segments: %zu (%s), locked: %zu buffers (%s)\n", s.total_buffers,
+           bytesToString(s.total_bytes).c_str(), s.lock_buffers,
+           bytesToString(s.lock_bytes).c_str());
+    printf("Free: %zu buffers (%s), largest %s, fragmentation %.1f%%\n",
+           s.free_buffers, bytesToString(s.free_bytes).c_str(),
+           bytesToString(s.largest_free).c_str(), fragmentation);
+    printf("Reused %zu of %zu allocations (%.1f%%)\n", s.reused, requests,
+           reuse);
+}
+
+}  // namespace common
@@ -0,0 +1,155 @@
+/*******************************************************
+ * Copyright (c) 2026, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <common/defines.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace common {
+
+/// Caches the buffers of one device in geometric size classes.
+///
+/// Requests are rounded up to a size class. There are four classes between
+/// consecutive powers of two so a buffer is at most 25% larger than the
+/// request. The free buffers of each class are kept in a bin and a request is
+/// served from its own bin in constant time.
+///
+/// When the buffers of the backend are plain pointers, the pool can split
+/// large free buffers to serve smaller requests and allocates small buffers
+/// out of larger segments. Neighbouring free buffers of a segment are merged
+/// again when they are released. Garbage collection only frees segments that
+/// are entirely free.
+///
+/// The pool is sharded to avoid contention between host threads. Each thread
+/// allocates from the shard assigned to it and buffers return to the shard
+/// they came from, which acts as a per thread cache. Buffers are looked up by
+/// pointer in a separate set of shards.
+class SizeClassPool {
+   public:
+    /// The smallest size class
+    static constexpr size_t MIN_CLASS = 1024;
+
+    /// Small buffers are allocated out of segments of this size when the
+    /// pool splits buffers
+    static constexpr size_t SEGMENT_BYTES = 1 << 20;
+
+    static constexpr unsigned NUM_SHARDS = 8;
+
+    using native_alloc_t = std::function<void *(size_t)>;
+
+    struct stats {
+        size_t total_bytes;
+        size_t total_buffers;
+        size_t lock_bytes;
+        size_t lock_buffers;
+        size_t free_bytes;
+        size_t free_buffers;
+        size_t largest_free;
+        size_t reused;
+        size_t allocated;
+    };
+
+    explicit SizeClassPool(bool split);
+    ~SizeClassPool();
+
+    SizeClassPool(const SizeClassPool &other) = delete;
+    SizeClassPool &operator=(const SizeClassPool &other) = delete;
+
+    /// Returns the size class \p bytes is rounded up to
+    static size_t classSize(size_t bytes);
+
+    /// Returns a locked buffer of at least \p bytes. A cached buffer is used
+    /// when one fits, otherwise a new one is allocated with \p nativeAlloc.
+    void *alloc(bool user_lock, size_t bytes,
+                const native_alloc_t &nativeAlloc);
+
+    /// Releases the lock of \p ptr and caches the buffer once it is not
+    /// locked by either ArrayFire or the user. Returns false if the buffer
+    /// does not belong to the pool.
+    bool unlock(void *ptr, bool user_unlock);
+
+    void userLock(const void *ptr);
+    bool isUserLocked(const void *ptr);
+
+    /// Returns the size of a locked buffer or 0 if it is not in the pool
+    size_t allocated(const void *ptr);
+
+    /// Removes the segments that are entirely free from the pool and adds
+    /// their pointers to \p segments. Returns the number of bytes removed.
+    size_t collect(std::vector<void *> &segments);
+
+    size_t totalBytes() const { return total_bytes; }
+    size_t lockBytes() const { return lock_bytes; }
+    size_t lockBuffers() const { return lock_buffers; }
+    size_t totalBuffers() const { return total_buffers; }
+
+    stats getStats();
+
+    /// Prints the locked and free buffers followed by the statistics
+    void printInfo();
+
+   private:
+    struct block {
+        char *ptr;
+        size_t bytes;
+        block *prev;  ///< Neighbours in the same segment
+        block *next;
+        unsigned shard;
+        int bin;  ///< -1 while the block is in use
+        size_t bin_pos;
+    };
+
+    // 4 bins per power of two from MIN_CLASS up to 2^63
+    static constexpr int NUM_BINS = 4 * (64 - 10);
+
+    struct pool_shard {
+        mutex_t mutex;
+        std::array<std::vector<block *>, NUM_BINS> bins;
+        std::vector<block *> segments;
+    };
+
+    struct locked_entry {
+        bool manager_lock;
+        bool user_lock;
+        block *blk;  ///< nullptr for buffers the user locked
+    };
+
+    struct lock_shard {
+        mutex_t mutex;
+        std::unordered_map<const void *, locked_entry> map;
+    };
+
+    static int binOf(size_t bytes);
+    lock_shard &lockShardOf(const void *ptr);
+
+    block *take(pool_shard &shard, size_t bytes);
+    void release(block *blk);
+    void addToBin(pool_shard &shard, block *blk);
+    void removeFromBin(pool_shard &shard, block *blk);
+
+    bool split;
+    std::array<pool_shard, NUM_SHARDS> shards;
+    std::array<lock_shard, NUM_SHARDS> lock_shards;
+
+    std::atomic<size_t> total_bytes;
+    std::atomic<size_t> total_buffers;
+    std::atomic<size_t> lock_bytes;
+    std::atomic<size_t> lock_buffers;
+    std::atomic<size_t> reused;
+    std::atomic<size_t> allocated_count;
+};
+
+}  // namespace common
@@ -149,6 +149,26 @@ class Node {
         UNUSED(lim);
     }
 
+    /// Creates a copy of the node that reads its operands from \p children
+    /// instead of the original child nodes.
+    ///
+    /// The copy has its own intermediate buffers so that it can be evaluated
+    /// concurrently with the original node. This is only used by the CPU
+    /// backend.
+    ///
+    /// \param[in] children The copies of this node's children in the same
+    ///                     order as m_children. Entries past the number of
+    ///                     children of the node are ignored.
+    virtual Node_ptr clone(
+        const std::array<Node_ptr, kMaxChildren> &children) const {
+        UNUSED(children);
+        return nullptr;
+    }
+
+    /// Returns true if the node can generate the host source of the compiled
+    /// JIT engine. This is only used by the CPU backend.
+    virtual bool isCompilable() const { return false; }
+
     /// Generates the variable that stores the thread's/work-item's offset into
     /// the memory.
     ///
@@ -221,6 +241,16 @@ class Node {
     /// Returns the height of the JIT tree from this node
     int getHeight() const { return m_height; }
 
+    /// Returns the number of children of the node. The children are stored
+    /// first in m_children, followed by null entries.
+    int getNumChildren() const {
+        int count = 0;
+        while (count < kMaxChildren && m_children[count] != nullptr) {
+            count++;
+        }
+        return count;
+    }
+
     /// Returns the short name for this type
     /// \note For the shift node this is "Sh" appended by the short name of the
     ///       type
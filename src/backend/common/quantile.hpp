@@ -0,0 +1,79 @@
+/*******************************************************
+ * Copyright (c) 2026, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Array.hpp>
+#include <arith.hpp>
+#include <cast.hpp>
+#include <join.hpp>
+#include <sort.hpp>
+#include <af/defines.h>
+#include <af/dim4.hpp>
+
+#include <cmath>
+#include <vector>
+
+namespace common {
+
+/// The position of a quantile between two ranks of the sorted values
+struct QuantileRank {
+    dim_t lo;     ///< The rank at or below the quantile
+    double frac;  ///< The weight of rank lo + 1. Zero if the quantile is lo.
+};
+
+/// Returns the rank of the quantile \p prob of \p n values. The quantile
+/// interpolates linearly between the closest ranks, as the default method of
+/// NumPy and R (type 7) does.
+inline QuantileRank quantileRank(double prob, dim_t n) {
+    const double h = prob * static_cast<double>(n - 1);
+    const auto lo  = static_cast<dim_t>(std::floor(h));
+    if (lo >= n - 1) { return {n - 1, 0.0}; }
+    return {lo, h - static_cast<double>(lo)};
+}
+
+/// Computes the quantiles \p probs of \p in along \p dim by sorting it
+/// first. Used by the backends that don't have a selection kernel.
+template<typename T, typename To>
+detail::Array<To> quantileBySort(const detail::Array<T>& in,
+                                 const std::vector<double>& probs,
+                                 const int dim) {
+    using detail::Array;
+    const dim_t n         = in.dims()[dim];
+    const Array<T> sorted = detail::sort<T>(in, dim, true);
+    std::vector<af_seq> index(4, af_span);
+    auto rankOf = [&](dim_t rank) {
+        index[dim] = {static_cast<double>(rank), static_cast<double>(rank),
+                      1.0};
+        return detail::cast<To, T>(detail::createSubArray(sorted, index));
+    };
+
+    std::vector<Array<To>> parts;
+    parts.reserve(probs.size());
+    for (double prob : probs) {
+        const QuantileRank rank = quantileRank(prob, n);
+        Array<To> lo            = rankOf(rank.lo);
+        if (rank.frac == 0.0) {
+            parts.push_back(lo);
+            continue;
+        }
+        const af::dim4 odims = lo.dims();
+        Array<To> hi         = rankOf(rank.lo + 1);
+        Array<To> wlo =
+            detail::createValueArray<To>(odims, To(1.0 - rank.frac));
+        Array<To> whi = detail::createValueArray<To>(odims, To(rank.frac));
+        parts.push_back(detail::arithOp<To, af_add_t>(
+            detail::arithOp<To, af_mul_t>(lo, wlo, odims),
+            detail::arithOp<To, af_mul_t>(hi, whi, odims), odims));
+    }
+    if (parts.size() == 1) { return parts[0]; }
+    return detail::join<To>(dim, parts);
+}
+
+}  // namespace common
@@ -13,6 +13,7 @@
 #include <err_cpu.hpp>
 #include <jit/BinaryNode.hpp>
 #include <optypes.hpp>
+#include <simd.hpp>
 #include <af/dim4.hpp>
 #include <cmath>
 
@@ -81,6 +82,31 @@ NUMERIC_FN(af_rem_t, __rem)
 NUMERIC_FN(af_atan2_t, atan2)
 NUMERIC_FN(af_hypot_t, hypot)
 
+#undef NUMERIC_FN
+
+#define SIMD_FN(T, OP, FN)                                                 \
+    template<>                                                             \
+    struct BinOp<T, T, OP> {                                               \
+        void eval(jit::array<T> &out, const jit::array<T> &lhs,            \
+                  const jit::array<T> &rhs, int lim) const {               \
+            simd::FN(out.data(), lhs.data(), rhs.data(), lim);             \
+        }                                                                  \
+    };
+
+#define SIMD_FNS(OP, FN)   \
+    SIMD_FN(float, OP, FN) \
+    SIMD_FN(double, OP, FN)
+
+SIMD_FNS(af_add_t, add)
+SIMD_FNS(af_sub_t, sub)
+SIMD_FNS(af_mul_t, mul)
+SIMD_FNS(af_div_t, div)
+SIMD_FNS(af_max_t, max)
+SIMD_FNS(af_min_t, min)
+
+#undef SIMD_FNS
+#undef SIMD_FN
+
 template<typename T, af_op_t op>
 Array<T> arithOp(const Array<T> &lhs, const Array<T> &rhs,
                  const af::dim4 &odims) {
@@ -22,6 +22,7 @@
 #include <common/half.hpp>
 #include <copy.hpp>
 #include <kernel/dot.hpp>
+#include <kernel/small_gemm.hpp>
 #include <platform.hpp>
 #include <types.hpp>
 
@@ -239,6 +240,12 @@ void gemm(Array<T> &out, af_mat_prop optLhs, af_mat_prop optRhs, const T *alpha,
 
     auto alpha_ = scale_type<T, false>(alpha);
     auto beta_  = scale_type<T, false>(beta);
+
+    // Batches of small matrices skip BLAS and its per call overhead
+    const bool smallBatch = oDims.ndims() > 2 &&
+                            std::max({M, N, K}) <= kernel::kSmallGemmSize;
+    const T alphaVal      = *alpha;
+    const T betaVal       = *beta;
 #ifdef USE_MKL
     auto alpha_batched = scale_type<T, true>(alpha);
     auto beta_batched  = scale_type<T, true>(beta);
@@ -249,7 +256,10 @@ void gemm(Array<T> &out, af_mat_prop optLhs, af_mat_prop optRhs, const T *alpha,
         dim4 rStrides = right.strides();
         dim4 oStrides = output.strides();
 
-        if (output.dims().ndims() <= 2) {
+        if (smallBatch) {
+            kernel::smallGemm(output, left, right, optLhs, optRhs, alphaVal,
+                              betaVal);
+        } else if (output.dims().ndims() <= 2) {
             if (right.dims()[bColDim] == 1) {
                 dim_t incr =
                     (optRhs == AF_MAT_NONE) ? rStrides[0] : rStrides[1];
@@ -16,6 +16,7 @@
 #include <Array.hpp>
 #include <Param.hpp>
 #include <copy.hpp>
+#include <kernel/small_lapack.hpp>
 #include <types.hpp>
 
 #include <lapack_helper.hpp>
@@ -24,6 +25,8 @@
 #include <triangle.hpp>
 #include <af/dim4.hpp>
 
+#include <vector>
+
 namespace cpu {
 
 template<typename T>
@@ -63,17 +66,33 @@ int cholesky_inplace(Array<T> &in, const bool is_upper) {
     char uplo = 'L';
     if (is_upper) { uplo = 'U'; }
 
-    int info  = 0;
-    auto func = [&](int *info, Param<T> in) {
-        *info = potrf_func<T>()(AF_LAPACK_COL_MAJOR, uplo, N, in.get(),
-                                in.strides(1));
+    // A batch reports the info of its first matrix that is not positive
+    // definite
+    std::vector<int> infos(iDims[2] * iDims[3], 0);
+    auto func = [&](Param<T> in) {
+        const int lda = in.strides(1);
+        kernel::forEachMatrix(iDims, N * N * N, [&](dim_t z, dim_t w) {
+            T *a      = in.get() + w * in.strides(3) + z * in.strides(2);
+            int &info = infos[w * iDims[2] + z];
+            if (N <= kernel::kSmallMatrixSize) {
+                kernel::dispatchSmallSize(N, [&](auto size) {
+                    info = kernel::potrfSmall<decltype(size)::value>(
+                        is_upper, a, lda, N);
+                });
+            } else {
+                info = potrf_func<T>()(AF_LAPACK_COL_MAJOR, uplo, N, a, lda);
+            }
+        });
     };
 
-    getQueue().enqueue(func, &info, in);
+    getQueue().enqueue(func, in);
     // Ensure the value of info has been written into info.
     getQueue().sync();
 
-    return info;
+    for (int info : infos) {
+        if (info != 0) { return info; }
+    }
+    return 0;
 }
 
 #define INSTANTIATE_CH(T)                                                 \
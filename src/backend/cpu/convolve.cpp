@@ -65,9 +65,7 @@ Array<T> convolve(Array<T> const &signal, Array<accT> const &filter,
 template<typename T, typename accT>
 Array<T> convolve2(Array<T> const &signal, Array<accT> const &c_filter,
                    Array<accT> const &r_filter, const bool expand) {
-    const auto &sDims = signal.dims();
-    dim4 tDims        = sDims;
-    dim4 oDims        = sDims;
+    dim4 oDims = signal.dims();
 
     if (expand) {
         auto cfDims = c_filter.dims();
@@ -77,20 +75,18 @@ Array<T> convolve2(Array<T> const &signal, Array<accT> const &c_filter,
         auto rflen = rfDims.elements();
         // separable convolve only does AF_BATCH_NONE and standard
         // batch(AF_BATCH_LHS)
-        tDims[0] += cflen - 1;
         oDims[0] += cflen - 1;
         oDims[1] += rflen - 1;
     }
 
-    Array<T> out  = createEmptyArray<T>(oDims);
-    Array<T> temp = createEmptyArray<T>(tDims);
+    Array<T> out = createEmptyArray<T>(oDims);
 
     if (expand) {
         getQueue().enqueue(kernel::convolve2<T, accT, true>, out, signal,
-                           c_filter, r_filter, temp);
+                           c_filter, r_filter);
     } else {
         getQueue().enqueue(kernel::convolve2<T, accT, false>, out, signal,
-                           c_filter, r_filter, temp);
+                           c_filter, r_filter);
     }
     return out;
 }
@@ -126,7 +126,7 @@ DeviceManager::DeviceManager()
     , fgMngr(new graphics::ForgeManager())
     , memManager(new common::DefaultMemoryManager(
           getDeviceCount(), common::MAX_BUFFERS,
-          AF_MEM_DEBUG || AF_CPU_MEM_DEBUG)) {
+          AF_MEM_DEBUG || AF_CPU_MEM_DEBUG, true)) {
     // Use the default ArrayFire memory manager
     std::unique_ptr<cpu::Allocator> deviceMemoryManager(new cpu::Allocator());
     memManager->setAllocator(std::move(deviceMemoryManager));
@@ -144,7 +144,8 @@ void DeviceManager::resetMemoryManager() {
     // Replace with default memory manager
     std::unique_ptr<MemoryManagerBase> mgr(
         new common::DefaultMemoryManager(getDeviceCount(), common::MAX_BUFFERS,
-                                         AF_MEM_DEBUG || AF_CPU_MEM_DEBUG));
+                                         AF_MEM_DEBUG || AF_CPU_MEM_DEBUG,
+                                         true));
     setMemoryManager(std::move(mgr));
 }
 
@@ -10,61 +10,112 @@
 #include <fft.hpp>
 
 #include <Array.hpp>
+#include <common/defines.hpp>
+#include <common/err_common.hpp>
+#include <common/util.hpp>
 #include <copy.hpp>
+#include <fftw.hpp>
 #include <fftw3.h>
+#include <parallel.hpp>
 #include <platform.hpp>
 #include <types.hpp>
 #include <af/dim4.hpp>
 
 #include <array>
+#include <cstdint>
+#include <string>
 #include <type_traits>
 
 using af::dim4;
+using common::FFTPlanKey;
 using std::array;
+using std::string;
 
 namespace cpu {
 
+#if defined(USE_MKL) || defined(AF_WITH_FFTW_THREADS)
+#define FFTW_THREADS(PRE)                                            \
+    static void initThreads() { PRE##_init_threads(); }              \
+    static void planWithThreads(int n) { PRE##_plan_with_nthreads(n); }
+#else
+#define FFTW_THREADS(PRE)       \
+    static void initThreads() {} \
+    static void planWithThreads(int) {}
+#endif
+
+// The FFTW wrappers of MKL don't implement wisdom
+#ifdef USE_MKL
+#define FFTW_WISDOM(PRE)                        \
+    static void importWisdom(const char *) {} \
+    static void exportWisdom(const char *) {}
+#else
+#define FFTW_WISDOM(PRE)                                    \
+    static void importWisdom(const char *file) {            \
+        PRE##_import_wisdom_from_filename(file);            \
+    }                                                       \
+    static void exportWisdom(const char *file) {            \
+        PRE##_export_wisdom_to_filename(file);              \
+    }
+#endif
+
+/// The FFTW functions of one precision, selected by the complex type
 template<typename T>
-struct fftw_transform;
-
-#define TRANSFORM(PRE, TY)                                             \
-    template<>                                                         \
-    struct fftw_transform<TY> {                                        \
-        typedef PRE##_plan plan_t;                                     \
-        typedef PRE##_complex ctype_t;                                 \
-                                                                       \
-        template<typename... Args>                                     \
-        plan_t create(Args... args) {                                  \
-            return PRE##_plan_many_dft(args...);                       \
-        }                                                              \
-        void execute(plan_t plan) { return PRE##_execute(plan); }      \
-        void destroy(plan_t plan) { return PRE##_destroy_plan(plan); } \
+struct fftw_api;
+
+#define FFTW_API(PRE, TY, TR)                                                 \
+    template<>                                                                \
+    struct fftw_api<TY> {                                                     \
+        typedef PRE##_plan plan_t;                                            \
+        typedef PRE##_complex ctype_t;                                        \
+        typedef TR real_t;                                                    \
+                                                                              \
+        static const char *name() { return #PRE; }                            \
+        static plan_t create(int rank, const int *n, int batch, ctype_t *in,  \
+                             const int *inembed, int istride, int idist,      \
+                             ctype_t *out, const int *onembed, int ostride,   \
+                             int odist, int sign, unsigned flags) {           \
+            return PRE##_plan_many_dft(rank, n, batch, in, inembed, istride,  \
+                                       idist, out, onembed, ostride, odist,   \
+                                       sign, flags);                          \
+        }                                                                     \
+        static plan_t create(int rank, const int *n, int batch, TR *in,       \
+                             const int *inembed, int istride, int idist,      \
+                             ctype_t *out, const int *onembed, int ostride,   \
+                             int odist, unsigned flags) {                     \
+            return PRE##_plan_many_dft_r2c(rank, n, batch, in, inembed,       \
+                                           istride, idist, out, onembed,      \
+                                           ostride, odist, flags);            \
+        }                                                                     \
+        static plan_t create(int rank, const int *n, int batch, ctype_t *in,  \
+                             const int *inembed, int istride, int idist,      \
+                             TR *out, const int *onembed, int ostride,        \
+                             int odist, unsigned flags) {                     \
+            return PRE##_plan_many_dft_c2r(rank, n, batch, in, inembed,       \
+                                           istride, idist, out, onembed,      \
+                                           ostride, odist, flags);            \
+        }                                                                     \
+        static void execute(plan_t plan, ctype_t *in, ctype_t *out) {         \
+            PRE##_execute_dft(plan, in, out);                                 \
+        }                                                                     \
+        static void execute(plan_t plan, TR *in, ctype_t *out) {              \
+            PRE##_execute_dft_r2c(plan, in, out);                             \
+        }                                                                     \
+        static void execute(plan_t plan, ctype_t *in, TR *out) {              \
+            PRE##_execute_dft_c2r(plan, in, out);                             \
+        }                                                                     \
+        static void destroy(plan_t plan) { PRE##_destroy_plan(plan); }        \
+        static void *malloc(size_t bytes) { return PRE##_malloc(bytes); }     \
+        static void free(void *ptr) { PRE##_free(ptr); }                      \
+        FFTW_THREADS(PRE)                                                     \
+        FFTW_WISDOM(PRE)                                                      \
     };
 
-TRANSFORM(fftwf, cfloat)
-TRANSFORM(fftw, cdouble)
-
-template<typename To, typename Ti>
-struct fftw_real_transform;
-
-#define TRANSFORM_REAL(PRE, To, Ti, POST)                              \
-    template<>                                                         \
-    struct fftw_real_transform<To, Ti> {                               \
-        typedef PRE##_plan plan_t;                                     \
-        typedef PRE##_complex ctype_t;                                 \
-                                                                       \
-        template<typename... Args>                                     \
-        plan_t create(Args... args) {                                  \
-            return PRE##_plan_many_dft_##POST(args...);                \
-        }                                                              \
-        void execute(plan_t plan) { return PRE##_execute(plan); }      \
-        void destroy(plan_t plan) { return PRE##_destroy_plan(plan); } \
-    };
+FFTW_API(fftwf, cfloat, float)
+FFTW_API(fftw, cdouble, double)
 
-TRANSFORM_REAL(fftwf, cfloat, float, r2c)
-TRANSFORM_REAL(fftw, cdouble, double, r2c)
-TRANSFORM_REAL(fftwf, float, cfloat, c2r)
-TRANSFORM_REAL(fftw, double, cdouble, c2r)
+#undef FFTW_API
+#undef FFTW_WISDOM
+#undef FFTW_THREADS
 
 inline array<int, AF_MAX_DIMS> computeDims(const int rank, const dim4 &idims) {
     array<int, AF_MAX_DIMS> retVal = {};
@@ -72,7 +123,180 @@ inline array<int, AF_MAX_DIMS> computeDims(const int rank, const dim4 &idims) {
     return retVal;
 }
 
-void setFFTPlanCacheSize(size_t numPlans) { UNUSED(numPlans); }
+/// Transforms with at least this many elements run on the CPU threads if
+/// FFTW was built with thread support
+constexpr dim_t FFT_THREADED_MIN_ELEMENTS = 1 << 16;
+
+/// Plans with the same arrays are reused by executing them on new arrays.
+/// FFTW requires the new arrays to have the alignment of the ones the plan
+/// was created with, which is part of the plan key.
+constexpr std::uintptr_t FFT_ALIGNMENT = 64;
+
+enum FFTKind { FFT_FORWARD, FFT_BACKWARD, FFT_R2C, FFT_C2R };
+
+/// The planner rigor selected by AF_CPU_FFT_PLANNER
+unsigned fftPlannerFlags() {
+#ifdef USE_MKL
+    // MKL ignores the planner rigor
+    return FFTW_ESTIMATE;
+#else
+    static const unsigned flags = [] {
+        const string planner = getEnvVar("AF_CPU_FFT_PLANNER");
+        if (planner == "MEASURE") { return unsigned(FFTW_MEASURE); }
+        if (planner == "PATIENT") { return unsigned(FFTW_PATIENT); }
+        if (planner == "EXHAUSTIVE") { return unsigned(FFTW_EXHAUSTIVE); }
+        return unsigned(FFTW_ESTIMATE);  // NOLINT(hicpp-signed-bitwise)
+    }();
+    return flags;
+#endif
+}
+
+template<typename T>
+string fftWisdomFile() {
+    const string &cacheDirectory = getCacheDirectory();
+    if (cacheDirectory.empty()) { return string(); }
+    return cacheDirectory + AF_PATH_SEPARATOR + fftw_api<T>::name() +
+           "_wisdom_CPU";
+}
+
+/// Initializes the threads of FFTW and loads the wisdom saved by earlier runs
+/// before the first plan of each precision is created
+template<typename T>
+void initPlanner() {
+    static bool initialized = false;
+    if (initialized) { return; }
+    initialized = true;
+
+    fftw_api<T>::initThreads();
+    if (fftPlannerFlags() != FFTW_ESTIMATE) {
+        const string file = fftWisdomFile<T>();
+        if (!file.empty()) { fftw_api<T>::importWisdom(file.c_str()); }
+    }
+}
+
+/// Saves the wisdom gathered by the planner so later runs can skip the
+/// measurements. The file is written under a temporary name and renamed so
+/// that concurrent processes never read a partial file.
+template<typename T>
+void saveWisdom() {
+    const string file = fftWisdomFile<T>();
+    if (file.empty()) { return; }
+    const string tempFile =
+        getCacheDirectory() + AF_PATH_SEPARATOR + makeTempFilename();
+    fftw_api<T>::exportWisdom(tempFile.c_str());
+    if (!renameFile(tempFile, file)) { removeFile(tempFile); }
+}
+
+/// Offset of \p ptr from the last FFT_ALIGNMENT boundary
+inline int alignmentOf(const void *ptr) {
+    return static_cast<int>(reinterpret_cast<std::uintptr_t>(ptr) %
+                            FFT_ALIGNMENT);
+}
+
+/// Returns an array of \p bytes allocated in \p buffer whose alignment
+/// matches that of \p like
+template<typename T>
+void *scratchLike(void *&buffer, const void *like, size_t bytes) {
+    buffer = fftw_api<T>::malloc(bytes + FFT_ALIGNMENT);
+    if (!buffer) { AF_ERROR("Failed to allocate FFT scratch", AF_ERR_NO_MEM); }
+    const int offset =
+        (alignmentOf(like) - alignmentOf(buffer) + int(FFT_ALIGNMENT)) %
+        int(FFT_ALIGNMENT);
+    return static_cast<char *>(buffer) + offset;
+}
+
+/// Returns the cached plan of the transform described by \p key from \p in
+/// to \p out or creates one by calling \p create(in, out, flags).
+///
+/// The rigor of the planner is set by AF_CPU_FFT_PLANNER. Planners other than
+/// FFTW_ESTIMATE overwrite the arrays they plan with, so those plans are made
+/// with scratch arrays of \p ibytes and \p obytes that have the alignment of
+/// \p in and \p out.
+template<typename T, typename Ti, typename To, typename CreateFunc>
+SharedPlan findPlan(FFTPlanKey key, Ti *in, To *out, size_t ibytes,
+                    size_t obytes, CreateFunc create) {
+    using api           = fftw_api<T>;
+    const bool inplace  = static_cast<void *>(in) == static_cast<void *>(out);
+    const unsigned rigor = fftPlannerFlags();
+
+    dim_t elements = key.batch;
+    for (int r = 0; r < key.rank; r++) { elements *= key.n[r]; }
+
+    key.type |= (std::is_same<T, cdouble>::value ? 1 << 2 : 0) |
+                (inplace ? 1 << 3 : 0) | (alignmentOf(in) << 8) |
+                (alignmentOf(out) << 16);
+    key.flags |= static_cast<int>(rigor);
+#if defined(USE_MKL) || defined(AF_WITH_FFTW_THREADS)
+    key.threads = elements >= FFT_THREADED_MIN_ELEMENTS ? getNumThreads() : 1;
+#else
+    key.threads = 1;
+#endif
+
+    PlanCache &planner = fftManager();
+    SharedPlan retVal  = planner.find(key);
+    if (retVal) { return retVal; }
+
+    initPlanner<T>();
+    api::planWithThreads(key.threads);
+
+    const unsigned flags = static_cast<unsigned>(key.flags);
+    typename api::plan_t plan;
+    if (rigor == FFTW_ESTIMATE) {
+        plan = create(in, out, flags);
+    } else {
+        void *ibuffer = nullptr;
+        void *obuffer = nullptr;
+        Ti *sin = static_cast<Ti *>(scratchLike<T>(ibuffer, in, ibytes));
+        To *sout =
+            inplace ? reinterpret_cast<To *>(sin)
+                    : static_cast<To *>(scratchLike<T>(obuffer, out, obytes));
+        plan = create(sin, sout, flags);
+        api::free(ibuffer);
+        if (obuffer) { api::free(obuffer); }
+        if (plan) { saveWisdom<T>(); }
+    }
+    if (!plan) { AF_ERROR("Failed to create an FFTW plan", AF_ERR_INTERNAL); }
+
+    retVal = SharedPlan(plan, api::destroy);
+    planner.push(key, retVal);
+    return retVal;
+}
+
+/// The key of a transform with the layout that fftw_plan_many_dft takes
+inline FFTPlanKey makeKey(FFTKind kind, int rank, const int *n, int batch,
+                          const int *inembed, int istride, int idist,
+                          const int *onembed, int ostride, int odist,
+                          unsigned flags) {
+    FFTPlanKey key;
+    key.rank  = rank;
+    key.type  = kind;
+    key.flags = static_cast<int>(flags);
+    key.batch = batch;
+    for (int r = 0; r < rank; ++r) {
+        key.n[r]       = n[r];
+        key.inembed[r] = inembed[r];
+        key.onembed[r] = onembed[r];
+    }
+    key.istride = istride;
+    key.idist   = idist;
+    key.ostride = ostride;
+    key.odist   = odist;
+    return key;
+}
+
+/// Number of elements spanned by \p batch transforms with the given layout
+inline size_t layoutSpan(int rank, const int *embed, int stride, int dist,
+                         int batch) {
+    size_t span = stride;
+    for (int r = 0; r < rank; ++r) { span *= embed[r]; }
+    return span + static_cast<size_t>(batch - 1) * dist;
+}
+
+void setFFTPlanCacheSize(size_t numPlans) {
+    getQueue().enqueue(
+        [](size_t size) { fftManager().setMaxCacheSize(size); },
+        numPlans);
+}
 
 template<typename T>
 void fft_inplace(Array<T> &in, const int rank, const bool direction) {
@@ -84,25 +308,34 @@ void fft_inplace(Array<T> &in, const int rank, const bool direction) {
 
         const af::dim4 istrides = in.strides();
 
-        using ctype_t = typename fftw_transform<T>::ctype_t;
-        typename fftw_transform<T>::plan_t plan;
-
-        fftw_transform<T> transform;
+        using api     = fftw_api<T>;
+        using ctype_t = typename api::ctype_t;
 
         int batch = 1;
         for (int i = rank; i < 4; i++) { batch *= idims[i]; }
 
-        plan = transform.create(
-            rank, t_dims.data(), batch, reinterpret_cast<ctype_t *>(in.get()),
-            in_embed.data(), static_cast<int>(istrides[0]),
-            static_cast<int>(istrides[rank]),
-            reinterpret_cast<ctype_t *>(in.get()), in_embed.data(),
-            static_cast<int>(istrides[0]), static_cast<int>(istrides[rank]),
-            direction ? FFTW_FORWARD : FFTW_BACKWARD,
-            FFTW_ESTIMATE);  // NOLINT(hicpp-signed-bitwise)
-
-        transform.execute(plan);
-        transform.destroy(plan);
+        const int stride = static_cast<int>(istrides[0]);
+        const int dist   = static_cast<int>(istrides[rank]);
+        const size_t bytes =
+            layoutSpan(rank, in_embed.data(), stride, dist, batch) * sizeof(T);
+
+        const FFTPlanKey key =
+            makeKey(direction ? FFT_FORWARD : FFT_BACKWARD, rank,
+                    t_dims.data(), batch, in_embed.data(), stride, dist,
+                    in_embed.data(), stride, dist, 0);
+
+        auto *data = reinterpret_cast<ctype_t *>(in.get());
+
+        SharedPlan plan = findPlan<T>(
+            key, data, data, bytes, bytes,
+            [&](ctype_t *idata, ctype_t *odata, unsigned flags) {
+                return api::create(rank, t_dims.data(), batch, idata,
+                                   in_embed.data(), stride, dist, odata,
+                                   in_embed.data(), stride, dist,
+                                   direction ? FFTW_FORWARD : FFTW_BACKWARD,
+                                   flags);
+            });
+        api::execute(static_cast<typename api::plan_t>(plan.get()), data, data);
     };
     getQueue().enqueue(func, in, in.getDataDims());
 }
@@ -124,25 +357,36 @@ Array<Tc> fft_r2c(const Array<Tr> &in, const int rank) {
         const af::dim4 istrides = in.strides();
         const af::dim4 ostrides = out.strides();
 
-        using ctype_t = typename fftw_real_transform<Tc, Tr>::ctype_t;
-        using plan_t  = typename fftw_real_transform<Tc, Tr>::plan_t;
-        plan_t plan;
-
-        fftw_real_transform<Tc, Tr> transform;
+        using api     = fftw_api<Tc>;
+        using ctype_t = typename api::ctype_t;
 
         int batch = 1;
         for (int i = rank; i < 4; i++) { batch *= idims[i]; }
 
-        plan = transform.create(
-            rank, t_dims.data(), batch, const_cast<Tr *>(in.get()),
-            in_embed.data(), static_cast<int>(istrides[0]),
-            static_cast<int>(istrides[rank]),
-            reinterpret_cast<ctype_t *>(out.get()), out_embed.data(),
-            static_cast<int>(ostrides[0]), static_cast<int>(ostrides[rank]),
-            FFTW_ESTIMATE);
-
-        transform.execute(plan);
-        transform.destroy(plan);
+        const int istride = static_cast<int>(istrides[0]);
+        const int idist   = static_cast<int>(istrides[rank]);
+        const int ostride = static_cast<int>(ostrides[0]);
+        const int odist   = static_cast<int>(ostrides[rank]);
+
+        const FFTPlanKey key =
+            makeKey(FFT_R2C, rank, t_dims.data(), batch, in_embed.data(),
+                    istride, idist, out_embed.data(), ostride, odist, 0);
+
+        auto *src = const_cast<Tr *>(in.get());
+        auto *dst = reinterpret_cast<ctype_t *>(out.get());
+
+        SharedPlan plan = findPlan<Tc>(
+            key, src, dst,
+            layoutSpan(rank, in_embed.data(), istride, idist, batch) *
+                sizeof(Tr),
+            layoutSpan(rank, out_embed.data(), ostride, odist, batch) *
+                sizeof(Tc),
+            [&](Tr *idata, ctype_t *odata, unsigned flags) {
+                return api::create(rank, t_dims.data(), batch, idata,
+                                   in_embed.data(), istride, idist, odata,
+                                   out_embed.data(), ostride, odist, flags);
+            });
+        api::execute(static_cast<typename api::plan_t>(plan.get()), src, dst);
     };
 
     getQueue().enqueue(func, out, out.getDataDims(), in, in.getDataDims());
@@ -163,36 +407,46 @@ Array<Tr> fft_c2r(const Array<Tc> &in, const dim4 &odims, const int rank) {
         const af::dim4 istrides = in.strides();
         const af::dim4 ostrides = out.strides();
 
-        using ctype_t = typename fftw_real_transform<Tr, Tc>::ctype_t;
-        using plan_t  = typename fftw_real_transform<Tr, Tc>::plan_t;
-        plan_t plan;
-
-        fftw_real_transform<Tr, Tc> transform;
+        using api     = fftw_api<Tc>;
+        using ctype_t = typename api::ctype_t;
 
         int batch = 1;
         for (int i = rank; i < 4; i++) { batch *= odims[i]; }
 
-        // By default, fftw estimate flag is sufficient for most transforms.
-        // However, complex to real transforms modify the input data memory
-        // while performing the transformation. To avoid that, we need to pass
-        // FFTW_PRESERVE_INPUT also. This flag however only works for 1D
+        const int istride = static_cast<int>(istrides[0]);
+        const int idist   = static_cast<int>(istrides[rank]);
+        const int ostride = static_cast<int>(ostrides[0]);
+        const int odist   = static_cast<int>(ostrides[rank]);
+
+        // Complex to real transforms modify the input data memory while
+        // performing the transformation. To avoid that, we need to pass
+        // FFTW_PRESERVE_INPUT. This flag however only works for 1D
         // transforms and for higher level transformations, a copy of input
         // data is passed onto the upstream FFTW calls.
-        unsigned int flags = FFTW_ESTIMATE;  // NOLINT(hicpp-signed-bitwise)
+        unsigned int flags = 0;
         if (rank == 1) {
             flags |= FFTW_PRESERVE_INPUT;  // NOLINT(hicpp-signed-bitwise)
         }
 
-        plan = transform.create(
-            rank, t_dims.data(), batch,
-            reinterpret_cast<ctype_t *>(const_cast<Tc *>(in.get())),
-            in_embed.data(), static_cast<int>(istrides[0]),
-            static_cast<int>(istrides[rank]), out.get(), out_embed.data(),
-            static_cast<int>(ostrides[0]), static_cast<int>(ostrides[rank]),
-            flags);
-
-        transform.execute(plan);
-        transform.destroy(plan);
+        const FFTPlanKey key =
+            makeKey(FFT_C2R, rank, t_dims.data(), batch, in_embed.data(),
+                    istride, idist, out_embed.data(), ostride, odist, flags);
+
+        auto *src = reinterpret_cast<ctype_t *>(const_cast<Tc *>(in.get()));
+        auto *dst = out.get();
+
+        SharedPlan plan = findPlan<Tc>(
+            key, src, dst,
+            layoutSpan(rank, in_embed.data(), istride, idist, batch) *
+                sizeof(Tc),
+            layoutSpan(rank, out_embed.data(), ostride, odist, batch) *
+                sizeof(Tr),
+            [&](ctype_t *idata, Tr *odata, unsigned flags) {
+                return api::create(rank, t_dims.data(), batch, idata,
+                                   in_embed.data(), istride, idist, odata,
+                                   out_embed.data(), ostride, odist, flags);
+            });
+        api::execute(static_cast<typename api::plan_t>(plan.get()), src, dst);
     };
 
 #ifdef USE_MKL
@@ -0,0 +1,26 @@
+/*******************************************************
+ * Copyright (c) 2026, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <common/FFTPlanCache.hpp>
+
+#include <memory>
+
+namespace cpu {
+
+// fftw_plan and fftwf_plan are different pointer types so the cache holds
+// them type erased. The deleter of each plan destroys it with the matching
+// precision.
+typedef void PlanType;
+typedef std::shared_ptr<PlanType> SharedPlan;
+
+class PlanCache : public common::FFTPlanCache<PlanCache, PlanType> {};
+
+}  // namespace cpu
@@ -12,11 +12,14 @@
 #include <Array.hpp>
 #include <common/half.hpp>
 #include <handle.hpp>
+#include <jit/GatherNode.hpp>
 #include <kernel/index.hpp>
 #include <platform.hpp>
 #include <queue.hpp>
 #include <af/dim4.hpp>
 
+#include <array>
+#include <memory>
 #include <utility>
 #include <vector>
 
@@ -50,11 +53,33 @@ Array<T> index(const Array<T>& in, const af_index_t idxrs[]) {
         }
     }
 
-    Array<T> out = createEmptyArray<T>(oDims);
-    vector<CParam<uint>> idxParams(idxArrs.begin(), idxArrs.end());
+    // The result is a gather node so that the operations using it read the
+    // selected elements of the input directly instead of a copy. The offset
+    // tables are filled on the queue once the index arrays are evaluated.
+    auto offsets = std::make_shared<jit::GatherOffsets>();
+    std::array<std::shared_ptr<const uint>, 4> idxData;
+    for (unsigned x = 0; x < isSeq.size(); ++x) {
+        (*offsets)[x].resize(oDims[x]);
+        if (!isSeq[x]) {
+            // get evaluates the array before its buffer is shared
+            const uint* ptr = idxArrs[x].get();
+            idxData[x] = std::shared_ptr<const uint>(idxArrs[x].getData(), ptr);
+        }
+    }
+
+    const dim4 iDims   = in.dims();
+    const dim4 iOffs   = toOffset(seqs, in.getDataDims());
+    const dim4 iStrds  = in.strides();
+    const T* inPtr     = in.get();
+    const bool contig0 = isSeq[0] && iStrds[0] == 1 &&
+                         iOffs[0] + oDims[0] <= iDims[0];
+    getQueue().enqueue(kernel::gatherOffsets, offsets, iDims, iStrds, iOffs,
+                       idxData);
 
-    getQueue().enqueue(kernel::index<T>, out, in, in.getDataDims(),
-                       std::move(isSeq), std::move(seqs), std::move(idxParams));
+    const unsigned bytes = in.getDataDims().elements() * sizeof(T);
+    auto node = std::make_shared<jit::GatherNode<T>>(
+        in.getData(), inPtr, bytes, offsets, oDims.get(), contig0, iOffs[0]);
+    Array<T> out = createNodeArray<T>(oDims, node);
 
     return out;
 }
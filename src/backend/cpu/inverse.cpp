@@ -16,9 +16,11 @@
 #include <handle.hpp>
 #include <range.hpp>
 #include <af/dim4.hpp>
+#include <algorithm>
 #include <cassert>
 
 #include <identity.hpp>
+#include <kernel/small_lapack.hpp>
 #include <lapack_helper.hpp>
 #include <lu.hpp>
 #include <platform.hpp>
@@ -60,8 +62,24 @@ Array<T> inverse(const Array<T> &in) {
     Array<int> pivot = lu_inplace<T>(A, false);
 
     auto func = [=](Param<T> A, Param<int> pivot, int M) {
-        getri_func<T>()(AF_LAPACK_COL_MAJOR, M, A.get(), A.strides(1),
-                        pivot.get());
+        const int lda = A.strides(1);
+        kernel::forEachMatrix(A.dims(), M * M * M, [&](dim_t z, dim_t w) {
+            T *a = A.get() + w * A.strides(3) + z * A.strides(2);
+            const int *p =
+                pivot.get() + w * pivot.strides(3) + z * pivot.strides(2);
+            if (M <= kernel::kSmallMatrixSize) {
+                T lu[kernel::kSmallMatrixSize * kernel::kSmallMatrixSize];
+                for (int c = 0; c < M; c++) {
+                    std::copy(a + c * lda, a + c * lda + M, lu + c * M);
+                }
+                kernel::dispatchSmallSize(M, [&](auto size) {
+                    kernel::getriSmall<decltype(size)::value>(lu, M, p, a, lda,
+                                                              M);
+                });
+            } else {
+                getri_func<T>()(AF_LAPACK_COL_MAJOR, M, a, lda, p);
+            }
+        });
     };
     getQueue().enqueue(func, A, pivot, M);
 
@@ -0,0 +1,321 @@
+/*******************************************************
+ * Copyright (c) 2026, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <jit.hpp>
+
+#include <common/Logger.hpp>
+#include <common/defines.hpp>
+#include <common/jit/Node.hpp>
+#include <common/module_loading.hpp>
+#include <common/util.hpp>
+#include <jit/HostSource.hpp>
+#include <kernel_headers/simd_math_hpp.hpp>
+#include <af/version.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using common::getFuncName;
+using common::Node;
+using common::Node_ids;
+using std::lock_guard;
+using std::mutex;
+using std::string;
+using std::stringstream;
+using std::to_string;
+using std::unordered_map;
+using std::vector;
+
+namespace cpu {
+namespace jit {
+
+namespace {
+
+spdlog::logger *getLogger() {
+    static std::shared_ptr<spdlog::logger> logger(common::loggerFactory("jit"));
+    return logger.get();
+}
+
+string getKernelString(const string &funcName, const vector<Node *> &full_nodes,
+                       const vector<Node_ids> &full_ids,
+                       const vector<int> &output_ids, const char *out_type,
+                       bool is_linear) {
+    // Helpers matching the functors used by the interpreted nodes. The float
+    // functions use the approximations of simd_math.hpp, which is pasted in
+    // front of them.
+    static const char *includeStr = R"JIT(
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+typedef long long dim_t;
+
+template<typename T>
+static inline T __mod(T lhs, T rhs) {
+    T res  = lhs % rhs;
+    T diff = rhs - res;
+    return (res < 0) ? (diff < 0 ? T(-diff) : diff) : res;
+}
+static inline float __mod(float lhs, float rhs) {
+    return std::fmod(lhs, rhs);
+}
+static inline double __mod(double lhs, double rhs) {
+    return std::fmod(lhs, rhs);
+}
+
+template<typename T>
+static inline T __rem(T lhs, T rhs) {
+    return lhs % rhs;
+}
+static inline float __rem(float lhs, float rhs) {
+    return std::remainder(lhs, rhs);
+}
+static inline double __rem(double lhs, double rhs) {
+    return std::remainder(lhs, rhs);
+}
+
+template<typename T>
+static inline T __sigmoid(T in) {
+    return (1.0) / (1 + std::exp(-in));
+}
+static inline float __sigmoid(float in) {
+    return cpu::simd::approxSigmoid(in);
+}
+
+template<typename T>
+static inline T __rsqrt(T in) {
+    return std::pow(in, -0.5);
+}
+static inline float __rsqrt(float in) {
+    return 1.f / std::sqrt(in);
+}
+static inline double __rsqrt(double in) {
+    return 1.0 / std::sqrt(in);
+}
+
+template<typename T>
+static inline T __exp(T in) {
+    return std::exp(in);
+}
+static inline float __exp(float in) {
+    return cpu::simd::approxExp(in);
+}
+
+template<typename T>
+static inline T __log(T in) {
+    return std::log(in);
+}
+static inline float __log(float in) {
+    return cpu::simd::approxLog(in);
+}
+
+template<typename T>
+static inline T __tanh(T in) {
+    return std::tanh(in);
+}
+static inline float __tanh(float in) {
+    return cpu::simd::approxTanh(in);
+}
+
+template<typename T>
+static inline T __sin(T in) {
+    return std::sin(in);
+}
+static inline float __sin(float in) {
+    return cpu::simd::trigLarge(in) ? std::sin(in) : cpu::simd::approxSin(in);
+}
+
+template<typename T>
+static inline T __cos(T in) {
+    return std::cos(in);
+}
+static inline float __cos(float in) {
+    return cpu::simd::trigLarge(in) ? std::cos(in) : cpu::simd::approxCos(in);
+}
+
+template<typename T>
+static inline bool __iszero(T in) {
+    return in == 0;
+}
+)JIT";
+
+    static const char *kernelVoid = "extern \"C\" void ";
+    static const char *kernelParams =
+        "(void *const *args, const dim_t *odims, const dim_t *ostrides, "
+        "dim_t begin, dim_t end) {\n";
+
+    static const char *linearLoop = R"JIT(
+for (dim_t idx = begin; idx < end; idx++) {
+    const dim_t oidx = idx;
+)JIT";
+
+    static const char *generalLoop = R"JIT(
+for (dim_t row = begin; row < end; row++) {
+    const dim_t y    = row % odims[1];
+    const dim_t z    = (row / odims[1]) % odims[2];
+    const dim_t w    = row / (odims[1] * odims[2]);
+    const dim_t ooff = y * ostrides[1] + z * ostrides[2] + w * ostrides[3];
+    for (dim_t x = 0; x < odims[0]; x++) {
+    const dim_t oidx = ooff + x;
+)JIT";
+
+    stringstream paramStream;
+    stringstream offsetsStream;
+    stringstream opsStream;
+    stringstream outParamStream;
+    stringstream outWriteStream;
+
+    for (size_t i = 0; i < full_nodes.size(); i++) {
+        const auto &node     = full_nodes[i];
+        const auto &ids_curr = full_ids[i];
+        node->genParams(paramStream, ids_curr.id, is_linear);
+        node->genOffsets(offsetsStream, ids_curr.id, is_linear);
+        node->genFuncs(opsStream, ids_curr);
+    }
+
+    const int nargs = ARGS_PER_NODE * static_cast<int>(full_nodes.size());
+    for (size_t i = 0; i < output_ids.size(); i++) {
+        const int id = output_ids[i];
+        outParamStream << out_type << " *out" << i << " = *static_cast<"
+                       << out_type << " *const *>(args[" << nargs + i
+                       << "]);\n";
+        outWriteStream << "out" << i << "[oidx] = val" << id << ";\n";
+    }
+
+    stringstream kerStream;
+    kerStream << string(simd_math_hpp, simd_math_hpp_len) << "\n";
+    kerStream << includeStr << "\n";
+    kerStream << kernelVoid << funcName << kernelParams;
+    kerStream << paramStream.str() << outParamStream.str();
+    kerStream << (is_linear ? linearLoop : generalLoop);
+    kerStream << offsetsStream.str() << opsStream.str()
+              << outWriteStream.str();
+    kerStream << (is_linear ? "}\n" : "}\n}\n");
+    kerStream << "}\n";
+
+    saveKernel(funcName, kerStream.str(), ".cpp");
+
+    return kerStream.str();
+}
+
+/// Compiles \p source into a shared library in the kernel cache directory and
+/// returns the kernel named \p funcName from it
+CompiledKernel compileKernel(const string &funcName, const string &source) {
+    const string &cacheDirectory = getCacheDirectory();
+    if (cacheDirectory.empty()) { return nullptr; }
+
+    // The library name depends on the source so that changes to the code
+    // generation never load stale libraries
+    const string libFile =
+        cacheDirectory + AF_PATH_SEPARATOR + funcName + "_" +
+        to_string(deterministicHash(source)) + "_CPU_AF_" +
+        to_string(AF_API_VERSION_CURRENT) + ".so";
+
+    LibHandle handle = common::loadLibrary(libFile.c_str());
+    if (handle) {
+        AF_TRACE("{{{:<20} : loaded from {}}}", funcName, libFile);
+    } else {
+        const string tempName =
+            cacheDirectory + AF_PATH_SEPARATOR + makeTempFilename();
+        const string srcFile = tempName + ".cpp";
+        const string tempLib = tempName + ".so";
+        {
+            std::ofstream out(srcFile);
+            out << source;
+        }
+
+        string compiler = getEnvVar("AF_CPU_JIT_COMPILER");
+        if (compiler.empty()) { compiler = "c++"; }
+
+        // The floating point flags match those of simd.cpp so that both
+        // engines produce the same results
+        const string command = compiler +
+                               " -std=c++11 -O3 -march=native "
+                               "-ffp-contract=off -fno-math-errno "
+                               "-fno-trapping-math -fPIC -shared -o \"" +
+                               tempLib + "\" \"" + srcFile + "\"";
+        const int status = std::system(command.c_str());
+        removeFile(srcFile);
+        if (status != 0) {
+            AF_TRACE("{{{:<20} : compilation failed: {}}}", funcName,
+                     command);
+            removeFile(tempLib);
+            return nullptr;
+        }
+
+        // Another process may have created the library in the meantime
+        if (!renameFile(tempLib, libFile)) { removeFile(tempLib); }
+        handle = common::loadLibrary(libFile.c_str());
+        if (!handle) {
+            AF_TRACE("{{{:<20} : unable to load {}: {}}}", funcName, libFile,
+                     common::getErrorMessage());
+            return nullptr;
+        }
+        AF_TRACE("{{{:<20} : compiled to {}}}", funcName, libFile);
+    }
+
+    return reinterpret_cast<CompiledKernel>(
+        common::getFunctionPointer(handle, funcName.c_str()));
+}
+
+}  // namespace
+
+bool isCompiledJITEnabled() {
+#if defined(OS_WIN)
+    return false;
+#else
+    // Read on every evaluation so the engine can be switched at run time
+    return getEnvVar("AF_CPU_JIT_COMPILE") == "1";
+#endif
+}
+
+CompiledKernel getCompiledKernel(const vector<Node *> &full_nodes,
+                                 const vector<Node_ids> &full_ids,
+                                 const vector<int> &output_ids,
+                                 const char *out_type, bool is_linear) {
+    for (const auto &node : full_nodes) {
+        if (!node->isCompilable()) { return nullptr; }
+    }
+
+    vector<Node *> output_nodes;
+    string outputs;
+    for (int id : output_ids) {
+        output_nodes.push_back(full_nodes[id]);
+        outputs += to_string(id) + ',';
+    }
+
+    // getFuncName only records the number of outputs and not which nodes
+    // they are
+    const string funcName =
+        getFuncName(output_nodes, full_nodes, full_ids, is_linear) + "_" +
+        to_string(deterministicHash(outputs + out_type));
+
+    static mutex kernelMutex;
+    static unordered_map<string, CompiledKernel> kernels;
+
+    lock_guard<mutex> lock(kernelMutex);
+    auto it = kernels.find(funcName);
+    if (it != kernels.end()) { return it->second; }
+
+    // Failures are cached as well so the tree is not compiled again
+    CompiledKernel kernel = compileKernel(
+        funcName, getKernelString(funcName, full_nodes, full_ids, output_ids,
+                                  out_type, is_linear));
+    kernels[funcName] = kernel;
+    return kernel;
+}
+
+}  // namespace jit
+}  // namespace cpu
@@ -0,0 +1,61 @@
+/*******************************************************
+ * Copyright (c) 2026, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <common/jit/Node.hpp>
+
+#include <vector>
+
+namespace cpu {
+namespace jit {
+
+/// Signature of the kernels created by the compiled JIT engine
+///
+/// \param[in] args     The addresses of the kernel arguments. The arguments of
+///                     node N start at ARGS_PER_NODE * N and the addresses of
+///                     the output pointers follow the arguments of the nodes
+/// \param[in] odims    The dimensions of the outputs
+/// \param[in] ostrides The strides of the outputs
+/// \param[in] begin    The first element (linear kernels) or the first
+///                     row along dimensions 1-3 (general kernels) to evaluate
+/// \param[in] end      One past the last element or row to evaluate
+using CompiledKernel = void (*)(void *const *args, const dim_t *odims,
+                                const dim_t *ostrides, dim_t begin,
+                                dim_t end);
+
+/// Returns true if the compiled JIT engine is enabled.
+///
+/// The engine is enabled by setting the AF_CPU_JIT_COMPILE environment
+/// variable to 1. The variable is read every time a tree is evaluated. The
+/// engine is not available on Windows.
+bool isCompiledJITEnabled();
+
+/// Returns a kernel that evaluates the whole tree in a single loop.
+///
+/// The source of the kernel is generated from the nodes, compiled into a
+/// shared library in the kernel cache directory and loaded. Kernels are
+/// cached in memory and on disk by the hash of the tree so each tree shape
+/// is only compiled once.
+///
+/// \param[in] full_nodes The nodes of the tree with children before parents
+/// \param[in] full_ids   The ids of the nodes and of their children
+/// \param[in] output_ids The ids of the output nodes
+/// \param[in] out_type   The name of the output type in the generated source
+/// \param[in] is_linear  True if every buffer can be indexed linearly
+///
+/// \returns the kernel or nullptr if the tree contains nodes that can't be
+///          compiled or the compilation failed
+CompiledKernel getCompiledKernel(const std::vector<common::Node *> &full_nodes,
+                                 const std::vector<common::Node_ids> &full_ids,
+                                 const std::vector<int> &output_ids,
+                                 const char *out_type, bool is_linear);
+
+}  // namespace jit
+}  // namespace cpu
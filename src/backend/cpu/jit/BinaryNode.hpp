@@ -12,7 +12,10 @@
 #include <math.hpp>
 #include <optypes.hpp>
 #include <array>
+#include <sstream>
+#include <string>
 #include <vector>
+#include "HostSource.hpp"
 #include "Node.hpp"
 
 namespace cpu {
@@ -49,10 +52,32 @@ class BinaryNode : public TNode<compute_t<To>> {
         m_op.eval(this->m_val, m_lhs->m_val, m_rhs->m_val, lim);
     }
 
+    common::Node_ptr clone(
+        const std::array<common::Node_ptr, common::Node::kMaxChildren>
+            &children) const final {
+        return std::make_shared<BinaryNode>(children[0], children[1]);
+    }
+
+    bool isCompilable() const final {
+        return hostTypeName<compute_t<To>>() != nullptr &&
+               hostTypeName<compute_t<Ti>>() != nullptr &&
+               binaryOpSource(op).str != nullptr;
+    }
+
     void genKerName(std::string &kerString,
                     const common::Node_ids &ids) const final {
-        UNUSED(kerString);
-        UNUSED(ids);
+        kerString += "_O";
+        kerString += std::to_string(op);
+        kerString += ',';
+        kerString += hostTypeName<compute_t<To>>();
+        kerString += ',';
+        kerString += hostTypeName<compute_t<Ti>>();
+        kerString += ',';
+        kerString += std::to_string(ids.child_ids[0]);
+        kerString += ',';
+        kerString += std::to_string(ids.child_ids[1]);
+        kerString += ',';
+        kerString += std::to_string(ids.id);
     }
 
     void genParams(std::stringstream &kerStream, int id,
@@ -79,8 +104,18 @@ class BinaryNode : public TNode<compute_t<To>> {
 
     void genFuncs(std::stringstream &kerStream,
                   const common::Node_ids &ids) const final {
-        UNUSED(kerStream);
-        UNUSED(ids);
+        const OpSource src    = binaryOpSource(op);
+        const std::string lhs = "val" + std::to_string(ids.child_ids[0]);
+        const std::string rhs = "val" + std::to_string(ids.child_ids[1]);
+
+        kerStream << hostTypeName<compute_t<To>>() << " val" << ids.id
+                  << " = ";
+        if (src.infix) {
+            kerStream << lhs << " " << src.str << " " << rhs;
+        } else {
+            kerStream << src.str << "(" << lhs << ", " << rhs << ")";
+        }
+        kerStream << ";\n";
     }
 };
 
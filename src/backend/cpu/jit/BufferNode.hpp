@@ -13,7 +13,10 @@
 #include <af/defines.h>
 
 #include <mutex>
+#include <sstream>
+#include <string>
 #include <vector>
+#include "HostSource.hpp"
 #include "Node.hpp"
 namespace cpu {
 
@@ -75,6 +78,16 @@ class BufferNode : public TNode<T> {
         }
     }
 
+    common::Node_ptr clone(
+        const std::array<common::Node_ptr, common::Node::kMaxChildren>
+            &children) const final {
+        UNUSED(children);
+        auto node = std::make_shared<BufferNode>();
+        node->setData(m_sptr, m_bytes, m_ptr - m_sptr.get(), m_dims,
+                      m_strides, m_linear_buffer);
+        return node;
+    }
+
     void getInfo(unsigned &len, unsigned &buf_count,
                  unsigned &bytes) const final {
         len++;
@@ -85,38 +98,64 @@ class BufferNode : public TNode<T> {
 
     size_t getBytes() const final { return m_bytes; }
 
+    bool isCompilable() const final { return hostTypeName<T>() != nullptr; }
+
     void genKerName(std::string &kerString,
                     const common::Node_ids &ids) const final {
-        UNUSED(kerString);
-        UNUSED(ids);
+        kerString += "_B";
+        kerString += hostTypeName<T>();
+        kerString += ',';
+        kerString += std::to_string(ids.id);
     }
 
     void genParams(std::stringstream &kerStream, int id,
                    bool is_linear) const final {
-        UNUSED(kerStream);
-        UNUSED(id);
         UNUSED(is_linear);
+        const char *type = hostTypeName<T>();
+        const int arg    = ARGS_PER_NODE * id;
+        kerStream << "const " << type << " *in" << id
+                  << " = *static_cast<const " << type << " *const *>(args["
+                  << arg << "]);\n"
+                  << "const dim_t *dims" << id
+                  << " = static_cast<const dim_t *>(args[" << arg + 1
+                  << "]);\n"
+                  << "const dim_t *strides" << id
+                  << " = static_cast<const dim_t *>(args[" << arg + 2
+                  << "]);\n";
     }
 
     int setArgs(int start_id, bool is_linear,
                 std::function<void(int id, const void *ptr, size_t arg_size)>
                     setArg) const override {
         UNUSED(is_linear);
-        UNUSED(setArg);
-        return start_id++;
+        setArg(start_id, static_cast<const void *>(&m_ptr), sizeof(T *));
+        setArg(start_id + 1, static_cast<const void *>(m_dims),
+               sizeof(m_dims));
+        setArg(start_id + 2, static_cast<const void *>(m_strides),
+               sizeof(m_strides));
+        return start_id + ARGS_PER_NODE;
     }
 
     void genOffsets(std::stringstream &kerStream, int id,
                     bool is_linear) const final {
-        UNUSED(kerStream);
-        UNUSED(id);
-        UNUSED(is_linear);
+        kerStream << "const dim_t idx" << id << " = ";
+        if (is_linear) {
+            kerStream << "idx;\n";
+        } else {
+            // Dimensions of size one are broadcast like in calc
+            const std::string d = "dims" + std::to_string(id);
+            const std::string s = "strides" + std::to_string(id);
+            kerStream << "(w < " << d << "[3]) * w * " << s << "[3] + "
+                      << "(z < " << d << "[2]) * z * " << s << "[2] + "
+                      << "(y < " << d << "[1]) * y * " << s << "[1] + "
+                      << "(x < " << d << "[0] ? x : 0);\n";
+        }
     }
 
     void genFuncs(std::stringstream &kerStream,
                   const common::Node_ids &ids) const final {
-        UNUSED(kerStream);
-        UNUSED(ids);
+        kerStream << hostTypeName<T>() << " val" << ids.id << " = in"
+                  << ids.id << "[idx" << ids.id << "];\n";
     }
 
     bool isLinear(dim_t *dims) const final {
@@ -0,0 +1,199 @@
+/*******************************************************
+ * Copyright (c) 2026, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <common/defines.hpp>
+#include <af/defines.h>
+
+#include <array>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "HostSource.hpp"
+#include "Node.hpp"
+
+namespace cpu {
+
+namespace jit {
+
+/// The offsets into the input of the elements that an index operation
+/// selects along each dimension
+using GatherOffsets = std::array<std::vector<dim_t>, 4>;
+
+/// Reads the elements of a buffer selected by sequences and index arrays.
+///
+/// The node takes the place of the copy that index would create, so the
+/// operations that use the indexed array read the input directly. The
+/// offsets along each dimension are looked up in tables that are filled on
+/// the queue before the tree is evaluated.
+template<typename T>
+class GatherNode : public TNode<T> {
+   protected:
+    std::shared_ptr<T> m_sptr;
+    const T *m_ptr;
+    unsigned m_bytes;
+    std::shared_ptr<const GatherOffsets> m_offsets;
+    std::array<const dim_t *, 4> m_tables;
+    dim_t m_dims[4];
+    /// Set if the first dimension is a contiguous range of the input that
+    /// starts at m_base0
+    bool m_contiguous0;
+    dim_t m_base0;
+
+   public:
+    /// \param[in] data        The buffer of the input
+    /// \param[in] ptr         The first element of the input in \p data
+    /// \param[in] bytes       The size of \p data in bytes
+    /// \param[in] offsets     The offset tables. They must have the sizes of
+    ///                        \p dims already, only their contents may be
+    ///                        written after the node is created.
+    /// \param[in] dims        The dimensions of the gathered array
+    /// \param[in] contiguous0 True if the offsets along the first dimension
+    ///                        are \p base0 + i
+    /// \param[in] base0       The offset of the first element along the
+    ///                        first dimension
+    GatherNode(std::shared_ptr<T> data, const T *ptr, unsigned bytes,
+               std::shared_ptr<const GatherOffsets> offsets,
+               const dim_t *dims, bool contiguous0, dim_t base0)
+        : TNode<T>(T(0), 0, {})
+        , m_sptr(data)
+        , m_ptr(ptr)
+        , m_bytes(bytes)
+        , m_offsets(offsets)
+        , m_contiguous0(contiguous0)
+        , m_base0(base0) {
+        for (int i = 0; i < 4; i++) {
+            m_tables[i] = (*m_offsets)[i].data();
+            m_dims[i]   = dims[i];
+        }
+    }
+
+    void calc(int x, int y, int z, int w, int lim) final {
+        using Tc = compute_t<T>;
+
+        // Dimensions of size one are broadcast like in BufferNode
+        dim_t l_off = 0;
+        l_off += m_tables[3][(w < (int)m_dims[3]) ? w : 0];
+        l_off += m_tables[2][(z < (int)m_dims[2]) ? z : 0];
+        l_off += m_tables[1][(y < (int)m_dims[1]) ? y : 0];
+        const T *in_ptr = m_ptr + l_off;
+        Tc *out_ptr     = this->m_val.data();
+        if (m_contiguous0 && x + lim <= m_dims[0]) {
+            in_ptr += m_base0 + x;
+            for (int i = 0; i < lim; i++) {
+                out_ptr[i] = static_cast<Tc>(in_ptr[i]);
+            }
+        } else {
+            const dim_t *off0 = m_tables[0];
+            for (int i = 0; i < lim; i++) {
+                out_ptr[i] = static_cast<Tc>(
+                    in_ptr[off0[((x + i) < m_dims[0]) ? (x + i) : 0]]);
+            }
+        }
+    }
+
+    void calc(int idx, int lim) final {
+        // Trees with gather nodes are never linear. The element is located
+        // from its linear index for completeness.
+        using Tc = compute_t<T>;
+
+        Tc *out_ptr = this->m_val.data();
+        for (int i = 0; i < lim; i++) {
+            dim_t rest   = idx + i;
+            dim_t offset = 0;
+            for (int d = 0; d < 4; d++) {
+                offset += m_tables[d][rest % m_dims[d]];
+                rest /= m_dims[d];
+            }
+            out_ptr[i] = static_cast<Tc>(m_ptr[offset]);
+        }
+    }
+
+    common::Node_ptr clone(
+        const std::array<common::Node_ptr, common::Node::kMaxChildren>
+            &children) const final {
+        UNUSED(children);
+        return std::make_shared<GatherNode>(*this);
+    }
+
+    void getInfo(unsigned &len, unsigned &buf_count,
+                 unsigned &bytes) const final {
+        len++;
+        buf_count++;
+        bytes += m_bytes;
+    }
+
+    size_t getBytes() const final { return m_bytes; }
+
+    bool isCompilable() const final { return hostTypeName<T>() != nullptr; }
+
+    void genKerName(std::string &kerString,
+                    const common::Node_ids &ids) const final {
+        kerString += "_G";
+        kerString += hostTypeName<T>();
+        kerString += ',';
+        kerString += std::to_string(ids.id);
+    }
+
+    void genParams(std::stringstream &kerStream, int id,
+                   bool is_linear) const final {
+        UNUSED(is_linear);
+        const char *type = hostTypeName<T>();
+        const int arg    = ARGS_PER_NODE * id;
+        kerStream << "const " << type << " *in" << id
+                  << " = *static_cast<const " << type << " *const *>(args["
+                  << arg << "]);\n"
+                  << "const dim_t *const *offs" << id
+                  << " = static_cast<const dim_t *const *>(args[" << arg + 1
+                  << "]);\n"
+                  << "const dim_t *dims" << id
+                  << " = static_cast<const dim_t *>(args[" << arg + 2
+                  << "]);\n";
+    }
+
+    int setArgs(int start_id, bool is_linear,
+                std::function<void(int id, const void *ptr, size_t arg_size)>
+                    setArg) const override {
+        UNUSED(is_linear);
+        setArg(start_id, static_cast<const void *>(&m_ptr), sizeof(T *));
+        setArg(start_id + 1, static_cast<const void *>(m_tables.data()),
+               sizeof(m_tables));
+        setArg(start_id + 2, static_cast<const void *>(m_dims),
+               sizeof(m_dims));
+        return start_id + ARGS_PER_NODE;
+    }
+
+    void genOffsets(std::stringstream &kerStream, int id,
+                    bool is_linear) const final {
+        UNUSED(is_linear);
+        const std::string o = "offs" + std::to_string(id);
+        const std::string d = "dims" + std::to_string(id);
+        kerStream << "const dim_t idx" << id << " = " << o << "[3][w < " << d
+                  << "[3] ? w : 0] + " << o << "[2][z < " << d
+                  << "[2] ? z : 0] + " << o << "[1][y < " << d
+                  << "[1] ? y : 0] + " << o << "[0][x < " << d
+                  << "[0] ? x : 0];\n";
+    }
+
+    void genFuncs(std::stringstream &kerStream,
+                  const common::Node_ids &ids) const final {
+        kerStream << hostTypeName<T>() << " val" << ids.id << " = in"
+                  << ids.id << "[idx" << ids.id << "];\n";
+    }
+
+    bool isLinear(dim_t *dims) const final {
+        UNUSED(dims);
+        return false;
+    }
+};
+
+}  // namespace jit
+}  // namespace cpu
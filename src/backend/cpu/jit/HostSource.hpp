@@ -0,0 +1,140 @@
+/*******************************************************
+ * Copyright (c) 2026, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+/// Helpers used by the CPU JIT nodes to generate the C++ source of the
+/// compiled JIT engine. See getCompiledKernel in jit.hpp.
+#pragma once
+
+#include <optypes.hpp>
+#include <types.hpp>
+
+#include <sstream>
+
+namespace cpu {
+namespace jit {
+
+/// Number of kernel argument slots reserved for each node of the tree.
+///
+/// The compiled kernels receive their arguments as an array of pointers. The
+/// arguments of the node with id N start at index ARGS_PER_NODE * N.
+constexpr int ARGS_PER_NODE = 3;
+
+/// Returns the name of \p T in the generated source or nullptr if the type
+/// is not supported by the compiled engine
+template<typename T>
+inline const char *hostTypeName() {
+    return nullptr;
+}
+
+#define HOST_TYPE_NAME(T, NAME)            \
+    template<>                             \
+    inline const char *hostTypeName<T>() { \
+        return NAME;                       \
+    }
+
+HOST_TYPE_NAME(float, "float")
+HOST_TYPE_NAME(double, "double")
+HOST_TYPE_NAME(int, "int")
+HOST_TYPE_NAME(uint, "unsigned int")
+HOST_TYPE_NAME(intl, "long long")
+HOST_TYPE_NAME(uintl, "unsigned long long")
+HOST_TYPE_NAME(short, "short")
+HOST_TYPE_NAME(ushort, "unsigned short")
+HOST_TYPE_NAME(char, "char")
+HOST_TYPE_NAME(uchar, "unsigned char")
+
+#undef HOST_TYPE_NAME
+
+/// Describes how an operation is written in the generated source
+struct OpSource {
+    /// The operator or the name of the function. nullptr if the operation is
+    /// not supported by the compiled engine.
+    const char *str;
+    /// True if str is an operator placed between/before the operands, false
+    /// if it is a function called with the operands.
+    bool infix;
+};
+
+/// Returns the source of the binary operations used by cpu::BinOp
+inline OpSource binaryOpSource(af_op_t op) {
+    switch (op) {
+        case af_add_t: return {"+", true};
+        case af_sub_t: return {"-", true};
+        case af_mul_t: return {"*", true};
+        case af_div_t: return {"/", true};
+        case af_eq_t: return {"==", true};
+        case af_neq_t: return {"!=", true};
+        case af_lt_t: return {"<", true};
+        case af_gt_t: return {">", true};
+        case af_le_t: return {"<=", true};
+        case af_ge_t: return {">=", true};
+        case af_and_t: return {"&&", true};
+        case af_or_t: return {"||", true};
+        case af_bitor_t: return {"|", true};
+        case af_bitand_t: return {"&", true};
+        case af_bitxor_t: return {"^", true};
+        case af_bitshiftl_t: return {"<<", true};
+        case af_bitshiftr_t: return {">>", true};
+        case af_max_t: return {"std::max", false};
+        case af_min_t: return {"std::min", false};
+        case af_mod_t: return {"__mod", false};
+        case af_rem_t: return {"__rem", false};
+        case af_pow_t: return {"std::pow", false};
+        case af_atan2_t: return {"std::atan2", false};
+        case af_hypot_t: return {"std::hypot", false};
+        default: return {nullptr, false};
+    }
+}
+
+/// Returns the source of the unary operations used by cpu::UnOp. Casts are
+/// handled by the UnaryNode because they depend on the output type.
+inline OpSource unaryOpSource(af_op_t op) {
+    switch (op) {
+        case af_sin_t: return {"__sin", false};
+        case af_cos_t: return {"__cos", false};
+        case af_tan_t: return {"std::tan", false};
+        case af_asin_t: return {"std::asin", false};
+        case af_acos_t: return {"std::acos", false};
+        case af_atan_t: return {"std::atan", false};
+        case af_sinh_t: return {"std::sinh", false};
+        case af_cosh_t: return {"std::cosh", false};
+        case af_tanh_t: return {"__tanh", false};
+        case af_asinh_t: return {"std::asinh", false};
+        case af_acosh_t: return {"std::acosh", false};
+        case af_atanh_t: return {"std::atanh", false};
+        case af_round_t: return {"std::round", false};
+        case af_trunc_t: return {"std::trunc", false};
+        case af_signbit_t: return {"std::signbit", false};
+        case af_floor_t: return {"std::floor", false};
+        case af_ceil_t: return {"std::ceil", false};
+        case af_exp_t: return {"__exp", false};
+        case af_sigmoid_t: return {"__sigmoid", false};
+        case af_expm1_t: return {"std::expm1", false};
+        case af_erf_t: return {"std::erf", false};
+        case af_erfc_t: return {"std::erfc", false};
+        case af_log_t: return {"__log", false};
+        case af_log10_t: return {"std::log10", false};
+        case af_log1p_t: return {"std::log1p", false};
+        case af_log2_t: return {"std::log2", false};
+        case af_sqrt_t: return {"std::sqrt", false};
+        case af_rsqrt_t: return {"__rsqrt", false};
+        case af_cbrt_t: return {"std::cbrt", false};
+        case af_tgamma_t: return {"std::tgamma", false};
+        case af_lgamma_t: return {"std::lgamma", false};
+        case af_noop_t: return {"", false};
+        case af_bitnot_t: return {"~", true};
+        case af_isinf_t: return {"std::isinf", false};
+        case af_isnan_t: return {"std::isnan", false};
+        case af_iszero_t: return {"__iszero", false};
+        default: return {nullptr, false};
+    }
+}
+
+}  // namespace jit
+}  // namespace cpu
@@ -9,7 +9,10 @@
 
 #pragma once
 #include <optypes.hpp>
+#include <sstream>
+#include <string>
 #include <vector>
+#include "HostSource.hpp"
 #include "Node.hpp"
 
 namespace cpu {
@@ -21,25 +24,39 @@ class ScalarNode : public TNode<T> {
    public:
     ScalarNode(T val) : TNode<T>(val, 0, {}) {}
 
+    common::Node_ptr clone(
+        const std::array<common::Node_ptr, common::Node::kMaxChildren>
+            &children) const final {
+        UNUSED(children);
+        return std::make_shared<ScalarNode>(*this);
+    }
+
+    bool isCompilable() const final { return hostTypeName<T>() != nullptr; }
+
     void genKerName(std::string &kerString,
                     const common::Node_ids &ids) const final {
-        UNUSED(kerString);
-        UNUSED(ids);
+        kerString += "_S";
+        kerString += hostTypeName<T>();
+        kerString += ',';
+        kerString += std::to_string(ids.id);
     }
 
     void genParams(std::stringstream &kerStream, int id,
                    bool is_linear) const final {
-        UNUSED(kerStream);
-        UNUSED(id);
         UNUSED(is_linear);
+        const char *type = hostTypeName<T>();
+        kerStream << "const " << type << " scalar" << id
+                  << " = *static_cast<const " << type << " *>(args["
+                  << ARGS_PER_NODE * id << "]);\n";
     }
 
     int setArgs(int start_id, bool is_linear,
                 std::function<void(int id, const void *ptr, size_t arg_size)>
                     setArg) const override {
         UNUSED(is_linear);
-        UNUSED(setArg);
-        return start_id++;
+        setArg(start_id, static_cast<const void *>(this->m_val.data()),
+               sizeof(T));
+        return start_id + ARGS_PER_NODE;
     }
 
     void genOffsets(std::stringstream &kerStream, int id,
@@ -51,8 +68,8 @@ class ScalarNode : public TNode<T> {
 
     void genFuncs(std::stringstream &kerStream,
                   const common::Node_ids &ids) const final {
-        UNUSED(kerStream);
-        UNUSED(ids);
+        kerStream << hostTypeName<T>() << " val" << ids.id << " = scalar"
+                  << ids.id << ";\n";
     }
 };
 }  // namespace jit
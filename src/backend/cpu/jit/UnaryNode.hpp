@@ -11,8 +11,12 @@
 #include <math.hpp>
 #include <optypes.hpp>
 #include <types.hpp>
+#include "HostSource.hpp"
 #include "Node.hpp"
 
+#include <sstream>
+#include <string>
+#include <type_traits>
 #include <vector>
 
 namespace cpu {
@@ -48,16 +52,46 @@ class UnaryNode : public TNode<To> {
         m_op.eval(TNode<To>::m_val, m_child->m_val, lim);
     }
 
+    common::Node_ptr clone(
+        const std::array<common::Node_ptr, common::Node::kMaxChildren>
+            &children) const final {
+        return std::make_shared<UnaryNode>(children[0]);
+    }
+
+    bool isCompilable() const final {
+        if (hostTypeName<To>() == nullptr || hostTypeName<Ti>() == nullptr) {
+            return false;
+        }
+        // std::abs is ambiguous for unsigned types
+        if (op == af_abs_t) { return std::is_signed<Ti>::value; }
+        return op == af_cast_t || unaryOpSource(op).str != nullptr;
+    }
+
     void genKerName(std::string &kerString,
                     const common::Node_ids &ids) const final {
-        UNUSED(kerString);
-        UNUSED(ids);
+        kerString += "_U";
+        kerString += std::to_string(op);
+        kerString += ',';
+        kerString += hostTypeName<To>();
+        kerString += ',';
+        kerString += hostTypeName<Ti>();
+        kerString += ',';
+        kerString += std::to_string(ids.child_ids[0]);
+        kerString += ',';
+        kerString += std::to_string(ids.id);
     }
 
     void genFuncs(std::stringstream &kerStream,
                   const common::Node_ids &ids) const final {
-        UNUSED(kerStream);
-        UNUSED(ids);
+        kerStream << hostTypeName<To>() << " val" << ids.id << " = ";
+        if (op == af_cast_t) {
+            kerStream << "static_cast<" << hostTypeName<To>() << ">";
+        } else if (op == af_abs_t) {
+            kerStream << "std::abs";
+        } else {
+            kerStream << unaryOpSource(op).str;
+        }
+        kerStream << "(val" << ids.child_ids[0] << ");\n";
     }
 };
 
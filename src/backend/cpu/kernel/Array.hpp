@@ -9,13 +9,45 @@
 
 #pragma once
 #include <Param.hpp>
+#include <common/dispatch.hpp>
+#include <jit.hpp>
+#include <jit/HostSource.hpp>
 #include <jit/Node.hpp>
+#include <parallel.hpp>
 #include <platform.hpp>
+
+#include <algorithm>
+#include <array>
 #include <vector>
 
 namespace cpu {
 namespace kernel {
 
+/// Creates copies of the nodes in \p full_nodes that are linked to each other
+/// the same way as the originals. Each copy owns its own m_val buffer so the
+/// copied tree can be evaluated concurrently with the original tree.
+///
+/// \param[in] full_nodes The nodes of the tree with children before parents
+/// \param[in] ids        The ids of the nodes in \p full_nodes and of their
+///                       children
+/// \returns the copies in the same order as \p full_nodes
+inline std::vector<common::Node_ptr> cloneNodes(
+    const std::vector<common::Node *> &full_nodes,
+    const std::vector<common::Node_ids> &ids) {
+    std::vector<common::Node_ptr> clones;
+    clones.reserve(full_nodes.size());
+    for (size_t n = 0; n < full_nodes.size(); n++) {
+        // Only the real children are copied. The ids of the unused slots are
+        // zero and may refer to a node which isn't copied yet.
+        std::array<common::Node_ptr, common::Node::kMaxChildren> children;
+        for (int c = 0; c < full_nodes[n]->getNumChildren(); c++) {
+            children[c] = clones[ids[n].child_ids[c]];
+        }
+        clones.push_back(full_nodes[n]->clone(children));
+    }
+    return clones;
+}
+
 template<typename T>
 void evalMultiple(std::vector<Param<T>> arrays,
                   std::vector<common::Node_ptr> output_nodes_) {
@@ -24,65 +56,105 @@ void evalMultiple(std::vector<Param<T>> arrays,
 
     common::Node_map_t nodes;
     std::vector<T *> ptrs;
-    std::vector<TNode<T> *> output_nodes;
     std::vector<common::Node *> full_nodes;
     std::vector<common::Node_ids> ids;
+    std::vector<int> output_ids;
 
     int narrays = static_cast<int>(arrays.size());
     for (int i = 0; i < narrays; i++) {
         ptrs.push_back(arrays[i].get());
-        output_nodes.push_back(
-            reinterpret_cast<TNode<T> *>(output_nodes_[i].get()));
-        output_nodes_[i]->getNodesMap(nodes, full_nodes, ids);
+        output_ids.push_back(
+            output_nodes_[i]->getNodesMap(nodes, full_nodes, ids));
     }
 
     bool is_linear = true;
     for (auto node : full_nodes) { is_linear &= node->isLinear(odims.get()); }
 
-    if (is_linear) {
-        int num = arrays[0].dims().elements();
-        int cnum =
-            jit::VECTOR_LENGTH * std::ceil(double(num) / jit::VECTOR_LENGTH);
-        for (int i = 0; i < cnum; i += jit::VECTOR_LENGTH) {
-            int lim = std::min(jit::VECTOR_LENGTH, num - i);
-            for (int n = 0; n < (int)full_nodes.size(); n++) {
-                full_nodes[n]->calc(i, lim);
-            }
-            for (int n = 0; n < (int)output_nodes.size(); n++) {
-                std::copy(output_nodes[n]->m_val.begin(),
-                          output_nodes[n]->m_val.begin() + lim, ptrs[n] + i);
+    // Splitting the work is only worth it when every thread gets a few
+    // thousand elements. Otherwise handing out the work and copying the tree
+    // costs more than the evaluation.
+    constexpr dim_t CHUNKS_PER_BLOCK = 64;
+
+    // The output is processed in chunks of VECTOR_LENGTH elements along the
+    // first dimension. The linear case treats the whole output as one row.
+    const int dim0       = static_cast<int>(is_linear ? odims.elements()
+                                                      : odims[0]);
+    const dim_t nchunks0 = divup(dim0, jit::VECTOR_LENGTH);
+    const dim_t nrows    = is_linear ? 1 : odims[1] * odims[2] * odims[3];
+
+    jit::CompiledKernel compiled = nullptr;
+    if (jit::isCompiledJITEnabled() && jit::hostTypeName<T>() != nullptr) {
+        compiled = jit::getCompiledKernel(full_nodes, ids, output_ids,
+                                          jit::hostTypeName<T>(), is_linear);
+    }
+
+    if (compiled) {
+        std::vector<void *> args(jit::ARGS_PER_NODE * full_nodes.size() +
+                                 narrays);
+        for (size_t n = 0; n < full_nodes.size(); n++) {
+            full_nodes[n]->setArgs(
+                jit::ARGS_PER_NODE * static_cast<int>(n), is_linear,
+                [&](int id, const void *ptr, size_t arg_size) {
+                    UNUSED(arg_size);
+                    args[id] = const_cast<void *>(ptr);
+                });
+        }
+        for (int n = 0; n < narrays; n++) {
+            args[jit::ARGS_PER_NODE * full_nodes.size() + n] = &ptrs[n];
+        }
+
+        // The linear kernels work on elements, the general kernels on rows
+        const dim_t work = is_linear ? dim0 : nrows;
+        const dim_t grain = CHUNKS_PER_BLOCK * jit::VECTOR_LENGTH /
+                            (is_linear ? 1 : std::max(dim0, 1));
+        parallel_for(0, work, grain, [&](dim_t begin, dim_t end) {
+            compiled(args.data(), odims.get(), ostrs.get(), begin, end);
+        });
+        return;
+    }
+
+    // Evaluates the chunks [begin, end). A call that covers every chunk runs
+    // on the original nodes, any other call works on a private copy of the
+    // tree.
+    auto evalChunks = [&](dim_t begin, dim_t end) {
+        std::vector<common::Node_ptr> clones;
+        std::vector<common::Node *> tree = full_nodes;
+        if (begin != 0 || end != nchunks0 * nrows) {
+            clones = cloneNodes(full_nodes, ids);
+            for (size_t n = 0; n < tree.size(); n++) {
+                tree[n] = clones[n].get();
             }
         }
-    } else {
-        for (int w = 0; w < (int)odims[3]; w++) {
-            dim_t offw = w * ostrs[3];
-
-            for (int z = 0; z < (int)odims[2]; z++) {
-                dim_t offz = z * ostrs[2] + offw;
-
-                for (int y = 0; y < (int)odims[1]; y++) {
-                    dim_t offy = y * ostrs[1] + offz;
-
-                    int dim0  = odims[0];
-                    int cdim0 = jit::VECTOR_LENGTH *
-                                std::ceil(double(dim0) / jit::VECTOR_LENGTH);
-                    for (int x = 0; x < (int)cdim0; x += jit::VECTOR_LENGTH) {
-                        int lim  = std::min(jit::VECTOR_LENGTH, dim0 - x);
-                        dim_t id = x + offy;
-
-                        for (int n = 0; n < (int)full_nodes.size(); n++) {
-                            full_nodes[n]->calc(x, y, z, w, lim);
-                        }
-                        for (int n = 0; n < (int)output_nodes.size(); n++) {
-                            std::copy(output_nodes[n]->m_val.begin(),
-                                      output_nodes[n]->m_val.begin() + lim,
-                                      ptrs[n] + id);
-                        }
-                    }
-                }
+        std::vector<TNode<T> *> output_nodes;
+        for (int id : output_ids) {
+            output_nodes.push_back(reinterpret_cast<TNode<T> *>(tree[id]));
+        }
+
+        for (dim_t chunk = begin; chunk < end; chunk++) {
+            int x   = static_cast<int>(chunk % nchunks0) * jit::VECTOR_LENGTH;
+            int lim = std::min(jit::VECTOR_LENGTH, dim0 - x);
+            dim_t id;
+
+            if (is_linear) {
+                for (auto node : tree) { node->calc(x, lim); }
+                id = x;
+            } else {
+                dim_t row = chunk / nchunks0;
+                int y     = static_cast<int>(row % odims[1]);
+                int z     = static_cast<int>((row / odims[1]) % odims[2]);
+                int w     = static_cast<int>(row / (odims[1] * odims[2]));
+                for (auto node : tree) { node->calc(x, y, z, w, lim); }
+                id = x + y * ostrs[1] + z * ostrs[2] + w * ostrs[3];
+            }
+
+            for (int n = 0; n < narrays; n++) {
+                std::copy(output_nodes[n]->m_val.begin(),
+                          output_nodes[n]->m_val.begin() + lim, ptrs[n] + id);
             }
         }
-    }
+    };
+
+    parallel_for(0, nchunks0 * nrows, CHUNKS_PER_BLOCK, evalChunks);
 }
 
 template<typename T>
@@ -10,6 +10,7 @@
 #pragma once
 #include <Param.hpp>
 #include <common/ArrayInfo.hpp>
+#include <parallel.hpp>
 #include <types.hpp>
 #include <utility.hpp>
 
@@ -17,11 +18,21 @@
 #include <af/dim4.hpp>
 #include <af/seq.h>
 
+#include <algorithm>
+#include <array>
 #include <vector>
 
 namespace cpu {
 namespace kernel {
 
+/// Scatters \p rhs to the elements of \p out selected by \p seqs and
+/// \p idxArrs.
+///
+/// The destination offsets along every dimension are computed once. Rows
+/// selected by a sequence along the first dimension are copied with memcpy
+/// when they are contiguous and with a strided loop otherwise. The rows are
+/// copied in parallel unless an index array selects them, as an index array
+/// may select a row more than once and the last copy must win.
 template<typename T>
 void assign(Param<T> out, af::dim4 dDims, CParam<T> rhs,
             std::vector<bool> const isSeq, std::vector<af_seq> const seqs,
@@ -33,49 +44,53 @@ void assign(Param<T> out, af::dim4 dDims, CParam<T> rhs,
     // retrieve rhs array dimenesions & strides
     af::dim4 src_dims    = rhs.dims();
     af::dim4 src_strides = rhs.strides();
-    // declare pointers to af_array index data
-    uint const* const ptr0 = idxArrs[0].get();
-    uint const* const ptr1 = idxArrs[1].get();
-    uint const* const ptr2 = idxArrs[2].get();
-    uint const* const ptr3 = idxArrs[3].get();
 
-    const T* src = rhs.get();
-    T* dst       = out.get();
-
-    for (dim_t l = 0; l < src_dims[3]; ++l) {
-        dim_t src_loff = l * src_strides[3];
-
-        dim_t dst_lIdx =
-            trimIndex(isSeq[3] ? l + dst_offsets[3] : ptr3[l], pDims[3]);
-        dim_t dst_loff = dst_lIdx * dst_strides[3];
-
-        for (dim_t k = 0; k < src_dims[2]; ++k) {
-            dim_t src_koff = k * src_strides[2];
-
-            dim_t dst_kIdx =
-                trimIndex(isSeq[2] ? k + dst_offsets[2] : ptr2[k], pDims[2]);
-            dim_t dst_koff = dst_kIdx * dst_strides[2];
-
-            for (dim_t j = 0; j < src_dims[1]; ++j) {
-                dim_t src_joff = j * src_strides[1];
-
-                dim_t dst_jIdx = trimIndex(
-                    isSeq[1] ? j + dst_offsets[1] : ptr1[j], pDims[1]);
-                dim_t dst_joff = dst_jIdx * dst_strides[1];
+    std::array<std::vector<dim_t>, 4> offs;
+    for (int d = 0; d < 4; ++d) {
+        offs[d] = indexOffsets(isSeq[d] ? nullptr : idxArrs[d].get(),
+                               dst_offsets[d], src_dims[d], pDims[d],
+                               dst_strides[d]);
+    }
 
-                for (dim_t i = 0; i < src_dims[0]; ++i) {
-                    dim_t src_ioff = i * src_strides[0];
-                    dim_t src_idx  = src_ioff + src_joff + src_koff + src_loff;
+    // A sequence that stays inside the first dimension selects evenly
+    // spaced elements
+    const dim_t n0      = src_dims[0];
+    const bool affine   = isSeq[0] && dst_offsets[0] + n0 <= pDims[0];
+    const dim_t base0   = dst_offsets[0] * dst_strides[0];
+    const dim_t stride0 = dst_strides[0];
 
-                    dim_t dst_iIdx = trimIndex(
-                        isSeq[0] ? i + dst_offsets[0] : ptr0[i], pDims[0]);
-                    dim_t dst_ioff = dst_iIdx * dst_strides[0];
-                    dim_t dst_idx  = dst_ioff + dst_joff + dst_koff + dst_loff;
+    const T* src = rhs.get();
+    T* dst       = out.get();
 
-                    dst[dst_idx] = src[src_idx];
+    auto copyRows = [&](dim_t first, dim_t last) {
+        for (dim_t row = first; row < last; ++row) {
+            const dim_t j = row % src_dims[1];
+            const dim_t k = (row / src_dims[1]) % src_dims[2];
+            const dim_t l = row / (src_dims[1] * src_dims[2]);
+
+            const T* irow = src + j * src_strides[1] + k * src_strides[2] +
+                            l * src_strides[3];
+            T* orow       = dst + offs[1][j] + offs[2][k] + offs[3][l];
+            if (affine && stride0 == 1 && src_strides[0] == 1) {
+                std::copy(irow, irow + n0, orow + base0);
+            } else if (affine) {
+                for (dim_t i = 0; i < n0; ++i) {
+                    orow[base0 + i * stride0] = irow[i * src_strides[0]];
+                }
+            } else {
+                const dim_t* off0 = offs[0].data();
+                for (dim_t i = 0; i < n0; ++i) {
+                    orow[off0[i]] = irow[i * src_strides[0]];
                 }
             }
         }
+    };
+
+    const dim_t nrows = src_dims[1] * src_dims[2] * src_dims[3];
+    if (isSeq[1] && isSeq[2] && isSeq[3]) {
+        parallel_for(0, nrows, parallelGrain(n0), copyRows);
+    } else {
+        copyRows(0, nrows);
     }
 }
 
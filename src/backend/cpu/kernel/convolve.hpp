@@ -10,29 +10,232 @@
 #pragma once
 #include <Param.hpp>
 #include <math.hpp>
+#include <parallel.hpp>
 #include <af/defines.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <type_traits>
+#include <vector>
+
 namespace cpu {
 namespace kernel {
 
+/// Adds the convolution of \p src with a filter of \p FW coefficients to the
+/// \p n elements of \p acc. Element i of the convolution is the sum of
+/// src[i - w] * coef[w]. The loop over the filter is unrolled so the sums
+/// stay in registers and the loop over the elements is vectorized.
+template<typename T, int FW>
+void convolveLine(T *acc, const T *src, const T *coef, dim_t n) {
+    for (dim_t i = 0; i < n; ++i) {
+        T sum = acc[i];
+        for (int w = 0; w < FW; ++w) { sum += src[i - w] * coef[w]; }
+        acc[i] = sum;
+    }
+}
+
+/// Adds the convolution of \p src with the \p fw coefficients of \p coef to
+/// the \p n elements of \p acc. \p src must be readable from index 1 - fw.
+/// The products are added in the same order for every filter width.
+template<typename T>
+void convolveLine(T *acc, const T *src, const T *coef, dim_t fw, dim_t n) {
+    switch (fw) {
+        case 1: convolveLine<T, 1>(acc, src, coef, n); return;
+        case 3: convolveLine<T, 3>(acc, src, coef, n); return;
+        case 5: convolveLine<T, 5>(acc, src, coef, n); return;
+        case 7: convolveLine<T, 7>(acc, src, coef, n); return;
+        default: break;
+    }
+    for (dim_t w = 0; w < fw; ++w) {
+        const T c       = coef[w];
+        const T *shifts = src - w;
+        for (dim_t i = 0; i < n; ++i) { acc[i] += shifts[i] * c; }
+    }
+}
+
+/// Copies the first \p rank dimensions of \p iptr into a dense buffer of
+/// AccT with fDims[d] - 1 zeros on both sides of every dimension d. The
+/// convolutions read the buffer without checking the borders.
+template<typename InT, typename AccT>
+std::vector<AccT> padSignal(InT const *const iptr, af::dim4 const &sDims,
+                            af::dim4 const &sStrides, af::dim4 const &fDims,
+                            const int rank, af::dim4 &pDims) {
+    af::dim4 halo(0, 0, 0, 0);
+    pDims = af::dim4(1, 1, 1, 1);
+    for (int d = 0; d < rank; ++d) {
+        halo[d]  = fDims[d] - 1;
+        pDims[d] = sDims[d] + 2 * halo[d];
+    }
+
+    std::vector<AccT> pad(pDims.elements(), AccT(0));
+    const dim_t nlines = rank == 1 ? 1 : sDims[1] * (rank > 2 ? sDims[2] : 1);
+    parallel_for(0, nlines, parallelGrain(sDims[0]), [&](dim_t first,
+                                                         dim_t last) {
+        for (dim_t line = first; line < last; ++line) {
+            const dim_t j  = line % sDims[1];
+            const dim_t k  = line / sDims[1];
+            InT const *src = iptr + j * sStrides[1] + k * sStrides[2];
+            AccT *dst      = pad.data() + halo[0] +
+                        ((k + halo[2]) * pDims[1] + j + halo[1]) * pDims[0];
+            for (dim_t i = 0; i < sDims[0]; ++i) {
+                dst[i] = AccT(src[i * sStrides[0]]);
+            }
+        }
+    });
+    return pad;
+}
+
+/// Returns the coefficients of the first \p rank dimensions of the filter
+/// in a dense buffer
+template<typename AccT>
+std::vector<AccT> denseFilter(AccT const *const fptr, af::dim4 const &fDims,
+                              af::dim4 const &fStrides, const int rank) {
+    const dim_t fw = fDims[0];
+    const dim_t fh = rank > 1 ? fDims[1] : 1;
+    const dim_t fd = rank > 2 ? fDims[2] : 1;
+    std::vector<AccT> coef(fw * fh * fd);
+    for (dim_t k = 0; k < fd; ++k) {
+        for (dim_t j = 0; j < fh; ++j) {
+            for (dim_t i = 0; i < fw; ++i) {
+                coef[(k * fh + j) * fw + i] =
+                    fptr[k * fStrides[2] + j * fStrides[1] + i * fStrides[0]];
+            }
+        }
+    }
+    return coef;
+}
+
+/// Convolves a 2D signal with the column filter \p col along dim 0 and then
+/// with the row filter \p row along dim 1. The result of the first pass is
+/// stored as TmpT.
+template<typename InT, typename AccT, typename TmpT>
+void separable_2d(InT *optr, InT const *const iptr,
+                  std::vector<AccT> const &col, std::vector<AccT> const &row,
+                  af::dim4 const &sDims, af::dim4 const &oStrides,
+                  af::dim4 const &sStrides, const bool expand) {
+    const dim_t cl = static_cast<dim_t>(col.size());
+    const dim_t rl = static_cast<dim_t>(row.size());
+    const dim_t n0 = expand ? sDims[0] + cl - 1 : sDims[0];
+    const dim_t n1 = expand ? sDims[1] + rl - 1 : sDims[1];
+    const dim_t i0 = expand ? 0 : cl / 2;
+    const dim_t j0 = expand ? 0 : rl / 2;
+
+    // Columns of the signal convolved with col
+    std::vector<TmpT> tmp(n0 * sDims[1]);
+    parallel_for(0, sDims[1], parallelGrain(n0 * cl), [&](dim_t first,
+                                                          dim_t last) {
+        std::vector<AccT> line(sDims[0] + 2 * (cl - 1), AccT(0));
+        std::vector<AccT> acc(n0);
+        for (dim_t j = first; j < last; ++j) {
+            InT const *src = iptr + j * sStrides[1];
+            for (dim_t i = 0; i < sDims[0]; ++i) {
+                line[cl - 1 + i] = AccT(src[i * sStrides[0]]);
+            }
+            std::fill(acc.begin(), acc.end(), AccT(0));
+            convolveLine(acc.data(), line.data() + cl - 1 + i0, col.data(),
+                         cl, n0);
+            for (dim_t i = 0; i < n0; ++i) { tmp[j * n0 + i] = TmpT(acc[i]); }
+        }
+    });
+
+    parallel_for(0, n1, parallelGrain(n0 * rl), [&](dim_t first, dim_t last) {
+        std::vector<AccT> acc(n0);
+        for (dim_t j = first; j < last; ++j) {
+            std::fill(acc.begin(), acc.end(), AccT(0));
+            for (dim_t w = 0; w < rl; ++w) {
+                const dim_t q = j + j0 - w;
+                if (q < 0 || q >= sDims[1]) { continue; }
+                const AccT c    = row[w];
+                TmpT const *src = tmp.data() + q * n0;
+                for (dim_t i = 0; i < n0; ++i) { acc[i] += AccT(src[i]) * c; }
+            }
+            InT *dst = optr + j * oStrides[1];
+            for (dim_t i = 0; i < n0; ++i) { dst[i] = InT(acc[i]); }
+        }
+    });
+}
+
+/// Factors the \p fw x \p fh filter \p coef into a column and a row filter
+/// whose outer product reproduces every coefficient exactly. Returns false
+/// if the filter is not separable.
+///
+/// Filters of whole numbers are factored into whole numbers so the
+/// convolution of whole numbers stays exact.
+template<typename AccT>
+typename std::enable_if<std::is_floating_point<AccT>::value, bool>::type
+factorFilter(std::vector<AccT> const &coef, const dim_t fw, const dim_t fh,
+             std::vector<AccT> &col, std::vector<AccT> &row) {
+    // The largest coefficient is the pivot
+    dim_t pivot = 0;
+    bool whole  = true;
+    for (dim_t i = 0; i < fw * fh; ++i) {
+        if (std::abs(coef[i]) > std::abs(coef[pivot])) { pivot = i; }
+        whole = whole && coef[i] == std::trunc(coef[i]) &&
+                std::abs(coef[i]) < AccT(1 << 24);
+    }
+    if (coef[pivot] == AccT(0)) { return false; }
+
+    const dim_t pi = pivot % fw;
+    const dim_t pj = pivot / fw;
+    col.resize(fw);
+    row.resize(fh);
+
+    // The column of the pivot divided by the greatest common divisor of its
+    // elements, or by the pivot if the coefficients are not whole numbers
+    AccT scale = coef[pivot];
+    if (whole) {
+        long long divisor = 0;
+        for (dim_t i = 0; i < fw; ++i) {
+            long long b = std::llabs(static_cast<long long>(coef[pj * fw + i]));
+            while (b != 0) {
+                const long long t = divisor % b;
+                divisor           = b;
+                b                 = t;
+            }
+        }
+        scale = AccT(divisor);
+    }
+    for (dim_t i = 0; i < fw; ++i) { col[i] = coef[pj * fw + i] / scale; }
+    for (dim_t j = 0; j < fh; ++j) { row[j] = coef[j * fw + pi] / col[pi]; }
+
+    for (dim_t j = 0; j < fh; ++j) {
+        for (dim_t i = 0; i < fw; ++i) {
+            if (col[i] * row[j] != coef[j * fw + i]) { return false; }
+        }
+    }
+    return true;
+}
+
+template<typename AccT>
+typename std::enable_if<!std::is_floating_point<AccT>::value, bool>::type
+factorFilter(std::vector<AccT> const &, const dim_t, const dim_t,
+             std::vector<AccT> &, std::vector<AccT> &) {
+    return false;
+}
+
 template<typename InT, typename AccT>
 void one2one_1d(InT *optr, InT const *const iptr, AccT const *const fptr,
                 af::dim4 const &oDims, af::dim4 const &sDims,
                 af::dim4 const &fDims, af::dim4 const &sStrides,
-                const bool expand) {
-    dim_t start = (expand ? 0 : fDims[0] / 2);
-    dim_t end   = (expand ? oDims[0] : start + sDims[0]);
-    for (dim_t i = start; i < end; ++i) {
-        AccT accum = 0.0;
-        for (dim_t f = 0; f < fDims[0]; ++f) {
-            dim_t iIdx = i - f;
-            InT s_val =
-                ((iIdx >= 0 && iIdx < sDims[0]) ? iptr[iIdx * sStrides[0]]
-                                                : InT(0));
-            accum += AccT(s_val * fptr[f]);
+                af::dim4 const &fStrides, const bool expand) {
+    const dim_t fw    = fDims[0];
+    const dim_t start = expand ? 0 : fw / 2;
+    const dim_t n     = expand ? oDims[0] : sDims[0];
+
+    af::dim4 pDims;
+    const std::vector<AccT> pad =
+        padSignal<InT, AccT>(iptr, sDims, sStrides, fDims, 1, pDims);
+    const std::vector<AccT> coef = denseFilter(fptr, fDims, fStrides, 1);
+
+    parallel_for(0, n, parallelGrain(fw), [&](dim_t first, dim_t last) {
+        std::vector<AccT> acc(last - first, AccT(0));
+        convolveLine(acc.data(), pad.data() + fw - 1 + start + first,
+                     coef.data(), fw, last - first);
+        for (dim_t i = first; i < last; ++i) {
+            optr[i] = InT(acc[i - first]);
         }
-        optr[i - start] = InT(accum);
-    }
+    });
 }
 
 template<typename InT, typename AccT>
@@ -41,36 +244,45 @@ void one2one_2d(InT *optr, InT const *const iptr, AccT const *const fptr,
                 af::dim4 const &fDims, af::dim4 const &oStrides,
                 af::dim4 const &sStrides, af::dim4 const &fStrides,
                 const bool expand) {
-    dim_t jStart = (expand ? 0 : fDims[1] / 2);
-    dim_t jEnd   = (expand ? oDims[1] : jStart + sDims[1]);
-    dim_t iStart = (expand ? 0 : fDims[0] / 2);
-    dim_t iEnd   = (expand ? oDims[0] : iStart + sDims[0]);
-
-    for (dim_t j = jStart; j < jEnd; ++j) {
-        dim_t joff = (j - jStart) * oStrides[1];
-
-        for (dim_t i = iStart; i < iEnd; ++i) {
-            AccT accum = AccT(0);
-            for (dim_t wj = 0; wj < fDims[1]; ++wj) {
-                dim_t jIdx    = j - wj;
-                dim_t w_joff  = wj * fStrides[1];
-                dim_t s_joff  = jIdx * sStrides[1];
-                bool isJValid = (jIdx >= 0 && jIdx < sDims[1]);
-
-                for (dim_t wi = 0; wi < fDims[0]; ++wi) {
-                    dim_t iIdx = i - wi;
-
-                    InT s_val = InT(0);
-                    if (isJValid && (iIdx >= 0 && iIdx < sDims[0])) {
-                        s_val = iptr[s_joff + iIdx * sStrides[0]];
-                    }
-
-                    accum += AccT(s_val * fptr[w_joff + wi * fStrides[0]]);
-                }
+    const dim_t fw               = fDims[0];
+    const dim_t fh               = fDims[1];
+    const std::vector<AccT> coef = denseFilter(fptr, fDims, fStrides, 2);
+
+    // Separable floating point filters are applied as two 1D filters when
+    // that takes fewer operations. Rounding the first pass to an integer
+    // type would change the results so other types always take the direct
+    // path.
+    std::vector<AccT> col, row;
+    if (std::is_same<InT, AccT>::value && fw * fh > 2 * (fw + fh) &&
+        factorFilter(coef, fw, fh, col, row)) {
+        separable_2d<InT, AccT, AccT>(optr, iptr, col, row, sDims, oStrides,
+                                      sStrides, expand);
+        return;
+    }
+
+    const dim_t iStart = expand ? 0 : fw / 2;
+    const dim_t jStart = expand ? 0 : fh / 2;
+    const dim_t n0     = expand ? oDims[0] : sDims[0];
+    const dim_t n1     = expand ? oDims[1] : sDims[1];
+
+    af::dim4 pDims;
+    const std::vector<AccT> pad =
+        padSignal<InT, AccT>(iptr, sDims, sStrides, fDims, 2, pDims);
+
+    const dim_t grain = parallelGrain(n0 * fw * fh);
+    parallel_for(0, n1, grain, [&](dim_t first, dim_t last) {
+        std::vector<AccT> acc(n0);
+        for (dim_t j = first; j < last; ++j) {
+            std::fill(acc.begin(), acc.end(), AccT(0));
+            for (dim_t wj = 0; wj < fh; ++wj) {
+                const AccT *src = pad.data() + fw - 1 + iStart +
+                                  (j + jStart + fh - 1 - wj) * pDims[0];
+                convolveLine(acc.data(), src, coef.data() + wj * fw, fw, n0);
             }
-            optr[joff + i - iStart] = InT(accum);
+            InT *dst = optr + j * oStrides[1];
+            for (dim_t i = 0; i < n0; ++i) { dst[i] = InT(acc[i]); }
         }
-    }
+    });
 }
 
 template<typename InT, typename AccT>
@@ -79,53 +291,42 @@ void one2one_3d(InT *optr, InT const *const iptr, AccT const *const fptr,
                 af::dim4 const &fDims, af::dim4 const &oStrides,
                 af::dim4 const &sStrides, af::dim4 const &fStrides,
                 const bool expand) {
-    dim_t kStart = (expand ? 0 : fDims[2] / 2);
-    dim_t kEnd   = (expand ? oDims[2] : kStart + sDims[2]);
-    dim_t jStart = (expand ? 0 : fDims[1] / 2);
-    dim_t jEnd   = (expand ? oDims[1] : jStart + sDims[1]);
-    dim_t iStart = (expand ? 0 : fDims[0] / 2);
-    dim_t iEnd   = (expand ? oDims[0] : iStart + sDims[0]);
-
-    for (dim_t k = kStart; k < kEnd; ++k) {
-        dim_t koff = (k - kStart) * oStrides[2];
-
-        for (dim_t j = jStart; j < jEnd; ++j) {
-            dim_t joff = (j - jStart) * oStrides[1];
-
-            for (dim_t i = iStart; i < iEnd; ++i) {
-                AccT accum = AccT(0);
-                for (dim_t wk = 0; wk < fDims[2]; ++wk) {
-                    dim_t kIdx    = k - wk;
-                    dim_t w_koff  = wk * fStrides[2];
-                    dim_t s_koff  = kIdx * sStrides[2];
-                    bool isKValid = (kIdx >= 0 && kIdx < sDims[2]);
-
-                    for (dim_t wj = 0; wj < fDims[1]; ++wj) {
-                        dim_t jIdx    = j - wj;
-                        dim_t w_joff  = wj * fStrides[1];
-                        dim_t s_joff  = jIdx * sStrides[1];
-                        bool isJValid = (jIdx >= 0 && jIdx < sDims[1]);
-
-                        for (dim_t wi = 0; wi < fDims[0]; ++wi) {
-                            dim_t iIdx = i - wi;
-
-                            InT s_val = InT(0);
-                            if (isKValid && isJValid &&
-                                (iIdx >= 0 && iIdx < sDims[0])) {
-                                s_val =
-                                    iptr[s_koff + s_joff + iIdx * sStrides[0]];
-                            }
-
-                            accum +=
-                                AccT(s_val *
-                                     fptr[w_koff + w_joff + wi * fStrides[0]]);
-                        }
-                    }
+    const dim_t fw     = fDims[0];
+    const dim_t fh     = fDims[1];
+    const dim_t fd     = fDims[2];
+    const dim_t iStart = expand ? 0 : fw / 2;
+    const dim_t jStart = expand ? 0 : fh / 2;
+    const dim_t kStart = expand ? 0 : fd / 2;
+    const dim_t n0     = expand ? oDims[0] : sDims[0];
+    const dim_t n1     = expand ? oDims[1] : sDims[1];
+    const dim_t n2     = expand ? oDims[2] : sDims[2];
+
+    af::dim4 pDims;
+    const std::vector<AccT> pad =
+        padSignal<InT, AccT>(iptr, sDims, sStrides, fDims, 3, pDims);
+    const std::vector<AccT> coef = denseFilter(fptr, fDims, fStrides, 3);
+
+    const dim_t grain = parallelGrain(n0 * fw * fh * fd);
+    parallel_for(0, n1 * n2, grain, [&](dim_t first, dim_t last) {
+        std::vector<AccT> acc(n0);
+        for (dim_t line = first; line < last; ++line) {
+            const dim_t j = line % n1;
+            const dim_t k = line / n1;
+            std::fill(acc.begin(), acc.end(), AccT(0));
+            for (dim_t wk = 0; wk < fd; ++wk) {
+                const dim_t pk = k + kStart + fd - 1 - wk;
+                for (dim_t wj = 0; wj < fh; ++wj) {
+                    const dim_t pj = j + jStart + fh - 1 - wj;
+                    const AccT *src = pad.data() + fw - 1 + iStart +
+                                      (pk * pDims[1] + pj) * pDims[0];
+                    convolveLine(acc.data(), src,
+                                 coef.data() + (wk * fh + wj) * fw, fw, n0);
                 }
-                optr[koff + joff + i - iStart] = InT(accum);
-            }  // i loop ends here
-        }      // j loop ends here
-    }          // k loop ends here
+            }
+            InT *dst = optr + j * oStrides[1] + k * oStrides[2];
+            for (dim_t i = 0; i < n0; ++i) { dst[i] = InT(acc[i]); }
+        }
+    });
 }
 
 template<typename InT, typename AccT>
@@ -178,113 +379,81 @@ void convolve_nd(Param<InT> out, CParam<InT> signal, CParam<AccT> filter,
         }
     }
 
-    for (dim_t b3 = 0; b3 < batch[3]; ++b3) {
-        for (dim_t b2 = 0; b2 < batch[2]; ++b2) {
-            for (dim_t b1 = 0; b1 < batch[1]; ++b1) {
-                InT *out = optr + b1 * out_step[1] + b2 * out_step[2] +
-                           b3 * out_step[3];
-                InT const *in =
-                    iptr + b1 * in_step[1] + b2 * in_step[2] + b3 * in_step[3];
-                AccT const *filt = fptr + b1 * filt_step[1] +
-                                   b2 * filt_step[2] + b3 * filt_step[3];
-
-                switch (rank) {
-                    case 1:
-                        one2one_1d<InT, AccT>(out, in, filt, oDims, sDims,
-                                              fDims, sStrides, expand);
-                        break;
-                    case 2:
-                        one2one_2d<InT, AccT>(out, in, filt, oDims, sDims,
-                                              fDims, oStrides, sStrides,
-                                              fStrides, expand);
-                        break;
-                    case 3:
-                        one2one_3d<InT, AccT>(out, in, filt, oDims, sDims,
-                                              fDims, oStrides, sStrides,
-                                              fStrides, expand);
-                        break;
-                }
-            }
-        }
-    }
-}
-
-template<typename InT, typename AccT, bool Expand, int ConvDim>
-void convolve2_separable(InT *optr, InT const *const iptr,
-                         AccT const *const fptr, af::dim4 const &oDims,
-                         af::dim4 const &sDims, af::dim4 const &orgDims,
-                         dim_t fDim, af::dim4 const &oStrides,
-                         af::dim4 const &sStrides, dim_t fStride) {
-    UNUSED(orgDims);
-    UNUSED(sStrides);
-    UNUSED(fStride);
-    for (dim_t j = 0; j < oDims[1]; ++j) {
-        dim_t jOff = j * oStrides[1];
-        dim_t cj   = j + (ConvDim == 1) * (Expand ? 0 : fDim >> 1);
-
-        for (dim_t i = 0; i < oDims[0]; ++i) {
-            dim_t iOff = i * oStrides[0];
-            dim_t ci   = i + (ConvDim == 0) * (Expand ? 0 : fDim >> 1);
-
-            AccT accum = scalar<AccT>(0);
-
-            for (dim_t f = 0; f < fDim; ++f) {
-                InT f_val = fptr[f];
-                InT s_val;
-
-                if (ConvDim == 0) {
-                    dim_t offi     = ci - f;
-                    bool isCIValid = offi >= 0 && offi < sDims[0];
-                    bool isCJValid = cj >= 0 && cj < sDims[1];
-                    s_val = (isCJValid && isCIValid ? iptr[cj * sDims[0] + offi]
-                                                    : scalar<InT>(0));
-                } else {
-                    dim_t offj     = cj - f;
-                    bool isCIValid = ci >= 0 && ci < sDims[0];
-                    bool isCJValid = offj >= 0 && offj < sDims[1];
-                    s_val = (isCJValid && isCIValid ? iptr[offj * sDims[0] + ci]
-                                                    : scalar<InT>(0));
-                }
-
-                accum += AccT(s_val * f_val);
+    // The batches run in parallel when there are enough of them to keep
+    // every thread busy. Otherwise they run one after the other and the 2D
+    // and 3D convolutions split their output between the threads instead.
+    const dim_t nbatches = batch[1] * batch[2] * batch[3];
+    const dim_t grain    = nbatches < getNumThreads() ? nbatches : 1;
+    parallel_for(0, nbatches, grain, [&](dim_t first, dim_t last) {
+        for (dim_t b = first; b < last; ++b) {
+            const dim_t b1 = b % batch[1];
+            const dim_t b2 = (b / batch[1]) % batch[2];
+            const dim_t b3 = b / (batch[1] * batch[2]);
+
+            InT *out = optr + b1 * out_step[1] + b2 * out_step[2] +
+                       b3 * out_step[3];
+            InT const *in =
+                iptr + b1 * in_step[1] + b2 * in_step[2] + b3 * in_step[3];
+            AccT const *filt = fptr + b1 * filt_step[1] + b2 * filt_step[2] +
+                               b3 * filt_step[3];
+
+            switch (rank) {
+                case 1:
+                    one2one_1d<InT, AccT>(out, in, filt, oDims, sDims, fDims,
+                                          sStrides, fStrides, expand);
+                    break;
+                case 2:
+                    one2one_2d<InT, AccT>(out, in, filt, oDims, sDims, fDims,
+                                          oStrides, sStrides, fStrides,
+                                          expand);
+                    break;
+                case 3:
+                    one2one_3d<InT, AccT>(out, in, filt, oDims, sDims, fDims,
+                                          oStrides, sStrides, fStrides,
+                                          expand);
+                    break;
             }
-            optr[iOff + jOff] = InT(accum);
         }
-    }
+    });
 }
 
 template<typename InT, typename AccT, bool Expand>
 void convolve2(Param<InT> out, CParam<InT> signal, CParam<AccT> c_filter,
-               CParam<AccT> r_filter, Param<InT> temp) {
-    dim_t cflen = (dim_t)c_filter.dims().elements();
-    dim_t rflen = (dim_t)r_filter.dims().elements();
-
-    auto oDims = out.dims();
-    auto sDims = signal.dims();
+               CParam<AccT> r_filter) {
+    // The filters are applied in InT as they always have been, which
+    // truncates fractional coefficients for integer signals
+    auto coefficients = [](CParam<AccT> filter) {
+        const dim_t len = filter.dims().elements();
+        std::vector<AccT> coef(len);
+        for (dim_t f = 0; f < len; ++f) {
+            coef[f] = AccT(InT(filter.get()[f * filter.strides(0)]));
+        }
+        return coef;
+    };
+    const std::vector<AccT> col = coefficients(c_filter);
+    const std::vector<AccT> row = coefficients(r_filter);
 
+    auto oDims    = out.dims();
+    auto sDims    = signal.dims();
     auto oStrides = out.strides();
     auto sStrides = signal.strides();
-    auto tStrides = temp.strides();
-
-    for (dim_t b3 = 0; b3 < oDims[3]; ++b3) {
-        dim_t i_b3Off = b3 * sStrides[3];
-        dim_t t_b3Off = b3 * tStrides[3];
-        dim_t o_b3Off = b3 * oStrides[3];
 
-        for (dim_t b2 = 0; b2 < oDims[2]; ++b2) {
-            InT const *const iptr = signal.get() + b2 * sStrides[2] + i_b3Off;
-            InT *tptr             = temp.get() + b2 * tStrides[2] + t_b3Off;
-            InT *optr             = out.get() + b2 * oStrides[2] + o_b3Off;
+    // See convolve_nd for how the work is split between the threads
+    const dim_t nbatches = oDims[2] * oDims[3];
+    const dim_t grain    = nbatches < getNumThreads() ? nbatches : 1;
+    parallel_for(0, nbatches, grain, [&](dim_t first, dim_t last) {
+        for (dim_t b = first; b < last; ++b) {
+            const dim_t b2 = b % oDims[2];
+            const dim_t b3 = b / oDims[2];
 
-            convolve2_separable<InT, AccT, Expand, 0>(
-                tptr, iptr, c_filter.get(), temp.dims(), sDims, sDims, cflen,
-                tStrides, sStrides, c_filter.strides(0));
+            InT const *const iptr =
+                signal.get() + b2 * sStrides[2] + b3 * sStrides[3];
+            InT *optr = out.get() + b2 * oStrides[2] + b3 * oStrides[3];
 
-            convolve2_separable<InT, AccT, Expand, 1>(
-                optr, tptr, r_filter.get(), oDims, temp.dims(), sDims, rflen,
-                oStrides, tStrides, r_filter.strides(0));
+            separable_2d<InT, AccT, InT>(optr, iptr, col, row, sDims,
+                                         oStrides, sStrides, Expand);
         }
-    }
+    });
 }
 
 }  // namespace kernel
@@ -9,40 +9,164 @@
 
 #pragma once
 #include <Param.hpp>
+#include <parallel.hpp>
 #include <types.hpp>
 
+#include <algorithm>
+#include <limits>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
 namespace cpu {
 namespace kernel {
 
+/// Maps values to the bin (value - minval) / step, clamped to the range of
+/// bins.
+///
+/// The quotient is computed by multiplying with the reciprocal of the step.
+/// The product can differ from the quotient in the last bits, so values
+/// that are that close to the edge of a bin are divided to get the same bin
+/// as the division. Integer types with at most 16 bits look their bins up
+/// in a table with an entry for every value instead.
+template<typename T, bool UseTable = std::is_integral<T>::value &&
+                                     (sizeof(T) <= 2)>
+class HistogramBins {
+    using value_t = decltype(compute_t<T>() - compute_t<T>());
+    using acc_t   = decltype(value_t() / float());
+
+    compute_t<T> minval;
+    float step;
+    acc_t scale;
+    acc_t tolerance;
+    int lastBin;
+
+   public:
+    HistogramBins(unsigned nbins, double minval_, double maxval_)
+        : minval(compute_t<T>(minval_))
+        , step(static_cast<float>((maxval_ - minval_) / (float)nbins))
+        , scale(acc_t(1) / acc_t(step))
+        , tolerance(8 * std::numeric_limits<acc_t>::epsilon())
+        , lastBin(static_cast<int>(nbins) - 1) {}
+
+    int operator()(T value) const {
+        const value_t x = compute_t<T>(value) - minval;
+        const acc_t q   = x * scale;
+        int bin         = static_cast<int>(q);
+        if (nearEdge(q, bin)) { bin = static_cast<int>(x / step); }
+        return std::min(std::max(bin, 0), lastBin);
+    }
+
+    /// Writes the bins of the \p n values at \p in to \p bins. The products
+    /// are computed in a loop without branches that the compiler can
+    /// vectorize and only the values close to an edge are revisited.
+    void operator()(const T* in, int n, int* bins) const {
+        int anyNearEdge = 0;
+        for (int i = 0; i < n; ++i) {
+            const value_t x = compute_t<T>(in[i]) - minval;
+            const acc_t q   = x * scale;
+            const int bin   = static_cast<int>(q);
+            anyNearEdge |= static_cast<int>(nearEdge(q, bin));
+            bins[i] = std::min(std::max(bin, 0), lastBin);
+        }
+        if (anyNearEdge) {
+            for (int i = 0; i < n; ++i) { bins[i] = (*this)(in[i]); }
+        }
+    }
+
+   private:
+    bool nearEdge(acc_t q, int bin) const {
+        const acc_t f = q - static_cast<acc_t>(bin);
+        return (f < tolerance * q) | (acc_t(1) - f < tolerance * q);
+    }
+};
+
+template<typename T>
+class HistogramBins<T, true> {
+    using index_t = typename std::make_unsigned<T>::type;
+
+    std::vector<uint> table;
+
+   public:
+    HistogramBins(unsigned nbins, double minval, double maxval)
+        : table(size_t(std::numeric_limits<index_t>::max()) + 1) {
+        const HistogramBins<T, false> binOf(nbins, minval, maxval);
+        for (size_t i = 0; i < table.size(); ++i) {
+            table[i] = binOf(static_cast<T>(static_cast<index_t>(i)));
+        }
+    }
+
+    void operator()(const T* in, int n, int* bins) const {
+        for (int i = 0; i < n; ++i) {
+            bins[i] = table[static_cast<index_t>(in[i])];
+        }
+    }
+};
+
+/// Counts the values of every slice of \p in into the bins of \p out.
+///
+/// The rows of all slices are split between threads. Each thread counts
+/// into private bins, which are added to the output when it reaches the end
+/// of its rows in a slice. Four sets of private bins are used in turns so
+/// that runs of equal values don't serialize on the increments of one bin.
 template<typename T, bool IsLinear>
 void histogram(Param<uint> out, CParam<T> in, const unsigned nbins,
                const double minval, const double maxval) {
     dim4 const outDims  = out.dims();
-    float const step    = (maxval - minval) / (float)nbins;
     dim4 const inDims   = in.dims();
     dim4 const iStrides = in.strides();
     dim4 const oStrides = out.strides();
-    dim_t const nElems  = inDims[0] * inDims[1];
-
-    auto minValT = compute_t<T>(minval);
-    for (dim_t b3 = 0; b3 < outDims[3]; b3++) {
-        uint* outData   = out.get() + b3 * oStrides[3];
-        const T* inData = in.get() + b3 * iStrides[3];
-        for (dim_t b2 = 0; b2 < outDims[2]; b2++) {
-            for (dim_t i = 0; i < nElems; i++) {
-                int idx =
-                    IsLinear
-                        ? i
-                        : ((i % inDims[0]) + (i / inDims[0]) * iStrides[1]);
-                int bin = (int)((compute_t<T>(inData[idx]) - minValT) / step);
-                bin     = std::max(bin, 0);
-                bin     = std::min(bin, (int)(nbins - 1));
-                outData[bin]++;
+
+    const HistogramBins<T> binOf(nbins, minval, maxval);
+
+    // Linear inputs are counted as a single row per slice
+    const dim_t rowLen  = IsLinear ? inDims[0] * inDims[1] : inDims[0];
+    const dim_t nrows   = IsLinear ? 1 : inDims[1];
+    const dim_t nslices = outDims[2] * outDims[3];
+
+    constexpr int NCOPIES = 4;
+    constexpr dim_t CHUNK = 256;
+    std::mutex mergeMutex;
+
+    auto countRows = [&](dim_t first, dim_t last) {
+        std::vector<uint> local(NCOPIES * nbins, 0);
+        uint* bins[NCOPIES];
+        for (int c = 0; c < NCOPIES; ++c) { bins[c] = &local[c * nbins]; }
+        int chunkBins[CHUNK];
+
+        for (dim_t row = first; row < last;) {
+            const dim_t slice = row / nrows;
+            const dim_t b2    = slice % outDims[2];
+            const dim_t b3    = slice / outDims[2];
+            const T* inData   = in.get() + b2 * iStrides[2] + b3 * iStrides[3];
+            const dim_t end   = std::min(last, (slice + 1) * nrows);
+
+            for (; row < end; ++row) {
+                const T* rowData = inData + (row % nrows) * iStrides[1];
+                for (dim_t i = 0; i < rowLen; i += CHUNK) {
+                    const int n = static_cast<int>(std::min(CHUNK, rowLen - i));
+                    binOf(rowData + i, n, chunkBins);
+                    int j = 0;
+                    for (; j + NCOPIES <= n; j += NCOPIES) {
+                        bins[0][chunkBins[j]]++;
+                        bins[1][chunkBins[j + 1]]++;
+                        bins[2][chunkBins[j + 2]]++;
+                        bins[3][chunkBins[j + 3]]++;
+                    }
+                    for (; j < n; ++j) { bins[0][chunkBins[j]]++; }
+                }
             }
-            inData += iStrides[2];
-            outData += oStrides[2];
+
+            uint* outData = out.get() + b2 * oStrides[2] + b3 * oStrides[3];
+            std::lock_guard<std::mutex> lock(mergeMutex);
+            for (unsigned b = 0; b < nbins; ++b) {
+                outData[b] += bins[0][b] + bins[1][b] + bins[2][b] + bins[3][b];
+            }
+            std::fill(local.begin(), local.end(), 0);
         }
-    }
+    };
+
+    parallel_for(0, nslices * nrows, parallelGrain(rowLen), countRows);
 }
 
 }  // namespace kernel
@@ -8,57 +8,37 @@
  ********************************************************/
 
 #pragma once
-#include <Param.hpp>
+#include <jit/GatherNode.hpp>
 #include <utility.hpp>
+
+#include <algorithm>
+#include <array>
+#include <memory>
 #include <vector>
 
 namespace cpu {
 namespace kernel {
 
-template<typename T>
-void index(Param<T> out, CParam<T> in, const af::dim4 dDims,
-           std::vector<bool> const isSeq, std::vector<af_seq> const seqs,
-           std::vector<CParam<uint>> idxArrs) {
-    const af::dim4 iDims    = in.dims();
-    const af::dim4 iOffs    = toOffset(seqs, dDims);
-    const af::dim4 iStrds   = in.strides();
-    const af::dim4 oDims    = out.dims();
-    const af::dim4 oStrides = out.strides();
-    const T* src            = in.get();
-    T* dst                  = out.get();
-    const uint* ptr0        = idxArrs[0].get();
-    const uint* ptr1        = idxArrs[1].get();
-    const uint* ptr2        = idxArrs[2].get();
-    const uint* ptr3        = idxArrs[3].get();
-
-    for (dim_t l = 0; l < oDims[3]; ++l) {
-        dim_t lOff   = l * oStrides[3];
-        dim_t inIdx3 = trimIndex(isSeq[3] ? l + iOffs[3] : ptr3[l], iDims[3]);
-        dim_t inOff3 = inIdx3 * iStrds[3];
-
-        for (dim_t k = 0; k < oDims[2]; ++k) {
-            dim_t kOff = k * oStrides[2];
-            dim_t inIdx2 =
-                trimIndex(isSeq[2] ? k + iOffs[2] : ptr2[k], iDims[2]);
-            dim_t inOff2 = inIdx2 * iStrds[2];
-
-            for (dim_t j = 0; j < oDims[1]; ++j) {
-                dim_t jOff = j * oStrides[1];
-                dim_t inIdx1 =
-                    trimIndex(isSeq[1] ? j + iOffs[1] : ptr1[j], iDims[1]);
-                dim_t inOff1 = inIdx1 * iStrds[1];
-
-                for (dim_t i = 0; i < oDims[0]; ++i) {
-                    dim_t iOff = i * oStrides[0];
-                    dim_t inIdx0 =
-                        trimIndex(isSeq[0] ? i + iOffs[0] : ptr0[i], iDims[0]);
-                    dim_t inOff0 = inIdx0 * iStrds[0];
-
-                    dst[lOff + kOff + jOff + iOff] =
-                        src[inOff3 + inOff2 + inOff1 + inOff0];
-                }
-            }
-        }
+/// Fills the offset tables of a gather node.
+///
+/// \param[out] offs  The tables. Each table already has the size of the
+///                   output along its dimension.
+/// \param[in] iDims  The dimensions of the input
+/// \param[in] iStrds The strides of the input
+/// \param[in] iOffs  The first element selected by the sequences
+/// \param[in] idx    The index arrays or nullptr for dimensions indexed by a
+///                   sequence
+inline void gatherOffsets(std::shared_ptr<jit::GatherOffsets> offs,
+                          const af::dim4 iDims, const af::dim4 iStrds,
+                          const af::dim4 iOffs,
+                          std::array<std::shared_ptr<const uint>, 4> idx) {
+    for (int d = 0; d < 4; ++d) {
+        std::vector<dim_t> &table = (*offs)[d];
+        const dim_t count         = static_cast<dim_t>(table.size());
+        std::vector<dim_t> values =
+            indexOffsets(idx[d].get(), iOffs[d], count, iDims[d], iStrds[d]);
+        // The node holds pointers to the tables, they must not be replaced
+        std::copy(values.begin(), values.end(), table.begin());
     }
 }
 
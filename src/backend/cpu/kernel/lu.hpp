@@ -61,13 +61,20 @@ void lu_split(Param<T> lower, Param<T> upper, CParam<T> in) {
     }
 }
 
-void convertPivot(Param<int> p, Param<int> pivot) {
-    int *d_pi = pivot.get();
-    int *d_po = p.get();
-    dim_t d0  = pivot.dims(0);
-    for (int j = 0; j < (int)d0; j++) {
-        // 1 indexed in pivot
-        std::swap(d_po[j], d_po[d_pi[j] - 1]);
+inline void convertPivot(Param<int> p, Param<int> pivot) {
+    const af::dim4 pdm = pivot.dims();
+    const af::dim4 pst = pivot.strides();
+    const af::dim4 ost = p.strides();
+
+    for (dim_t ow = 0; ow < pdm[3]; ow++) {
+        for (dim_t oz = 0; oz < pdm[2]; oz++) {
+            const int *d_pi = pivot.get() + ow * pst[3] + oz * pst[2];
+            int *d_po       = p.get() + ow * ost[3] + oz * ost[2];
+            for (int j = 0; j < (int)pdm[0]; j++) {
+                // 1 indexed in pivot
+                std::swap(d_po[j], d_po[d_pi[j] - 1]);
+            }
+        }
     }
 }
 
@@ -10,195 +10,404 @@
 #pragma once
 
 #include <Param.hpp>
+#include <common/dispatch.hpp>
+#include <parallel.hpp>
+#include <simd.hpp>
 
 #include <algorithm>
+#include <type_traits>
 #include <vector>
 
 namespace cpu {
 namespace kernel {
 
-template<typename T, af::borderType Pad>
-void medfilt1(Param<T> out, CParam<T> in, dim_t w_wid) {
+/// Odd windows with at most this many values use a sorting network
+constexpr dim_t kMedianNetworkMaxSize = 25;
+
+/// The number of consecutive rows the sorting network filters together
+constexpr int kMedianNetworkLanes = 64;
+
+/// The number of consecutive rows of a column filtered by a single task of
+/// the histogram and selection paths
+constexpr dim_t kMedianRowChunk = 256;
+
+/// Returns the index read for the position \p i of an axis of length \p n
+/// that may lie outside of the axis, or -1 if the position reads zero
+template<af::borderType Pad>
+int medianSource(int i, int n) {
     constexpr bool IsValidPadType = (Pad == AF_PAD_ZERO || Pad == AF_PAD_SYM);
+    static_assert(IsValidPadType, "Unsupported padding type");
+
+    if (Pad == AF_PAD_ZERO) { return (i < 0 || i >= n) ? -1 : i; }
+
+    if (i < 0) { i *= -1; }
+    if (i >= n) { i = 2 * (n - 1) - i; }
+    // Windows much larger than the axis reflect past the other edge
+    return std::min(std::max(i, 0), n - 1);
+}
+
+/// The input rows and columns read by the windows of a median filter
+struct MedianWindow {
+    int len;
+    int wid;
+    /// The row read by the window row i of the output row r is rows[r + i]
+    std::vector<int> rows;
+    /// The column read by the window column j of the output column c is
+    /// cols[c + j]
+    std::vector<int> cols;
+
+    template<af::borderType Pad>
+    static MedianWindow create(const af::dim4 &dims, int len, int wid) {
+        MedianWindow win{len, wid, std::vector<int>(dims[0] + len - 1),
+                         std::vector<int>(dims[1] + wid - 1)};
+        for (int p = 0; p < static_cast<int>(win.rows.size()); ++p) {
+            win.rows[p] = medianSource<Pad>(p - len / 2, dims[0]);
+        }
+        for (int p = 0; p < static_cast<int>(win.cols.size()); ++p) {
+            win.cols[p] = medianSource<Pad>(p - wid / 2, dims[1]);
+        }
+        return win;
+    }
+};
+
+/// The rows [r0, r1) of a single column of a single image
+struct MedianTask {
+    dim_t col;
+    dim_t r0;
+    dim_t r1;
+    dim_t inOffset;
+    dim_t outOffset;
+};
 
+/// Returns the task \p t when every column of every image is split into
+/// tasks of \p chunk rows
+inline MedianTask medianTask(dim_t t, dim_t chunk, const af::dim4 &dims,
+                             const af::dim4 &istrides,
+                             const af::dim4 &ostrides) {
+    const dim_t nchunks = divup(dims[0], chunk);
+    const dim_t idx     = t / nchunks;
+    const dim_t col     = idx % dims[1];
+    const dim_t b2      = (idx / dims[1]) % dims[2];
+    const dim_t b3      = idx / (dims[1] * dims[2]);
+    const dim_t r0      = (t % nchunks) * chunk;
+    return {col, r0, std::min(r0 + chunk, dims[0]),
+            b3 * istrides[3] + b2 * istrides[2],
+            b3 * ostrides[3] + b2 * ostrides[2] + col * ostrides[1]};
+}
+
+/// Returns the median of a window with an even number of values from its
+/// two middle values
+template<typename T>
+T medianOfMiddle(T lo, T hi) {
+    return static_cast<T>((hi + lo) / 2);
+}
+
+/// Returns the comparators of Batcher's odd-even merge sort of \p n values
+/// that the middle value of the sorted values depends on, as pairs of
+/// indices in the format of simd::sortingNetwork
+inline std::vector<int> medianNetwork(int n) {
+    int size = 1;
+    while (size < n) { size *= 2; }
+
+    std::vector<int> network;
+    for (int p = 1; p < size; p *= 2) {
+        for (int k = p; k >= 1; k /= 2) {
+            for (int j = k % p; j + k < size; j += 2 * k) {
+                for (int i = 0; i < std::min(k, size - j - k); ++i) {
+                    // The values past n are treated as infinity, which never
+                    // moves below n, so the comparators with them do nothing
+                    if ((i + j) / (2 * p) == (i + j + k) / (2 * p) &&
+                        i + j + k < n) {
+                        network.push_back(i + j);
+                        network.push_back(i + j + k);
+                    }
+                }
+            }
+        }
+    }
+
+    std::vector<bool> needed(n, false);
+    needed[n / 2] = true;
+    std::vector<int> pruned;
+    for (size_t c = network.size(); c > 0; c -= 2) {
+        const int lo = network[c - 2];
+        const int hi = network[c - 1];
+        if (needed[lo] || needed[hi]) {
+            needed[lo] = true;
+            needed[hi] = true;
+            pruned.push_back(hi);
+            pruned.push_back(lo);
+        }
+    }
+    std::reverse(pruned.begin(), pruned.end());
+    return pruned;
+}
+
+/// Filters odd windows of at most kMedianNetworkMaxSize values. The values
+/// of the windows of kMedianNetworkLanes consecutive rows are gathered so
+/// that every comparator of the network is applied to all rows at once.
+template<typename T>
+void medianByNetwork(Param<T> out, CParam<T> in, const MedianWindow &win) {
+    constexpr int L         = kMedianNetworkLanes;
     const af::dim4 dims     = in.dims();
     const af::dim4 istrides = in.strides();
     const af::dim4 ostrides = out.strides();
+    const dim_t is0 = istrides[0], is1 = istrides[1], os0 = ostrides[0];
 
-    std::vector<T> wind_vals;
-    wind_vals.reserve(w_wid);
-
-    for (int b3 = 0; b3 < (int)dims[3]; b3++) {
-        T const* in_ptr = in.get() + b3 * istrides[3];
-        T* out_ptr      = out.get() + b3 * ostrides[3];
-
-        for (int b2 = 0; b2 < (int)dims[2]; b2++) {
-            for (int col = 0; col < (int)dims[1]; col++) {
-                int ocol_off = col * ostrides[1];
-
-                for (int row = 0; row < (int)dims[0]; row++) {
-                    wind_vals.clear();
-                    for (int wi = 0; wi < (int)w_wid; ++wi) {
-                        int im_row = row + wi - w_wid / 2;
-                        int im_roff;
-                        switch (Pad) {
-                            case AF_PAD_ZERO:
-                                im_roff = im_row * istrides[0];
-                                if (im_row < 0 || im_row >= (int)dims[0])
-                                    wind_vals.push_back(0);
-                                else
-                                    wind_vals.push_back(in_ptr[im_roff]);
-                                break;
-                            case AF_PAD_SYM: {
-                                if (im_row < 0) { im_row *= -1; }
-
-                                if (im_row >= (int)dims[0]) {
-                                    im_row = 2 * ((int)dims[0] - 1) - im_row;
-                                }
-
-                                im_roff = im_row * istrides[0];
-                                wind_vals.push_back(in_ptr[im_roff]);
-                            } break;
-                            default:
-                                static_assert(IsValidPadType,
-                                              "Unsupported padding type");
-                                break;
-                        }
-                    }
+    const int n        = win.len * win.wid;
+    const auto network = medianNetwork(n);
+
+    const dim_t ntasks = divup(dims[0], L) * dims[1] * dims[2] * dims[3];
+    const int npairs   = static_cast<int>(network.size() / 2);
+    const dim_t cost   = L * (n + npairs);
+    parallel_for(0, ntasks, parallelGrain(cost), [&](dim_t first, dim_t last) {
+        std::vector<T> values(n * L, T(0));
 
-                    int off = wind_vals.size() / 2;
-                    std::stable_sort(wind_vals.begin(), wind_vals.end());
-                    if (wind_vals.size() % 2 == 0)
-                        out_ptr[ocol_off + row * ostrides[0]] =
-                            (wind_vals[off] + wind_vals[off - 1]) / 2;
-                    else {
-                        out_ptr[ocol_off + row * ostrides[0]] = wind_vals[off];
+        for (dim_t t = first; t < last; ++t) {
+            const MedianTask task =
+                medianTask(t, L, dims, istrides, ostrides);
+            const T *in_ptr = in.get() + task.inOffset;
+            const int nl    = static_cast<int>(task.r1 - task.r0);
+            const int *rows = win.rows.data() + task.r0;
+
+            T *dst = values.data();
+            for (int wj = 0; wj < win.wid; ++wj) {
+                const int sc = win.cols[task.col + wj];
+                for (int wi = 0; wi < win.len; ++wi, dst += L) {
+                    for (int l = 0; l < nl; ++l) {
+                        const int sr = rows[l + wi];
+                        dst[l]       = (sr < 0 || sc < 0)
+                                               ? T(0)
+                                               : in_ptr[sr * is0 + sc * is1];
                     }
                 }
             }
-            in_ptr += istrides[2];
-            out_ptr += ostrides[2];
+
+            simd::sortingNetwork(values.data(), network.data(), npairs, L);
+
+            const T *median = values.data() + (n / 2) * L;
+            T *out_ptr      = out.get() + task.outOffset + task.r0 * os0;
+            for (int l = 0; l < nl; ++l) { out_ptr[l * os0] = median[l]; }
+        }
+    });
+}
+
+/// A histogram of 8 or 16 bit integers that tracks the value of a given rank
+/// as values enter and leave it. A coarse histogram of blocks of bins lets
+/// the search skip runs of empty bins.
+template<typename T>
+class MedianHistogram {
+    using bin_t = typename std::make_unsigned<T>::type;
+
+    static constexpr unsigned kBins  = 1u << (8 * sizeof(T));
+    static constexpr unsigned kBlock = sizeof(T) == 1 ? 16 : 256;
+    static constexpr unsigned kSign =
+        std::is_signed<T>::value ? kBins / 2 : 0;
+
+    std::vector<unsigned> fine;
+    std::vector<unsigned> coarse;
+    /// The bin of the last value returned by select
+    unsigned current;
+    /// The number of values in the bins below current
+    unsigned below;
+
+    static unsigned bin(T value) {
+        return static_cast<bin_t>(value) ^ kSign;
+    }
+
+   public:
+    MedianHistogram()
+        : fine(size_t{kBins}, 0)
+        , coarse(size_t{kBins / kBlock}, 0)
+        , current(0)
+        , below(0) {}
+
+    void add(T value) {
+        const unsigned b = bin(value);
+        ++fine[b];
+        ++coarse[b / kBlock];
+        below += b < current;
+    }
+
+    void remove(T value) {
+        const unsigned b = bin(value);
+        --fine[b];
+        --coarse[b / kBlock];
+        below -= b < current;
+    }
+
+    /// Returns the value of rank \p rank (0 for the smallest value)
+    T select(unsigned rank) {
+        while (below + fine[current] <= rank) {
+            if (current % kBlock == 0 &&
+                below + coarse[current / kBlock] <= rank) {
+                below += coarse[current / kBlock];
+                current += kBlock;
+            } else {
+                below += fine[current];
+                ++current;
+            }
         }
+        while (below > rank) {
+            if (current % kBlock == 0 &&
+                below - coarse[current / kBlock - 1] > rank) {
+                current -= kBlock;
+                below -= coarse[current / kBlock];
+            } else {
+                --current;
+                below -= fine[current];
+            }
+        }
+        return static_cast<T>(static_cast<bin_t>(current ^ kSign));
     }
+};
+
+/// Filters 8 and 16 bit integers with a histogram of the window that slides
+/// down each column, so every output costs O(window width) updates instead
+/// of sorting the window.
+template<typename T>
+void medianByHistogram(Param<T> out, CParam<T> in, const MedianWindow &win,
+                       std::true_type) {
+    const af::dim4 dims     = in.dims();
+    const af::dim4 istrides = in.strides();
+    const af::dim4 ostrides = out.strides();
+    const dim_t is0 = istrides[0], is1 = istrides[1], os0 = ostrides[0];
+
+    const unsigned n    = win.len * win.wid;
+    const unsigned rank = n / 2;
+
+    const dim_t ntasks =
+        divup(dims[0], kMedianRowChunk) * dims[1] * dims[2] * dims[3];
+    const dim_t cost = (kMedianRowChunk + win.len) * win.wid * 2;
+    parallel_for(0, ntasks, parallelGrain(cost), [&](dim_t first, dim_t last) {
+        MedianHistogram<T> hist;
+        std::vector<int> cols(win.wid);
+
+        for (dim_t t = first; t < last; ++t) {
+            const MedianTask task =
+                medianTask(t, kMedianRowChunk, dims, istrides, ostrides);
+            const T *in_ptr = in.get() + task.inOffset;
+            T *out_ptr      = out.get() + task.outOffset;
+            std::copy_n(win.cols.begin() + task.col, win.wid, cols.begin());
+
+            // Adds (or removes) the values of the padded input row p
+            auto update = [&](dim_t p, bool add) {
+                const int sr = win.rows[p];
+                for (int wj = 0; wj < win.wid; ++wj) {
+                    const int sc = cols[wj];
+                    const T v =
+                        (sr < 0 || sc < 0) ? T(0) : in_ptr[sr * is0 + sc * is1];
+                    if (add) {
+                        hist.add(v);
+                    } else {
+                        hist.remove(v);
+                    }
+                }
+            };
+
+            for (int wi = 0; wi < win.len; ++wi) { update(task.r0 + wi, true); }
+            for (dim_t r = task.r0; r < task.r1; ++r) {
+                if (r > task.r0) {
+                    update(r - 1, false);
+                    update(r + win.len - 1, true);
+                }
+                T median = hist.select(rank);
+                if (n % 2 == 0) {
+                    median = medianOfMiddle(hist.select(rank - 1), median);
+                    hist.select(rank);
+                }
+                out_ptr[r * os0] = median;
+            }
+            // Leave the histogram empty for the next task
+            for (int wi = 0; wi < win.len; ++wi) {
+                update(task.r1 - 1 + wi, false);
+            }
+        }
+    });
 }
 
-template<typename T, af::borderType Pad>
-void medfilt2(Param<T> out, CParam<T> in, dim_t w_len, dim_t w_wid) {
-    constexpr bool IsValidPadType = (Pad == AF_PAD_ZERO || Pad == AF_PAD_SYM);
+template<typename T>
+void medianByHistogram(Param<T>, CParam<T>, const MedianWindow &,
+                       std::false_type) {}
 
+/// Filters any window by gathering it and selecting its middle values
+template<typename T>
+void medianBySelection(Param<T> out, CParam<T> in, const MedianWindow &win) {
     const af::dim4 dims     = in.dims();
     const af::dim4 istrides = in.strides();
     const af::dim4 ostrides = out.strides();
+    const dim_t is0 = istrides[0], is1 = istrides[1], os0 = ostrides[0];
+
+    const int n = win.len * win.wid;
+
+    const dim_t ntasks =
+        divup(dims[0], kMedianRowChunk) * dims[1] * dims[2] * dims[3];
+    const dim_t cost = kMedianRowChunk * n * 4;
+    parallel_for(0, ntasks, parallelGrain(cost), [&](dim_t first, dim_t last) {
+        std::vector<T> values(n);
 
-    std::vector<T> wind_vals;
-    wind_vals.reserve(w_len * w_wid);
-
-    for (int b3 = 0; b3 < (int)dims[3]; b3++) {
-        T const* in_ptr = in.get() + b3 * istrides[3];
-        T* out_ptr      = out.get() + b3 * ostrides[3];
-
-        for (int b2 = 0; b2 < (int)dims[2]; b2++) {
-            for (int col = 0; col < (int)dims[1]; col++) {
-                int ocol_off = col * ostrides[1];
-
-                for (int row = 0; row < (int)dims[0]; row++) {
-                    wind_vals.clear();
-
-                    for (int wj = 0; wj < (int)w_wid; ++wj) {
-                        bool isColOff = false;
-
-                        int im_col  = col + wj - w_wid / 2;
-                        int im_coff = 0;
-                        switch (Pad) {
-                            case AF_PAD_ZERO:
-                                im_coff = im_col * istrides[1];
-                                if (im_col < 0 || im_col >= (int)dims[1])
-                                    isColOff = true;
-                                break;
-                            case AF_PAD_SYM: {
-                                if (im_col < 0) {
-                                    im_col *= -1;
-                                    isColOff = true;
-                                }
-
-                                if (im_col >= (int)dims[1]) {
-                                    im_col   = 2 * ((int)dims[1] - 1) - im_col;
-                                    isColOff = true;
-                                }
-
-                                im_coff = im_col * istrides[1];
-                            } break;
-                            default:
-                                static_assert(IsValidPadType,
-                                              "Unsupported padding type");
-                                break;
-                        }
-
-                        for (int wi = 0; wi < (int)w_len; ++wi) {
-                            bool isRowOff = false;
-
-                            int im_row  = row + wi - w_len / 2;
-                            int im_roff = 0;
-                            switch (Pad) {
-                                case AF_PAD_ZERO:
-                                    im_roff = im_row * istrides[0];
-                                    if (im_row < 0 || im_row >= (int)dims[0])
-                                        isRowOff = true;
-                                    break;
-                                case AF_PAD_SYM: {
-                                    if (im_row < 0) {
-                                        im_row *= -1;
-                                        isRowOff = true;
-                                    }
-
-                                    if (im_row >= (int)dims[0]) {
-                                        im_row =
-                                            2 * ((int)dims[0] - 1) - im_row;
-                                        isRowOff = true;
-                                    }
-
-                                    im_roff = im_row * istrides[0];
-                                } break;
-                                default:
-                                    static_assert(IsValidPadType,
-                                                  "Unsupported padding type");
-                                    break;
-                            }
-
-                            if (isRowOff || isColOff) {
-                                switch (Pad) {
-                                    case AF_PAD_ZERO:
-                                        wind_vals.push_back(0);
-                                        break;
-                                    case AF_PAD_SYM:
-                                        wind_vals.push_back(
-                                            in_ptr[im_coff + im_roff]);
-                                        break;
-                                    default:
-                                        static_assert(
-                                            IsValidPadType,
-                                            "Unsupported padding type");
-                                        break;
-                                }
-                            } else
-                                wind_vals.push_back(in_ptr[im_coff + im_roff]);
-                        }
+        for (dim_t t = first; t < last; ++t) {
+            const MedianTask task =
+                medianTask(t, kMedianRowChunk, dims, istrides, ostrides);
+            const T *in_ptr = in.get() + task.inOffset;
+            T *out_ptr      = out.get() + task.outOffset;
+
+            for (dim_t r = task.r0; r < task.r1; ++r) {
+                auto dst = values.begin();
+                for (int wj = 0; wj < win.wid; ++wj) {
+                    const int sc = win.cols[task.col + wj];
+                    for (int wi = 0; wi < win.len; ++wi) {
+                        const int sr = win.rows[r + wi];
+                        *dst++       = (sr < 0 || sc < 0)
+                                           ? T(0)
+                                           : in_ptr[sr * is0 + sc * is1];
                     }
+                }
 
-                    std::stable_sort(wind_vals.begin(), wind_vals.end());
-                    int off = wind_vals.size() / 2;
-                    if (wind_vals.size() % 2 == 0)
-                        out_ptr[ocol_off + row * ostrides[0]] =
-                            (wind_vals[off] + wind_vals[off - 1]) / 2;
-                    else
-                        out_ptr[ocol_off + row * ostrides[0]] = wind_vals[off];
+                const auto mid = values.begin() + n / 2;
+                std::nth_element(values.begin(), mid, values.end());
+                T median = *mid;
+                if (n % 2 == 0) {
+                    median = medianOfMiddle(
+                        *std::max_element(values.begin(), mid), median);
                 }
+                out_ptr[r * os0] = median;
             }
-            in_ptr += istrides[2];
-            out_ptr += ostrides[2];
         }
+    });
+}
+
+/// Replaces every value with the median of the \p w_len x \p w_wid window
+/// around it. Windows with an even number of values use the mean of their
+/// two middle values.
+template<typename T, af::borderType Pad>
+void medianFilter(Param<T> out, CParam<T> in, dim_t w_len, dim_t w_wid) {
+    using UseHistogram =
+        std::integral_constant<bool, std::is_integral<T>::value &&
+                                         (sizeof(T) <= 2)>;
+
+    const MedianWindow win = MedianWindow::create<Pad>(
+        in.dims(), static_cast<int>(w_len), static_cast<int>(w_wid));
+    const dim_t n = w_len * w_wid;
+
+    if (n % 2 == 1 && n <= kMedianNetworkMaxSize) {
+        medianByNetwork<T>(out, in, win);
+    } else if (UseHistogram::value) {
+        medianByHistogram<T>(out, in, win, UseHistogram());
+    } else {
+        medianBySelection<T>(out, in, win);
     }
 }
 
+template<typename T, af::borderType Pad>
+void medfilt1(Param<T> out, CParam<T> in, dim_t w_wid) {
+    medianFilter<T, Pad>(out, in, w_wid, 1);
+}
+
+template<typename T, af::borderType Pad>
+void medfilt2(Param<T> out, CParam<T> in, dim_t w_len, dim_t w_wid) {
+    medianFilter<T, Pad>(out, in, w_len, w_wid);
+}
+
 }  // namespace kernel
 }  // namespace cpu
@@ -10,6 +10,7 @@
 #pragma once
 #include <Param.hpp>
 #include <common/Binary.hpp>
+#include <parallel.hpp>
 #include <utility.hpp>
 #include <limits>
 
@@ -45,8 +46,8 @@ struct MorphFilterOp {
 template<typename T, bool IsDilation>
 void morph(Param<T> paddedOut, CParam<T> paddedIn, CParam<T> mask) {
     MorphFilterOp<T, IsDilation> filterOp;
-    T init = IsDilation ? common::Binary<T, af_max_t>::init()
-                        : common::Binary<T, af_min_t>::init();
+    const T init = IsDilation ? common::Binary<T, af_max_t>::init()
+                              : common::Binary<T, af_min_t>::init();
 
     const af::dim4 ostrides = paddedOut.strides();
     T* outData              = paddedOut.get();
@@ -57,21 +58,28 @@ void morph(Param<T> paddedOut, CParam<T> paddedIn, CParam<T> mask) {
     std::vector<dim_t> offsets;
     getOffsets(offsets, istrides, mask);
 
-    const dim_t batchSize = dims[0] * dims[1];
-    const int batchCount  = dims[2] * dims[3];
-    for (int b = 0; b < batchCount; ++b) {
-        for (dim_t n = 0; n < batchSize; ++n) {
-            T filterResult = init;
-            for (size_t oi = 0; oi < offsets.size(); ++oi) {
-                dim_t x = n + offsets[oi];
-                if (x >= 0 && x < batchSize)
-                    filterResult = filterOp(filterResult, inData[x]);
+    const dim_t batchSize  = dims[0] * dims[1];
+    const dim_t batchCount = dims[2] * dims[3];
+
+    // Every column of every image is processed independently
+    const dim_t grain = parallelGrain(dims[0] * offsets.size());
+    parallel_for(0, batchCount * dims[1], grain, [&](dim_t first, dim_t last) {
+        for (dim_t col = first; col < last; ++col) {
+            const dim_t b   = col / dims[1];
+            const T* bIn    = inData + b * istrides[2];
+            T* bOut         = outData + b * ostrides[2];
+            const dim_t beg = (col % dims[1]) * dims[0];
+            for (dim_t n = beg; n < beg + dims[0]; ++n) {
+                T filterResult = init;
+                for (size_t oi = 0; oi < offsets.size(); ++oi) {
+                    dim_t x = n + offsets[oi];
+                    if (x >= 0 && x < batchSize)
+                        filterResult = filterOp(filterResult, bIn[x]);
+                }
+                bOut[n] = filterResult;
             }
-            outData[n] = filterResult;
         }
-        outData += ostrides[2];
-        inData += istrides[2];
-    }
+    });
 }
 
 template<typename T, bool IsDilation>
@@ -89,13 +97,20 @@ void morph3d(Param<T> out, CParam<T> in, CParam<T> mask) {
     const T* inData         = in.get();
     const T* filter         = mask.get();
 
-    T init = IsDilation ? common::Binary<T, af_max_t>::init()
-                        : common::Binary<T, af_min_t>::init();
+    const T init = IsDilation ? common::Binary<T, af_max_t>::init()
+                              : common::Binary<T, af_min_t>::init();
+
+    // Every slice of every volume is processed independently
+    const dim_t grain = parallelGrain(dims[0] * dims[1] * window.elements());
+    parallel_for(0, bCount * dims[2], grain, [&](dim_t first, dim_t last) {
+        for (dim_t slice = first; slice < last; ++slice) {
+            // either channels or batch is handled by outer most loop
+            const dim_t batchId = slice / dims[2];
+            const T* bIn        = inData + batchId * istrides[3];
+            T* bOut             = outData + batchId * ostrides[3];
 
-    for (dim_t batchId = 0; batchId < bCount; ++batchId) {
-        // either channels or batch is handled by outer most loop
-        for (dim_t k = 0; k < dims[2]; ++k) {
             // k steps along 3rd dimension
+            const dim_t k = slice % dims[2];
             for (dim_t j = 0; j < dims[1]; ++j) {
                 // j steps along 2nd dimension
                 for (dim_t i = 0; i < dims[0]; ++i) {
@@ -117,8 +132,8 @@ void morph3d(Param<T> out, CParam<T> in, CParam<T> mask) {
                                 if ((maskValue > (T)0) && offi >= 0 &&
                                     offj >= 0 && offk >= 0 && offi < dims[0] &&
                                     offj < dims[1] && offk < dims[2]) {
-                                    T inValue = inData[getIdx(istrides, offi,
-                                                              offj, offk)];
+                                    T inValue = bIn[getIdx(istrides, offi,
+                                                           offj, offk)];
 
                                     if (IsDilation)
                                         filterResult =
@@ -132,14 +147,11 @@ void morph3d(Param<T> out, CParam<T> in, CParam<T> mask) {
                         }      // window 1st dimension loop ends here
                     }          // filter window loop ends here
 
-                    outData[getIdx(ostrides, i, j, k)] = filterResult;
+                    bOut[getIdx(ostrides, i, j, k)] = filterResult;
                 }  // 1st dimension loop ends here
             }      // 2nd dimension loop ends here
-        }          // 3rd dimension loop ends here
-        // next iteration will be next batch if any
-        outData += ostrides[3];
-        inData += istrides[3];
-    }
+        }          // slice loop ends here
+    });
 }
 }  // namespace kernel
 }  // namespace cpu
@@ -9,6 +9,15 @@
 
 #pragma once
 #include <Param.hpp>
+#include <common/blas_headers.hpp>
+#include <memory.hpp>
+#include <parallel.hpp>
+#include <simd.hpp>
+
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace cpu {
 namespace kernel {
@@ -57,43 +66,358 @@ struct dist_op<ushort, To, AF_SHD> {
     To operator()(ushort v1, ushort v2) { return __builtin_popcount(v1 ^ v2); }
 };
 
+/// The number of training samples whose distances are computed at once
+constexpr dim_t kNNTrainTile = 256;
+/// The number of training samples in a tile of the GEMM path
+constexpr dim_t kNNGemmTrainTile = 1024;
+/// The number of queries in a tile of the GEMM path
+constexpr dim_t kNNGemmQueryTile = 256;
+/// The number of features from which squared distances use GEMM
+constexpr dim_t kNNGemmMinFeatures = 16;
+/// The number of candidates beyond k that the GEMM path keeps for every
+/// query to make up for the rounding errors of its distances. See
+/// nearestGemm for the ties this doesn't cover.
+constexpr dim_t kNNGemmExtraCandidates = 16;
+
+/// The k nearest training samples of a query, kept in a max-heap ordered by
+/// distance and then by index so that the farthest neighbour is on top. The
+/// heap lives in external storage and is resumed from its size, so the
+/// training samples can be added in several tiles.
+template<typename To>
+class NeighbourHeap {
+    std::pair<To, uint> *m_heap;
+    uint m_size;
+    uint m_k;
+
+   public:
+    NeighbourHeap(std::pair<To, uint> *storage, uint size, uint k)
+        : m_heap(storage), m_size(size), m_k(k) {}
+
+    uint size() const { return m_size; }
+
+    /// Adds the training sample \p idx. Samples are added in the order of
+    /// their indices, so a full heap keeps the earlier one of two ties.
+    void push(To dist, uint idx) {
+        if (m_size < m_k) {
+            m_heap[m_size++] = {dist, idx};
+            std::push_heap(m_heap, m_heap + m_size);
+        } else if (dist < m_heap[0].first) {
+            std::pop_heap(m_heap, m_heap + m_k);
+            m_heap[m_k - 1] = {dist, idx};
+            std::push_heap(m_heap, m_heap + m_k);
+        }
+    }
+
+    /// Adds the \p n samples with the distances \p dist, starting at index
+    /// \p first. Once the heap is full, most samples are rejected by a
+    /// single comparison.
+    void push(const To *dist, uint first, dim_t n) {
+        dim_t j = 0;
+        for (; j < n && m_size < m_k; ++j) { push(dist[j], first + j); }
+        for (; j < n; ++j) {
+            if (dist[j] < m_heap[0].first) { push(dist[j], first + j); }
+        }
+    }
+
+    /// Sorts the neighbours, nearest first
+    void sort() { std::sort_heap(m_heap, m_heap + m_size); }
+};
+
+/// Computes the distances between a query and a tile of training samples.
+/// Both are stored feature by feature: feature f of the query is query[f]
+/// and feature f of sample j is tile[f * ld + j].
+template<typename T, typename To, af_match_type dist_type>
+struct TileDistance {
+    using packed_t = T;
+
+    void operator()(To *dist, const T *query, const T *tile, dim_t ld,
+                    dim_t nfeat, dim_t n) const {
+        dist_op<T, To, dist_type> op;
+        std::fill(dist, dist + n, To(0));
+        for (dim_t f = 0; f < nfeat; ++f) {
+            const T q    = query[f];
+            const T *row = tile + f * ld;
+            for (dim_t j = 0; j < n; ++j) { dist[j] += op(q, row[j]); }
+        }
+    }
+};
+
+/// Hamming distances of the unsigned types are counted 32 bits at a time
+/// with the vectorized population count. Wider words are truncated like in
+/// dist_op.
+#define NN_HAMMING_TILE(T)                                                 \
+    template<>                                                             \
+    struct TileDistance<T, uint, AF_SHD> {                                 \
+        using packed_t = uint;                                             \
+                                                                           \
+        void operator()(uint *dist, const uint *query, const uint *tile,   \
+                        dim_t ld, dim_t nfeat, dim_t n) const {            \
+            std::fill(dist, dist + n, 0U);                                 \
+            simd::hamming(dist, query, tile, static_cast<int>(nfeat),      \
+                          static_cast<int>(ld), static_cast<int>(n));      \
+        }                                                                  \
+    };
+
+NN_HAMMING_TILE(uchar)
+NN_HAMMING_TILE(ushort)
+NN_HAMMING_TILE(uint)
+NN_HAMMING_TILE(uintl)
+
+#undef NN_HAMMING_TILE
+
+/// Writes the sorted neighbours of query \p q to the outputs
+template<typename To>
+void writeNeighbours(Param<uint> idx, Param<To> dists, dim_t q,
+                     const std::pair<To, uint> *nn, uint k) {
+    uint *iPtr = idx.get() + q * idx.strides()[1];
+    To *dPtr   = dists.get() + q * dists.strides()[1];
+    for (uint r = 0; r < k; ++r) {
+        dPtr[r] = nn[r].first;
+        iPtr[r] = nn[r].second;
+    }
+}
+
+/// Finds the neighbours from distances computed directly, tile by tile.
+///
+/// The queries are copied feature by feature once. The training samples are
+/// processed in tiles of kNNTrainTile samples, which are transposed when the
+/// features of a sample are contiguous, so that the distances to all
+/// samples of a tile are accumulated with unit stride. The queries are split
+/// between threads for every tile and each query keeps its neighbours in a
+/// bounded heap, so the distance matrix is never stored.
 template<typename T, typename To, af_match_type dist_type>
-void nearest_neighbour(Param<To> dists, CParam<T> query, CParam<T> train,
-                       const uint dist_dim) {
-    uint sample_dim  = (dist_dim == 0) ? 1 : 0;
-    const dim4 qDims = query.dims();
-    const dim4 tDims = train.dims();
-
-    const unsigned distLength = qDims[dist_dim];
-    const unsigned nQuery     = qDims[sample_dim];
-    const unsigned nTrain     = tDims[sample_dim];
-
-    const T* qPtr = query.get();
-    const T* tPtr = train.get();
-    To* dPtr      = dists.get();
-
-    dist_op<T, To, dist_type> op;
-
-    for (unsigned i = 0; i < nQuery; i++) {
-        for (unsigned j = 0; j < nTrain; j++) {
-            To local_dist = 0;
-            for (unsigned k = 0; k < distLength; k++) {
-                size_t qIdx, tIdx;
-                if (sample_dim == 0) {
-                    qIdx = k * qDims[0] + i;
-                    tIdx = k * tDims[0] + j;
-                } else {
-                    qIdx = i * qDims[0] + k;
-                    tIdx = j * tDims[0] + k;
+void nearestDirect(Param<uint> idx, Param<To> dists, CParam<T> query,
+                   CParam<T> train, const uint dist_dim, const uint k) {
+    using Distance = TileDistance<T, To, dist_type>;
+    using P        = typename Distance::packed_t;
+
+    const bool sampleRows = dist_dim == 1;
+    const dim_t nfeat     = query.dims()[dist_dim];
+    const dim_t nQuery    = query.dims()[sampleRows ? 0 : 1];
+    const dim_t nTrain    = train.dims()[sampleRows ? 0 : 1];
+    const dim_t qLd       = query.strides()[1];
+    const dim_t tLd       = train.strides()[1];
+    const T *qPtr         = query.get();
+    const T *tPtr         = train.get();
+
+    auto queries = memAlloc<P>(nQuery * nfeat);
+    for (dim_t q = 0; q < nQuery; ++q) {
+        for (dim_t f = 0; f < nfeat; ++f) {
+            queries.get()[q * nfeat + f] = static_cast<P>(
+                sampleRows ? qPtr[q + f * qLd] : qPtr[q * qLd + f]);
+        }
+    }
+
+    const bool packTiles = !sampleRows || !std::is_same<P, T>::value;
+    auto tile            = memAlloc<P>(packTiles ? nfeat * kNNTrainTile : 1);
+    auto heaps           = memAlloc<std::pair<To, uint>>(nQuery * k);
+    std::vector<uint> sizes(nQuery, 0);
+
+    for (dim_t t0 = 0; t0 < nTrain; t0 += kNNTrainTile) {
+        const dim_t tb = std::min(kNNTrainTile, nTrain - t0);
+
+        const P *tileData = reinterpret_cast<const P *>(tPtr + t0);
+        dim_t ld          = tLd;
+        if (packTiles) {
+            P *packed = tile.get();
+            for (dim_t f = 0; f < nfeat; ++f) {
+                for (dim_t j = 0; j < tb; ++j) {
+                    const dim_t s      = t0 + j;
+                    packed[f * tb + j] = static_cast<P>(
+                        sampleRows ? tPtr[s + f * tLd] : tPtr[s * tLd + f]);
                 }
+            }
+            tileData = packed;
+            ld       = tb;
+        }
 
-                local_dist += op(qPtr[qIdx], tPtr[tIdx]);
+        auto searchTile = [&](dim_t first, dim_t last) {
+            const Distance distance;
+            To dist[kNNTrainTile];
+            for (dim_t q = first; q < last; ++q) {
+                NeighbourHeap<To> heap(heaps.get() + q * k, sizes[q], k);
+                distance(dist, queries.get() + q * nfeat, tileData, ld, nfeat,
+                         tb);
+                heap.push(dist, static_cast<uint>(t0), tb);
+                sizes[q] = heap.size();
             }
+        };
+        parallel_for(0, nQuery, parallelGrain(tb * nfeat), searchTile);
+    }
+
+    parallel_for(0, nQuery, parallelGrain(k), [&](dim_t first, dim_t last) {
+        for (dim_t q = first; q < last; ++q) {
+            NeighbourHeap<To> heap(heaps.get() + q * k, sizes[q], k);
+            heap.sort();
+            writeNeighbours(idx, dists, q, heaps.get() + q * k, k);
+        }
+    });
+}
+
+/// Computes C = -2 op(A) op(B) in column major order
+inline void nnGemm(CBLAS_TRANSPOSE tA, CBLAS_TRANSPOSE tB, int M, int N, int K,
+                   const float *A, int lda, const float *B, int ldb, float *C,
+                   int ldc) {
+    cblas_sgemm(CblasColMajor, tA, tB, M, N, K, -2.f, A, lda, B, ldb, 0.f, C,
+                ldc);
+}
+
+inline void nnGemm(CBLAS_TRANSPOSE tA, CBLAS_TRANSPOSE tB, int M, int N, int K,
+                   const double *A, int lda, const double *B, int ldb,
+                   double *C, int ldc) {
+    cblas_dgemm(CblasColMajor, tA, tB, M, N, K, -2.0, A, lda, B, ldb, 0.0, C,
+                ldc);
+}
+
+/// Finds the neighbours from the squared distances |q|^2 + |t|^2 - 2 q.t,
+/// with the products of tiles of queries and training samples computed by
+/// GEMM. A few more than k candidates are selected with bounded heaps as in
+/// nearestDirect. The distances of the candidates are then recomputed
+/// directly and the nearest k of them are returned, so the results don't
+/// carry the rounding errors of the expansion.
+///
+/// Unlike nearestDirect, this doesn't always return the earlier of two
+/// training samples at the same distance. Samples at the same exact distance
+/// can get different rounded distances, and when more than
+/// kNNGemmExtraCandidates of them compete for the last neighbours, the
+/// candidates are picked by the rounding errors rather than by index.
+template<typename T>
+void nearestGemm(Param<uint> idx, Param<T> dists, CParam<T> query,
+                 CParam<T> train, const uint dist_dim, const uint k) {
+    const bool sampleRows = dist_dim == 1;
+    const dim_t nfeat     = query.dims()[dist_dim];
+    const dim_t nQuery    = query.dims()[sampleRows ? 0 : 1];
+    const dim_t nTrain    = train.dims()[sampleRows ? 0 : 1];
+    const dim_t qLd       = query.strides()[1];
+    const dim_t tLd       = train.strides()[1];
+    const T *qPtr         = query.get();
+    const T *tPtr         = train.get();
+
+    // The offsets of sample s and of feature f of a sample
+    const dim_t qSample  = sampleRows ? 1 : qLd;
+    const dim_t qFeature = sampleRows ? qLd : 1;
+    const dim_t tSample  = sampleRows ? 1 : tLd;
+    const dim_t tFeature = sampleRows ? tLd : 1;
+
+    auto squaredNorms = [nfeat](T *norms, const T *ptr, dim_t nsamples,
+                                dim_t sample, dim_t feature) {
+        parallel_for(0, nsamples, parallelGrain(nfeat),
+                     [&](dim_t first, dim_t last) {
+                         for (dim_t s = first; s < last; ++s) {
+                             T sum = 0;
+                             for (dim_t f = 0; f < nfeat; ++f) {
+                                 const T v = ptr[s * sample + f * feature];
+                                 sum += v * v;
+                             }
+                             norms[s] = sum;
+                         }
+                     });
+    };
+    auto qNorms = memAlloc<T>(nQuery);
+    auto tNorms = memAlloc<T>(nTrain);
+    squaredNorms(qNorms.get(), qPtr, nQuery, qSample, qFeature);
+    squaredNorms(tNorms.get(), tPtr, nTrain, tSample, tFeature);
+
+    const uint nc =
+        static_cast<uint>(std::min(nTrain, dim_t(k) + kNNGemmExtraCandidates));
+    auto products = memAlloc<T>(kNNGemmQueryTile * kNNGemmTrainTile);
+    auto heaps    = memAlloc<std::pair<T, uint>>(nQuery * nc);
+    std::vector<uint> sizes(nQuery, 0);
 
-            dPtr[i * nTrain + j] = local_dist;
+    // The tile of training samples is the transposed left operand, so the
+    // products of a query are contiguous
+    const CBLAS_TRANSPOSE tOp = sampleRows ? CblasNoTrans : CblasTrans;
+    const CBLAS_TRANSPOSE qOp = sampleRows ? CblasTrans : CblasNoTrans;
+
+    for (dim_t q0 = 0; q0 < nQuery; q0 += kNNGemmQueryTile) {
+        const dim_t qb = std::min(kNNGemmQueryTile, nQuery - q0);
+        for (dim_t t0 = 0; t0 < nTrain; t0 += kNNGemmTrainTile) {
+            const dim_t tb = std::min(kNNGemmTrainTile, nTrain - t0);
+            T *prod        = products.get();
+            nnGemm(tOp, qOp, static_cast<int>(tb), static_cast<int>(qb),
+                   static_cast<int>(nfeat), tPtr + t0 * tSample,
+                   static_cast<int>(tLd), qPtr + q0 * qSample,
+                   static_cast<int>(qLd), prod, static_cast<int>(tb));
+
+            const T *tn = tNorms.get() + t0;
+            parallel_for(
+                q0, q0 + qb, parallelGrain(tb), [&](dim_t first, dim_t last) {
+                    for (dim_t q = first; q < last; ++q) {
+                        T *dist    = prod + (q - q0) * tb;
+                        const T qn = qNorms.get()[q];
+                        for (dim_t j = 0; j < tb; ++j) {
+                            dist[j] = std::max(dist[j] + qn + tn[j], T(0));
+                        }
+                        NeighbourHeap<T> heap(heaps.get() + q * nc,
+                                              sizes[q], nc);
+                        heap.push(dist, static_cast<uint>(t0), tb);
+                        sizes[q] = heap.size();
+                    }
+                });
+        }
+    }
+
+    dist_op<T, T, AF_SSD> op;
+    parallel_for(0, nQuery, parallelGrain(nc * nfeat), [&](dim_t first,
+                                                           dim_t last) {
+        for (dim_t q = first; q < last; ++q) {
+            std::pair<T, uint> *nn = heaps.get() + q * nc;
+            const T *qs            = qPtr + q * qSample;
+            for (uint r = 0; r < nc; ++r) {
+                const T *ts = tPtr + nn[r].second * tSample;
+                T sum       = 0;
+                for (dim_t f = 0; f < nfeat; ++f) {
+                    sum += op(qs[f * qFeature], ts[f * tFeature]);
+                }
+                nn[r].first = sum;
+            }
+            std::partial_sort(nn, nn + k, nn + nc);
+            writeNeighbours(idx, dists, q, nn, k);
         }
+    });
+}
+
+template<typename T, typename To, af_match_type dist_type>
+void nearestSearch(Param<uint> idx, Param<To> dists, CParam<T> query,
+                   CParam<T> train, const uint dist_dim, const uint k,
+                   std::false_type) {
+    nearestDirect<T, To, dist_type>(idx, dists, query, train, dist_dim, k);
+}
+
+template<typename T, typename To, af_match_type dist_type>
+void nearestSearch(Param<uint> idx, Param<To> dists, CParam<T> query,
+                   CParam<T> train, const uint dist_dim, const uint k,
+                   std::true_type) {
+    if (query.dims()[dist_dim] >= kNNGemmMinFeatures) {
+        nearestGemm<T>(idx, dists, query, train, dist_dim, k);
+    } else {
+        nearestDirect<T, To, dist_type>(idx, dists, query, train, dist_dim, k);
     }
 }
 
+/// Finds the \p k nearest training samples of every query.
+///
+/// Squared distances between floating point samples with many features are
+/// computed with GEMM, all other distances directly. The direct path returns
+/// the earlier of two training samples at the same distance. The GEMM path
+/// only does so when few samples share the distance of the k-th neighbour.
+///
+/// \param[out] idx      The indices of the neighbours of every query
+/// \param[out] dists    The distances to the neighbours of every query
+/// \param[in]  query    The query samples
+/// \param[in]  train    The training samples
+/// \param[in]  dist_dim The dimension along which the features are stored
+/// \param[in]  k        The number of neighbours
+template<typename T, typename To, af_match_type dist_type>
+void nearest_neighbour(Param<uint> idx, Param<To> dists, CParam<T> query,
+                       CParam<T> train, const uint dist_dim, const uint k) {
+    using useGemm =
+        std::integral_constant<bool, dist_type == AF_SSD &&
+                                         std::is_floating_point<T>::value &&
+                                         std::is_same<T, To>::value>;
+    nearestSearch<T, To, dist_type>(idx, dists, query, train, dist_dim, k,
+                                    useGemm());
+}
+
 }  // namespace kernel
 }  // namespace cpu
@@ -0,0 +1,105 @@
+/*******************************************************
+ * Copyright (c) 2026, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <Param.hpp>
+#include <common/quantile.hpp>
+#include <parallel.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace cpu {
+namespace kernel {
+
+/// Computes the quantiles at \p ranks of every line of \p in along \p dim.
+/// Only the ranks that are needed are selected. They are selected in
+/// increasing order so each selection only partitions the values above the
+/// previous rank. NaNs are ordered after all the other values.
+template<typename T, typename To>
+void quantile(Param<To> out, CParam<T> in,
+              const std::vector<common::QuantileRank> ranks, const int dim) {
+    const af::dim4 dims     = in.dims();
+    const af::dim4 istrides = in.strides();
+    const af::dim4 ostrides = out.strides();
+    const dim_t n           = dims[dim];
+    const dim_t nlines      = dims.elements() / n;
+
+    // The distinct ranks to select, in increasing order
+    std::vector<dim_t> select;
+    for (const auto &rank : ranks) {
+        select.push_back(rank.lo);
+        if (rank.frac != 0.0) { select.push_back(rank.lo + 1); }
+    }
+    std::sort(select.begin(), select.end());
+    select.erase(std::unique(select.begin(), select.end()), select.end());
+    auto selectIndex = [&](dim_t rank) {
+        return std::lower_bound(select.begin(), select.end(), rank) -
+               select.begin();
+    };
+
+    // The dimensions other than dim, in order
+    int odim[3];
+    for (int i = 0, j = 0; i < 4; i++) {
+        if (i != dim) { odim[j++] = i; }
+    }
+    auto lineOffset = [&](dim_t line, const af::dim4 &strides) {
+        const dim_t i0 = line % dims[odim[0]];
+        const dim_t i1 = (line / dims[odim[0]]) % dims[odim[1]];
+        const dim_t i2 = line / (dims[odim[0]] * dims[odim[1]]);
+        return i0 * strides[odim[0]] + i1 * strides[odim[1]] +
+               i2 * strides[odim[2]];
+    };
+
+    auto less = [](T a, T b) { return a < b || (b != b && a == a); };
+
+    const T *iptr = in.get();
+    To *optr      = out.get();
+    parallel_for(0, nlines, parallelGrain(n), [&](dim_t first, dim_t last) {
+        std::vector<T> values(n);
+        std::vector<T> picked(select.size());
+        for (dim_t line = first; line < last; line++) {
+            const T *src = iptr + lineOffset(line, istrides);
+            for (dim_t k = 0; k < n; k++) {
+                values[k] = src[k * istrides[dim]];
+            }
+
+            auto begin = values.begin();
+            for (size_t i = 0; i < select.size(); i++) {
+                auto nth = values.begin() + select[i];
+                if (nth == begin) {
+                    std::iter_swap(begin,
+                                   std::min_element(begin, values.end(), less));
+                } else {
+                    std::nth_element(begin, nth, values.end(), less);
+                }
+                picked[i] = *nth;
+                begin     = nth + 1;
+            }
+
+            To *dst = optr + lineOffset(line, ostrides);
+            for (size_t p = 0; p < ranks.size(); p++) {
+                const common::QuantileRank &rank = ranks[p];
+                const T lo = picked[selectIndex(rank.lo)];
+                To result  = static_cast<To>(lo);
+                if (rank.frac != 0.0) {
+                    const T hi = picked[selectIndex(rank.lo + 1)];
+                    result     = static_cast<To>(
+                        (1.0 - rank.frac) * static_cast<double>(lo) +
+                        rank.frac * static_cast<double>(hi));
+                }
+                dst[p * ostrides[dim]] = result;
+            }
+        }
+    });
+}
+
+}  // namespace kernel
+}  // namespace cpu
@@ -16,6 +16,8 @@
 #include <kernel/random_engine_mersenne.hpp>
 #include <kernel/random_engine_philox.hpp>
 #include <kernel/random_engine_threefry.hpp>
+#include <parallel.hpp>
+#include <simd.hpp>
 #include <types.hpp>
 
 #include <algorithm>
@@ -166,82 +168,47 @@ double getDoubleNegative11(uint *val, uint index) {
     return fma(v, signed_factor, half_factor);
 }
 
-#define MAX_RESET_CTR_VAL 64
-#define WRITE_STRIDE 256
+/// Number of counters that the counter based engines process at a time.
+/// This is also the number of threads of the CUDA blocks emulated by
+/// philoxUniform and philoxNormal.
+constexpr int RNG_LANES = 256;
 
-// This implementation aims to emulate the corresponding method in the CUDA
-// backend, in order to produce the exact same numbers as CUDA.
-// A stride of WRITE_STRIDE (256) is applied between each write
-// (emulating the CUDA thread writing to 4 locations with a stride of
-// blockDim.x, which is 256).
-// ELEMS_PER_ITER correspond to elementsPerBlock in the CUDA backend, so each
-// "iter" (iteration) here correspond to a CUDA thread block doing its work.
-// This change was prompted by issue #2429
+/// Uniform values of the first input of the Box-Muller transform
 template<typename T>
-void philoxUniform(T *out, size_t elements, const uintl seed, uintl counter) {
-    uint hi  = seed >> 32;
-    uint lo  = seed;
-    uint hic = counter >> 32;
-    uint loc = counter;
+compute_t<T> boxMullerNegative11(uint *val, uint index);
 
-    constexpr size_t RESET_CTR = MAX_RESET_CTR_VAL / sizeof(T);
-    constexpr size_t ELEMS_PER_ITER =
-        WRITE_STRIDE * 4 * sizeof(uint) / sizeof(T);
-
-    int num_iters = divup(elements, ELEMS_PER_ITER);
-    size_t len    = num_iters * ELEMS_PER_ITER;
-
-    constexpr size_t NUM_WRITES = 16 / sizeof(T);
-    for (size_t iter = 0; iter < len; iter += ELEMS_PER_ITER) {
-        for (size_t i = 0; i < WRITE_STRIDE; i += RESET_CTR) {
-            for (size_t j = 0; j < RESET_CTR; ++j) {
-                // first_write_idx is the first of the 4 locations that will
-                // be written to
-                uintptr_t first_write_idx = iter + i + j;
-                if (first_write_idx >= elements) { break; }
-
-                // Recalculate key and ctr to emulate how the CUDA backend
-                // calculates these per thread
-                uint key[2] = {lo, hi};
-                uint ctr[4] = {loc + (uint)first_write_idx, 0, 0, 0};
-                ctr[1]      = hic + (ctr[0] < loc);
-                ctr[2]      = (ctr[1] < hic);
-                philox(key, ctr);
-
-                // Use the same ctr array for each of the 4 locations,
-                // but each of the location gets a different ctr value
-                for (size_t buf_idx = 0; buf_idx < NUM_WRITES; ++buf_idx) {
-                    size_t out_idx = iter + buf_idx * WRITE_STRIDE + i + j;
-                    if (out_idx < elements) {
-                        out[out_idx] = transform<T>(ctr, buf_idx);
-                    }
-                }
-            }
-        }
-    }
+template<>
+float boxMullerNegative11<float>(uint *val, uint index) {
+    return getFloatNegative11(val, index);
 }
 
-#undef MAX_RESET_CTR_VAL
-#undef WRITE_STRIDE
+template<>
+double boxMullerNegative11<double>(uint *val, uint index) {
+    return getDoubleNegative11(val, index);
+}
 
+template<>
+float boxMullerNegative11<common::half>(uint *val, uint index) {
+    return static_cast<float>(getHalfNegative11(val, index));
+}
+
+/// Uniform values of the second input of the Box-Muller transform
 template<typename T>
-void threefryUniform(T *out, size_t elements, const uintl seed, uintl counter) {
-    uint hi     = seed >> 32;
-    uint lo     = seed;
-    uint hic    = counter >> 32;
-    uint loc    = counter;
-    uint key[2] = {lo, hi};
-    uint ctr[2] = {loc, hic};
-    uint val[2];
-
-    int reset = (2 * sizeof(uint)) / sizeof(T);
-    for (int i = 0; i < (int)elements; i += reset) {
-        threefry(key, ctr, val);
-        ++ctr[0];
-        ctr[1] += (ctr[0] == 0);
-        int lim = (reset < (int)(elements - i)) ? reset : (int)(elements - i);
-        for (int j = 0; j < lim; ++j) { out[i + j] = transform<T>(val, j); }
-    }
+compute_t<T> boxMuller01(uint *val, uint index);
+
+template<>
+float boxMuller01<float>(uint *val, uint index) {
+    return getFloat01(val, index);
+}
+
+template<>
+double boxMuller01<double>(uint *val, uint index) {
+    return getDouble01(val, index);
+}
+
+template<>
+float boxMuller01<common::half>(uint *val, uint index) {
+    return static_cast<float>(getHalf01(val, index));
 }
 
 template<typename T>
@@ -258,72 +225,220 @@ void boxMullerTransform(data_t<T> *const out1, data_t<T> *const out2,
     *out2 = r * cos(theta);
 }
 
-void boxMullerTransform(uint val[4], double *temp) {
-    boxMullerTransform<double>(&temp[0], &temp[1], getDoubleNegative11(val, 0),
-                               getDouble01(val, 1));
+/// Box-Muller transform of \p n pairs of uniform values
+void boxMullerTransform(double *out1, double *out2, const double *r1,
+                        const double *r2, int n) {
+    for (int i = 0; i < n; ++i) {
+        boxMullerTransform<double>(&out1[i], &out2[i], r1[i], r2[i]);
+    }
 }
 
-void boxMullerTransform(uint val[4], float *temp) {
-    boxMullerTransform<float>(&temp[0], &temp[1], getFloatNegative11(val, 0),
-                              getFloat01(val, 1));
-    boxMullerTransform<float>(&temp[2], &temp[3], getFloatNegative11(val, 2),
-                              getFloat01(val, 3));
+void boxMullerTransform(float *out1, float *out2, const float *r1,
+                        const float *r2, int n) {
+    simd::boxMuller(out1, out2, r1, r2, n);
 }
 
-void boxMullerTransform(uint val[4], common::half *temp) {
-    using common::half;
-    boxMullerTransform<half>(&temp[0], &temp[1], getHalfNegative11(val, 0),
-                             getHalf01(val, 1));
-    boxMullerTransform<half>(&temp[2], &temp[3], getHalfNegative11(val, 2),
-                             getHalf01(val, 3));
-    boxMullerTransform<half>(&temp[4], &temp[5], getHalfNegative11(val, 4),
-                             getHalf01(val, 5));
-    boxMullerTransform<half>(&temp[6], &temp[7], getHalfNegative11(val, 6),
-                             getHalf01(val, 7));
+void boxMullerTransform(common::half *out1, common::half *out2,
+                        const float *r1, const float *r2, int n) {
+    float temp1[2 * RNG_LANES];
+    float temp2[2 * RNG_LANES];
+    simd::boxMuller(temp1, temp2, r1, r2, n);
+    for (int i = 0; i < n; ++i) {
+        out1[i] = static_cast<common::half>(temp1[i]);
+        out2[i] = static_cast<common::half>(temp2[i]);
+    }
 }
 
+/// Writes the normal values of the random numbers \p val to \p out. Every
+/// 4 * sizeof(uint) bytes of \p val produce 4 * sizeof(uint) / sizeof(T)
+/// values. The two values of each pair are stored next to each other.
 template<typename T>
-void philoxNormal(T *out, size_t elements, const uintl seed, uintl counter) {
-    uint hi     = seed >> 32;
-    uint lo     = seed;
-    uint hic    = counter >> 32;
-    uint loc    = counter;
-    uint key[2] = {lo, hi};
-    uint ctr[4] = {loc, hic, 0, 0};
-    T temp[(4 * sizeof(uint)) / sizeof(T)];
+void boxMullerStream(T *out, uint *val, int elements) {
+    using Tc = compute_t<T>;
+    Tc r1[2 * RNG_LANES];
+    Tc r2[2 * RNG_LANES];
+    T out1[2 * RNG_LANES];
+    T out2[2 * RNG_LANES];
+
+    const int npairs = divup(elements, 2);
+    for (int i = 0; i < npairs; ++i) {
+        r1[i] = boxMullerNegative11<T>(val, 2 * i);
+        r2[i] = boxMuller01<T>(val, 2 * i + 1);
+    }
+    boxMullerTransform(out1, out2, r1, r2, npairs);
+    for (int i = 0; i < elements; ++i) {
+        out[i] = (i & 1) ? out2[i >> 1] : out1[i >> 1];
+    }
+}
 
-    int reset = (4 * sizeof(uint)) / sizeof(T);
-    for (int i = 0; i < (int)elements; i += reset) {
-        philox(key, ctr);
-        boxMullerTransform(ctr, temp);
-        int lim = (reset < (int)(elements - i)) ? reset : (int)(elements - i);
-        for (int j = 0; j < lim; ++j) { out[i + j] = temp[j]; }
+/// Runs Philox on the RNG_LANES counters that start \p offset after the
+/// counter (\p loc, \p hic). Word i of the result of lane t is in r[i][t].
+inline void philoxLanes(uint r[4][RNG_LANES], uint lo, uint hi, uint loc,
+                        uint hic, size_t offset) {
+    for (int t = 0; t < RNG_LANES; ++t) {
+        r[0][t] = loc + static_cast<uint>(offset + t);
+        r[1][t] = hic + (r[0][t] < loc);
+        r[2][t] = (r[1][t] < hic);
+        r[3][t] = 0;
+    }
+    simd::philox(r[0], r[1], r[2], r[3], lo, hi, RNG_LANES);
+}
+
+/// Runs Threefry on the \p n counters following \p counter. The words of
+/// the results are stored next to each other in \p val.
+inline void threefryLanes(uint *val, uint lo, uint hi, uintl counter, int n) {
+    uint c0[RNG_LANES];
+    uint c1[RNG_LANES];
+    for (int t = 0; t < n; ++t) {
+        const uintl ctr = counter + t;
+        c0[t]           = static_cast<uint>(ctr);
+        c1[t]           = static_cast<uint>(ctr >> 32);
+    }
+    simd::threefry(c0, c1, lo, hi, n);
+    for (int t = 0; t < n; ++t) {
+        val[2 * t]     = c0[t];
+        val[2 * t + 1] = c1[t];
     }
 }
 
+// This implementation aims to emulate the corresponding method in the CUDA
+// backend, in order to produce the exact same numbers as CUDA.
+// A stride of RNG_LANES (256) is applied between each write
+// (emulating the CUDA thread writing to 4 locations with a stride of
+// blockDim.x, which is 256).
+// ELEMS_PER_ITER correspond to elementsPerBlock in the CUDA backend, so each
+// "iter" (iteration) here correspond to a CUDA thread block doing its work.
+// The blocks are independent and are generated in parallel.
+// This change was prompted by issue #2429
 template<typename T>
-void threefryNormal(T *out, size_t elements, const uintl seed, uintl counter) {
-    uint hi     = seed >> 32;
-    uint lo     = seed;
-    uint hic    = counter >> 32;
-    uint loc    = counter;
-    uint key[2] = {lo, hi};
-    uint ctr[2] = {loc, hic};
-    uint val[4];
-    T temp[(4 * sizeof(uint)) / sizeof(T)];
+void philoxUniform(T *out, size_t elements, const uintl seed, uintl counter) {
+    uint hi  = seed >> 32;
+    uint lo  = seed;
+    uint hic = counter >> 32;
+    uint loc = counter;
 
-    int reset = (4 * sizeof(uint)) / sizeof(T);
-    for (int i = 0; i < (int)elements; i += reset) {
-        threefry(key, ctr, val);
-        ++ctr[0];
-        ctr[1] += (ctr[0] == 0);
-        threefry(key, ctr, val + 2);
-        ++ctr[0];
-        ctr[1] += (ctr[0] == 0);
-        boxMullerTransform(val, temp);
-        int lim = (reset < (int)(elements - i)) ? reset : (int)(elements - i);
-        for (int j = 0; j < lim; ++j) { out[i + j] = temp[j]; }
-    }
+    constexpr size_t ELEMS_PER_ITER = RNG_LANES * 4 * sizeof(uint) / sizeof(T);
+    constexpr size_t NUM_WRITES     = 16 / sizeof(T);
+
+    const dim_t num_iters = divup(elements, ELEMS_PER_ITER);
+    const dim_t grain     = parallelGrain(ELEMS_PER_ITER);
+    parallel_for(0, num_iters, grain, [&](dim_t first, dim_t last) {
+        uint r[4][RNG_LANES];
+        for (dim_t it = first; it < last; ++it) {
+            const size_t iter = it * ELEMS_PER_ITER;
+            philoxLanes(r, lo, hi, loc, hic, iter);
+
+            // Each lane writes to NUM_WRITES locations, but each of the
+            // locations gets a different part of its result
+            for (size_t buf_idx = 0; buf_idx < NUM_WRITES; ++buf_idx) {
+                const size_t base = iter + buf_idx * RNG_LANES;
+                const size_t lim  = std::min<size_t>(
+                    RNG_LANES, elements > base ? elements - base : 0);
+                for (size_t t = 0; t < lim; ++t) {
+                    uint ctr[4]   = {r[0][t], r[1][t], r[2][t], r[3][t]};
+                    out[base + t] = transform<T>(ctr, buf_idx);
+                }
+            }
+        }
+    });
+}
+
+template<typename T>
+void threefryUniform(T *out, size_t elements, const uintl seed, uintl counter) {
+    uint hi = seed >> 32;
+    uint lo = seed;
+
+    // Each counter produces reset values
+    constexpr size_t reset = (2 * sizeof(uint)) / sizeof(T);
+    constexpr size_t chunk = RNG_LANES * reset;
+
+    const dim_t nchunks = divup(elements, chunk);
+    const dim_t grain   = parallelGrain(chunk);
+    parallel_for(0, nchunks, grain, [&](dim_t first, dim_t last) {
+        uint val[2 * RNG_LANES];
+        for (dim_t c = first; c < last; ++c) {
+            const size_t begin = c * chunk;
+            const size_t lim   = std::min(chunk, elements - begin);
+            threefryLanes(val, lo, hi, counter + c * RNG_LANES,
+                          static_cast<int>(divup(lim, reset)));
+            for (size_t i = 0; i < lim; ++i) {
+                out[begin + i] = transform<T>(val + 2 * (i / reset), i % reset);
+            }
+        }
+    });
+}
+
+// Emulates the normal values of the CUDA backend. Each lane writes the pairs
+// of values produced by its counter RNG_LANES apart.
+template<typename T>
+void philoxNormal(T *out, size_t elements, const uintl seed, uintl counter) {
+    using Tc = compute_t<T>;
+    uint hi  = seed >> 32;
+    uint lo  = seed;
+    uint hic = counter >> 32;
+    uint loc = counter;
+
+    constexpr size_t ELEMS_PER_ITER = RNG_LANES * 4 * sizeof(uint) / sizeof(T);
+    constexpr int NUM_PAIRS         = 8 / sizeof(T);
+
+    const dim_t num_iters = divup(elements, ELEMS_PER_ITER);
+    const dim_t grain     = parallelGrain(ELEMS_PER_ITER);
+    parallel_for(0, num_iters, grain, [&](dim_t first, dim_t last) {
+        uint r[4][RNG_LANES];
+        Tc r1[RNG_LANES];
+        Tc r2[RNG_LANES];
+        T out1[RNG_LANES];
+        T out2[RNG_LANES];
+        for (dim_t it = first; it < last; ++it) {
+            const size_t iter = it * ELEMS_PER_ITER;
+            const bool full   = iter + ELEMS_PER_ITER <= elements;
+            philoxLanes(r, lo, hi, loc, hic, iter);
+
+            for (int p = 0; p < NUM_PAIRS; ++p) {
+                for (int t = 0; t < RNG_LANES; ++t) {
+                    uint ctr[4] = {r[0][t], r[1][t], r[2][t], r[3][t]};
+                    r1[t]       = boxMullerNegative11<T>(ctr, 2 * p);
+                    r2[t]       = boxMuller01<T>(ctr, 2 * p + 1);
+                }
+
+                T *dst1 = out + iter + 2 * p * RNG_LANES;
+                T *dst2 = dst1 + RNG_LANES;
+                if (full) {
+                    boxMullerTransform(dst1, dst2, r1, r2, RNG_LANES);
+                    continue;
+                }
+                boxMullerTransform(out1, out2, r1, r2, RNG_LANES);
+                for (int t = 0; t < RNG_LANES; ++t) {
+                    const size_t idx = iter + 2 * p * RNG_LANES + t;
+                    if (idx < elements) { dst1[t] = out1[t]; }
+                    if (idx + RNG_LANES < elements) { dst2[t] = out2[t]; }
+                }
+            }
+        }
+    });
+}
+
+template<typename T>
+void threefryNormal(T *out, size_t elements, const uintl seed, uintl counter) {
+    uint hi = seed >> 32;
+    uint lo = seed;
+
+    // Every two counters produce reset values
+    constexpr size_t reset = (4 * sizeof(uint)) / sizeof(T);
+    constexpr size_t chunk = RNG_LANES / 2 * reset;
+
+    const dim_t nchunks = divup(elements, chunk);
+    const dim_t grain   = parallelGrain(chunk);
+    parallel_for(0, nchunks, grain, [&](dim_t first, dim_t last) {
+        uint val[2 * RNG_LANES];
+        for (dim_t c = first; c < last; ++c) {
+            const size_t begin = c * chunk;
+            const size_t lim   = std::min(chunk, elements - begin);
+            threefryLanes(val, lo, hi, counter + c * RNG_LANES,
+                          2 * static_cast<int>(divup(lim, reset)));
+            boxMullerStream(out + begin, val, static_cast<int>(lim));
+        }
+    });
 }
 
 template<typename T>
@@ -357,22 +472,24 @@ void normalDistributionMT(T *out, size_t elements, uint *const state,
                           const uint *const sh2, uint mask,
                           const uint *const recursion_table,
                           const uint *const temper_table) {
-    T temp[(4 * sizeof(uint)) / sizeof(T)];
     uint l_state[STATE_SIZE];
-    uint o[4];
+    uint o[2 * RNG_LANES];
     uint lpos = pos[0];
     uint lsh1 = sh1[0];
     uint lsh2 = sh2[0];
 
     state_read(l_state, state);
 
+    // The random numbers of a chunk are transformed together
     int reset = (4 * sizeof(uint)) / sizeof(T);
-    for (int i = 0; i < (int)elements; i += reset) {
-        mersenne(o, l_state, i, lpos, lsh1, lsh2, mask, recursion_table,
-                 temper_table);
-        boxMullerTransform(o, temp);
-        int lim = (reset < (int)(elements - i)) ? reset : (int)(elements - i);
-        for (int j = 0; j < lim; ++j) { out[i + j] = temp[j]; }
+    int chunk = RNG_LANES / 2 * reset;
+    for (int c = 0; c < (int)elements; c += chunk) {
+        int lim = (chunk < (int)(elements - c)) ? chunk : (int)(elements - c);
+        for (int i = 0, j = 0; i < lim; i += reset, j += 4) {
+            mersenne(o + j, l_state, c + i, lpos, lsh1, lsh2, mask,
+                     recursion_table, temper_table);
+        }
+        boxMullerStream(out + c, o, lim);
     }
 
     state_write(state, l_state);
@@ -11,55 +11,318 @@
 #include <Param.hpp>
 #include <common/Binary.hpp>
 #include <common/Transform.hpp>
+#include <common/dispatch.hpp>
 #include <common/half.hpp>
+#include <parallel.hpp>
+
+#include <algorithm>
+#include <array>
+#include <vector>
 
 namespace cpu {
 namespace kernel {
 
-template<af_op_t op, typename Ti, typename To, int D>
-struct reduce_dim {
-    void operator()(Param<To> out, const dim_t outOffset, CParam<Ti> in,
-                    const dim_t inOffset, const int dim, bool change_nan,
-                    double nanval) {
-        static const int D1 = D - 1;
-        reduce_dim<op, Ti, To, D1> reduce_dim_next;
+/// Maximum number of elements along the reduced dimension that a single task
+/// reduces. The partial results of the blocks are always combined in the same
+/// order so the result doesn't depend on the number of threads.
+constexpr dim_t REDUCE_BLOCK = 32768;
+
+/// Number of dim 0 elements that are accumulated together when reducing
+/// along dimensions 1-3
+constexpr dim_t REDUCE_TILE = 1024;
+
+/// Number of independent accumulators used for contiguous reductions. They
+/// break the dependency between consecutive elements so that the loop can be
+/// vectorized.
+constexpr int REDUCE_LANES = 8;
+
+/// Maximum number of partial results stored when a reduction along
+/// dimensions 1-3 is split into blocks
+constexpr dim_t REDUCE_MAX_PARTIALS = 1 << 20;
+
+template<af_op_t op, typename Ti, typename To>
+struct Reducer {
+    using Tc = compute_t<To>;
+
+    common::Transform<data_t<Ti>, Tc, op> transform;
+    common::Binary<Tc, op> reduce;
+    bool change_nan;
+    Tc nanval;
+
+    Reducer(bool change_nan_, double nanval_)
+        : change_nan(change_nan_), nanval(static_cast<Tc>(nanval_)) {}
 
-        const af::dim4 ostrides = out.strides();
-        const af::dim4 istrides = in.strides();
-        const af::dim4 odims    = out.dims();
+    Tc load(data_t<Ti> in) {
+        Tc val = transform(in);
+        return (change_nan && IS_NAN(val)) ? nanval : val;
+    }
+
+    /// Reduces \p n elements of \p in that are \p stride elements apart
+    Tc run(const data_t<Ti> *in, dim_t n, dim_t stride) {
+        Tc acc[REDUCE_LANES];
+        for (int j = 0; j < REDUCE_LANES; j++) { acc[j] = reduce.init(); }
+
+        dim_t i = 0;
+        if (stride == 1) {
+            for (; i + REDUCE_LANES <= n; i += REDUCE_LANES) {
+                for (int j = 0; j < REDUCE_LANES; j++) {
+                    acc[j] = reduce(load(in[i + j]), acc[j]);
+                }
+            }
+        }
+        for (; i < n; i++) { acc[0] = reduce(load(in[i * stride]), acc[0]); }
 
-        for (dim_t i = 0; i < odims[D1]; i++) {
-            reduce_dim_next(out, outOffset + i * ostrides[D1], in,
-                            inOffset + i * istrides[D1], dim, change_nan,
-                            nanval);
+        for (int w = REDUCE_LANES / 2; w > 0; w /= 2) {
+            for (int j = 0; j < w; j++) { acc[j] = reduce(acc[j], acc[j + w]); }
+        }
+        return acc[0];
+    }
+
+    /// Accumulates \p n rows of \p width elements into \p acc. The rows are
+    /// \p stride elements apart and the elements of a row \p xstride apart.
+    void runRows(Tc *acc, const data_t<Ti> *in, dim_t width, dim_t xstride,
+                 dim_t n, dim_t stride) {
+        for (dim_t k = 0; k < n; k++) {
+            const data_t<Ti> *row = in + k * stride;
+            if (xstride == 1) {
+                for (dim_t x = 0; x < width; x++) {
+                    acc[x] = reduce(load(row[x]), acc[x]);
+                }
+            } else {
+                for (dim_t x = 0; x < width; x++) {
+                    acc[x] = reduce(load(row[x * xstride]), acc[x]);
+                }
+            }
         }
     }
 };
 
+/// Returns the offset of row \p row, counted along dimensions 1-3
+inline dim_t rowOffset(dim_t row, const af::dim4 &dims,
+                       const af::dim4 &strides) {
+    const dim_t y = row % dims[1];
+    const dim_t z = (row / dims[1]) % dims[2];
+    const dim_t w = row / (dims[1] * dims[2]);
+    return y * strides[1] + z * strides[2] + w * strides[3];
+}
+
+/// Reduces along dimension 0. The rows, and blocks of long rows, are
+/// reduced in parallel.
 template<af_op_t op, typename Ti, typename To>
-struct reduce_dim<op, Ti, To, 0> {
-    common::Transform<data_t<Ti>, compute_t<To>, op> transform;
-    common::Binary<compute_t<To>, op> reduce;
-    void operator()(Param<To> out, const dim_t outOffset, CParam<Ti> in,
-                    const dim_t inOffset, const int dim, bool change_nan,
-                    double nanval) {
-        const af::dim4 istrides = in.strides();
-        const af::dim4 idims    = in.dims();
-
-        data_t<To> *const outPtr      = out.get() + outOffset;
-        data_t<Ti> const *const inPtr = in.get() + inOffset;
-        dim_t stride                  = istrides[dim];
-
-        compute_t<To> out_val = common::Binary<compute_t<To>, op>::init();
-        for (dim_t i = 0; i < idims[dim]; i++) {
-            compute_t<To> in_val = transform(inPtr[i * stride]);
-            if (change_nan) in_val = IS_NAN(in_val) ? nanval : in_val;
-            out_val = reduce(in_val, out_val);
+void reduce_first(Param<To> out, CParam<Ti> in, bool change_nan,
+                  double nanval) {
+    using Tc = compute_t<To>;
+    const Reducer<op, Ti, To> reducer(change_nan, nanval);
+
+    const af::dim4 idims    = in.dims();
+    const af::dim4 istrides = in.strides();
+    const af::dim4 odims    = out.dims();
+    const af::dim4 ostrides = out.strides();
+
+    const dim_t len     = idims[0];
+    const dim_t nrows   = idims[1] * idims[2] * idims[3];
+    const dim_t nblocks = std::max<dim_t>(divup(len, REDUCE_BLOCK), 1);
+    const dim_t grain =
+        divup(REDUCE_BLOCK, std::max<dim_t>(std::min(len, REDUCE_BLOCK), 1));
+
+    data_t<To> *const outPtr      = out.get();
+    data_t<Ti> const *const inPtr = in.get();
+    std::vector<Tc> partials(nblocks > 1 ? nrows * nblocks : 0);
+
+    parallel_for(0, nrows * nblocks, grain, [&](dim_t begin, dim_t end) {
+        Reducer<op, Ti, To> r = reducer;
+        for (dim_t t = begin; t < end; t++) {
+            const dim_t row   = t / nblocks;
+            const dim_t first = (t % nblocks) * REDUCE_BLOCK;
+            const dim_t n     = std::min(REDUCE_BLOCK, len - first);
+
+            const Tc val = r.run(inPtr + rowOffset(row, idims, istrides) +
+                                     first * istrides[0],
+                                 n, istrides[0]);
+            if (nblocks == 1) {
+                outPtr[rowOffset(row, odims, ostrides)] = data_t<To>(val);
+            } else {
+                partials[t] = val;
+            }
+        }
+    });
+
+    if (nblocks == 1) { return; }
+    parallel_for(0, nrows, 1, [&](dim_t begin, dim_t end) {
+        Reducer<op, Ti, To> r = reducer;
+        for (dim_t row = begin; row < end; row++) {
+            Tc val = partials[row * nblocks];
+            for (dim_t b = 1; b < nblocks; b++) {
+                val = r.reduce(partials[row * nblocks + b], val);
+            }
+            outPtr[rowOffset(row, odims, ostrides)] = data_t<To>(val);
+        }
+    });
+}
+
+/// Reduces along dimensions 1-3. Contiguous tiles of dim 0 are accumulated
+/// row by row so the input is read in memory order. Tiles, and blocks of
+/// rows when there are few tiles, are reduced in parallel.
+template<af_op_t op, typename Ti, typename To>
+void reduce_other(Param<To> out, CParam<Ti> in, const int dim,
+                  bool change_nan, double nanval) {
+    using Tc = compute_t<To>;
+    const Reducer<op, Ti, To> reducer(change_nan, nanval);
+
+    const af::dim4 idims    = in.dims();
+    const af::dim4 istrides = in.strides();
+    const af::dim4 ostrides = out.strides();
+
+    // The two dimensions that are neither dim 0 nor the reduced dimension
+    dim_t sdims[2], sistrides[2], sostrides[2];
+    for (int d = 1, s = 0; d < 4; d++) {
+        if (d == dim) { continue; }
+        sdims[s]     = idims[d];
+        sistrides[s] = istrides[d];
+        sostrides[s] = ostrides[d];
+        s++;
+    }
+
+    const dim_t width   = idims[0];
+    const dim_t len     = idims[dim];
+    const dim_t stride  = istrides[dim];
+    const dim_t nslices = sdims[0] * sdims[1];
+    const dim_t ntiles  = divup(width, REDUCE_TILE);
+
+    // Split the rows into blocks of about REDUCE_BLOCK elements as long as
+    // the partial results stay small
+    dim_t rowsPerBlock = std::max<dim_t>(
+        REDUCE_BLOCK / std::max<dim_t>(std::min(width, REDUCE_TILE), 1), 1);
+    dim_t nblocks      = std::min(
+        divup(len, rowsPerBlock),
+        REDUCE_MAX_PARTIALS / std::max<dim_t>(nslices * width, 1));
+    nblocks      = std::max<dim_t>(nblocks, 1);
+    rowsPerBlock = std::max<dim_t>(divup(len, nblocks), 1);
+    nblocks      = std::max<dim_t>(divup(len, rowsPerBlock), 1);
+
+    data_t<To> *const outPtr      = out.get();
+    data_t<Ti> const *const inPtr = in.get();
+    std::vector<Tc> partials(nblocks > 1 ? nslices * nblocks * width : 0);
+
+    parallel_for(0, nslices * ntiles * nblocks, 1, [&](dim_t begin,
+                                                        dim_t end) {
+        Reducer<op, Ti, To> r = reducer;
+        std::array<Tc, REDUCE_TILE> acc;
+        for (dim_t t = begin; t < end; t++) {
+            const dim_t slice = t / (ntiles * nblocks);
+            const dim_t tile  = (t / nblocks) % ntiles;
+            const dim_t b     = t % nblocks;
+            const dim_t s0    = slice % sdims[0];
+            const dim_t s1    = slice / sdims[0];
+
+            const dim_t x0 = tile * REDUCE_TILE;
+            const dim_t w  = std::min(REDUCE_TILE, width - x0);
+            const dim_t k0 = b * rowsPerBlock;
+            const dim_t n  = std::min(rowsPerBlock, len - k0);
+
+            std::fill(acc.begin(), acc.begin() + w, r.reduce.init());
+            r.runRows(acc.data(),
+                      inPtr + s0 * sistrides[0] + s1 * sistrides[1] +
+                          x0 * istrides[0] + k0 * stride,
+                      w, istrides[0], n, stride);
+
+            if (nblocks == 1) {
+                data_t<To> *o = outPtr + s0 * sostrides[0] +
+                                s1 * sostrides[1] + x0 * ostrides[0];
+                for (dim_t x = 0; x < w; x++) {
+                    o[x * ostrides[0]] = data_t<To>(acc[x]);
+                }
+            } else {
+                std::copy(acc.begin(), acc.begin() + w,
+                          partials.begin() + (slice * nblocks + b) * width +
+                              x0);
+            }
         }
+    });
 
-        *outPtr = data_t<To>(out_val);
+    if (nblocks == 1) { return; }
+    parallel_for(0, nslices * width, REDUCE_TILE, [&](dim_t begin,
+                                                      dim_t end) {
+        Reducer<op, Ti, To> r = reducer;
+        for (dim_t i = begin; i < end; i++) {
+            const dim_t slice = i / width;
+            const dim_t x     = i % width;
+            const Tc *p       = &partials[slice * nblocks * width + x];
+
+            Tc val = p[0];
+            for (dim_t b = 1; b < nblocks; b++) {
+                val = r.reduce(p[b * width], val);
+            }
+            outPtr[(slice % sdims[0]) * sostrides[0] +
+                   (slice / sdims[0]) * sostrides[1] + x * ostrides[0]] =
+                data_t<To>(val);
+        }
+    });
+}
+
+template<af_op_t op, typename Ti, typename To>
+void reduce(Param<To> out, CParam<Ti> in, const int dim, bool change_nan,
+            double nanval) {
+    if (dim == 0) {
+        reduce_first<op, Ti, To>(out, in, change_nan, nanval);
+    } else {
+        reduce_other<op, Ti, To>(out, in, dim, change_nan, nanval);
     }
-};
+}
+
+/// Reduces all the elements of \p in. Blocks of about REDUCE_BLOCK elements
+/// are reduced in parallel and their results combined in order.
+template<af_op_t op, typename Ti, typename To>
+compute_t<To> reduce_all(CParam<Ti> in, bool change_nan, double nanval) {
+    using Tc = compute_t<To>;
+    const Reducer<op, Ti, To> reducer(change_nan, nanval);
+
+    af::dim4 idims    = in.dims();
+    af::dim4 istrides = in.strides();
+
+    // Linear arrays are reduced as a single row
+    if (istrides[0] == 1 && istrides[1] == idims[0] &&
+        istrides[2] == idims[0] * idims[1] &&
+        istrides[3] == idims[0] * idims[1] * idims[2]) {
+        idims = af::dim4(idims.elements(), 1, 1, 1);
+    }
+
+    const dim_t len     = idims[0];
+    const dim_t nrows   = idims[1] * idims[2] * idims[3];
+    const dim_t nblocks = std::max<dim_t>(divup(len, REDUCE_BLOCK), 1);
+    const dim_t rowsPerTask =
+        nblocks > 1 ? 1
+                    : std::max<dim_t>(REDUCE_BLOCK / std::max<dim_t>(len, 1),
+                                      1);
+    const dim_t ntasks = divup(nrows, rowsPerTask) * nblocks;
+
+    data_t<Ti> const *const inPtr = in.get();
+    std::vector<Tc> partials(ntasks);
+
+    parallel_for(0, ntasks, 1, [&](dim_t begin, dim_t end) {
+        Reducer<op, Ti, To> r = reducer;
+        for (dim_t t = begin; t < end; t++) {
+            const dim_t row0  = (t / nblocks) * rowsPerTask;
+            const dim_t rows  = std::min(rowsPerTask, nrows - row0);
+            const dim_t first = (t % nblocks) * REDUCE_BLOCK;
+            const dim_t n     = std::min(REDUCE_BLOCK, len - first);
+
+            Tc val = r.reduce.init();
+            for (dim_t row = row0; row < row0 + rows; row++) {
+                val = r.reduce(r.run(inPtr + rowOffset(row, idims, istrides) +
+                                         first * istrides[0],
+                                     n, istrides[0]),
+                               val);
+            }
+            partials[t] = val;
+        }
+    });
+
+    Reducer<op, Ti, To> r = reducer;
+    Tc val                = r.reduce.init();
+    for (const Tc &partial : partials) { val = r.reduce(partial, val); }
+    return val;
+}
 
 template<typename Tk>
 void n_reduced_keys(Param<Tk> okeys, int *n_reduced, CParam<Tk> keys) {
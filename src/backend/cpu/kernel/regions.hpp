@@ -10,158 +10,254 @@
 #pragma once
 #include <Param.hpp>
 #include <memory.hpp>
-#include <map>
-#include <set>
+#include <parallel.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <vector>
 
 namespace cpu {
 namespace kernel {
 
-template<typename T>
-class LabelNode {
-   private:
-    T label;
-    T minLabel;
-    unsigned rank;
-    LabelNode* parent;
+/// Returns the root of the set of label \p x and halves the path to it
+template<typename L>
+L findRoot(L* parent, L x) {
+    while (parent[x] != x) {
+        parent[x] = parent[parent[x]];
+        x         = parent[x];
+    }
+    return x;
+}
 
-   public:
-    LabelNode() : label(0), minLabel(0), rank(0), parent(this) {}
-    LabelNode(T label) : label(label), minLabel(label), rank(0), parent(this) {}
+/// Merges the sets of labels \p a and \p b under the smaller root and
+/// returns it. The root of every set is therefore its smallest label.
+template<typename L>
+L setUnion(L* parent, L a, L b) {
+    a = findRoot(parent, a);
+    b = findRoot(parent, b);
+    if (a < b) {
+        parent[b] = a;
+        return a;
+    }
+    parent[a] = b;
+    return b;
+}
 
-    T getLabel() { return label; }
+/// A neighbour of a pixel that precedes it in raster order
+struct RegionsNeighbour {
+    int di, dj, dk;
+    /// Set if the neighbour is also connected to the previous pixel of the
+    /// line, which already merged it when that pixel is foreground
+    bool nextToPrevious;
+};
 
-    T getMinLabel() { return minLabel; }
+/// Returns the neighbours that precede a pixel in raster order and are not
+/// on its own line
+inline std::vector<RegionsNeighbour> regionsNeighbours(
+    af_connectivity connectivity, bool is3D) {
+    std::vector<RegionsNeighbour> result;
+    const bool full = connectivity == AF_CONNECTIVITY_8;
+    for (int dk = (is3D ? -1 : 0); dk <= 0; ++dk) {
+        for (int dj = -1; dj <= (dk < 0 ? 1 : -1); ++dj) {
+            for (int di = -1; di <= 1; ++di) {
+                const int distance = (di != 0) + (dj != 0) + (dk != 0);
+                if (full || distance == 1) {
+                    result.push_back({di, dj, dk, full && di <= 0});
+                }
+            }
+        }
+    }
+    return result;
+}
 
-    LabelNode* getParent() { return parent; }
+/// Labels the connected components of the nonzero voxels of \p in.
+///
+/// The lines along the first dimension are split into slabs along the last
+/// dimension, which are labeled in parallel with provisional labels. The
+/// labels of a line start at a fixed base, so every slab gets a distinct
+/// range of labels. Equivalent labels are merged in a flat union-find array.
+/// The borders between slabs are merged afterwards. The labels are then
+/// replaced by the numbers of their components, which are ordered by the
+/// first voxel of each component in raster order.
+///
+/// \param[out] out          The labels of the voxels, zero for the
+///                          background
+/// \param[in]  in           The binary image or volume
+/// \param[in]  connectivity AF_CONNECTIVITY_4 connects voxels that share a
+///                          face, AF_CONNECTIVITY_8 also connects voxels that
+///                          share an edge or a corner
+/// \param[in]  lab          Storage for the provisional label of every voxel
+/// \param[in]  par          Storage for the union-find array
+template<typename T, typename L>
+void labelRegions(Param<T> out, CParam<char> in, af_connectivity connectivity,
+                  L* lab, L* par) {
+    const af::dim4 dims   = in.dims();
+    const af::dim4 oStrds = out.strides();
+    const dim_t s0        = in.strides()[0];
+    const dim_t s1        = in.strides()[1];
+    const dim_t s2        = in.strides()[2];
+    const dim_t d0        = dims[0];
+    const dim_t d1        = dims[1];
+    const dim_t d2        = dims[2];
+    const bool is3D       = d2 > 1;
 
-    unsigned getRank() { return rank; }
+    // The slabs are split along the last dimension
+    const int sd      = is3D ? 2 : 1;
+    const dim_t nsd   = dims[sd];
+    const dim_t slice = is3D ? d0 * d1 : d0;
 
-    void setMinLabel(T l) { minLabel = l; }
+    // A new label is only created when the previous voxel of its line is
+    // background, so a line needs at most (d0 + 1) / 2 labels
+    const L lineLabels = static_cast<L>((d0 + 1) / 2);
 
-    void setParent(LabelNode* p) { parent = p; }
+    const std::vector<RegionsNeighbour> neighbours =
+        regionsNeighbours(connectivity, is3D);
+    const size_t nn = neighbours.size();
 
-    void setRank(unsigned r) { rank = r; }
-};
+    const char* inPtr = in.get();
 
-template<typename T>
-static LabelNode<T>* find(LabelNode<T>* x) {
-    if (x->getParent() != x) x->setParent(find(x->getParent()));
-    return x->getParent();
-}
+    // One past the last label created on every line
+    std::vector<L> lineEnd(d1 * d2);
 
-template<typename T>
-static void setUnion(LabelNode<T>* x, LabelNode<T>* y) {
-    LabelNode<T>* xRoot = find(x);
-    LabelNode<T>* yRoot = find(y);
-    if (xRoot == yRoot) return;
-
-    T xMinLabel = xRoot->getMinLabel();
-    T yMinLabel = yRoot->getMinLabel();
-    xRoot->setMinLabel(std::min(xMinLabel, yMinLabel));
-    yRoot->setMinLabel(std::min(xMinLabel, yMinLabel));
-
-    if (xRoot->getRank() < yRoot->getRank())
-        xRoot->setParent(yRoot);
-    else if (xRoot->getRank() > yRoot->getRank())
-        yRoot->setParent(xRoot);
-    else {
-        yRoot->setParent(xRoot);
-        xRoot->setRank(xRoot->getRank() + 1);
-    }
-}
+    // Points to the labels of the neighbouring lines of line (j, k). Lines
+    // outside the volume or before position first along the slab dimension
+    // are set to nullptr.
+    auto neighbourLines = [&](dim_t j, dim_t k, dim_t first, const L** lines) {
+        for (size_t n = 0; n < nn; ++n) {
+            const dim_t nj   = j + neighbours[n].dj;
+            const dim_t nk   = k + neighbours[n].dk;
+            const dim_t pos  = is3D ? nk : nj;
+            const bool valid = nj >= 0 && nj < d1 && nk >= 0 && pos >= first;
+            lines[n]         = valid ? lab + (nj + nk * d1) * d0 : nullptr;
+        }
+    };
 
-template<typename T>
-void regions(Param<T> out, CParam<char> in, af_connectivity connectivity) {
-    const af::dim4 inDims = in.dims();
-    const char* inPtr     = in.get();
-    T* outPtr             = out.get();
-
-    // Map labels
-    typedef typename std::unique_ptr<LabelNode<T>> UnqLabelPtr;
-    typedef typename std::map<T, UnqLabelPtr> LabelMap;
-    typedef typename LabelMap::iterator LabelMapIterator;
-
-    LabelMap lmap;
-
-    // Initial label
-    T label = (T)1;
-
-    for (int j = 0; j < (int)inDims[1]; j++) {
-        for (int i = 0; i < (int)inDims[0]; i++) {
-            int idx = j * inDims[0] + i;
-            if (inPtr[idx] != 0) {
-                std::vector<T> l;
-
-                // Test neighbors
-                if (i > 0 && outPtr[j * (int)inDims[0] + i - 1] > 0)
-                    l.push_back(outPtr[j * inDims[0] + i - 1]);
-                if (j > 0 && outPtr[(j - 1) * (int)inDims[0] + i] > 0)
-                    l.push_back(outPtr[(j - 1) * inDims[0] + i]);
-                if (connectivity == AF_CONNECTIVITY_8 && i > 0 && j > 0 &&
-                    outPtr[(j - 1) * inDims[0] + i - 1] > 0)
-                    l.push_back(outPtr[(j - 1) * inDims[0] + i - 1]);
-                if (connectivity == AF_CONNECTIVITY_8 &&
-                    i < (int)inDims[0] - 1 && j > 0 &&
-                    outPtr[(j - 1) * inDims[0] + i + 1] != 0)
-                    l.push_back(outPtr[(j - 1) * inDims[0] + i + 1]);
-
-                if (!l.empty()) {
-                    T minl = l[0];
-                    for (size_t k = 0; k < l.size(); k++) {
-                        minl                        = std::min(l[k], minl);
-                        LabelMapIterator currentMap = lmap.find(l[k]);
-                        LabelNode<T>* node          = currentMap->second.get();
-                        // Group labels of the same region under a disjoint set
-                        for (size_t m = k + 1; m < l.size(); m++)
-                            setUnion(node, lmap.find(l[m])->second.get());
+    std::mutex startsMutex;
+    std::vector<dim_t> starts;
+
+    auto labelSlab = [&](dim_t first, dim_t last) {
+        {
+            std::lock_guard<std::mutex> lock(startsMutex);
+            starts.push_back(first);
+        }
+        std::vector<const L*> lines(nn);
+        const dim_t jBegin = is3D ? 0 : first;
+        const dim_t jEnd   = is3D ? d1 : last;
+        const dim_t kBegin = is3D ? first : 0;
+        const dim_t kEnd   = is3D ? last : 1;
+        for (dim_t k = kBegin; k < kEnd; ++k) {
+            for (dim_t j = jBegin; j < jEnd; ++j) {
+                const char* line = inPtr + j * s1 + k * s2;
+                L* curr          = lab + (j + k * d1) * d0;
+                L next           = 1 + static_cast<L>(j + k * d1) * lineLabels;
+                neighbourLines(j, k, first, lines.data());
+
+                // The last pair of labels that was merged. Runs of voxels
+                // usually see the same pair again.
+                L mergedA = 0;
+                L mergedB = 0;
+                for (dim_t i = 0; i < d0; ++i) {
+                    if (line[i * s0] == 0) {
+                        curr[i] = 0;
+                        continue;
                     }
-                    // Set label to smallest neighbor label
-                    outPtr[idx] = minl;
-                } else {
-                    // Insert new label in map
-                    lmap.insert(std::make_pair(
-                        label, UnqLabelPtr(new LabelNode<T>(label))));
-                    outPtr[idx] = label++;
+                    L l = i > 0 ? curr[i - 1] : 0;
+                    for (size_t n = 0; n < nn; ++n) {
+                        const RegionsNeighbour& nb = neighbours[n];
+                        const dim_t ni             = i + nb.di;
+                        if (!lines[n] || ni < 0 || ni >= d0) { continue; }
+                        if (l != 0 && i > 0 && nb.nextToPrevious &&
+                            curr[i - 1] != 0) {
+                            continue;
+                        }
+                        const L nl = lines[n][ni];
+                        if (nl == 0 || nl == l) { continue; }
+                        if (l == 0) {
+                            l = nl;
+                        } else if (l != mergedA || nl != mergedB) {
+                            l       = setUnion(par, l, nl);
+                            mergedA = l;
+                            mergedB = nl;
+                        }
+                    }
+                    if (l == 0) {
+                        l      = next++;
+                        par[l] = l;
+                    }
+                    curr[i] = l;
                 }
+                lineEnd[j + k * d1] = next;
             }
         }
-    }
-
-    std::set<T> removed;
-
-    for (int j = 0; j < (int)inDims[1]; j++) {
-        for (int i = 0; i < (int)inDims[0]; i++) {
-            int idx = j * (int)inDims[0] + i;
-            if (inPtr[idx] != 0) {
-                T l                         = outPtr[idx];
-                LabelMapIterator currentMap = lmap.find(l);
+    };
 
-                if (currentMap != lmap.end()) {
-                    LabelNode<T>* node = currentMap->second.get();
+    parallel_for(0, nsd, parallelGrain(slice), labelSlab);
 
-                    LabelNode<T>* nodeRoot = find(node);
-                    outPtr[idx]            = nodeRoot->getMinLabel();
-
-                    // Mark removed labels (those that are part of a region
-                    // that contains a smaller label)
-                    if (node->getMinLabel() < l || nodeRoot->getMinLabel() < l)
-                        removed.insert(l);
-                    if (node->getLabel() > node->getMinLabel())
-                        removed.insert(node->getLabel());
+    // Merge the first line or plane of every slab with the one before it
+    std::vector<const L*> lines(nn);
+    for (dim_t first : starts) {
+        if (first == 0) { continue; }
+        const dim_t jBegin = is3D ? 0 : first;
+        const dim_t jEnd   = is3D ? d1 : first + 1;
+        const dim_t k      = is3D ? first : 0;
+        for (dim_t j = jBegin; j < jEnd; ++j) {
+            const L* curr = lab + (j + k * d1) * d0;
+            neighbourLines(j, k, 0, lines.data());
+            for (size_t n = 0; n < nn; ++n) {
+                const bool before =
+                    is3D ? neighbours[n].dk < 0 : neighbours[n].dj < 0;
+                if (!before || !lines[n]) { continue; }
+                for (dim_t i = 0; i < d0; ++i) {
+                    const dim_t ni = i + neighbours[n].di;
+                    if (curr[i] == 0 || ni < 0 || ni >= d0) { continue; }
+                    const L nl = lines[n][ni];
+                    if (nl != 0) { setUnion(par, curr[i], nl); }
                 }
             }
         }
     }
 
-    // Calculate final neighbors (ensure final labels are sequential)
-    for (int j = 0; j < (int)inDims[1]; j++) {
-        for (int i = 0; i < (int)inDims[0]; i++) {
-            int idx = j * (int)inDims[0] + i;
-            if (outPtr[idx] > 0) {
-                outPtr[idx] -=
-                    distance(removed.begin(), removed.lower_bound(outPtr[idx]));
+    // Number the components in the order of their roots. Every label links
+    // to a smaller one, so the parent of a label has already been replaced
+    // by its component number when the label is reached.
+    L count = 0;
+    for (dim_t line = 0; line < d1 * d2; ++line) {
+        for (L l = 1 + static_cast<L>(line) * lineLabels; l < lineEnd[line];
+             ++l) {
+            par[l] = par[l] == l ? ++count : par[par[l]];
+        }
+    }
+
+    const dim_t nlines = d1 * d2;
+    parallel_for(0, nlines, parallelGrain(d0), [&](dim_t first, dim_t last) {
+        for (dim_t line = first; line < last; ++line) {
+            const dim_t j = line % d1;
+            const dim_t k = line / d1;
+            const L* curr = lab + line * d0;
+            T* o          = out.get() + j * oStrds[1] + k * oStrds[2];
+            for (dim_t i = 0; i < d0; ++i) {
+                o[i] = curr[i] ? static_cast<T>(par[curr[i]]) : T(0);
             }
         }
+    });
+}
+
+template<typename T>
+void regions(Param<T> out, CParam<char> in, af_connectivity connectivity) {
+    const af::dim4 dims = in.dims();
+    const dim_t nlines  = dims[1] * dims[2];
+    const dim_t nlabels = 1 + nlines * ((dims[0] + 1) / 2);
+
+    if (nlabels <= std::numeric_limits<uint32_t>::max()) {
+        auto labels = memAlloc<uint32_t>(dims[0] * nlines);
+        auto parent = memAlloc<uint32_t>(nlabels);
+        labelRegions<T>(out, in, connectivity, labels.get(), parent.get());
+    } else {
+        auto labels = memAlloc<dim_t>(dims[0] * nlines);
+        auto parent = memAlloc<dim_t>(nlabels);
+        labelRegions<T>(out, in, connectivity, labels.get(), parent.get());
     }
 }
 
@@ -11,6 +11,7 @@
 #include <Param.hpp>
 #include <common/complex.hpp>
 #include <math.hpp>
+#include <parallel.hpp>
 #include <af/traits.hpp>
 
 namespace cpu {
@@ -163,12 +164,16 @@ void resize(Param<T> out, CParam<T> in) {
     af::dim4 ostrides = out.strides();
     af::dim4 istrides = in.strides();
 
-    resize_op<T, method> op;
-    for (dim_t y = 0; y < odims[1]; y++) {
-        for (dim_t x = 0; x < odims[0]; x++) {
-            op(outPtr, inPtr, odims, idims, ostrides, istrides, x, y);
+    // Each call to op writes one pixel of every channel
+    const dim_t grain = parallelGrain(odims[0] * odims[2] * odims[3]);
+    parallel_for(0, odims[1], grain, [&](dim_t first, dim_t last) {
+        resize_op<T, method> op;
+        for (dim_t y = first; y < last; y++) {
+            for (dim_t x = 0; x < odims[0]; x++) {
+                op(outPtr, inPtr, odims, idims, ostrides, istrides, x, y);
+            }
         }
-    }
+    });
 }
 
 }  // namespace kernel
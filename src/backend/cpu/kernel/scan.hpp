@@ -11,64 +11,236 @@
 #include <Param.hpp>
 #include <common/Binary.hpp>
 #include <common/Transform.hpp>
+#include <common/dispatch.hpp>
+#include <parallel.hpp>
+#include <algorithm>
+#include <type_traits>
+#include <vector>
 
 namespace cpu {
 namespace kernel {
 
-template<af_op_t op, typename Ti, typename To, int D, bool inclusive_scan>
-struct scan_dim {
-    void operator()(Param<To> out, dim_t outOffset, CParam<Ti> in,
-                    dim_t inOffset, const int dim) const {
-        const af::dim4 odims    = out.dims();
-        const af::dim4 ostrides = out.strides();
-        const af::dim4 istrides = in.strides();
-
-        const int D1 = D - 1;
-        for (dim_t i = 0; i < odims[D1]; i++) {
-            scan_dim<op, Ti, To, D1, inclusive_scan> func;
-            func(out, outOffset + i * ostrides[D1], in,
-                 inOffset + i * istrides[D1], dim);
-            if (D1 == dim) break;
-        }
-    }
+/// Lines at least this long are scanned in blocks of this size that are
+/// processed in parallel
+constexpr dim_t SCAN_BLOCK = 1 << 14;
+
+/// Only shapes with fewer lines than this use the blocked scan. Many lines
+/// are scanned in parallel with each other instead. The choice depends only
+/// on the shape so the results don't depend on the number of threads.
+constexpr dim_t SCAN_BLOCKED_MAX_LINES = 16;
+
+/// Scans along dim > 0 process this many elements of every row at a time
+constexpr dim_t SCAN_ROW_CHUNK = 1024;
+
+/// Used in place of the keys by the scans without keys
+struct NoKey {};
+inline bool operator!=(NoKey, NoKey) { return false; }
+
+/// The elements of one scan. Each line is a set of elements along the scan
+/// dimension.
+template<typename Ti, typename Tk, typename To>
+struct ScanData {
+    const Ti *in;
+    const Tk *key;
+    To *out;
+    af::dim4 istrides;
+    af::dim4 kstrides;
+    af::dim4 ostrides;
 };
 
-template<af_op_t op, typename Ti, typename To, bool inclusive_scan>
-struct scan_dim<op, Ti, To, 0, inclusive_scan> {
-    void operator()(Param<To> output, dim_t outOffset, CParam<Ti> input,
-                    dim_t inOffset, const int dim) const {
-        const Ti* in = input.get() + inOffset;
-        To* out      = output.get() + outOffset;
+/// Scans the elements [\p first, \p last) of a line. \p prev is the
+/// inclusive scan of the element before \p first and is ignored if \p first
+/// is 0. A new segment starts wherever the key changes.
+template<af_op_t op, typename Ti, typename Tk, typename To, bool Inclusive>
+To scanLine(const ScanData<Ti, Tk, To> &d, dim_t ioff, dim_t koff, dim_t ooff,
+            const int dim, dim_t first, dim_t last, To prev) {
+    constexpr bool Keyed = !std::is_same<Tk, NoKey>::value;
+    common::Transform<Ti, To, op> transform;
+    common::Binary<To, op> binop;
+    const To init = common::Binary<To, op>::init();
+
+    const dim_t is = d.istrides[dim];
+    const dim_t ks = d.kstrides[dim];
+    const dim_t os = d.ostrides[dim];
+    for (dim_t k = first; k < last; k++) {
+        const bool start =
+            k == 0 || (Keyed && d.key[koff + k * ks] !=
+                                    d.key[koff + (k - 1) * ks]);
+        const To base = start ? init : prev;
+        prev          = binop(transform(d.in[ioff + k * is]), base);
+        d.out[ooff + k * os] = Inclusive ? prev : base;
+    }
+    return prev;
+}
 
-        const af::dim4 ostrides = output.strides();
-        const af::dim4 istrides = input.strides();
-        const af::dim4 idims    = input.dims();
+/// Scans every line of \p d along \p dim. Lines are scanned in parallel
+/// with each other and long lines are also split into blocks. The blocks are
+/// reduced in parallel, the reductions are scanned and then the blocks are
+/// scanned in parallel starting from the scan of the blocks before them.
+template<af_op_t op, typename Ti, typename Tk, typename To, bool Inclusive>
+void scanLines(const ScanData<Ti, Tk, To> &d, const af::dim4 &dims,
+               const int dim) {
+    constexpr bool Keyed = !std::is_same<Tk, NoKey>::value;
+    const dim_t n        = dims[dim];
+    const dim_t nlines   = dims.elements() / n;
 
-        dim_t istride = istrides[dim];
-        dim_t ostride = ostrides[dim];
+    // The dimensions other than dim, in order
+    int odim[3];
+    for (int i = 0, j = 0; i < 4; i++) {
+        if (i != dim) { odim[j++] = i; }
+    }
+    auto lineOffset = [&](dim_t line, const af::dim4 &strides) {
+        const dim_t i0 = line % dims[odim[0]];
+        const dim_t i1 = (line / dims[odim[0]]) % dims[odim[1]];
+        const dim_t i2 = line / (dims[odim[0]] * dims[odim[1]]);
+        return i0 * strides[odim[0]] + i1 * strides[odim[1]] +
+               i2 * strides[odim[2]];
+    };
+
+    const To init = common::Binary<To, op>::init();
+    if (n < 2 * SCAN_BLOCK || nlines >= SCAN_BLOCKED_MAX_LINES) {
+        parallel_for(0, nlines, parallelGrain(n), [&](dim_t first,
+                                                      dim_t last) {
+            for (dim_t line = first; line < last; line++) {
+                scanLine<op, Ti, Tk, To, Inclusive>(
+                    d, lineOffset(line, d.istrides),
+                    lineOffset(line, d.kstrides), lineOffset(line, d.ostrides),
+                    dim, 0, n, init);
+            }
+        });
+        return;
+    }
+
+    const dim_t nblocks = divup(n, SCAN_BLOCK);
+    std::vector<To> carry(nblocks);
+    std::vector<char> restart(nblocks);
+    for (dim_t line = 0; line < nlines; line++) {
+        const dim_t ioff = lineOffset(line, d.istrides);
+        const dim_t koff = lineOffset(line, d.kstrides);
+        const dim_t ooff = lineOffset(line, d.ostrides);
+        const dim_t is   = d.istrides[dim];
+        const dim_t ks   = d.kstrides[dim];
+
+        // The scan of each block, restarted at its last segment
+        parallel_for(0, nblocks, 1, [&](dim_t first, dim_t last) {
+            common::Transform<Ti, To, op> transform;
+            common::Binary<To, op> binop;
+            for (dim_t b = first; b < last; b++) {
+                const dim_t end = std::min(n, (b + 1) * SCAN_BLOCK);
+                To acc          = init;
+                bool restarted  = false;
+                for (dim_t k = b * SCAN_BLOCK; k < end; k++) {
+                    const bool start =
+                        Keyed && k > 0 &&
+                        d.key[koff + k * ks] != d.key[koff + (k - 1) * ks];
+                    restarted = restarted || start;
+                    acc = binop(transform(d.in[ioff + k * is]),
+                                start ? init : acc);
+                }
+                carry[b]   = acc;
+                restart[b] = restarted;
+            }
+        });
 
+        // carry[b] becomes the inclusive scan of the element before block b
+        common::Binary<To, op> binop;
+        To prev = init;
+        for (dim_t b = 0; b < nblocks; b++) {
+            const To block = carry[b];
+            carry[b]       = prev;
+            prev           = restart[b] ? block : binop(block, prev);
+        }
+
+        parallel_for(0, nblocks, 1, [&](dim_t first, dim_t last) {
+            for (dim_t b = first; b < last; b++) {
+                scanLine<op, Ti, Tk, To, Inclusive>(
+                    d, ioff, koff, ooff, dim, b * SCAN_BLOCK,
+                    std::min(n, (b + 1) * SCAN_BLOCK), carry[b]);
+            }
+        });
+    }
+}
+
+/// Scans along \p dim > 0 a chunk of every row at a time. The running scans
+/// of the chunk are kept in a small buffer so the input and the output are
+/// read and written contiguously.
+template<af_op_t op, typename Ti, typename Tk, typename To, bool Inclusive>
+void scanRows(const ScanData<Ti, Tk, To> &d, const af::dim4 &dims,
+              const int dim) {
+    constexpr bool Keyed = !std::is_same<Tk, NoKey>::value;
+    const dim_t n        = dims[dim];
+    const dim_t width    = dims[0];
+    const dim_t nchunks  = divup(width, SCAN_ROW_CHUNK);
+
+    // The dimensions other than 0 and dim
+    int odim[2];
+    for (int i = 1, j = 0; i < 4; i++) {
+        if (i != dim) { odim[j++] = i; }
+    }
+    const dim_t nslabs = dims[odim[0]] * dims[odim[1]];
+    auto slabOffset    = [&](dim_t slab, const af::dim4 &strides) {
+        return (slab % dims[odim[0]]) * strides[odim[0]] +
+               (slab / dims[odim[0]]) * strides[odim[1]];
+    };
+
+    const dim_t grain = parallelGrain(n * std::min(width, SCAN_ROW_CHUNK));
+    parallel_for(0, nslabs * nchunks, grain, [&](dim_t first, dim_t last) {
         common::Transform<Ti, To, op> transform;
-        // FIXME: Change the name to something better
-        common::Binary<To, op> scan;
-
-        To out_val = common::Binary<To, op>::init();
-        for (dim_t i = 0; i < idims[dim]; i++) {
-            To in_val = transform(in[i * istride]);
-            out_val   = scan(in_val, out_val);
-            if (!inclusive_scan) {
-                // The loop shifts the output index by 1.
-                // The last index wraps around and writes the first element.
-                if (i == (idims[dim] - 1)) {
-                    out[0] = common::Binary<To, op>::init();
-                } else {
-                    out[(i + 1) * ostride] = out_val;
+        common::Binary<To, op> binop;
+        const To init = common::Binary<To, op>::init();
+        std::vector<To> acc(SCAN_ROW_CHUNK);
+
+        for (dim_t item = first; item < last; item++) {
+            const dim_t slab = item / nchunks;
+            const dim_t x0   = (item % nchunks) * SCAN_ROW_CHUNK;
+            const dim_t len  = std::min(SCAN_ROW_CHUNK, width - x0);
+
+            const Ti *in = d.in + slabOffset(slab, d.istrides);
+            const Tk *key =
+                Keyed ? d.key + slabOffset(slab, d.kstrides) : nullptr;
+            To *out         = d.out + slabOffset(slab, d.ostrides);
+            const dim_t is0 = d.istrides[0];
+            const dim_t ks0 = d.kstrides[0];
+            const dim_t os0 = d.ostrides[0];
+
+            std::fill(acc.begin(), acc.begin() + len, init);
+            for (dim_t k = 0; k < n; k++) {
+                const Ti *irow = in + k * d.istrides[dim];
+                To *orow       = out + k * d.ostrides[dim];
+                const Tk *krow = Keyed ? key + k * d.kstrides[dim] : nullptr;
+                const Tk *kprv = Keyed ? krow - d.kstrides[dim] : nullptr;
+                for (dim_t x = x0; x < x0 + len; x++) {
+                    const bool start =
+                        Keyed && k > 0 && krow[x * ks0] != kprv[x * ks0];
+                    const To base = start ? init : acc[x - x0];
+                    acc[x - x0]   = binop(transform(irow[x * is0]), base);
+                    orow[x * os0] = Inclusive ? acc[x - x0] : base;
                 }
-            } else {
-                out[i * ostride] = out_val;
             }
         }
+    });
+}
+
+template<af_op_t op, typename Ti, typename Tk, typename To, bool Inclusive>
+void scanDim(const ScanData<Ti, Tk, To> &d, const af::dim4 &dims,
+             const int dim) {
+    if (dims.elements() == 0) { return; }
+
+    // Narrow rows are better handled as independent lines
+    if (dim > 0 && dims[0] >= 16) {
+        scanRows<op, Ti, Tk, To, Inclusive>(d, dims, dim);
+    } else {
+        scanLines<op, Ti, Tk, To, Inclusive>(d, dims, dim);
     }
-};
+}
+
+template<af_op_t op, typename Ti, typename To, bool inclusive_scan>
+void scan(Param<To> out, CParam<Ti> in, const int dim) {
+    const ScanData<Ti, NoKey, To> d{in.get(),     nullptr,       out.get(),
+                                    in.strides(), in.strides(),
+                                    out.strides()};
+    scanDim<op, Ti, NoKey, To, inclusive_scan>(d, in.dims(), dim);
+}
 
 }  // namespace kernel
 }  // namespace cpu
@@ -0,0 +1,134 @@
+/*******************************************************
+ * Copyright (c) 2026, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <Param.hpp>
+#include <math.hpp>
+#include <parallel.hpp>
+#include <simd.hpp>
+#include <af/defines.h>
+
+#include <algorithm>
+
+// Products of batches of small matrices. Calling BLAS once for every matrix
+// of a batch of 3x3 or 4x4 matrices is dominated by the cost of the calls,
+// so the products are computed directly instead. Runs of matrices with
+// constant strides are handed to simd::gemmSmall in a single call, and the
+// runs are processed in parallel.
+
+namespace cpu {
+namespace kernel {
+
+/// Batched products whose matrices have at most this many rows and columns
+/// are computed by smallGemm instead of BLAS
+constexpr int kSmallGemmSize = simd::GEMM_SMALL_SIZE;
+
+/// Products of the types which are not vectorized. See simd::gemmSmall. The
+/// elements of A and B are conjugated when \p conjA and \p conjB are true.
+template<typename T>
+void gemmSmall(T *c, const T *a, const T *b, T alpha, T beta,
+               const simd::SmallGemm &g, bool conjA, bool conjB) {
+    const bool zero = beta == scalar<T>(0);
+    for (int t = 0; t < g.count; t++) {
+        const T *at = a + t * g.aNext;
+        const T *bt = b + t * g.bNext;
+        T *ct       = c + t * g.cNext;
+        for (int j = 0; j < g.n; j++) {
+            T acc[kSmallGemmSize];
+            std::fill(acc, acc + g.m, scalar<T>(0));
+            for (int p = 0; p < g.k; p++) {
+                T bv = bt[p * g.bRow + j * g.bCol];
+                if (conjB) { bv = conjugate(bv); }
+                const T *ap = at + p * g.aCol;
+                for (int i = 0; i < g.m; i++) {
+                    const T av = ap[i * g.aRow];
+                    acc[i] += (conjA ? conjugate(av) : av) * bv;
+                }
+            }
+            T *cj = ct + j * g.cCol;
+            for (int i = 0; i < g.m; i++) {
+                cj[i] = zero ? alpha * acc[i] : alpha * acc[i] + beta * cj[i];
+            }
+        }
+    }
+}
+
+inline void gemmSmall(float *c, const float *a, const float *b, float alpha,
+                      float beta, const simd::SmallGemm &g, bool, bool) {
+    simd::gemmSmall(c, a, b, alpha, beta, g);
+}
+
+inline void gemmSmall(double *c, const double *a, const double *b,
+                      double alpha, double beta, const simd::SmallGemm &g,
+                      bool, bool) {
+    simd::gemmSmall(c, a, b, alpha, beta, g);
+}
+
+/// Computes out = alpha * op(lhs) * op(rhs) + beta * out for batches of
+/// matrices with at most kSmallGemmSize rows and columns. The batch
+/// dimensions of lhs and rhs which are not the same as those of out are
+/// broadcast. out is not read when beta is zero.
+template<typename T>
+void smallGemm(Param<T> out, CParam<T> lhs, CParam<T> rhs,
+               af_mat_prop optLhs, af_mat_prop optRhs, T alpha, T beta) {
+    const af::dim4 lDims    = lhs.dims();
+    const af::dim4 rDims    = rhs.dims();
+    const af::dim4 oDims    = out.dims();
+    const af::dim4 lStrides = lhs.strides();
+    const af::dim4 rStrides = rhs.strides();
+    const af::dim4 oStrides = out.strides();
+
+    const bool lTrans = optLhs != AF_MAT_NONE;
+    const bool rTrans = optRhs != AF_MAT_NONE;
+
+    simd::SmallGemm g;
+    g.m    = static_cast<int>(oDims[0]);
+    g.n    = static_cast<int>(oDims[1]);
+    g.k    = static_cast<int>(lTrans ? lDims[0] : lDims[1]);
+    g.aRow = lTrans ? lStrides[1] : lStrides[0];
+    g.aCol = lTrans ? lStrides[0] : lStrides[1];
+    g.bRow = rTrans ? rStrides[1] : rStrides[0];
+    g.bCol = rTrans ? rStrides[0] : rStrides[1];
+    g.cCol = oStrides[1];
+
+    const dim_t d2       = oDims[2];
+    const dim_t lStride2 = (lDims[2] == d2) * lStrides[2];
+    const dim_t lStride3 = (lDims[3] == oDims[3]) * lStrides[3];
+    const dim_t rStride2 = (rDims[2] == d2) * rStrides[2];
+    const dim_t rStride3 = (rDims[3] == oDims[3]) * rStrides[3];
+
+    const bool conjA = optLhs == AF_MAT_CTRANS;
+    const bool conjB = optRhs == AF_MAT_CTRANS;
+
+    // The matrices of a run share the index along dimension 3, so the
+    // distance between consecutive ones is constant
+    auto process = [&](dim_t first, dim_t last) {
+        simd::SmallGemm run = g;
+        run.aNext           = lStride2;
+        run.bNext           = rStride2;
+        run.cNext           = oStrides[2];
+        for (dim_t n = first; n < last; n += run.count) {
+            const dim_t w = n / d2;
+            const dim_t z = n - w * d2;
+            run.count = static_cast<int>(std::min(last - n, d2 - z));
+
+            gemmSmall(out.get() + z * oStrides[2] + w * oStrides[3],
+                      lhs.get() + z * lStride2 + w * lStride3,
+                      rhs.get() + z * rStride2 + w * rStride3, alpha, beta,
+                      run, conjA, conjB);
+        }
+    };
+
+    const dim_t batch = d2 * oDims[3];
+    const dim_t cost  = static_cast<dim_t>(g.m) * g.n * std::max(g.k, 1);
+    parallel_for(0, batch, parallelGrain(cost), process);
+}
+
+}  // namespace kernel
+}  // namespace cpu
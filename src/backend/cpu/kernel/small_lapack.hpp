@@ -0,0 +1,224 @@
+/*******************************************************
+ * Copyright (c) 2026, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <math.hpp>
+#include <parallel.hpp>
+#include <types.hpp>
+#include <af/dim4.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <type_traits>
+#include <utility>
+
+// Unblocked dense factorizations for the small matrices of a batch. They
+// follow the semantics of the LAPACK routine they are named after, including
+// 1 based pivots and the values of info, so that callers can switch between
+// them and LAPACK by size. Calling LAPACK for every matrix of a batch of
+// thousands of 4x4 matrices is dominated by argument checking and dispatch.
+
+namespace cpu {
+namespace kernel {
+
+/// Matrices with at most this many rows and columns are factorized by the
+/// kernels in this file instead of LAPACK
+constexpr int kSmallMatrixSize = 16;
+
+/// The magnitude LAPACK uses to choose pivots
+inline float pivotMagnitude(float v) { return std::abs(v); }
+inline double pivotMagnitude(double v) { return std::abs(v); }
+inline float pivotMagnitude(cfloat v) {
+    return std::abs(v.real()) + std::abs(v.imag());
+}
+inline double pivotMagnitude(cdouble v) {
+    return std::abs(v.real()) + std::abs(v.imag());
+}
+
+inline float realPart(float v) { return v; }
+inline double realPart(double v) { return v; }
+inline float realPart(cfloat v) { return v.real(); }
+inline double realPart(cdouble v) { return v.real(); }
+
+/// Calls \p func with std::integral_constant<int, n> for the sizes the
+/// kernels are unrolled for and with std::integral_constant<int, 0>, which
+/// selects the runtime sized loops, for all other sizes
+template<typename Func>
+void dispatchSmallSize(int n, Func &&func) {
+    switch (n) {
+        case 2: func(std::integral_constant<int, 2>()); break;
+        case 3: func(std::integral_constant<int, 3>()); break;
+        case 4: func(std::integral_constant<int, 4>()); break;
+        case 5: func(std::integral_constant<int, 5>()); break;
+        case 6: func(std::integral_constant<int, 6>()); break;
+        case 7: func(std::integral_constant<int, 7>()); break;
+        case 8: func(std::integral_constant<int, 8>()); break;
+        default: func(std::integral_constant<int, 0>()); break;
+    }
+}
+
+/// Calls \p func(i2, i3) for every matrix of an array of dimensions \p dims
+/// in parallel. \p cost is the work of a single matrix in element operations.
+template<typename Func>
+void forEachMatrix(const af::dim4 &dims, dim_t cost, const Func &func) {
+    const dim_t d2 = dims[2];
+    parallel_for(0, d2 * dims[3], parallelGrain(cost),
+                 [&](dim_t first, dim_t last) {
+                     for (dim_t b = first; b < last; b++) {
+                         func(b % d2, b / d2);
+                     }
+                 });
+}
+
+/// LU factorization with partial pivoting of the m x n matrix \p A (getrf).
+/// The size is \p N x \p N when \p N is not zero.
+template<int N, typename T>
+int getrfSmall(T *A, int lda, int m, int n, int *piv) {
+    if (N) {
+        m = N;
+        n = N;
+    }
+    int info    = 0;
+    const int k = std::min(m, n);
+    for (int j = 0; j < k; j++) {
+        T *Aj    = A + j * lda;
+        int p    = j;
+        auto big = pivotMagnitude(Aj[j]);
+        for (int i = j + 1; i < m; i++) {
+            const auto v = pivotMagnitude(Aj[i]);
+            if (v > big) {
+                big = v;
+                p   = i;
+            }
+        }
+        piv[j] = p + 1;
+        // The whole column is zero so the trailing update is a no-op
+        if (Aj[p] == T(0)) {
+            if (info == 0) { info = j + 1; }
+            continue;
+        }
+        if (p != j) {
+            for (int c = 0; c < n; c++) {
+                std::swap(A[j + c * lda], A[p + c * lda]);
+            }
+        }
+        const T inv = T(1) / Aj[j];
+        for (int i = j + 1; i < m; i++) { Aj[i] *= inv; }
+        for (int c = j + 1; c < n; c++) {
+            T *Ac     = A + c * lda;
+            const T a = Ac[j];
+            for (int i = j + 1; i < m; i++) { Ac[i] -= Aj[i] * a; }
+        }
+    }
+    return info;
+}
+
+/// Solves A X = B with the n x n LU factorization from getrfSmall (getrs)
+template<int N, typename T>
+void getrsSmall(const T *A, int lda, int n, const int *piv, T *B, int ldb,
+                int nrhs) {
+    if (N) { n = N; }
+    for (int r = 0; r < nrhs; r++) {
+        T *b = B + r * ldb;
+        for (int i = 0; i < n; i++) { std::swap(b[i], b[piv[i] - 1]); }
+        for (int j = 0; j < n; j++) {
+            const T *Aj = A + j * lda;
+            const T x   = b[j];
+            for (int i = j + 1; i < n; i++) { b[i] -= Aj[i] * x; }
+        }
+        for (int j = n - 1; j >= 0; j--) {
+            const T *Aj = A + j * lda;
+            b[j] /= Aj[j];
+            const T x = b[j];
+            for (int i = 0; i < j; i++) { b[i] -= Aj[i] * x; }
+        }
+    }
+}
+
+/// Solves the triangular system A X = B (trtrs). Returns the index of the
+/// first zero on the diagonal, in which case B is left unchanged.
+template<int N, typename T>
+int trtrsSmall(bool upper, bool unit, const T *A, int lda, int n, T *B,
+               int ldb, int nrhs) {
+    if (N) { n = N; }
+    if (!unit) {
+        for (int j = 0; j < n; j++) {
+            if (A[j + j * lda] == T(0)) { return j + 1; }
+        }
+    }
+    for (int r = 0; r < nrhs; r++) {
+        T *b = B + r * ldb;
+        if (upper) {
+            for (int j = n - 1; j >= 0; j--) {
+                const T *Aj = A + j * lda;
+                if (!unit) { b[j] /= Aj[j]; }
+                const T x = b[j];
+                for (int i = 0; i < j; i++) { b[i] -= Aj[i] * x; }
+            }
+        } else {
+            for (int j = 0; j < n; j++) {
+                const T *Aj = A + j * lda;
+                if (!unit) { b[j] /= Aj[j]; }
+                const T x = b[j];
+                for (int i = j + 1; i < n; i++) { b[i] -= Aj[i] * x; }
+            }
+        }
+    }
+    return 0;
+}
+
+/// Cholesky factorization of the n x n Hermitian positive definite matrix
+/// \p A (potrf). Only the \p upper or lower triangle is read and written.
+template<int N, typename T>
+int potrfSmall(bool upper, T *A, int lda, int n) {
+    if (N) { n = N; }
+    // With the upper triangle A = U^H U, so U(k, j) is read as L(j, k) of
+    // A = L L^H through a conjugated transposed access
+    const int rs = upper ? lda : 1;
+    const int cs = upper ? 1 : lda;
+    auto L       = [&](int i, int k) -> T & { return A[i * rs + k * cs]; };
+    auto Lv      = [&](int i, int k) {
+        return upper ? conjugate(L(i, k)) : L(i, k);
+    };
+    for (int j = 0; j < n; j++) {
+        auto d = realPart(L(j, j));
+        for (int k = 0; k < j; k++) {
+            const T v = L(j, k);
+            d -= realPart(v * conjugate(v));
+        }
+        if (!(d > 0)) {
+            L(j, j) = T(d);
+            return j + 1;
+        }
+        d       = std::sqrt(d);
+        L(j, j) = T(d);
+        for (int i = j + 1; i < n; i++) {
+            T s = Lv(i, j);
+            for (int k = 0; k < j; k++) { s -= Lv(i, k) * conjugate(Lv(j, k)); }
+            s /= d;
+            L(i, j) = upper ? conjugate(s) : s;
+        }
+    }
+    return 0;
+}
+
+/// Inverts the n x n matrix \p A in place from its LU factorization in \p LU
+/// (getri). A is overwritten with the identity and solved against.
+template<int N, typename T>
+void getriSmall(const T *LU, int ldlu, const int *piv, T *A, int lda, int n) {
+    if (N) { n = N; }
+    for (int c = 0; c < n; c++) {
+        for (int i = 0; i < n; i++) { A[i + c * lda] = T(i == c ? 1 : 0); }
+    }
+    getrsSmall<N>(LU, ldlu, n, piv, A, lda, n);
+}
+
+}  // namespace kernel
+}  // namespace cpu
@@ -9,38 +9,349 @@
 
 #pragma once
 #include <Param.hpp>
+#include <common/dispatch.hpp>
 #include <err_cpu.hpp>
-#include <math.hpp>
+#include <parallel.hpp>
 #include <algorithm>
-#include <functional>
-#include <numeric>
+#include <array>
+#include <cstring>
+#include <type_traits>
+#include <vector>
 
 namespace cpu {
 namespace kernel {
 
-// Based off of http://stackoverflow.com/a/12399290
+// The sorts below are LSD radix sorts. The keys are mapped to unsigned
+// integers that have the same order and are then sorted one byte at a time,
+// which makes the sort stable. Bytes that are the same for every key are
+// skipped.
+
+/// Columns shorter than this are sorted with an insertion sort
+constexpr dim_t SORT_INSERTION_MAX = 64;
+
+/// Columns at least this long are split between the threads when there are
+/// too few columns to keep every thread busy
+constexpr dim_t SORT_PARALLEL_MIN = 1 << 16;
+
+constexpr int RADIX_BITS    = 8;
+constexpr int RADIX_BUCKETS = 1 << RADIX_BITS;
+
+/// Maps the keys of type T to unsigned integers with the same order
+template<typename T, typename Enable = void>
+struct RadixKey {
+    using Bits = typename std::make_unsigned<T>::type;
+
+    static constexpr Bits kFlip =
+        std::is_signed<T>::value ? Bits(Bits(1) << (8 * sizeof(Bits) - 1))
+                                 : Bits(0);
+
+    static Bits encode(T key) { return static_cast<Bits>(key) ^ kFlip; }
+    static T decode(Bits bits) { return static_cast<T>(bits ^ kFlip); }
+};
+
+/// Positive floating point numbers get their sign bit set and negative
+/// numbers have all of their bits flipped. -0 sorts before +0, positive NaNs
+/// after +inf and negative NaNs before -inf.
 template<typename T>
-void sort0Iterative(Param<T> val, bool isAscending) {
-    // initialize original index locations
-    T *val_ptr = val.get();
+struct RadixKey<T, typename std::enable_if<
+                       std::is_floating_point<T>::value>::type> {
+    using Bits = typename std::conditional<sizeof(T) == 4, uint32_t,
+                                           uint64_t>::type;
+
+    static constexpr Bits kSign = Bits(1) << (8 * sizeof(Bits) - 1);
+
+    static Bits encode(T key) {
+        Bits bits;
+        std::memcpy(&bits, &key, sizeof(bits));
+        return (bits & kSign) ? ~bits : (bits | kSign);
+    }
+
+    static T decode(Bits bits) {
+        bits = (bits & kSign) ? (bits & ~kSign) : ~bits;
+        T key;
+        std::memcpy(&key, &bits, sizeof(key));
+        return key;
+    }
+};
+
+/// Used in place of the values when only keys are sorted
+struct NoValue {};
+
+/// The buffers used to sort one column. Each pass moves the keys and the
+/// values from one half of a buffer to the other.
+template<typename Bits, typename Tv>
+struct SortBuffers {
+    std::vector<Bits> keys[2];
+    std::vector<Tv> vals[2];
+
+    void resize(dim_t n, bool withValues) {
+        for (int i = 0; i < 2; i++) {
+            if (static_cast<dim_t>(keys[i].size()) < n) { keys[i].resize(n); }
+            if (withValues && static_cast<dim_t>(vals[i].size()) < n) {
+                vals[i].resize(n);
+            }
+        }
+    }
+};
+
+/// Stable insertion sort of the \p n keys and values in \p key and \p val
+template<typename Bits, typename Tv, bool HasValues>
+void insertionSort(Bits *key, Tv *val, dim_t n) {
+    for (dim_t i = 1; i < n; i++) {
+        const Bits k = key[i];
+        if (!(k < key[i - 1])) { continue; }
+        Tv v;
+        if (HasValues) { v = val[i]; }
+        dim_t j = i;
+        for (; j > 0 && k < key[j - 1]; j--) {
+            key[j] = key[j - 1];
+            if (HasValues) { val[j] = val[j - 1]; }
+        }
+        key[j] = k;
+        if (HasValues) { val[j] = v; }
+    }
+}
+
+/// Counts the occurrences of every byte of the \p n keys in \p key
+template<typename Bits>
+void radixHistogram(std::array<dim_t, RADIX_BUCKETS> *hist, const Bits *key,
+                    dim_t n) {
+    for (dim_t i = 0; i < n; i++) {
+        const Bits k = key[i];
+        for (unsigned p = 0; p < sizeof(Bits); p++) {
+            hist[p][(k >> (p * RADIX_BITS)) & (RADIX_BUCKETS - 1)]++;
+        }
+    }
+}
+
+/// Returns true if every key has the same byte for the pass \p hist belongs
+/// to
+inline bool radixSkipPass(const std::array<dim_t, RADIX_BUCKETS> &hist,
+                          dim_t n) {
+    for (dim_t count : hist) {
+        if (count != 0) { return count == n; }
+    }
+    return true;
+}
+
+/// Sorts the first \p n keys and values of buffer 0 on the calling thread.
+/// Returns the index of the buffer that holds the sorted keys and values.
+template<typename Bits, typename Tv, bool HasValues>
+int radixSort(SortBuffers<Bits, Tv> &buf, dim_t n) {
+    Bits *key = buf.keys[0].data();
+    Tv *val   = HasValues ? buf.vals[0].data() : nullptr;
+    if (n <= SORT_INSERTION_MAX) {
+        insertionSort<Bits, Tv, HasValues>(key, val, n);
+        return 0;
+    }
+
+    std::array<dim_t, RADIX_BUCKETS> hist[sizeof(Bits)] = {};
+    radixHistogram(hist, key, n);
+
+    int src = 0;
+    for (unsigned p = 0; p < sizeof(Bits); p++) {
+        if (radixSkipPass(hist[p], n)) { continue; }
+
+        dim_t offset[RADIX_BUCKETS];
+        dim_t sum = 0;
+        for (int b = 0; b < RADIX_BUCKETS; b++) {
+            offset[b] = sum;
+            sum += hist[p][b];
+        }
+
+        const Bits *ikey = buf.keys[src].data();
+        Bits *okey       = buf.keys[1 - src].data();
+        const Tv *ival   = HasValues ? buf.vals[src].data() : nullptr;
+        Tv *oval         = HasValues ? buf.vals[1 - src].data() : nullptr;
+        const unsigned shift = p * RADIX_BITS;
+        for (dim_t i = 0; i < n; i++) {
+            const dim_t o = offset[(ikey[i] >> shift) & (RADIX_BUCKETS - 1)]++;
+            okey[o]       = ikey[i];
+            if (HasValues) { oval[o] = ival[i]; }
+        }
+        src = 1 - src;
+    }
+    return src;
+}
+
+/// Same as radixSort but splits every pass between the threads. Each thread
+/// moves a contiguous chunk of the keys to the positions computed from the
+/// histograms of all the chunks before it, so the result does not depend on
+/// the number of threads.
+template<typename Bits, typename Tv, bool HasValues>
+int radixSortParallel(SortBuffers<Bits, Tv> &buf, dim_t n) {
+    using Histogram     = std::array<dim_t, RADIX_BUCKETS>;
+    const dim_t nchunks = std::min<dim_t>(
+        4 * getNumThreads(), divup(n, SORT_PARALLEL_MIN / 4));
+    const dim_t chunk = divup(n, nchunks);
+
+    // Finds the passes that can be skipped
+    std::vector<Histogram> hist(nchunks * sizeof(Bits));
+    const Bits *key0 = buf.keys[0].data();
+    parallel_for(0, nchunks, 1, [&](dim_t first, dim_t last) {
+        for (dim_t c = first; c < last; c++) {
+            const dim_t beg = c * chunk;
+            radixHistogram(&hist[c * sizeof(Bits)], key0 + beg,
+                           std::min(chunk, n - beg));
+        }
+    });
+
+    int src = 0;
+    std::vector<Histogram> offsets(nchunks);
+    for (unsigned p = 0; p < sizeof(Bits); p++) {
+        Histogram total = {};
+        for (dim_t c = 0; c < nchunks; c++) {
+            for (int b = 0; b < RADIX_BUCKETS; b++) {
+                total[b] += hist[c * sizeof(Bits) + p][b];
+            }
+        }
+        if (radixSkipPass(total, n)) { continue; }
+
+        const Bits *ikey     = buf.keys[src].data();
+        Bits *okey           = buf.keys[1 - src].data();
+        const Tv *ival       = HasValues ? buf.vals[src].data() : nullptr;
+        Tv *oval             = HasValues ? buf.vals[1 - src].data() : nullptr;
+        const unsigned shift = p * RADIX_BITS;
+
+        // The keys were moved by the previous pass so the histograms of the
+        // chunks have to be computed again
+        parallel_for(0, nchunks, 1, [&](dim_t first, dim_t last) {
+            for (dim_t c = first; c < last; c++) {
+                Histogram &h = offsets[c];
+                h.fill(0);
+                const dim_t end = std::min((c + 1) * chunk, n);
+                for (dim_t i = c * chunk; i < end; i++) {
+                    h[(ikey[i] >> shift) & (RADIX_BUCKETS - 1)]++;
+                }
+            }
+        });
+
+        dim_t sum = 0;
+        for (int b = 0; b < RADIX_BUCKETS; b++) {
+            for (dim_t c = 0; c < nchunks; c++) {
+                const dim_t count = offsets[c][b];
+                offsets[c][b]     = sum;
+                sum += count;
+            }
+        }
 
-    std::function<bool(T, T)> op = std::greater<T>();
-    if (isAscending) { op = std::less<T>(); }
+        parallel_for(0, nchunks, 1, [&](dim_t first, dim_t last) {
+            for (dim_t c = first; c < last; c++) {
+                Histogram &offset = offsets[c];
+                const dim_t end   = std::min((c + 1) * chunk, n);
+                for (dim_t i = c * chunk; i < end; i++) {
+                    const dim_t o =
+                        offset[(ikey[i] >> shift) & (RADIX_BUCKETS - 1)]++;
+                    okey[o] = ikey[i];
+                    if (HasValues) { oval[o] = ival[i]; }
+                }
+            }
+        });
+        src = 1 - src;
+    }
+    return src;
+}
 
-    T *comp_ptr = nullptr;
-    for (dim_t w = 0; w < val.dims(3); w++) {
-        dim_t valW = w * val.strides(3);
-        for (dim_t z = 0; z < val.dims(2); z++) {
-            dim_t valWZ = valW + z * val.strides(2);
-            for (dim_t y = 0; y < val.dims(1); y++) {
-                dim_t valOffset = valWZ + y * val.strides(1);
+/// Sorts every column of \p okey along \p dim and moves the matching
+/// elements of \p oval with them. The sort is stable. \p oval is ignored
+/// when Tv is NoValue.
+template<typename Tk, typename Tv>
+void sortColumns(Param<Tk> okey, Param<Tv> oval, const int dim,
+                 bool isAscending) {
+    using Key  = RadixKey<Tk>;
+    using Bits = typename Key::Bits;
+    constexpr bool HasValues = !std::is_same<Tv, NoValue>::value;
 
-                comp_ptr = val_ptr + valOffset;
-                std::sort(comp_ptr, comp_ptr + val.dims(0), op);
+    const af::dim4 dims  = okey.dims();
+    const af::dim4 kstr  = okey.strides();
+    const af::dim4 vstr  = HasValues ? oval.strides() : kstr;
+    const dim_t n        = dims[dim];
+    const dim_t ncols    = dims.elements() / std::max<dim_t>(n, 1);
+    const Bits flip      = isAscending ? Bits(0) : static_cast<Bits>(~Bits(0));
+    Tk *const keyPtr     = okey.get();
+    Tv *const valPtr     = HasValues ? oval.get() : nullptr;
+    if (n <= 1) { return; }
+
+    // The dimensions other than dim, in order
+    int odim[3];
+    for (int i = 0, j = 0; i < 4; i++) {
+        if (i != dim) { odim[j++] = i; }
+    }
+
+    auto columnOffset = [&](dim_t col, const af::dim4 &strides) {
+        const dim_t i0 = col % dims[odim[0]];
+        const dim_t i1 = (col / dims[odim[0]]) % dims[odim[1]];
+        const dim_t i2 = col / (dims[odim[0]] * dims[odim[1]]);
+        return i0 * strides[odim[0]] + i1 * strides[odim[1]] +
+               i2 * strides[odim[2]];
+    };
+
+    // The keys are encoded while they are copied to the buffers and decoded
+    // while they are copied back. Descending sorts flip every bit.
+    auto load = [&](SortBuffers<Bits, Tv> &buf, dim_t col, dim_t first,
+                    dim_t last) {
+        const Tk *key = keyPtr + columnOffset(col, kstr);
+        Bits *bkey    = buf.keys[0].data();
+        for (dim_t i = first; i < last; i++) {
+            bkey[i] = Key::encode(key[i * kstr[dim]]) ^ flip;
+        }
+        if (HasValues) {
+            const Tv *val = valPtr + columnOffset(col, vstr);
+            Tv *bval      = buf.vals[0].data();
+            for (dim_t i = first; i < last; i++) {
+                bval[i] = val[i * vstr[dim]];
             }
         }
+    };
+    auto store = [&](SortBuffers<Bits, Tv> &buf, int src, dim_t col,
+                     dim_t first, dim_t last) {
+        Tk *key          = keyPtr + columnOffset(col, kstr);
+        const Bits *bkey = buf.keys[src].data();
+        for (dim_t i = first; i < last; i++) {
+            key[i * kstr[dim]] = Key::decode(bkey[i] ^ flip);
+        }
+        if (HasValues) {
+            Tv *val        = valPtr + columnOffset(col, vstr);
+            const Tv *bval = buf.vals[src].data();
+            for (dim_t i = first; i < last; i++) {
+                val[i * vstr[dim]] = bval[i];
+            }
+        }
+    };
+
+    if (n < SORT_PARALLEL_MIN || ncols >= getNumThreads()) {
+        // Every thread sorts whole columns
+        const dim_t grain = parallelGrain(n * sizeof(Bits));
+        parallel_for(0, ncols, grain, [&](dim_t first, dim_t last) {
+            SortBuffers<Bits, Tv> buf;
+            buf.resize(n, HasValues);
+            for (dim_t col = first; col < last; col++) {
+                load(buf, col, 0, n);
+                const int src = radixSort<Bits, Tv, HasValues>(buf, n);
+                store(buf, src, col, 0, n);
+            }
+        });
+    } else {
+        // The threads sort one long column at a time
+        SortBuffers<Bits, Tv> buf;
+        buf.resize(n, HasValues);
+        for (dim_t col = 0; col < ncols; col++) {
+            parallel_for(0, n, SORT_PARALLEL_MIN / 4,
+                         [&](dim_t first, dim_t last) {
+                             load(buf, col, first, last);
+                         });
+            const int src = radixSortParallel<Bits, Tv, HasValues>(buf, n);
+            parallel_for(0, n, SORT_PARALLEL_MIN / 4,
+                         [&](dim_t first, dim_t last) {
+                             store(buf, src, col, first, last);
+                         });
+        }
     }
-    return;
+}
+
+template<typename T>
+void sort(Param<T> val, const int dim, bool isAscending) {
+    sortColumns<T, NoValue>(val, Param<NoValue>(), dim, isAscending);
 }
 
 }  // namespace kernel
@@ -13,15 +13,11 @@
 namespace cpu {
 namespace kernel {
 
+/// Sorts \p okey along \p dim and reorders \p oval the same way. Elements
+/// with equal keys keep their order.
 template<typename Tk, typename Tv>
-void sort0ByKeyIterative(Param<Tk> okey, Param<Tv> oval, bool isAscending);
-
-template<typename Tk, typename Tv>
-void sortByKeyBatched(Param<Tk> okey, Param<Tv> oval, const int dim,
-                      bool isAscending);
-
-template<typename Tk, typename Tv>
-void sort0ByKey(Param<Tk> okey, Param<Tv> oval, bool isAscending);
+void sortByKey(Param<Tk> okey, Param<Tv> oval, const int dim,
+               bool isAscending);
 
 }  // namespace kernel
 }  // namespace cpu
@@ -171,5 +171,54 @@ void coo2csr(Param<T> ovalues, Param<int> orowIdx, Param<int> ocolIdx,
     }
 }
 
+/// Transposes the compressed rows in \p iptr and \p iidx into compressed
+/// columns in \p optr and \p oidx, which also converts compressed columns to
+/// compressed rows. The indices of every output row or column are sorted
+/// because the input is scattered in order.
+template<typename T>
+void compressedTranspose(Param<T> ovalues, Param<int> optr, Param<int> oidx,
+                         CParam<T> ivalues, CParam<int> iptr,
+                         CParam<int> iidx, const bool conjugate) {
+    T *ovPtr         = ovalues.get();
+    int *opPtr       = optr.get();
+    int *oiPtr       = oidx.get();
+    const T *ivPtr   = ivalues.get();
+    const int *ipPtr = iptr.get();
+    const int *iiPtr = iidx.get();
+
+    const int nIn  = iptr.dims(0) - 1;
+    const int nOut = optr.dims(0) - 1;
+
+    // Count the entries of every output row and turn them into offsets
+    std::fill(opPtr, opPtr + nOut + 1, 0);
+    for (int k = ipPtr[0]; k < ipPtr[nIn]; k++) { opPtr[iiPtr[k] + 1]++; }
+    for (int j = 0; j < nOut; j++) { opPtr[j + 1] += opPtr[j]; }
+
+    // opPtr[j] is advanced to the start of row j + 1 by the scatter
+    for (int i = 0; i < nIn; i++) {
+        for (int k = ipPtr[i]; k < ipPtr[i + 1]; k++) {
+            const int dst = opPtr[iiPtr[k]]++;
+            oiPtr[dst]    = i;
+            ovPtr[dst]    = conjugate ? cpu::conjugate(ivPtr[k]) : ivPtr[k];
+        }
+    }
+    for (int j = nOut; j > 0; j--) { opPtr[j] = opPtr[j - 1]; }
+    opPtr[0] = 0;
+}
+
+template<typename T>
+void csr2csc(Param<T> ovalues, Param<int> orowIdx, Param<int> ocolIdx,
+             CParam<T> ivalues, CParam<int> irowIdx, CParam<int> icolIdx) {
+    compressedTranspose<T>(ovalues, ocolIdx, orowIdx, ivalues, irowIdx,
+                           icolIdx, false);
+}
+
+template<typename T>
+void csc2csr(Param<T> ovalues, Param<int> orowIdx, Param<int> ocolIdx,
+             CParam<T> ivalues, CParam<int> irowIdx, CParam<int> icolIdx) {
+    compressedTranspose<T>(ovalues, orowIdx, ocolIdx, ivalues, icolIdx,
+                           irowIdx, false);
+}
+
 }  // namespace kernel
 }  // namespace cpu
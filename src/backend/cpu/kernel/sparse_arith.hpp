@@ -10,7 +10,9 @@
 #pragma once
 #include <Param.hpp>
 #include <math.hpp>
+#include <parallel.hpp>
 
+#include <algorithm>
 #include <cmath>
 
 namespace cpu {
@@ -45,6 +47,28 @@ struct arith_op<T, af_div_t> {
     T operator()(T v1, T v2) { return v1 / v2; }
 };
 
+/// Calls \p func(i, row) for every entry i of a CSR or COO matrix. The rows
+/// of a CSR matrix are processed in parallel. The entries of a COO matrix are
+/// processed in order because they can contain duplicates.
+template<af_storage type, typename Func>
+void forEachSparseEntry(CParam<int> rowIdx, const dim_t nnz, Func func) {
+    const int *rPtr = rowIdx.get();
+    if (type == AF_STORAGE_CSR) {
+        const dim_t rows = rowIdx.dims(0) - 1;
+        const dim_t cost = 1 + nnz / std::max<dim_t>(rows, 1);
+        parallel_for(0, rows, parallelGrain(cost), [&](dim_t first,
+                                                       dim_t last) {
+            for (dim_t r = first; r < last; r++) {
+                for (int i = rPtr[r]; i < rPtr[r + 1]; i++) {
+                    func(i, static_cast<int>(r));
+                }
+            }
+        });
+    } else {
+        for (int i = 0; i < static_cast<int>(nnz); i++) { func(i, rPtr[i]); }
+    }
+}
+
 template<typename T, af_op_t op, af_storage type>
 void sparseArithOpD(Param<T> output, CParam<T> values, CParam<int> rowIdx,
                     CParam<int> colIdx, CParam<T> rhs,
@@ -53,46 +77,32 @@ void sparseArithOpD(Param<T> output, CParam<T> values, CParam<int> rowIdx,
     const T *hPtr = rhs.get();
 
     const T *vPtr   = values.get();
-    const int *rPtr = rowIdx.get();
     const int *cPtr = colIdx.get();
 
     dim4 odims    = output.dims();
     dim4 ostrides = output.strides();
-    ;
     dim4 hstrides = rhs.strides();
-    ;
-
-    std::vector<int> temp;
-    if (type == AF_STORAGE_CSR) {
-        temp.resize(values.dims().elements());
-        for (int i = 0; i < rowIdx.dims(0) - 1; i++) {
-            for (int ii = rPtr[i]; ii < rPtr[i + 1]; ii++) { temp[ii] = i; }
-        }
-        //} else if(type == AF_STORAGE_CSC) {   // For future
-    }
-
-    const int *xx = (type == AF_STORAGE_CSR) ? temp.data() : rPtr;
-    const int *yy = (type == AF_STORAGE_CSC) ? temp.data() : cPtr;
 
-    for (int i = 0; i < (int)values.dims().elements(); i++) {
-        // Bad index data
-        if (xx[i] >= odims[0] || yy[i] >= odims[1]) continue;
+    forEachSparseEntry<type>(
+        rowIdx, values.dims().elements(), [&](int i, int row) {
+            const int col = cPtr[i];
+            // Bad index data
+            if (row >= odims[0] || col >= odims[1]) return;
 
-        int offset = xx[i] + yy[i] * ostrides[1];
-        int hoff   = xx[i] + yy[i] * hstrides[1];
+            dim_t offset = row + col * ostrides[1];
+            dim_t hoff   = row + col * hstrides[1];
 
-        if (reverse)
-            oPtr[offset] = arith_op<T, op>()(hPtr[hoff], vPtr[i]);
-        else
-            oPtr[offset] = arith_op<T, op>()(vPtr[i], hPtr[hoff]);
-    }
+            if (reverse)
+                oPtr[offset] = arith_op<T, op>()(hPtr[hoff], vPtr[i]);
+            else
+                oPtr[offset] = arith_op<T, op>()(vPtr[i], hPtr[hoff]);
+        });
 }
 
 template<typename T, af_op_t op, af_storage type>
 void sparseArithOpS(Param<T> values, Param<int> rowIdx, Param<int> colIdx,
                     CParam<T> rhs, const bool reverse = false) {
     T *vPtr         = values.get();
-    const int *rPtr = rowIdx.get();
     const int *cPtr = colIdx.get();
 
     const T *hPtr = rhs.get();
@@ -100,29 +110,19 @@ void sparseArithOpS(Param<T> values, Param<int> rowIdx, Param<int> colIdx,
     dim4 dims     = rhs.dims();
     dim4 hstrides = rhs.strides();
 
-    std::vector<int> temp;
-    if (type == AF_STORAGE_CSR) {
-        temp.resize(values.dims().elements());
-        for (int i = 0; i < rowIdx.dims(0) - 1; i++) {
-            for (int ii = rPtr[i]; ii < rPtr[i + 1]; ii++) { temp[ii] = i; }
-        }
-        //} else if(type == AF_STORAGE_CSC) {   // For future
-    }
-
-    const int *xx = (type == AF_STORAGE_CSR) ? temp.data() : rPtr;
-    const int *yy = (type == AF_STORAGE_CSC) ? temp.data() : cPtr;
-
-    for (int i = 0; i < (int)values.dims().elements(); i++) {
-        // Bad index data
-        if (xx[i] >= dims[0] || yy[i] >= dims[1]) continue;
+    forEachSparseEntry<type>(
+        rowIdx, values.dims().elements(), [&](int i, int row) {
+            const int col = cPtr[i];
+            // Bad index data
+            if (row >= dims[0] || col >= dims[1]) return;
 
-        int hoff = xx[i] + yy[i] * hstrides[1];
+            dim_t hoff = row + col * hstrides[1];
 
-        if (reverse)
-            vPtr[i] = arith_op<T, op>()(hPtr[hoff], vPtr[i]);
-        else
-            vPtr[i] = arith_op<T, op>()(vPtr[i], hPtr[hoff]);
-    }
+            if (reverse)
+                vPtr[i] = arith_op<T, op>()(hPtr[hoff], vPtr[i]);
+            else
+                vPtr[i] = arith_op<T, op>()(vPtr[i], hPtr[hoff]);
+        });
 }
 
 // The following functions can handle CSR
@@ -137,32 +137,35 @@ static void calcOutNNZ(Param<int> outRowIdx, const uint M, const uint N,
     const int *rrPtr = rRowIdx.get();
     const int *rcPtr = rColIdx.get();
 
-    unsigned csrOutCount = 0;
-    for (uint row = 0; row < M; ++row) {
-        const int lEnd = lrPtr[row + 1];
-        const int rEnd = rrPtr[row + 1];
-
-        uint rowNNZ = 0;
-        int l       = lrPtr[row];
-        int r       = rrPtr[row];
-        while (l < lEnd && r < rEnd) {
-            int lci = lcPtr[l];
-            int rci = rcPtr[r];
-
-            l += (lci <= rci);
-            r += (lci >= rci);
-            rowNNZ++;
+    // Count the entries of every row in parallel, then turn the counts into
+    // row offsets
+    parallel_for(0, M, parallelGrain(16), [&](dim_t first, dim_t last) {
+        for (dim_t row = first; row < last; ++row) {
+            const int lEnd = lrPtr[row + 1];
+            const int rEnd = rrPtr[row + 1];
+
+            int rowNNZ = 0;
+            int l      = lrPtr[row];
+            int r      = rrPtr[row];
+            while (l < lEnd && r < rEnd) {
+                int lci = lcPtr[l];
+                int rci = rcPtr[r];
+
+                l += (lci <= rci);
+                r += (lci >= rci);
+                rowNNZ++;
+            }
+            // Elements from lhs or rhs are exhausted.
+            // Just count left over elements
+            rowNNZ += (lEnd - l);
+            rowNNZ += (rEnd - r);
+
+            orPtr[row + 1] = rowNNZ;
         }
-        // Elements from lhs or rhs are exhausted.
-        // Just count left over elements
-        rowNNZ += (lEnd - l);
-        rowNNZ += (rEnd - r);
+    });
 
-        orPtr[row] = csrOutCount;
-        csrOutCount += rowNNZ;
-    }
-    // Write out the Rows+1 entry
-    orPtr[M] = csrOutCount;
+    orPtr[0] = 0;
+    for (uint row = 0; row < M; ++row) { orPtr[row + 1] += orPtr[row]; }
 }
 
 template<typename T, af_op_t op>
@@ -182,44 +185,46 @@ void sparseArithOp(Param<T> oVals, Param<int> oColIdx, CParam<int> oRowIdx,
 
     auto ZERO = scalar<T>(0);
 
-    for (uint row = 0; row < Rows; ++row) {
-        const int lEnd = lrPtr[row + 1];
-        const int rEnd = rrPtr[row + 1];
-        const int offs = orPtr[row];
-
-        T *ovPtr   = oVals.get() + offs;
-        int *ocPtr = oColIdx.get() + offs;
-
-        uint rowNNZ = 0;
-        int l       = lrPtr[row];
-        int r       = rrPtr[row];
-        while (l < lEnd && r < rEnd) {
-            int lci = lcPtr[l];
-            int rci = rcPtr[r];
-
-            T lhs = (lci <= rci ? lvPtr[l] : ZERO);
-            T rhs = (lci >= rci ? rvPtr[r] : ZERO);
-
-            ovPtr[rowNNZ] = binOp(lhs, rhs);
-            ocPtr[rowNNZ] = (lci <= rci) ? lci : rci;
-
-            l += (lci <= rci);
-            r += (lci >= rci);
-            rowNNZ++;
+    parallel_for(0, Rows, parallelGrain(16), [&](dim_t first, dim_t last) {
+        for (dim_t row = first; row < last; ++row) {
+            const int lEnd = lrPtr[row + 1];
+            const int rEnd = rrPtr[row + 1];
+            const int offs = orPtr[row];
+
+            T *ovPtr   = oVals.get() + offs;
+            int *ocPtr = oColIdx.get() + offs;
+
+            uint rowNNZ = 0;
+            int l       = lrPtr[row];
+            int r       = rrPtr[row];
+            while (l < lEnd && r < rEnd) {
+                int lci = lcPtr[l];
+                int rci = rcPtr[r];
+
+                T lhs = (lci <= rci ? lvPtr[l] : ZERO);
+                T rhs = (lci >= rci ? rvPtr[r] : ZERO);
+
+                ovPtr[rowNNZ] = binOp(lhs, rhs);
+                ocPtr[rowNNZ] = (lci <= rci) ? lci : rci;
+
+                l += (lci <= rci);
+                r += (lci >= rci);
+                rowNNZ++;
+            }
+            while (l < lEnd) {
+                ovPtr[rowNNZ] = binOp(lvPtr[l], ZERO);
+                ocPtr[rowNNZ] = lcPtr[l];
+                l++;
+                rowNNZ++;
+            }
+            while (r < rEnd) {
+                ovPtr[rowNNZ] = binOp(ZERO, rvPtr[r]);
+                ocPtr[rowNNZ] = rcPtr[r];
+                r++;
+                rowNNZ++;
+            }
         }
-        while (l < lEnd) {
-            ovPtr[rowNNZ] = binOp(lvPtr[l], ZERO);
-            ocPtr[rowNNZ] = lcPtr[l];
-            l++;
-            rowNNZ++;
-        }
-        while (r < rEnd) {
-            ovPtr[rowNNZ] = binOp(ZERO, rvPtr[r]);
-            ocPtr[rowNNZ] = rcPtr[r];
-            r++;
-            rowNNZ++;
-        }
-    }
+    });
 }
 }  // namespace kernel
 }  // namespace cpu
@@ -0,0 +1,195 @@
+/*******************************************************
+ * Copyright (c) 2026, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <Param.hpp>
+#include <math.hpp>
+#include <parallel.hpp>
+
+#include <algorithm>
+#include <vector>
+
+// CSR x CSR products with Gustavson's algorithm: row i of C = A * B is the
+// sum of the rows of B selected by the columns of row i of A, scaled by the
+// matching values of A. A symbolic pass counts the entries of every row of C
+// so that the caller can allocate it, then a numeric pass computes them.
+// Both passes process blocks of rows in parallel.
+
+namespace cpu {
+namespace kernel {
+
+/// Accumulates one row of C at a time. Rows with few products compared with
+/// the width of C use an open addressing hash table sized by the number of
+/// products, the others a dense array indexed by column which is allocated
+/// the first time it is needed.
+template<typename T>
+class SpgemmAccumulator {
+   public:
+    explicit SpgemmAccumulator(int ncols) : ncols_(ncols) {}
+
+    /// Starts a new row made of \p products multiply-adds
+    void reset(dim_t products) {
+        cols_.clear();
+        dense_ = products * kDenseRatio > ncols_;
+        if (dense_) {
+            if (stamp_.empty()) {
+                stamp_.assign(ncols_, -1);
+                values_.resize(ncols_);
+            }
+            row_++;
+        } else {
+            size_t capacity = 16;
+            while (capacity < 2 * static_cast<size_t>(products)) {
+                capacity *= 2;
+            }
+            keys_.assign(capacity, -1);
+            slots_.resize(capacity);
+            mask_ = capacity - 1;
+        }
+    }
+
+    /// Returns the sum of column \p col, adding it as zero if it is new
+    T &at(int col) {
+        if (dense_) {
+            if (stamp_[col] != row_) {
+                stamp_[col]  = row_;
+                values_[col] = scalar<T>(0);
+                cols_.push_back(col);
+            }
+            return values_[col];
+        }
+        size_t h = (static_cast<size_t>(col) * 2654435761u) & mask_;
+        while (keys_[h] != col) {
+            if (keys_[h] == -1) {
+                keys_[h]  = col;
+                slots_[h] = scalar<T>(0);
+                cols_.push_back(col);
+                break;
+            }
+            h = (h + 1) & mask_;
+        }
+        return slots_[h];
+    }
+
+    /// The columns of the row in the order they were first seen
+    std::vector<int> &cols() { return cols_; }
+
+   private:
+    /// Rows with at least ncols / kDenseRatio products use the dense array
+    static constexpr dim_t kDenseRatio = 8;
+
+    int ncols_;
+    bool dense_ = false;
+    std::vector<int> cols_;
+
+    // Dense accumulator. stamp_[c] is the last row that wrote column c.
+    int row_ = 0;
+    std::vector<int> stamp_;
+    std::vector<T> values_;
+
+    // Hash accumulator
+    size_t mask_ = 0;
+    std::vector<int> keys_;
+    std::vector<T> slots_;
+};
+
+/// Returns the number of multiply-adds in row \p i of A * B
+inline dim_t spgemmProducts(const int *aRow, const int *aCol, const int *bRow,
+                            int i) {
+    dim_t products = 0;
+    for (int k = aRow[i]; k < aRow[i + 1]; k++) {
+        products += bRow[aCol[k] + 1] - bRow[aCol[k]];
+    }
+    return products;
+}
+
+/// The average number of multiply-adds in a row of A * B
+inline dim_t spgemmRowCost(CParam<int> aRowIdx, CParam<int> bRowIdx) {
+    const dim_t M    = aRowIdx.dims(0) - 1;
+    const dim_t K    = bRowIdx.dims(0) - 1;
+    const dim_t aNNZ = aRowIdx.get()[M] - aRowIdx.get()[0];
+    const dim_t bNNZ = bRowIdx.get()[K] - bRowIdx.get()[0];
+    return 1 + aNNZ * bNNZ / std::max<dim_t>(M * K, 1);
+}
+
+/// Writes the number of entries of every row i of C = A * B to
+/// cRowIdx[i + 1]. C has \p ncols columns.
+inline void spgemmSymbolic(Param<int> cRowIdx, CParam<int> aRowIdx,
+                           CParam<int> aColIdx, CParam<int> bRowIdx,
+                           CParam<int> bColIdx, const int ncols) {
+    const int *aRow = aRowIdx.get();
+    const int *aCol = aColIdx.get();
+    const int *bRow = bRowIdx.get();
+    const int *bCol = bColIdx.get();
+    int *cRow       = cRowIdx.get();
+    const int M     = aRowIdx.dims(0) - 1;
+
+    cRow[0] = 0;
+    parallel_for(
+        0, M, parallelGrain(spgemmRowCost(aRowIdx, bRowIdx)),
+        [&](dim_t first, dim_t last) {
+            SpgemmAccumulator<char> acc(ncols);
+            for (dim_t i = first; i < last; i++) {
+                acc.reset(spgemmProducts(aRow, aCol, bRow, i));
+                for (int k = aRow[i]; k < aRow[i + 1]; k++) {
+                    const int j = aCol[k];
+                    for (int l = bRow[j]; l < bRow[j + 1]; l++) {
+                        acc.at(bCol[l]);
+                    }
+                }
+                cRow[i + 1] = static_cast<int>(acc.cols().size());
+            }
+        });
+}
+
+/// Computes the column indices and values of C = A * B. cRowIdx holds the
+/// offsets of the rows of C computed from spgemmSymbolic. The columns of
+/// every row are sorted.
+template<typename T>
+void spgemmNumeric(Param<T> cValues, Param<int> cColIdx, CParam<int> cRowIdx,
+                   CParam<T> aValues, CParam<int> aRowIdx, CParam<int> aColIdx,
+                   CParam<T> bValues, CParam<int> bRowIdx, CParam<int> bColIdx,
+                   const int ncols) {
+    const T *aVal   = aValues.get();
+    const int *aRow = aRowIdx.get();
+    const int *aCol = aColIdx.get();
+    const T *bVal   = bValues.get();
+    const int *bRow = bRowIdx.get();
+    const int *bCol = bColIdx.get();
+    const int *cRow = cRowIdx.get();
+    T *cVal         = cValues.get();
+    int *cCol       = cColIdx.get();
+    const int M     = aRowIdx.dims(0) - 1;
+
+    parallel_for(
+        0, M, parallelGrain(spgemmRowCost(aRowIdx, bRowIdx)),
+        [&](dim_t first, dim_t last) {
+            SpgemmAccumulator<T> acc(ncols);
+            for (dim_t i = first; i < last; i++) {
+                acc.reset(spgemmProducts(aRow, aCol, bRow, i));
+                for (int k = aRow[i]; k < aRow[i + 1]; k++) {
+                    const int j = aCol[k];
+                    const T a   = aVal[k];
+                    for (int l = bRow[j]; l < bRow[j + 1]; l++) {
+                        acc.at(bCol[l]) += a * bVal[l];
+                    }
+                }
+                std::vector<int> &cols = acc.cols();
+                std::sort(cols.begin(), cols.end());
+                int dst = cRow[i];
+                for (int c : cols) {
+                    cCol[dst]   = c;
+                    cVal[dst++] = acc.at(c);
+                }
+            }
+        });
+}
+
+}  // namespace kernel
+}  // namespace cpu
@@ -0,0 +1,244 @@
+/*******************************************************
+ * Copyright (c) 2026, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <Param.hpp>
+#include <common/dispatch.hpp>
+#include <math.hpp>
+#include <parallel.hpp>
+#include <simd.hpp>
+
+#include <algorithm>
+#include <vector>
+
+// Products of CSR matrices with dense vectors and matrices. The work is
+// split along the merge path of the row ends and the entry indices of the
+// matrix, so every thread gets about the same number of rows plus entries
+// however unevenly the entries are spread between the rows. A row that is
+// cut between two threads is completed by a serial pass which adds the
+// partial sum of the first thread to the value written by the second one.
+
+namespace cpu {
+namespace kernel {
+
+/// A point of the merge path: the number of rows completed and the number of
+/// entries consumed
+struct MergeCoord {
+    int row;
+    int nz;
+};
+
+/// Returns the point where diagonal \p diag crosses the merge path of the
+/// row ends rowPtr[1], ..., rowPtr[rows] and the entry indices [0, nnz)
+inline MergeCoord mergePathSearch(dim_t diag, const int *rowPtr, int rows,
+                                  int nnz) {
+    dim_t lo = std::max<dim_t>(0, diag - nnz);
+    dim_t hi = std::min<dim_t>(diag, rows);
+    while (lo < hi) {
+        dim_t mid = (lo + hi) / 2;
+        if (rowPtr[mid + 1] <= diag - 1 - mid) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return {static_cast<int>(lo), static_cast<int>(diag - lo)};
+}
+
+/// Returns the number of merge path partitions used for \p work element
+/// operations. There are more partitions than threads so that the threads
+/// which are not busy can take over the partitions of those which are.
+inline int spmmPartitions(dim_t work) {
+    dim_t parts =
+        std::min<dim_t>(work / PARALLEL_MIN_WORK, 4 * getNumThreads());
+    return static_cast<int>(std::max<dim_t>(parts, 1));
+}
+
+/// Row products of the types which are not vectorized. See simd::csrmv
+template<typename T>
+void csrmv(T *out, const T *values, const int *cols, const int *rowPtr,
+           int first, const T *x, int rows) {
+    for (int i = 0; i < rows; i++) {
+        T sum = scalar<T>(0);
+        for (int j = i == 0 ? first : rowPtr[i]; j < rowPtr[i + 1]; j++) {
+            sum += values[j] * x[cols[j]];
+        }
+        out[i] = sum;
+    }
+}
+
+inline void csrmv(float *out, const float *values, const int *cols,
+                  const int *rowPtr, int first, const float *x, int rows) {
+    simd::csrmv(out, values, cols, rowPtr, first, x, rows);
+}
+
+inline void csrmv(double *out, const double *values, const int *cols,
+                  const int *rowPtr, int first, const double *x, int rows) {
+    simd::csrmv(out, values, cols, rowPtr, first, x, rows);
+}
+
+/// Row products of the types which are not vectorized. See simd::csrmm
+template<typename T>
+void csrmm(T *out, int ldc, int width, const T *values, const int *cols,
+           const int *rowPtr, int first, const T *packed, int rows) {
+    for (int i = 0; i < rows; i++) {
+        T acc[simd::CSRMM_COLS];
+        std::fill(acc, acc + width, scalar<T>(0));
+        for (int j = i == 0 ? first : rowPtr[i]; j < rowPtr[i + 1]; j++) {
+            const T v    = values[j];
+            const T *row = packed + static_cast<size_t>(cols[j]) * width;
+            for (int k = 0; k < width; k++) { acc[k] += v * row[k]; }
+        }
+        for (int k = 0; k < width; k++) {
+            out[i + static_cast<size_t>(k) * ldc] = acc[k];
+        }
+    }
+}
+
+inline void csrmm(float *out, int ldc, int width, const float *values,
+                  const int *cols, const int *rowPtr, int first,
+                  const float *packed, int rows) {
+    simd::csrmm(out, ldc, width, values, cols, rowPtr, first, packed, rows);
+}
+
+inline void csrmm(double *out, int ldc, int width, const double *values,
+                  const int *cols, const int *rowPtr, int first,
+                  const double *packed, int rows) {
+    simd::csrmm(out, ldc, width, values, cols, rowPtr, first, packed, rows);
+}
+
+/// Computes out = A * rhs for the CSR matrix A and the vector \p rhs
+template<typename T>
+void spmv(Param<T> out, CParam<T> values, CParam<int> rowIdx,
+          CParam<int> colIdx, CParam<T> rhs) {
+    const int rows    = static_cast<int>(rowIdx.dims(0) - 1);
+    const int *rowPtr = rowIdx.get();
+    const int nnz     = rowPtr[rows];
+    const T *vPtr     = values.get();
+    const int *cPtr   = colIdx.get();
+    const T *xPtr     = rhs.get();
+    T *yPtr           = out.get();
+
+    const dim_t total = static_cast<dim_t>(rows) + nnz;
+    const int parts   = spmmPartitions(total);
+
+    // The partial sum of the row each partition stops in
+    std::vector<T> carry(parts, scalar<T>(0));
+    std::vector<int> carryRow(parts, rows);
+
+    parallel_for(0, parts, 1, [&](dim_t first, dim_t last) {
+        for (dim_t p = first; p < last; ++p) {
+            const MergeCoord begin =
+                mergePathSearch(total * p / parts, rowPtr, rows, nnz);
+            const MergeCoord end =
+                mergePathSearch(total * (p + 1) / parts, rowPtr, rows, nnz);
+
+            const int done = end.row - begin.row;
+            if (done > 0) {
+                csrmv(yPtr + begin.row, vPtr, cPtr, rowPtr + begin.row,
+                      begin.nz, xPtr, done);
+            }
+
+            const int bounds[2] = {done > 0 ? rowPtr[end.row] : begin.nz,
+                                   end.nz};
+            if (bounds[1] > bounds[0]) {
+                csrmv(&carry[p], vPtr, cPtr, bounds, bounds[0], xPtr, 1);
+            }
+            carryRow[p] = end.row;
+        }
+    });
+
+    for (int p = 0; p < parts; ++p) {
+        if (carryRow[p] < rows) { yPtr[carryRow[p]] += carry[p]; }
+    }
+}
+
+/// Computes out = A * rhs for the CSR matrix A and the matrix \p rhs.
+///
+/// The columns of \p rhs are copied in blocks of at most simd::CSRMM_COLS,
+/// stored row by row, so that every entry of A multiplies a contiguous row
+/// of the block. The rows of a partition are processed one block at a time
+/// to keep the entries of A they read in the cache.
+template<typename T>
+void spmm(Param<T> out, CParam<T> values, CParam<int> rowIdx,
+          CParam<int> colIdx, CParam<T> rhs) {
+    constexpr int W = simd::CSRMM_COLS;
+
+    const int rows    = static_cast<int>(rowIdx.dims(0) - 1);
+    const int *rowPtr = rowIdx.get();
+    const int nnz     = rowPtr[rows];
+    const T *vPtr     = values.get();
+    const int *cPtr   = colIdx.get();
+    const T *bPtr     = rhs.get();
+    T *oPtr           = out.get();
+
+    const dim_t K      = rhs.dims(0);
+    const dim_t N      = rhs.dims(1);
+    const dim_t ldb    = rhs.strides(1);
+    const int ldc      = static_cast<int>(out.strides(1));
+    const dim_t blocks = divup(N, W);
+
+    std::vector<T> packed(K * N);
+    parallel_for(0, K, parallelGrain(N), [&](dim_t first, dim_t last) {
+        for (dim_t b = 0; b < blocks; ++b) {
+            const dim_t width = std::min<dim_t>(W, N - b * W);
+            const T *src      = bPtr + b * W * ldb;
+            T *dst            = packed.data() + b * K * W;
+            for (dim_t c = first; c < last; ++c) {
+                for (dim_t k = 0; k < width; ++k) {
+                    dst[c * width + k] = src[c + k * ldb];
+                }
+            }
+        }
+    });
+
+    const dim_t total = static_cast<dim_t>(rows) + nnz;
+    const int parts   = spmmPartitions(total * N);
+
+    std::vector<T> carry(parts * blocks * W, scalar<T>(0));
+    std::vector<int> carryRow(parts, rows);
+
+    parallel_for(0, parts, 1, [&](dim_t first, dim_t last) {
+        for (dim_t p = first; p < last; ++p) {
+            const MergeCoord begin =
+                mergePathSearch(total * p / parts, rowPtr, rows, nnz);
+            const MergeCoord end =
+                mergePathSearch(total * (p + 1) / parts, rowPtr, rows, nnz);
+
+            const int done      = end.row - begin.row;
+            const int bounds[2] = {done > 0 ? rowPtr[end.row] : begin.nz,
+                                   end.nz};
+
+            for (dim_t b = 0; b < blocks; ++b) {
+                const int width =
+                    static_cast<int>(std::min<dim_t>(W, N - b * W));
+                const T *pk = packed.data() + b * K * W;
+                if (done > 0) {
+                    csrmm(oPtr + b * W * ldc + begin.row, ldc, width, vPtr,
+                          cPtr, rowPtr + begin.row, begin.nz, pk, done);
+                }
+                if (bounds[1] > bounds[0]) {
+                    csrmm(&carry[(p * blocks + b) * W], 1, width, vPtr, cPtr,
+                          bounds, bounds[0], pk, 1);
+                }
+            }
+            carryRow[p] = end.row;
+        }
+    });
+
+    for (int p = 0; p < parts; ++p) {
+        if (carryRow[p] == rows) { continue; }
+        for (dim_t col = 0; col < N; ++col) {
+            oPtr[carryRow[p] + col * ldc] += carry[p * blocks * W + col];
+        }
+    }
+}
+
+}  // namespace kernel
+}  // namespace cpu
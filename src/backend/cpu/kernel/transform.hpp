@@ -9,7 +9,9 @@
 
 #pragma once
 #include <Param.hpp>
+#include <common/dispatch.hpp>
 #include <err_cpu.hpp>
+#include <parallel.hpp>
 #include <af/traits.hpp>
 #include <type_traits>
 #include "interp.hpp"
@@ -89,13 +91,21 @@ void transform(Param<T> output, CParam<T> input, CParam<float> transform,
     int batch_size = 1;
     if (idims[2] != tdims[2]) batch_size = idims[2];
 
-    Interp2<T, WT, order> interp;
-    for (int idw = 0; idw < (int)odims[3]; idw++) {
-        dim_t out_offw = idw * ostrides[3];
-        dim_t in_offw  = (idims[3] > 1) * idw * istrides[3];
-        dim_t tf_offw  = (tdims[3] > 1) * idw * tstrides[3];
+    // Every row of every image is transformed independently. Images that
+    // share a transform are interpolated together.
+    const dim_t nimages = divup(odims[2], batch_size);
+    const dim_t grain   = parallelGrain(odims[0] * batch_size * order * order);
+    auto transformRows = [&](dim_t first, dim_t last) {
+        Interp2<T, WT, order> interp;
+        for (dim_t row = first; row < last; row++) {
+            const int idy = row % odims[1];
+            const int idz = ((row / odims[1]) % nimages) * batch_size;
+            const int idw = row / (odims[1] * nimages);
+
+            dim_t out_offw = idw * ostrides[3];
+            dim_t in_offw  = (idims[3] > 1) * idw * istrides[3];
+            dim_t tf_offw  = (tdims[3] > 1) * idw * tstrides[3];
 
-        for (int idz = 0; idz < (int)odims[2]; idz += batch_size) {
             dim_t out_offzw = out_offw + idz * ostrides[2];
             dim_t in_offzw  = in_offw + (idims[2] > 1) * idz * istrides[2];
             dim_t tf_offzw  = tf_offw + (tdims[2] > 1) * idz * tstrides[2];
@@ -106,36 +116,35 @@ void transform(Param<T> output, CParam<T> input, CParam<float> transform,
             calc_transform_inverse(tmat, tptr, inverse, perspective,
                                    perspective ? 9 : 6);
 
-            for (int idy = 0; idy < (int)odims[1]; idy++) {
-                for (int idx = 0; idx < (int)odims[0]; idx++) {
-                    WT xidi = idx * tmat[0] + idy * tmat[1] + tmat[2];
-                    WT yidi = idx * tmat[3] + idy * tmat[4] + tmat[5];
+            for (int idx = 0; idx < (int)odims[0]; idx++) {
+                WT xidi = idx * tmat[0] + idy * tmat[1] + tmat[2];
+                WT yidi = idx * tmat[3] + idy * tmat[4] + tmat[5];
 
-                    if (perspective) {
-                        WT W = idx * tmat[6] + idy * tmat[7] + tmat[8];
-                        xidi /= W;
-                        yidi /= W;
-                    }
+                if (perspective) {
+                    WT W = idx * tmat[6] + idy * tmat[7] + tmat[8];
+                    xidi /= W;
+                    yidi /= W;
+                }
 
-                    // FIXME: Nearest and lower do not do clamping, but other
-                    // methods do Make it consistent
-                    bool clamp = order != 1;
-                    bool condX = xidi >= -0.0001 && xidi < idims[0];
-                    bool condY = yidi >= -0.0001 && yidi < idims[1];
-
-                    int ooff = out_offzw + idy * ostrides[1] + idx;
-                    if (condX && condY) {
-                        interp(output, ooff, input, in_offzw, xidi, yidi,
-                               method, batch_size, clamp);
-                    } else {
-                        for (int n = 0; n < batch_size; n++) {
-                            out[ooff + n * ostrides[2]] = scalar<T>(0);
-                        }
+                // FIXME: Nearest and lower do not do clamping, but other
+                // methods do Make it consistent
+                bool clamp = order != 1;
+                bool condX = xidi >= -0.0001 && xidi < idims[0];
+                bool condY = yidi >= -0.0001 && yidi < idims[1];
+
+                int ooff = out_offzw + idy * ostrides[1] + idx;
+                if (condX && condY) {
+                    interp(output, ooff, input, in_offzw, xidi, yidi, method,
+                           batch_size, clamp);
+                } else {
+                    for (int n = 0; n < batch_size; n++) {
+                        out[ooff + n * ostrides[2]] = scalar<T>(0);
                     }
                 }
             }
         }
-    }
+    };
+    parallel_for(0, odims[3] * nimages * odims[1], grain, transformRows);
 }
 
 }  // namespace kernel
@@ -11,6 +11,7 @@
 #include <err_cpu.hpp>
 #include <jit/BinaryNode.hpp>
 #include <optypes.hpp>
+#include <simd.hpp>
 #include <types.hpp>
 #include <af/dim4.hpp>
 
@@ -36,6 +37,29 @@ LOGIC_FN(af_or_t, ||)
 
 #undef LOGIC_FN
 
+#define LOGIC_SIMD_FN(T, OP, FN)                                         \
+    template<>                                                           \
+    struct BinOp<char, T, OP> {                                          \
+        void eval(jit::array<char> &out, const jit::array<T> &lhs,       \
+                  const jit::array<T> &rhs, int lim) {                   \
+            simd::FN(out.data(), lhs.data(), rhs.data(), lim);           \
+        }                                                                \
+    };
+
+#define LOGIC_SIMD_FNS(OP, FN)   \
+    LOGIC_SIMD_FN(float, OP, FN) \
+    LOGIC_SIMD_FN(double, OP, FN)
+
+LOGIC_SIMD_FNS(af_eq_t, eq)
+LOGIC_SIMD_FNS(af_neq_t, neq)
+LOGIC_SIMD_FNS(af_lt_t, lt)
+LOGIC_SIMD_FNS(af_gt_t, gt)
+LOGIC_SIMD_FNS(af_le_t, le)
+LOGIC_SIMD_FNS(af_ge_t, ge)
+
+#undef LOGIC_SIMD_FNS
+#undef LOGIC_SIMD_FN
+
 #define LOGIC_CPLX_FN(T, OP, op)                                    \
     template<>                                                      \
     struct BinOp<char, std::complex<T>, OP> {                       \
@@ -13,6 +13,7 @@
 #if defined(WITH_LINEAR_ALGEBRA)
 #include <handle.hpp>
 #include <kernel/lu.hpp>
+#include <kernel/small_lapack.hpp>
 #include <lapack_helper.hpp>
 #include <math.hpp>
 #include <platform.hpp>
@@ -55,8 +56,8 @@ void lu(Array<T> &lower, Array<T> &upper, Array<int> &pivot,
     pivot            = lu_inplace(in_copy);
 
     // SPLIT into lower and upper
-    dim4 ldims(M, min(M, N));
-    dim4 udims(min(M, N), N);
+    dim4 ldims(M, min(M, N), iDims[2], iDims[3]);
+    dim4 udims(min(M, N), N, iDims[2], iDims[3]);
     lower = createEmptyArray<T>(ldims);
     upper = createEmptyArray<T>(udims);
 
@@ -65,19 +66,35 @@ void lu(Array<T> &lower, Array<T> &upper, Array<int> &pivot,
 
 template<typename T>
 Array<int> lu_inplace(Array<T> &in, const bool convert_pivot) {
-    dim4 iDims = in.dims();
-    Array<int> pivot =
-        createEmptyArray<int>(af::dim4(min(iDims[0], iDims[1]), 1, 1, 1));
+    dim4 iDims       = in.dims();
+    Array<int> pivot = createEmptyArray<int>(
+        af::dim4(min(iDims[0], iDims[1]), 1, iDims[2], iDims[3]));
 
     auto func = [=](Param<T> in, Param<int> pivot) {
-        dim4 iDims = in.dims();
-        getrf_func<T>()(AF_LAPACK_COL_MAJOR, iDims[0], iDims[1], in.get(),
-                        in.strides(1), pivot.get());
+        const dim4 iDims = in.dims();
+        const int M      = iDims[0];
+        const int N      = iDims[1];
+        const int lda    = in.strides(1);
+        const bool small = max(M, N) <= kernel::kSmallMatrixSize;
+
+        kernel::forEachMatrix(iDims, M * N * min(M, N), [&](dim_t z, dim_t w) {
+            T *A   = in.get() + w * in.strides(3) + z * in.strides(2);
+            int *p = pivot.get() + w * pivot.strides(3) + z * pivot.strides(2);
+            if (small && M == N) {
+                kernel::dispatchSmallSize(N, [&](auto size) {
+                    kernel::getrfSmall<decltype(size)::value>(A, lda, M, N, p);
+                });
+            } else if (small) {
+                kernel::getrfSmall<0>(A, lda, M, N, p);
+            } else {
+                getrf_func<T>()(AF_LAPACK_COL_MAJOR, M, N, A, lda, p);
+            }
+        });
     };
     getQueue().enqueue(func, in, pivot);
 
     if (convert_pivot) {
-        Array<int> p = range<int>(dim4(iDims[0]), 0);
+        Array<int> p = range<int>(dim4(iDims[0], 1, iDims[2], iDims[3]), 0);
         getQueue().enqueue(kernel::convertPivot, p, pivot);
         return p;
     } else {
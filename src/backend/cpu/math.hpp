@@ -118,5 +118,9 @@ inline double real(cdouble in) noexcept { return std::real(in); }
 inline float real(cfloat in) noexcept { return std::real(in); }
 inline double imag(cdouble in) noexcept { return std::imag(in); }
 inline float imag(cfloat in) noexcept { return std::imag(in); }
+inline float conjugate(float in) noexcept { return in; }
+inline double conjugate(double in) noexcept { return in; }
+inline cfloat conjugate(cfloat in) noexcept { return std::conj(in); }
+inline cdouble conjugate(cdouble in) noexcept { return std::conj(in); }
 
 }  // namespace cpu
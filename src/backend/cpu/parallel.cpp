@@ -0,0 +1,369 @@
+/*******************************************************
+ * Copyright (c) 2026, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <parallel.hpp>
+
+#include <common/dispatch.hpp>
+#include <common/util.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(OS_LNX)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using std::atomic;
+using std::condition_variable;
+using std::exception_ptr;
+using std::function;
+using std::lock_guard;
+using std::mutex;
+using std::string;
+using std::thread;
+using std::unique_lock;
+using std::unique_ptr;
+using std::vector;
+
+namespace cpu {
+
+namespace {
+
+/// Set on the threads that are currently executing parallel_for blocks so
+/// that nested calls run serially instead of waiting on the pool
+thread_local bool tInsideParallelRegion = false;
+
+int getDefaultNumThreads() {
+    string env_var = getEnvVar("AF_CPU_NUM_THREADS");
+    if (!env_var.empty()) {
+        int input = std::stoi(env_var);
+        if (input > 0) { return input; }
+    }
+    return std::max(1, static_cast<int>(thread::hardware_concurrency()));
+}
+
+/// The number of threads used by parallel_for. Zero until it is first read.
+atomic<int> gNumThreads{0};
+
+#if defined(OS_LNX)
+/// Appends the values of a sysfs list such as "0-3,8,10-11" to \p values
+void parseList(const string &list, vector<int> &values) {
+    std::stringstream ss(list);
+    string range;
+    while (std::getline(ss, range, ',')) {
+        if (range.empty()) { continue; }
+        const size_t dash = range.find('-');
+        const int first   = std::stoi(range.substr(0, dash));
+        const int last =
+            dash == string::npos ? first : std::stoi(range.substr(dash + 1));
+        for (int i = first; i <= last; i++) { values.push_back(i); }
+    }
+}
+
+vector<int> readList(const string &path) {
+    vector<int> values;
+    std::ifstream file(path);
+    string list;
+    if (file && std::getline(file, list)) { parseList(list, values); }
+    return values;
+}
+#endif
+
+/// Returns the CPUs the process may run on, grouped by NUMA node. Returns an
+/// empty list if the workers can't be pinned on this platform.
+vector<int> getCpuOrder() {
+    vector<int> order;
+#if defined(OS_LNX)
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) { return order; }
+
+    vector<bool> seen(CPU_SETSIZE, false);
+    auto add = [&](int cpu) {
+        if (cpu >= 0 && cpu < CPU_SETSIZE && !seen[cpu] &&
+            CPU_ISSET(cpu, &allowed)) {
+            seen[cpu] = true;
+            order.push_back(cpu);
+        }
+    };
+
+    const string nodeDir = "/sys/devices/system/node/";
+    for (int node : readList(nodeDir + "online")) {
+        const string path =
+            nodeDir + "node" + std::to_string(node) + "/cpulist";
+        for (int cpu : readList(path)) { add(cpu); }
+    }
+    // CPUs without NUMA information
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) { add(cpu); }
+#endif
+    return order;
+}
+
+/// Pins the calling thread to \p cpu. Failures are ignored because pinning
+/// only affects performance.
+void pinThread(int cpu) {
+#if defined(OS_LNX)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    UNUSED(cpu);
+#endif
+}
+
+/// The range of blocks owned by one participant of a parallel_for call. The
+/// owner takes blocks from the front and other participants steal from the
+/// back.
+struct BlockRange {
+    mutex mtx;
+    dim_t first = 0;
+    dim_t last  = 0;
+    // Keeps the fields of neighbouring ranges on different cache lines
+    // wherever the array starts. alignas would only be honoured by new from
+    // C++17.
+    char padding[64];
+};
+
+/// A fixed set of worker threads that cooperatively execute the blocks of one
+/// parallel_for call at a time.
+///
+/// The blocks are split into one contiguous range per participant so that
+/// every thread works on neighbouring data. A participant that runs out of
+/// blocks steals half of the remaining range of the next busy participant.
+/// When the workers are pinned, neighbouring participants run on the same
+/// NUMA node so blocks are stolen from the local node first.
+class ThreadPool {
+   public:
+    explicit ThreadPool(int nthreads)
+        : ranges(new BlockRange[nthreads]), nranges(nthreads) {
+        static const bool pin = getEnvVar("AF_CPU_PIN_THREADS") == "1";
+        static const vector<int> cpus = pin ? getCpuOrder() : vector<int>();
+
+        workers.reserve(nthreads - 1);
+        for (int i = 1; i < nthreads; i++) {
+            // The calling thread is participant 0 and is never pinned
+            const int cpu = cpus.empty() ? -1 : cpus[i % cpus.size()];
+            workers.emplace_back([this, i, cpu] {
+                if (cpu >= 0) { pinThread(cpu); }
+                workerLoop(i);
+            });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            lock_guard<mutex> lock(mtx);
+            stop = true;
+        }
+        wakeup.notify_all();
+        for (auto &worker : workers) { worker.join(); }
+    }
+
+    ThreadPool(const ThreadPool &)            = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    int size() const { return nranges; }
+
+    /// Runs \p task for every block in [0, nblocks). Only one thread may
+    /// call run at a time.
+    void run(dim_t nblocks, const function<void(dim_t)> &task) {
+        for (int i = 0; i < nranges; i++) {
+            lock_guard<mutex> lock(ranges[i].mtx);
+            ranges[i].first = nblocks * i / nranges;
+            ranges[i].last  = nblocks * (i + 1) / nranges;
+        }
+        {
+            lock_guard<mutex> lock(mtx);
+            job   = &task;
+            error = nullptr;
+            generation++;
+        }
+        wakeup.notify_all();
+
+        execute(0, task);
+
+        unique_lock<mutex> lock(mtx);
+        finished.wait(lock, [this] { return active == 0; });
+        job = nullptr;
+        if (error) { std::rethrow_exception(error); }
+    }
+
+   private:
+    /// Returns the next block of participant \p self or -1 if there are no
+    /// blocks left in any range
+    dim_t nextBlock(int self) {
+        {
+            BlockRange &own = ranges[self];
+            lock_guard<mutex> lock(own.mtx);
+            if (own.first < own.last) { return own.first++; }
+        }
+        for (int i = 1; i < nranges; i++) {
+            BlockRange &victim = ranges[(self + i) % nranges];
+            dim_t first, last;
+            {
+                lock_guard<mutex> lock(victim.mtx);
+                if (victim.first >= victim.last) { continue; }
+                // Take the back half, rounding up so a single block is taken
+                const dim_t left = victim.last - victim.first;
+                const dim_t mid  = victim.last - divup(left, dim_t(2));
+                first            = mid;
+                last             = victim.last;
+                victim.last      = mid;
+            }
+            BlockRange &own = ranges[self];
+            lock_guard<mutex> lock(own.mtx);
+            own.first = first + 1;
+            own.last  = last;
+            return first;
+        }
+        return -1;
+    }
+
+    void execute(int self, const function<void(dim_t)> &task) {
+        tInsideParallelRegion = true;
+        dim_t block;
+        while ((block = nextBlock(self)) >= 0) {
+            try {
+                task(block);
+            } catch (...) {
+                {
+                    lock_guard<mutex> lock(mtx);
+                    if (!error) { error = std::current_exception(); }
+                }
+                // Skip the remaining blocks
+                for (int i = 0; i < nranges; i++) {
+                    lock_guard<mutex> lock(ranges[i].mtx);
+                    ranges[i].first = ranges[i].last;
+                }
+            }
+        }
+        tInsideParallelRegion = false;
+    }
+
+    void workerLoop(int self) {
+        unsigned seen = 0;
+        unique_lock<mutex> lock(mtx);
+        while (true) {
+            wakeup.wait(lock, [&] { return stop || generation != seen; });
+            if (stop) { return; }
+            seen = generation;
+            // The job may already be over if this worker woke up late
+            if (job == nullptr) { continue; }
+
+            const function<void(dim_t)> &task = *job;
+            active++;
+            lock.unlock();
+            execute(self, task);
+            lock.lock();
+            active--;
+            if (active == 0) { finished.notify_all(); }
+        }
+    }
+
+    unique_ptr<BlockRange[]> ranges;
+    const int nranges;
+    vector<thread> workers;
+
+    mutex mtx;
+    condition_variable wakeup;
+    condition_variable finished;
+
+    const function<void(dim_t)> *job = nullptr;
+    exception_ptr error;
+    unsigned generation = 0;
+    int active          = 0;
+    bool stop           = false;
+};
+
+/// Held while a parallel_for call uses the pool and while the pool is
+/// replaced
+mutex &getPoolMutex() {
+    static auto *poolMutex = new mutex();
+    return *poolMutex;
+}
+
+/// The pool is intentionally leaked like the DeviceManager so that the
+/// workers are not joined during static destruction. Guarded by
+/// getPoolMutex().
+ThreadPool *gPool = nullptr;
+
+}  // namespace
+
+int getNumThreads() {
+    int nthreads = gNumThreads.load();
+    if (nthreads == 0) {
+        int expected = 0;
+        gNumThreads.compare_exchange_strong(expected, getDefaultNumThreads());
+        nthreads = gNumThreads.load();
+    }
+    return nthreads;
+}
+
+void setNumThreads(int nthreads) {
+    if (nthreads <= 0) { nthreads = getDefaultNumThreads(); }
+
+    // Waits for the running parallel_for call. The workers of the old pool
+    // are joined here so they don't compete with the new ones.
+    lock_guard<mutex> lock(getPoolMutex());
+    gNumThreads = nthreads;
+    if (gPool && gPool->size() != nthreads) {
+        delete gPool;
+        gPool = nullptr;
+    }
+}
+
+void parallel_for(dim_t begin, dim_t end, dim_t grain,
+                  const function<void(dim_t, dim_t)> &func) {
+    if (end <= begin) { return; }
+
+    const dim_t len = end - begin;
+    grain           = std::max<dim_t>(grain, 1);
+
+    const int nthreads = getNumThreads();
+    if (nthreads == 1 || len < 2 * grain || tInsideParallelRegion) {
+        func(begin, end);
+        return;
+    }
+
+    // Another thread is using the pool. Running serially is faster than
+    // waiting for it.
+    unique_lock<mutex> running(getPoolMutex(), std::try_to_lock);
+    if (!running) {
+        func(begin, end);
+        return;
+    }
+    if (gPool == nullptr) { gPool = new ThreadPool(nthreads); }
+
+    // A few blocks per thread lets the threads balance the load by stealing
+    // when the cost of the blocks is uneven
+    const dim_t nblocks   = std::min<dim_t>(divup(len, grain), 8 * nthreads);
+    const dim_t blockSize = divup(len, nblocks);
+    const dim_t nused     = divup(len, blockSize);
+
+    auto task = [&](dim_t block) {
+        dim_t first = begin + block * blockSize;
+        dim_t last  = std::min(first + blockSize, end);
+        func(first, last);
+    };
+
+    gPool->run(nused, task);
+}
+
+}  // namespace cpu
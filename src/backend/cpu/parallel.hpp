@@ -0,0 +1,57 @@
+/*******************************************************
+ * Copyright (c) 2026, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+
+#include <af/defines.h>
+
+#include <algorithm>
+#include <functional>
+
+namespace cpu {
+
+/// Returns the number of threads used to split the work inside CPU kernels.
+///
+/// Defaults to the number of hardware threads on the host. It can be
+/// overridden with the AF_CPU_NUM_THREADS environment variable or
+/// setNumThreads.
+int getNumThreads();
+
+/// Changes the number of threads used by parallel_for. Values less than one
+/// restore the default. Waits for the parallel_for call that is currently
+/// running, if any.
+void setNumThreads(int nthreads);
+
+/// The amount of work, roughly in element operations, below which splitting
+/// a range between threads costs more than it saves
+constexpr dim_t PARALLEL_MIN_WORK = 1 << 15;
+
+/// Returns the parallel_for grain for indices that each cost \p cost element
+/// operations
+inline dim_t parallelGrain(dim_t cost) {
+    return std::max<dim_t>(1, PARALLEL_MIN_WORK / std::max<dim_t>(cost, 1));
+}
+
+/// Calls \p func on disjoint sub-ranges of [\p begin, \p end) using the CPU
+/// worker pool and returns once all of them have been processed.
+///
+/// The calling thread processes sub-ranges along with the workers. Idle
+/// threads steal sub-ranges from busy ones so uneven work is balanced. Ranges
+/// shorter than two \p grain sized blocks, calls made from inside another
+/// parallel_for and calls made while another thread uses the pool are
+/// executed serially on the calling thread as a single func(begin, end) call.
+///
+/// \param[in] begin The first index of the range
+/// \param[in] end   One past the last index of the range
+/// \param[in] grain The minimum number of indices handed to a single call
+/// \param[in] func  The function called with the [first, last) sub-ranges
+void parallel_for(dim_t begin, dim_t end, dim_t grain,
+                  const std::function<void(dim_t, dim_t)> &func);
+
+}  // namespace cpu
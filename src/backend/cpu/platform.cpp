@@ -11,6 +11,7 @@
 #include <common/defines.hpp>
 #include <common/host_memory.hpp>
 #include <device_manager.hpp>
+#include <fftw.hpp>
 #include <platform.hpp>
 #include <version.hpp>
 #include <af/version.h>
@@ -180,4 +181,10 @@ graphics::ForgeManager& forgeManager() {
     return *(DeviceManager::getInstance().fgMngr);
 }
 
+PlanCache& fftManager() {
+    // Plans are only created and used on the queue thread
+    static PlanCache cache;
+    return cache;
+}
+
 }  // namespace cpu
@@ -26,6 +26,8 @@ using common::memory::MemoryManagerBase;
 
 namespace cpu {
 
+class PlanCache;
+
 int getBackend();
 
 std::string getDeviceInfo() noexcept;
@@ -67,4 +69,6 @@ void resetMemoryManagerPinned();
 
 graphics::ForgeManager& forgeManager();
 
+PlanCache& fftManager();
+
 }  // namespace cpu
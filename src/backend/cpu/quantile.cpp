@@ -0,0 +1,60 @@
+/*******************************************************
+ * Copyright (c) 2026, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <kernel/quantile.hpp>
+#include <quantile.hpp>
+
+#include <Array.hpp>
+#include <common/quantile.hpp>
+#include <platform.hpp>
+#include <queue.hpp>
+
+#include <vector>
+
+using af::dim4;
+using common::QuantileRank;
+using common::quantileRank;
+using std::vector;
+
+namespace cpu {
+
+template<typename T, typename To>
+Array<To> quantile(const Array<T> &in, const vector<double> &probs,
+                   const int dim) {
+    dim4 odims = in.dims();
+    odims[dim] = static_cast<dim_t>(probs.size());
+
+    vector<QuantileRank> ranks;
+    ranks.reserve(probs.size());
+    for (double prob : probs) {
+        ranks.push_back(quantileRank(prob, in.dims()[dim]));
+    }
+
+    Array<To> out = createEmptyArray<To>(odims);
+    getQueue().enqueue(kernel::quantile<T, To>, out, in, ranks, dim);
+    return out;
+}
+
+#define INSTANTIATE(T)                                                   \
+    template Array<float> quantile<T, float>(                            \
+        const Array<T> &in, const vector<double> &probs, const int dim); \
+    template Array<double> quantile<T, double>(                          \
+        const Array<T> &in, const vector<double> &probs, const int dim);
+
+INSTANTIATE(double)
+INSTANTIATE(float)
+INSTANTIATE(int)
+INSTANTIATE(uint)
+INSTANTIATE(short)
+INSTANTIATE(ushort)
+INSTANTIATE(uchar)
+
+#undef INSTANTIATE
+
+}  // namespace cpu
@@ -23,7 +23,6 @@
 using af::dim4;
 using common::Binary;
 using common::half;
-using common::Transform;
 using cpu::cdouble;
 
 namespace common {
@@ -41,10 +40,6 @@ struct Binary<cdouble, af_add_t> {
 
 namespace cpu {
 
-template<af_op_t op, typename Ti, typename To>
-using reduce_dim_func = std::function<void(
-    Param<To>, const dim_t, CParam<Ti>, const dim_t, const int, bool, double)>;
-
 template<af_op_t op, typename Ti, typename To>
 Array<To> reduce(const Array<Ti> &in, const int dim, bool change_nan,
                  double nanval) {
@@ -52,14 +47,8 @@ Array<To> reduce(const Array<Ti> &in, const int dim, bool change_nan,
     odims[dim] = 1;
 
     Array<To> out = createEmptyArray<To>(odims);
-    static const reduce_dim_func<op, Ti, To> reduce_funcs[4] = {
-        kernel::reduce_dim<op, Ti, To, 1>(),
-        kernel::reduce_dim<op, Ti, To, 2>(),
-        kernel::reduce_dim<op, Ti, To, 3>(),
-        kernel::reduce_dim<op, Ti, To, 4>()};
-
-    getQueue().enqueue(reduce_funcs[in.ndims() - 1], out, 0, in, 0, dim,
-                       change_nan, nanval);
+    getQueue().enqueue(kernel::reduce<op, Ti, To>, out, in, dim, change_nan,
+                       nanval);
 
     return out;
 }
@@ -112,39 +101,8 @@ Taccumulate reduce_all(const Array<Ti> &in, bool change_nan, double nanval) {
     in.eval();
     getQueue().sync();
 
-    Transform<Ti, compute_t<Taccumulate>, op> transform;
-    Binary<compute_t<Taccumulate>, op> reduce;
-
-    compute_t<Taccumulate> out = Binary<compute_t<Taccumulate>, op>::init();
-
-    // Decrement dimension of select dimension
-    af::dim4 dims           = in.dims();
-    af::dim4 strides        = in.strides();
-    const data_t<Ti> *inPtr = in.get();
-
-    for (dim_t l = 0; l < dims[3]; l++) {
-        dim_t off3 = l * strides[3];
-
-        for (dim_t k = 0; k < dims[2]; k++) {
-            dim_t off2 = k * strides[2];
-
-            for (dim_t j = 0; j < dims[1]; j++) {
-                dim_t off1 = j * strides[1];
-
-                for (dim_t i = 0; i < dims[0]; i++) {
-                    dim_t idx = i + off1 + off2 + off3;
-
-                    compute_t<Taccumulate> in_val = transform(inPtr[idx]);
-                    if (change_nan) {
-                        in_val = IS_NAN(in_val) ? nanval : in_val;
-                    }
-                    out = reduce(in_val, out);
-                }
-            }
-        }
-    }
-
-    return data_t<Taccumulate>(out);
+    return data_t<Taccumulate>(
+        kernel::reduce_all<op, Ti, Taccumulate>(in, change_nan, nanval));
 }
 
 #define INSTANTIATE(ROp, Ti, To)                                               \
@@ -15,9 +15,6 @@
 #include <queue.hpp>
 #include <regions.hpp>
 #include <af/dim4.hpp>
-#include <algorithm>
-#include <map>
-#include <set>
 
 using af::dim4;
 
@@ -0,0 +1,384 @@
+/*******************************************************
+ * Copyright (c) 2026, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <simd.hpp>
+#include <simd_math.hpp>
+
+#include <cmath>
+#include <cstdint>
+
+// The loops below are written so that the compiler can vectorize them. On
+// x86-64 ELF platforms every kernel is cloned for several instruction sets
+// and the dynamic loader picks the best clone for the host.
+#if defined(__x86_64__) && defined(__ELF__) &&                      \
+    ((defined(__clang__) && __clang_major__ >= 14) ||               \
+     (!defined(__clang__) && !defined(__INTEL_COMPILER) &&          \
+      defined(__GNUC__) && __GNUC__ >= 6))
+#define SIMD_CLONES \
+    __attribute__((target_clones("avx512f", "avx2", "sse4.2", "default")))
+// Helpers too large to be inlined by default would otherwise only be compiled
+// for the default instruction set
+#define SIMD_INLINE inline __attribute__((always_inline))
+#else
+#define SIMD_CLONES
+#define SIMD_INLINE inline
+#endif
+
+using std::uint32_t;
+using std::uint64_t;
+
+namespace cpu {
+namespace simd {
+
+namespace {
+
+// The constants of the random number generators are from Random123
+// github.com/DEShawResearch/Random123-Boost/blob/master/boost/random/
+
+inline void philoxRound(uint32_t &c0, uint32_t &c1, uint32_t &c2,
+                        uint32_t &c3, uint32_t &k0, uint32_t &k1) {
+    const uint64_t p0 = static_cast<uint64_t>(0xD2511F53) * c0;
+    const uint64_t p1 = static_cast<uint64_t>(0xCD9E8D57) * c2;
+    c0 = static_cast<uint32_t>(p1 >> 32) ^ c1 ^ k0;
+    c1 = static_cast<uint32_t>(p1);
+    c2 = static_cast<uint32_t>(p0 >> 32) ^ c3 ^ k1;
+    c3 = static_cast<uint32_t>(p0);
+    k0 += 0x9E3779B9;
+    k1 += 0xBB67AE85;
+}
+
+inline uint32_t rotL(uint32_t x, int n) { return (x << n) | (x >> (32 - n)); }
+
+/// Four Threefry rounds with the rotations \p r0 to \p r3
+inline void threefryRounds(uint32_t &x0, uint32_t &x1, int r0, int r1, int r2,
+                           int r3) {
+    x0 += x1;
+    x1 = rotL(x1, r0) ^ x0;
+    x0 += x1;
+    x1 = rotL(x1, r1) ^ x0;
+    x0 += x1;
+    x1 = rotL(x1, r2) ^ x0;
+    x0 += x1;
+    x1 = rotL(x1, r3) ^ x0;
+}
+
+/// Products of gemmSmall. The sizes which are not zero in the template
+/// arguments are known at compile time, which lets the compiler unroll the
+/// loops over them. The columns of A are contiguous when UnitRow is true.
+template<int M, int N, int K, bool UnitRow, typename T>
+SIMD_INLINE void gemmSmallImpl(T *c, const T *a, const T *b, T alpha, T beta,
+                               const SmallGemm &g) {
+    const int m              = M != 0 ? M : g.m;
+    const int n              = N != 0 ? N : g.n;
+    const int k              = K != 0 ? K : g.k;
+    const std::ptrdiff_t aRow = UnitRow ? 1 : g.aRow;
+    for (int t = 0; t < g.count; t++) {
+        const T *at = a + t * g.aNext;
+        const T *bt = b + t * g.bNext;
+        T *ct       = c + t * g.cNext;
+        for (int j = 0; j < n; j++) {
+            T acc[GEMM_SMALL_SIZE] = {};
+            for (int p = 0; p < k; p++) {
+                const T bv  = bt[p * g.bRow + j * g.bCol];
+                const T *ap = at + p * g.aCol;
+                for (int i = 0; i < m; i++) { acc[i] += ap[i * aRow] * bv; }
+            }
+            T *cj = ct + j * g.cCol;
+            if (beta == 0) {
+                for (int i = 0; i < m; i++) { cj[i] = alpha * acc[i]; }
+            } else {
+                for (int i = 0; i < m; i++) {
+                    cj[i] = alpha * acc[i] + beta * cj[i];
+                }
+            }
+        }
+    }
+}
+
+template<bool UnitRow, typename T>
+SIMD_INLINE void gemmSmallSizes(T *c, const T *a, const T *b, T alpha,
+                                T beta, const SmallGemm &g) {
+    // The 3x3 and 4x4 products and their matrix-vector forms, the usual
+    // ones in geometry, are unrolled. Columns of 8 and 16 rows fill whole
+    // vector registers.
+    if (g.m == 3 && g.k == 3 && g.n == 3) {
+        gemmSmallImpl<3, 3, 3, UnitRow>(c, a, b, alpha, beta, g);
+    } else if (g.m == 3 && g.k == 3 && g.n == 1) {
+        gemmSmallImpl<3, 1, 3, UnitRow>(c, a, b, alpha, beta, g);
+    } else if (g.m == 4 && g.k == 4 && g.n == 4) {
+        gemmSmallImpl<4, 4, 4, UnitRow>(c, a, b, alpha, beta, g);
+    } else if (g.m == 4 && g.k == 4 && g.n == 1) {
+        gemmSmallImpl<4, 1, 4, UnitRow>(c, a, b, alpha, beta, g);
+    } else if (g.m == 8) {
+        gemmSmallImpl<8, 0, 0, UnitRow>(c, a, b, alpha, beta, g);
+    } else if (g.m == 16) {
+        gemmSmallImpl<16, 0, 0, UnitRow>(c, a, b, alpha, beta, g);
+    } else {
+        gemmSmallImpl<0, 0, 0, UnitRow>(c, a, b, alpha, beta, g);
+    }
+}
+
+}  // namespace
+
+#define SIMD_BINARY(NAME, T, EXPR)                                         \
+    SIMD_CLONES void NAME(T *out, const T *lhs, const T *rhs, int n) {     \
+        for (int i = 0; i < n; i++) {                                      \
+            const T a = lhs[i];                                            \
+            const T b = rhs[i];                                            \
+            out[i]    = EXPR;                                              \
+        }                                                                  \
+    }
+
+#define SIMD_BINARY_ALL(NAME, EXPR) \
+    SIMD_BINARY(NAME, float, EXPR)  \
+    SIMD_BINARY(NAME, double, EXPR)
+
+SIMD_BINARY_ALL(add, a + b)
+SIMD_BINARY_ALL(sub, a - b)
+SIMD_BINARY_ALL(mul, a * b)
+SIMD_BINARY_ALL(div, a / b)
+// Same semantics as std::min and std::max when one of the values is NaN
+SIMD_BINARY_ALL(min, b < a ? b : a)
+SIMD_BINARY_ALL(max, a < b ? b : a)
+
+#undef SIMD_BINARY_ALL
+#undef SIMD_BINARY
+
+#define SIMD_COMPARE(NAME, T, OP)                                          \
+    SIMD_CLONES void NAME(char *out, const T *lhs, const T *rhs, int n) {  \
+        for (int i = 0; i < n; i++) { out[i] = lhs[i] OP rhs[i]; }         \
+    }
+
+#define SIMD_COMPARE_ALL(NAME, OP) \
+    SIMD_COMPARE(NAME, float, OP)  \
+    SIMD_COMPARE(NAME, double, OP)
+
+SIMD_COMPARE_ALL(eq, ==)
+SIMD_COMPARE_ALL(neq, !=)
+SIMD_COMPARE_ALL(lt, <)
+SIMD_COMPARE_ALL(gt, >)
+SIMD_COMPARE_ALL(le, <=)
+SIMD_COMPARE_ALL(ge, >=)
+
+#undef SIMD_COMPARE_ALL
+#undef SIMD_COMPARE
+
+#define SIMD_UNARY(NAME, T, FN)                                            \
+    SIMD_CLONES void NAME(T *out, const T *in, int n) {                    \
+        for (int i = 0; i < n; i++) { out[i] = FN(in[i]); }                \
+    }
+
+SIMD_UNARY(sqrt, float, std::sqrt)
+SIMD_UNARY(sqrt, double, std::sqrt)
+SIMD_UNARY(rsqrt, float, 1.f / std::sqrt)
+SIMD_UNARY(rsqrt, double, 1.0 / std::sqrt)
+
+SIMD_UNARY(exp, float, approxExp)
+SIMD_UNARY(log, float, approxLog)
+SIMD_UNARY(tanh, float, approxTanh)
+SIMD_UNARY(sigmoid, float, approxSigmoid)
+
+#undef SIMD_UNARY
+
+// Large arguments of sin and cos need a more precise range reduction. They
+// are rare so they are fixed up in a second pass.
+#define SIMD_TRIG(NAME, FN)                                                \
+    SIMD_CLONES void NAME(float *out, const float *in, int n) {            \
+        int large = 0;                                                     \
+        for (int i = 0; i < n; i++) {                                      \
+            out[i] = FN(in[i]);                                            \
+            large |= trigLarge(in[i]);                                     \
+        }                                                                  \
+        if (!large) { return; }                                            \
+        for (int i = 0; i < n; i++) {                                      \
+            if (trigLarge(in[i])) { out[i] = std::NAME(in[i]); }           \
+        }                                                                  \
+    }
+
+SIMD_TRIG(sin, approxSin)
+SIMD_TRIG(cos, approxCos)
+
+#undef SIMD_TRIG
+
+SIMD_CLONES void boxMuller(float *out1, float *out2, const float *r1,
+                           const float *r2, int n) {
+    constexpr double kPi = 3.14159265358979323846;
+    for (int i = 0; i < n; i++) {
+        // |theta| <= pi is in the range of approxSin and approxCos
+        const float theta = static_cast<float>(kPi * r1[i]);
+        const float r     = std::sqrt(-2.f * approxLog(r2[i]));
+        out1[i]           = r * approxSin(theta);
+        out2[i]           = r * approxCos(theta);
+    }
+}
+
+SIMD_CLONES void philox(unsigned *c0, unsigned *c1, unsigned *c2,
+                        unsigned *c3, unsigned k0, unsigned k1, int n) {
+    for (int i = 0; i < n; i++) {
+        uint32_t x0 = c0[i], x1 = c1[i], x2 = c2[i], x3 = c3[i];
+        uint32_t key0 = k0, key1 = k1;
+        philoxRound(x0, x1, x2, x3, key0, key1);
+        philoxRound(x0, x1, x2, x3, key0, key1);
+        philoxRound(x0, x1, x2, x3, key0, key1);
+        philoxRound(x0, x1, x2, x3, key0, key1);
+        philoxRound(x0, x1, x2, x3, key0, key1);
+        philoxRound(x0, x1, x2, x3, key0, key1);
+        philoxRound(x0, x1, x2, x3, key0, key1);
+        philoxRound(x0, x1, x2, x3, key0, key1);
+        philoxRound(x0, x1, x2, x3, key0, key1);
+        philoxRound(x0, x1, x2, x3, key0, key1);
+        c0[i] = x0;
+        c1[i] = x1;
+        c2[i] = x2;
+        c3[i] = x3;
+    }
+}
+
+SIMD_CLONES void threefry(unsigned *c0, unsigned *c1, unsigned k0,
+                          unsigned k1, int n) {
+    const uint32_t k2 = 0x1BD11BDA ^ k0 ^ k1;
+    for (int i = 0; i < n; i++) {
+        uint32_t x0 = c0[i] + k0;
+        uint32_t x1 = c1[i] + k1;
+        threefryRounds(x0, x1, 13, 15, 26, 6);
+        x0 += k1;
+        x1 += k2 + 1;
+        threefryRounds(x0, x1, 17, 29, 16, 24);
+        x0 += k2;
+        x1 += k0 + 2;
+        threefryRounds(x0, x1, 13, 15, 26, 6);
+        x0 += k0;
+        x1 += k1 + 3;
+        threefryRounds(x0, x1, 17, 29, 16, 24);
+        x0 += k1;
+        x1 += k2 + 4;
+        c0[i] = x0;
+        c1[i] = x1;
+    }
+}
+
+SIMD_CLONES void hamming(unsigned *acc, const unsigned *query,
+                         const unsigned *train, int nfeat, int ld, int n) {
+    for (int k = 0; k < nfeat; k++) {
+        const uint32_t q    = query[k];
+        const unsigned *row = train + static_cast<size_t>(k) * ld;
+        for (int j = 0; j < n; j++) {
+            // Bit parallel population count. The bytes are summed with
+            // shifts because compilers turn the usual multiplication into
+            // a scalar popcount instruction, which stops vectorization.
+            uint32_t x = q ^ row[j];
+            x          = x - ((x >> 1) & 0x55555555u);
+            x          = (x & 0x33333333u) + ((x >> 2) & 0x33333333u);
+            x          = (x + (x >> 4)) & 0x0f0f0f0fu;
+            x          = x + (x >> 8);
+            x          = x + (x >> 16);
+            acc[j] += x & 0x3fu;
+        }
+    }
+}
+
+#define SIMD_NETWORK(T)                                                    \
+    SIMD_CLONES void sortingNetwork(T *values, const int *pairs,           \
+                                    int npairs, int lanes) {               \
+        for (int c = 0; c < npairs; c++) {                                 \
+            const size_t i = pairs[2 * c];                                 \
+            const size_t j = pairs[2 * c + 1];                             \
+            T *lo          = values + i * lanes;                           \
+            T *hi          = values + j * lanes;                           \
+            for (int l = 0; l < lanes; l++) {                              \
+                const T a = lo[l];                                         \
+                const T b = hi[l];                                         \
+                lo[l]     = b < a ? b : a;                                 \
+                hi[l]     = a < b ? b : a;                                 \
+            }                                                              \
+        }                                                                  \
+    }
+
+SIMD_NETWORK(float)
+SIMD_NETWORK(double)
+SIMD_NETWORK(int)
+SIMD_NETWORK(unsigned)
+SIMD_NETWORK(short)
+SIMD_NETWORK(unsigned short)
+SIMD_NETWORK(char)
+SIMD_NETWORK(unsigned char)
+
+#undef SIMD_NETWORK
+
+// csrmv sums each row with several independent accumulators so that the
+// multiply-adds of consecutive entries do not wait on each other.
+#define SIMD_CSR(T)                                                        \
+    SIMD_CLONES void csrmv(T *out, const T *values, const int *cols,       \
+                           const int *rowPtr, int first, const T *x,       \
+                           int rows) {                                     \
+        constexpr int lanes = 8;                                           \
+        for (int i = 0; i < rows; i++) {                                   \
+            const int end = rowPtr[i + 1];                                 \
+            int j         = i == 0 ? first : rowPtr[i];                    \
+            T acc[lanes]  = {};                                            \
+            for (; j + lanes <= end; j += lanes) {                         \
+                for (int k = 0; k < lanes; k++) {                          \
+                    acc[k] += values[j + k] * x[cols[j + k]];              \
+                }                                                          \
+            }                                                              \
+            T sum = 0;                                                     \
+            for (; j < end; j++) { sum += values[j] * x[cols[j]]; }        \
+            for (int k = 0; k < lanes; k++) { sum += acc[k]; }             \
+            out[i] = sum;                                                  \
+        }                                                                  \
+    }                                                                      \
+                                                                           \
+    SIMD_CLONES void csrmm(T *out, int ldc, int width, const T *values,    \
+                           const int *cols, const int *rowPtr, int first,  \
+                           const T *packed, int rows) {                    \
+        for (int i = 0; i < rows; i++) {                                   \
+            const int end     = rowPtr[i + 1];                             \
+            T acc[CSRMM_COLS] = {};                                        \
+            for (int j = i == 0 ? first : rowPtr[i]; j < end; j++) {       \
+                const T v    = values[j];                                  \
+                const T *row = packed + static_cast<size_t>(cols[j]) *     \
+                                            width;                         \
+                if (width == CSRMM_COLS) {                                 \
+                    for (int k = 0; k < CSRMM_COLS; k++) {                 \
+                        acc[k] += v * row[k];                              \
+                    }                                                      \
+                } else {                                                   \
+                    for (int k = 0; k < width; k++) {                      \
+                        acc[k] += v * row[k];                              \
+                    }                                                      \
+                }                                                          \
+            }                                                              \
+            for (int k = 0; k < width; k++) {                              \
+                out[i + static_cast<size_t>(k) * ldc] = acc[k];            \
+            }                                                              \
+        }                                                                  \
+    }
+
+SIMD_CSR(float)
+SIMD_CSR(double)
+
+#undef SIMD_CSR
+
+#define SIMD_GEMM_SMALL(T)                                                 \
+    SIMD_CLONES void gemmSmall(T *c, const T *a, const T *b, T alpha,      \
+                               T beta, const SmallGemm &g) {               \
+        if (g.aRow == 1) {                                                 \
+            gemmSmallSizes<true>(c, a, b, alpha, beta, g);                 \
+        } else {                                                           \
+            gemmSmallSizes<false>(c, a, b, alpha, beta, g);                \
+        }                                                                  \
+    }
+
+SIMD_GEMM_SMALL(float)
+SIMD_GEMM_SMALL(double)
+
+#undef SIMD_GEMM_SMALL
+
+}  // namespace simd
+}  // namespace cpu
@@ -0,0 +1,161 @@
+/*******************************************************
+ * Copyright (c) 2026, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+/// Vectorized kernels of the CPU backend: the elementwise functions of the
+/// JIT nodes, the Philox and Threefry rounds and the Box-Muller transform of
+/// the random number generators, the Hamming distances of nearest neighbour
+/// search, the sorting networks of the median filters, the sparse products
+/// csrmv and csrmm, and the products of small matrices gemmSmall.
+///
+/// Each elementwise function processes the first \p n elements of its
+/// contiguous inputs. On x86-64 the kernels are compiled for several
+/// instruction sets (SSE4.2, AVX2 and AVX-512) and the best version supported
+/// by the host is selected when the library is loaded. Other platforms use a
+/// single version compiled with the default flags.
+///
+/// The transcendental functions for float use polynomial approximations
+/// that can be vectorized. They are accurate to a few ulp and handle
+/// infinities, NaNs and subnormal values the same way as the standard
+/// library. They are defined in simd_math.hpp, which the compiled JIT engine
+/// shares so both engines give the same results.
+#pragma once
+
+#include <cstddef>
+
+namespace cpu {
+namespace simd {
+
+#define SIMD_BINARY_DECL(NAME)                                             \
+    void NAME(float *out, const float *lhs, const float *rhs, int n);      \
+    void NAME(double *out, const double *lhs, const double *rhs, int n);
+
+#define SIMD_COMPARE_DECL(NAME)                                            \
+    void NAME(char *out, const float *lhs, const float *rhs, int n);       \
+    void NAME(char *out, const double *lhs, const double *rhs, int n);
+
+SIMD_BINARY_DECL(add)
+SIMD_BINARY_DECL(sub)
+SIMD_BINARY_DECL(mul)
+SIMD_BINARY_DECL(div)
+SIMD_BINARY_DECL(min)
+SIMD_BINARY_DECL(max)
+
+SIMD_COMPARE_DECL(eq)
+SIMD_COMPARE_DECL(neq)
+SIMD_COMPARE_DECL(lt)
+SIMD_COMPARE_DECL(gt)
+SIMD_COMPARE_DECL(le)
+SIMD_COMPARE_DECL(ge)
+
+#undef SIMD_BINARY_DECL
+#undef SIMD_COMPARE_DECL
+
+void sqrt(float *out, const float *in, int n);
+void sqrt(double *out, const double *in, int n);
+void rsqrt(float *out, const float *in, int n);
+void rsqrt(double *out, const double *in, int n);
+
+void exp(float *out, const float *in, int n);
+void log(float *out, const float *in, int n);
+void sin(float *out, const float *in, int n);
+void cos(float *out, const float *in, int n);
+void tanh(float *out, const float *in, int n);
+void sigmoid(float *out, const float *in, int n);
+
+/// Box-Muller transform of the uniform values \p r1 in (-1, 1] and \p r2 in
+/// (0, 1). Writes r * sin(pi * r1) to \p out1 and r * cos(pi * r1) to \p out2
+/// where r = sqrt(-2 * log(r2)).
+void boxMuller(float *out1, float *out2, const float *r1, const float *r2,
+               int n);
+
+/// Runs the Philox4x32-10 rounds with the key (\p k0, \p k1) on the \p n
+/// counters whose words are stored in \p c0 to \p c3. The counters are
+/// replaced by the results.
+void philox(unsigned *c0, unsigned *c1, unsigned *c2, unsigned *c3,
+            unsigned k0, unsigned k1, int n);
+
+/// Runs the Threefry2x32-16 rounds with the key (\p k0, \p k1) on the \p n
+/// counters whose words are stored in \p c0 and \p c1. The counters are
+/// replaced by the results.
+void threefry(unsigned *c0, unsigned *c1, unsigned k0, unsigned k1, int n);
+
+/// Adds the Hamming distances between the \p nfeat words of \p query and
+/// \p n training samples to \p acc. Word k of sample j is stored at
+/// train[k * ld + j].
+void hamming(unsigned *acc, const unsigned *query, const unsigned *train,
+             int nfeat, int ld, int n);
+
+#define SIMD_NETWORK_DECL(T) \
+    void sortingNetwork(T *values, const int *pairs, int npairs, int lanes);
+
+/// Applies the \p npairs comparators of a sorting network to \p lanes
+/// independent sets of values. Value i of lane l is stored at
+/// values[i * lanes + l]. Comparator c moves the smaller of the values
+/// pairs[2 * c] and pairs[2 * c + 1] to pairs[2 * c].
+SIMD_NETWORK_DECL(float)
+SIMD_NETWORK_DECL(double)
+SIMD_NETWORK_DECL(int)
+SIMD_NETWORK_DECL(unsigned)
+SIMD_NETWORK_DECL(short)
+SIMD_NETWORK_DECL(unsigned short)
+SIMD_NETWORK_DECL(char)
+SIMD_NETWORK_DECL(unsigned char)
+
+#undef SIMD_NETWORK_DECL
+
+/// The number of columns of the dense operand processed together by csrmm
+constexpr int CSRMM_COLS = 8;
+
+#define SIMD_CSR_DECL(T)                                                   \
+    void csrmv(T *out, const T *values, const int *cols,                   \
+               const int *rowPtr, int first, const T *x, int rows);        \
+    void csrmm(T *out, int ldc, int width, const T *values,                \
+               const int *cols, const int *rowPtr, int first,              \
+               const T *packed, int rows);
+
+/// Products of \p rows CSR rows with dense operands. Row i spans the entries
+/// [rowPtr[i], rowPtr[i + 1]) of \p values and \p cols, except that the
+/// first row starts at entry \p first.
+///
+/// csrmv writes the dot product of row i with the vector \p x to out[i].
+/// csrmm multiplies the rows with \p width columns of a dense matrix, at most
+/// CSRMM_COLS, that are packed row by row in \p packed: element (c, k) is
+/// stored at packed[c * width + k]. It writes column k of the result to
+/// out[i + k * ldc].
+SIMD_CSR_DECL(float)
+SIMD_CSR_DECL(double)
+
+#undef SIMD_CSR_DECL
+
+/// The largest number of rows of the products computed by gemmSmall
+constexpr int GEMM_SMALL_SIZE = 16;
+
+/// The sizes and the layout of a batch of products for gemmSmall. Element
+/// (i, p) of matrix t of A is a[t * aNext + i * aRow + p * aCol], element
+/// (p, j) of matrix t of B is b[t * bNext + p * bRow + j * bCol] and element
+/// (i, j) of matrix t of C is c[t * cNext + i + j * cCol].
+struct SmallGemm {
+    int m;      ///< The number of rows of A and C, at most GEMM_SMALL_SIZE
+    int n;      ///< The number of columns of B and C
+    int k;      ///< The number of columns of A and rows of B
+    int count;  ///< The number of products
+    std::ptrdiff_t aRow, aCol, aNext;
+    std::ptrdiff_t bRow, bCol, bNext;
+    std::ptrdiff_t cCol, cNext;
+};
+
+/// Computes C = alpha * A * B + beta * C for a batch of small matrices laid
+/// out as described by \p g. C is not read when \p beta is zero.
+void gemmSmall(float *c, const float *a, const float *b, float alpha,
+               float beta, const SmallGemm &g);
+void gemmSmall(double *c, const double *a, const double *b, double alpha,
+               double beta, const SmallGemm &g);
+
+}  // namespace simd
+}  // namespace cpu
@@ -0,0 +1,203 @@
+/*******************************************************
+ * Copyright (c) 2026, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+/// Scalar approximations of the float transcendental functions.
+///
+/// They are used by the kernels in simd.cpp and pasted into the source of the
+/// compiled JIT engine, so both JIT engines produce the same results. The
+/// file must therefore only depend on the standard library. It uses an
+/// include guard because #pragma once warns in the generated source.
+#ifndef AF_CPU_SIMD_MATH_HPP
+#define AF_CPU_SIMD_MATH_HPP
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace cpu {
+namespace simd {
+
+inline std::uint32_t asBits(float x) {
+    std::uint32_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    return bits;
+}
+
+inline float asFloat(std::uint32_t bits) {
+    float x;
+    std::memcpy(&x, &bits, sizeof(x));
+    return x;
+}
+
+/// Returns 2^n for n in [-126, 127]
+inline float pow2(std::int32_t n) {
+    return asFloat(static_cast<std::uint32_t>(n + 127) << 23);
+}
+
+// The approximations below are based on the single precision functions of
+// the Cephes Math Library by Stephen L. Moshier
+
+constexpr float kLog2e  = 1.44269504088896341f;
+constexpr float kLn2Hi  = 0.693359375f;
+constexpr float kLn2Lo  = -2.12194440e-4f;
+constexpr float kExpMax = 88.7228391f;   // log(FLT_MAX)
+constexpr float kExpMin = -103.972084f;  // log(smallest subnormal / 2)
+
+inline float approxExp(float x) {
+    // NaNs are clamped as well so that the conversion below is defined
+    const float xc = x > kExpMax ? kExpMax : (x >= kExpMin ? x : kExpMin);
+
+    // x = n * ln(2) + r with |r| <= ln(2) / 2
+    // Adding and subtracting 1.5 * 2^23 rounds to the nearest integer
+    const float fn       = (xc * kLog2e + 12582912.f) - 12582912.f;
+    const std::int32_t n = static_cast<std::int32_t>(fn);
+    float r              = xc - fn * kLn2Hi;
+    r                    = r - fn * kLn2Lo;
+
+    const float r2 = r * r;
+    float p        = 1.9875691500E-4f;
+    p              = p * r + 1.3981999507E-3f;
+    p              = p * r + 8.3334519073E-3f;
+    p              = p * r + 4.1665795894E-2f;
+    p              = p * r + 1.6666665459E-1f;
+    p              = p * r + 5.0000001201E-1f;
+    p              = p * r2 + r + 1.f;
+
+    // 2^n is applied in two steps so that subnormal results are correct
+    const std::int32_t n1 = n / 2;
+    const float res       = p * pow2(n1) * pow2(n - n1);
+
+    const float inf = std::numeric_limits<float>::infinity();
+    const float big = x > kExpMax ? inf : res;
+    const float out = x < kExpMin ? 0.f : big;
+    return x != x ? x : out;
+}
+
+inline float approxLog(float x) {
+    // Scale subnormal inputs into the normal range
+    const bool sub = x < std::numeric_limits<float>::min();
+    const float xs = sub ? x * 8388608.f : x;  // 2^23
+
+    // xs = m * 2^e with m in [sqrt(0.5), sqrt(2))
+    const std::uint32_t bits = asBits(xs);
+    std::int32_t e = static_cast<std::int32_t>((bits >> 23) & 0xff) - 126;
+    float m        = asFloat((bits & 0x007fffffu) | 0x3f000000u);  // [0.5, 1)
+    e              = sub ? e - 23 : e;
+
+    const bool small = m < 0.707106781186547524f;
+    e                = small ? e - 1 : e;
+    m                = small ? m + m - 1.f : m - 1.f;
+
+    const float fe = static_cast<float>(e);
+    const float z  = m * m;
+    float p        = 7.0376836292E-2f;
+    p              = p * m - 1.1514610310E-1f;
+    p              = p * m + 1.1676998740E-1f;
+    p              = p * m - 1.2420140846E-1f;
+    p              = p * m + 1.4249322787E-1f;
+    p              = p * m - 1.6668057665E-1f;
+    p              = p * m + 2.0000714765E-1f;
+    p              = p * m - 2.4999993993E-1f;
+    p              = p * m + 3.3333331174E-1f;
+
+    float y   = p * m * z;
+    y         = y + kLn2Lo * fe;
+    y         = y - 0.5f * z;
+    float res = m + y;
+    res       = res + kLn2Hi * fe;
+
+    const float inf = std::numeric_limits<float>::infinity();
+    res             = x == inf ? inf : res;
+    res             = x == 0.f ? -inf : res;
+    return (x < 0.f || x != x) ? std::numeric_limits<float>::quiet_NaN() : res;
+}
+
+/// Largest argument handled by approxSin and approxCos. Larger arguments
+/// are handled by the standard library.
+constexpr float kTrigMax = 8192.f;
+
+/// Reduces \p ax to [-pi/4, pi/4] and returns the octant in \p j
+inline float trigReduce(float ax, std::int32_t &j) {
+    j = static_cast<std::int32_t>(ax * 1.27323954473516f);  // 4 / pi
+    j = (j + 1) & ~1;
+    const float y = static_cast<float>(j);
+    float r       = ax - y * 0.78515625f;
+    r             = r - y * 2.4187564849853515625e-4f;
+    r             = r - y * 3.77489497744594108e-8f;
+    return r;
+}
+
+inline float sinPoly(float r) {
+    const float z = r * r;
+    float p       = -1.9515295891E-4f;
+    p             = p * z + 8.3321608736E-3f;
+    p             = p * z - 1.6666654611E-1f;
+    return p * z * r + r;
+}
+
+inline float cosPoly(float r) {
+    const float z = r * r;
+    float p       = 2.443315711809948E-5f;
+    p             = p * z - 1.388731625493765E-3f;
+    p             = p * z + 4.166664568298827E-2f;
+    return p * z * z - 0.5f * z + 1.f;
+}
+
+/// Flips the sign of \p x where \p sign has its sign bit set
+inline float flipSign(float x, std::uint32_t sign) {
+    return asFloat(asBits(x) ^ (sign & 0x80000000u));
+}
+
+/// Only valid for |x| <= kTrigMax. See trigLarge.
+inline float approxSin(float x) {
+    const float ax = std::fabs(x);
+    std::int32_t j;
+    const float r = trigReduce(ax < kTrigMax ? ax : kTrigMax, j);
+    const float s = (j & 2) ? cosPoly(r) : sinPoly(r);
+    // The sign flips for octants 4-7 and for negative arguments
+    return flipSign(s, (static_cast<std::uint32_t>(j) << 29) ^ asBits(x));
+}
+
+/// Only valid for |x| <= kTrigMax. See trigLarge.
+inline float approxCos(float x) {
+    const float ax = std::fabs(x);
+    std::int32_t j;
+    const float r = trigReduce(ax < kTrigMax ? ax : kTrigMax, j);
+    const float c = (j & 2) ? sinPoly(r) : cosPoly(r);
+    return flipSign(c, static_cast<std::uint32_t>(j + 2) << 29);
+}
+
+/// Returns true if \p x is outside the range of approxSin and approxCos
+inline bool trigLarge(float x) { return !(std::fabs(x) <= kTrigMax); }
+
+inline float approxTanh(float x) {
+    const float ax = std::fabs(x);
+
+    // tanh(x) = 1 - 2 / (exp(2x) + 1) away from zero
+    const float big = 1.f - 2.f / (approxExp(ax + ax) + 1.f);
+
+    const float z = x * x;
+    float p       = -5.70498872745E-3f;
+    p             = p * z + 2.06390887954E-2f;
+    p             = p * z - 5.37397155531E-2f;
+    p             = p * z + 1.33314422036E-1f;
+    p             = p * z - 3.33332819422E-1f;
+    const float small = p * z * x + x;
+
+    const float res = std::copysign(big, x);
+    return ax > 0.625f ? res : small;
+}
+
+inline float approxSigmoid(float x) { return 1.f / (1.f + approxExp(-x)); }
+
+}  // namespace simd
+}  // namespace cpu
+
+#endif  // AF_CPU_SIMD_MATH_HPP
@@ -13,6 +13,7 @@
 
 #if defined(WITH_LINEAR_ALGEBRA)
 #include <copy.hpp>
+#include <kernel/small_lapack.hpp>
 #include <lapack_helper.hpp>
 #include <math.hpp>
 #include <queue.hpp>
@@ -82,8 +83,24 @@ Array<T> solveLU(const Array<T> &A, const Array<int> &pivot, const Array<T> &b,
     // NOLINTNEXTLINE
     auto func = [=](CParam<T> A, Param<T> B, CParam<int> pivot, int N,
                     int NRHS) {
-        getrs_func<T>()(AF_LAPACK_COL_MAJOR, 'N', N, NRHS, A.get(),
-                        A.strides(1), pivot.get(), B.get(), B.strides(1));
+        const int lda = A.strides(1);
+        const int ldb = B.strides(1);
+        kernel::forEachMatrix(
+            B.dims(), N * (N + NRHS), [&](dim_t z, dim_t w) {
+                const T *a = A.get() + w * A.strides(3) + z * A.strides(2);
+                const int *p =
+                    pivot.get() + w * pivot.strides(3) + z * pivot.strides(2);
+                T *b = B.get() + w * B.strides(3) + z * B.strides(2);
+                if (N <= kernel::kSmallMatrixSize) {
+                    kernel::dispatchSmallSize(N, [&](auto size) {
+                        kernel::getrsSmall<decltype(size)::value>(
+                            a, lda, N, p, b, ldb, NRHS);
+                    });
+                } else {
+                    getrs_func<T>()(AF_LAPACK_COL_MAJOR, 'N', N, NRHS, a, lda,
+                                    p, b, ldb);
+                }
+            });
     };
     getQueue().enqueue(func, A, B, pivot, N, NRHS);
 
@@ -99,10 +116,24 @@ Array<T> triangleSolve(const Array<T> &A, const Array<T> &b,
 
     auto func = [=](const CParam<T> A, Param<T> B, int N, int NRHS,
                     const af_mat_prop options) {
-        trtrs_func<T>()(AF_LAPACK_COL_MAJOR, options & AF_MAT_UPPER ? 'U' : 'L',
-                        'N',  // transpose flag
-                        options & AF_MAT_DIAG_UNIT ? 'U' : 'N', N, NRHS,
-                        A.get(), A.strides(1), B.get(), B.strides(1));
+        const bool upper = options & AF_MAT_UPPER;
+        const bool unit  = options & AF_MAT_DIAG_UNIT;
+        const int lda    = A.strides(1);
+        const int ldb    = B.strides(1);
+        kernel::forEachMatrix(B.dims(), N * NRHS, [&](dim_t z, dim_t w) {
+            const T *a = A.get() + w * A.strides(3) + z * A.strides(2);
+            T *b       = B.get() + w * B.strides(3) + z * B.strides(2);
+            if (N <= kernel::kSmallMatrixSize) {
+                kernel::dispatchSmallSize(N, [&](auto size) {
+                    kernel::trtrsSmall<decltype(size)::value>(
+                        upper, unit, a, lda, N, b, ldb, NRHS);
+                });
+            } else {
+                trtrs_func<T>()(AF_LAPACK_COL_MAJOR, upper ? 'U' : 'L',
+                                'N',  // transpose flag
+                                unit ? 'U' : 'N', N, NRHS, a, lda, b, ldb);
+            }
+        });
     };
     getQueue().enqueue(func, A, B, N, NRHS, options);
 
@@ -130,23 +161,48 @@ Array<T> solve(const Array<T> &a, const Array<T> &b,
                       : padArrayBorders(b, NullShape, endPadding, AF_PAD_ZERO));
 
     if (M == N) {
-        Array<int> pivot = createEmptyArray<int>(dim4(N, 1, 1));
+        Array<int> pivot =
+            createEmptyArray<int>(dim4(N, 1, a.dims()[2], a.dims()[3]));
 
         auto func = [=](Param<T> A, Param<T> B, Param<int> pivot, int N,
                         int K) {
-            gesv_func<T>()(AF_LAPACK_COL_MAJOR, N, K, A.get(), A.strides(1),
-                           pivot.get(), B.get(), B.strides(1));
+            const int lda = A.strides(1);
+            const int ldb = B.strides(1);
+            kernel::forEachMatrix(
+                A.dims(), N * N * (N + K), [&](dim_t z, dim_t w) {
+                    T *a   = A.get() + w * A.strides(3) + z * A.strides(2);
+                    T *b   = B.get() + w * B.strides(3) + z * B.strides(2);
+                    int *p = pivot.get() + w * pivot.strides(3) +
+                             z * pivot.strides(2);
+                    if (N <= kernel::kSmallMatrixSize) {
+                        // Like gesv, the solve is skipped for singular
+                        // matrices
+                        kernel::dispatchSmallSize(N, [&](auto size) {
+                            constexpr int S = decltype(size)::value;
+                            if (kernel::getrfSmall<S>(a, lda, N, N, p) == 0) {
+                                kernel::getrsSmall<S>(a, lda, N, p, b, ldb, K);
+                            }
+                        });
+                    } else {
+                        gesv_func<T>()(AF_LAPACK_COL_MAJOR, N, K, a, lda, p, b,
+                                       ldb);
+                    }
+                });
         };
         getQueue().enqueue(func, A, B, pivot, N, K);
     } else {
         auto func = [=](Param<T> A, Param<T> B, int M, int N, int K) {
-            int sM = A.strides(1);
-            int sN = A.strides(2) / sM;
-
-            gels_func<T>()(AF_LAPACK_COL_MAJOR, 'N', M, N, K, A.get(),
-                           A.strides(1), B.get(), max(sM, sN));
+            kernel::forEachMatrix(
+                A.dims(), M * N * max(M, N), [&](dim_t z, dim_t w) {
+                    gels_func<T>()(
+                        AF_LAPACK_COL_MAJOR, 'N', M, N, K,
+                        A.get() + w * A.strides(3) + z * A.strides(2),
+                        A.strides(1),
+                        B.get() + w * B.strides(3) + z * B.strides(2),
+                        B.strides(1));
+                });
         };
-        B.resetDims(dim4(N, K));
+        B.resetDims(dim4(N, K, b.dims()[2], b.dims()[3]));
         getQueue().enqueue(func, A, B, M, N, K);
     }
 
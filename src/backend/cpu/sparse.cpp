@@ -111,6 +111,10 @@ SparseArray<T> sparseConvertStorageToStorage(const SparseArray<T> &in) {
         converter = kernel::csr2coo<T>;
     } else if (src == AF_STORAGE_COO && dest == AF_STORAGE_CSR) {
         converter = kernel::coo2csr<T>;
+    } else if (src == AF_STORAGE_CSR && dest == AF_STORAGE_CSC) {
+        converter = kernel::csr2csc<T>;
+    } else if (src == AF_STORAGE_CSC && dest == AF_STORAGE_CSR) {
+        converter = kernel::csc2csr<T>;
     } else {
         // Should never come here
         AF_ERROR("CPU Backend invalid conversion combination",
@@ -122,6 +126,24 @@ SparseArray<T> sparseConvertStorageToStorage(const SparseArray<T> &in) {
     return converted;
 }
 
+template<typename T>
+SparseArray<T> sparseTranspose(const SparseArray<T> &in, const bool conjugate) {
+    in.eval();
+
+    const dim4 &iDims = in.dims();
+    auto transposed   = createEmptySparseArray<T>(
+        dim4(iDims[1], iDims[0]), static_cast<int>(in.getNNZ()),
+        AF_STORAGE_CSR);
+    transposed.eval();
+
+    // The CSR arrays of the transpose are the CSC arrays of the input
+    getQueue().enqueue(kernel::compressedTranspose<T>, transposed.getValues(),
+                       transposed.getRowIdx(), transposed.getColIdx(),
+                       in.getValues(), in.getRowIdx(), in.getColIdx(),
+                       conjugate);
+    return transposed;
+}
+
 #define INSTANTIATE_TO_STORAGE(T, S)                     \
     template SparseArray<T>                              \
     sparseConvertStorageToStorage<T, S, AF_STORAGE_CSR>( \
@@ -149,7 +171,9 @@ SparseArray<T> sparseConvertStorageToStorage(const SparseArray<T> &in) {
                                                                             \
     INSTANTIATE_TO_STORAGE(T, AF_STORAGE_CSR)                               \
     INSTANTIATE_TO_STORAGE(T, AF_STORAGE_CSC)                               \
-    INSTANTIATE_TO_STORAGE(T, AF_STORAGE_COO)
+    INSTANTIATE_TO_STORAGE(T, AF_STORAGE_COO)                               \
+    template SparseArray<T> sparseTranspose<T>(const SparseArray<T> &in,    \
+                                               const bool conjugate);
 
 INSTANTIATE_SPARSE(float)
 INSTANTIATE_SPARSE(double)
@@ -22,4 +22,9 @@ Array<T> sparseConvertStorageToDense(const common::SparseArray<T> &in);
 template<typename T, af_storage dest, af_storage src>
 common::SparseArray<T> sparseConvertStorageToStorage(
     const common::SparseArray<T> &in);
+
+/// Returns the (conjugate) transpose of the CSR matrix \p in in CSR storage
+template<typename T>
+common::SparseArray<T> sparseTranspose(const common::SparseArray<T> &in,
+                                       const bool conjugate);
 }  // namespace cpu
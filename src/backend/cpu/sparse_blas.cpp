@@ -16,6 +16,8 @@
 #include <common/complex.hpp>
 #include <common/err_common.hpp>
 #include <complex.hpp>
+#include <kernel/spgemm.hpp>
+#include <kernel/spmm.hpp>
 #include <math.hpp>
 #include <platform.hpp>
 #include <queue.hpp>
@@ -23,6 +25,7 @@
 #include <af/dim4.hpp>
 
 #include <cassert>
+#include <limits>
 #include <stdexcept>
 #include <string>
 
@@ -275,186 +278,86 @@ Array<T> matmul(const common::SparseArray<T> &lhs, const Array<T> &rhs,
 #else  // #if USE_MKL
 
 template<typename T>
-T getConjugate(const T &in) {
-    // For non-complex types return same
-    return in;
-}
+Array<T> matmul(const common::SparseArray<T> &lhs, const Array<T> &rhs,
+                af_mat_prop optLhs, af_mat_prop optRhs) {
+    UNUSED(optRhs);
 
-template<>
-cfloat getConjugate(const cfloat &in) {
-    return std::conj(in);
-}
+    // The transposed products use an explicit transpose of lhs so that every
+    // thread writes its own rows of the output
+    const common::SparseArray<T> left =
+        (optLhs == AF_MAT_NONE
+             ? lhs
+             : sparseTranspose(lhs, optLhs == AF_MAT_CTRANS));
 
-template<>
-cdouble getConjugate(const cdouble &in) {
-    return std::conj(in);
-}
+    const int M = left.dims()[0];
+    const int N = rhs.dims()[1];
 
-template<typename T, bool conjugate>
-void mv(Param<T> output, CParam<T> values, CParam<int> rowIdx,
-        CParam<int> colIdx, CParam<T> right, int M) {
-    const T *valPtr   = values.get();
-    const int *rowPtr = rowIdx.get();
-    const int *colPtr = colIdx.get();
-    const T *rightPtr = right.get();
-
-    T *outPtr = output.get();
-
-    // Output Array Created is a zero value Array
-    // Hence, no need to initialize to zero here
-    for (int i = 0; i < M; ++i) {
-        for (int j = rowPtr[i]; j < rowPtr[i + 1]; ++j) {
-            // If stride[0] of right is not 1 then rightPtr[colPtr[j]*stride]
-            if (conjugate) {
-                outPtr[i] += getConjugate(valPtr[j]) * rightPtr[colPtr[j]];
-            } else {
-                outPtr[i] += valPtr[j] * rightPtr[colPtr[j]];
-            }
-        }
-    }
-}
+    Array<T> out = createEmptyArray<T>(af::dim4(M, N, 1, 1));
 
-template<typename T, bool conjugate>
-void mtv(Param<T> output, CParam<T> values, CParam<int> rowIdx,
-         CParam<int> colIdx, CParam<T> right, int M) {
-    UNUSED(M);
-
-    const T *valPtr   = values.get();
-    const int *rowPtr = rowIdx.get();
-    const int *colPtr = colIdx.get();
-    const T *rightPtr = right.get();
-    T *outPtr         = output.get();
-
-    // Output Array Created is a zero value Array
-    // Hence, no need to initialize to zero here
-    for (int i = 0; i < rowIdx.dims(0) - 1; ++i) {
-        for (int j = rowPtr[i]; j < rowPtr[i + 1]; ++j) {
-            // If stride[0] of right is not 1 then rightPtr[i*stride]
-            if (conjugate) {
-                outPtr[colPtr[j]] += getConjugate(valPtr[j]) * rightPtr[i];
-            } else {
-                outPtr[colPtr[j]] += valPtr[j] * rightPtr[i];
-            }
-        }
+    if (N == 1) {
+        getQueue().enqueue(kernel::spmv<T>, out, left.getValues(),
+                           left.getRowIdx(), left.getColIdx(), rhs);
+    } else {
+        getQueue().enqueue(kernel::spmm<T>, out, left.getValues(),
+                           left.getRowIdx(), left.getColIdx(), rhs);
     }
-}
 
-template<typename T, bool conjugate>
-void mm(Param<T> output, CParam<T> values, CParam<int> rowIdx,
-        CParam<int> colIdx, CParam<T> right, int M, int N, int ldb, int ldc) {
-    UNUSED(M);
-    const T *valPtr   = values.get();
-    const int *rowPtr = rowIdx.get();
-    const int *colPtr = colIdx.get();
-    const T *rightPtr = right.get();
-    T *outPtr         = output.get();
-
-    for (int o = 0; o < N; ++o) {
-        for (int i = 0; i < rowIdx.dims(0) - 1; ++i) {
-            outPtr[i] = scalar<T>(0);
-            for (int j = rowPtr[i]; j < rowPtr[i + 1]; ++j) {
-                // If stride[0] of right is not 1 then
-                // rightPtr[colPtr[j]*stride]
-                if (conjugate) {
-                    outPtr[i] += getConjugate(valPtr[j]) * rightPtr[colPtr[j]];
-                } else {
-                    outPtr[i] += valPtr[j] * rightPtr[colPtr[j]];
-                }
-            }
-        }
-        rightPtr += ldb;
-        outPtr += ldc;
-    }
+    return out;
 }
 
-template<typename T, bool conjugate>
-void mtm(Param<T> output, CParam<T> values, CParam<int> rowIdx,
-         CParam<int> colIdx, CParam<T> right, int M, int N, int ldb, int ldc) {
-    const T *valPtr   = values.get();
-    const int *rowPtr = rowIdx.get();
-    const int *colPtr = colIdx.get();
-    const T *rightPtr = right.get();
-    T *outPtr         = output.get();
-
-    for (int o = 0; o < N; ++o) {
-        for (int i = 0; i < M; ++i) { outPtr[i] = scalar<T>(0); }
-
-        for (int i = 0; i < rowIdx.dims(0) - 1; ++i) {
-            for (int j = rowPtr[i]; j < rowPtr[i + 1]; ++j) {
-                // If stride[0] of right is not 1 then rightPtr[i*stride]
-                if (conjugate) {
-                    outPtr[colPtr[j]] += getConjugate(valPtr[j]) * rightPtr[i];
-                } else {
-                    outPtr[colPtr[j]] += valPtr[j] * rightPtr[i];
-                }
-            }
-        }
-        rightPtr += ldb;
-        outPtr += ldc;
-    }
-}
+#endif  // #if USE_MKL
 
 template<typename T>
-Array<T> matmul(const common::SparseArray<T> &lhs, const Array<T> &rhs,
-                af_mat_prop optLhs, af_mat_prop optRhs) {
+common::SparseArray<T> matmul(const common::SparseArray<T> &lhs,
+                              const common::SparseArray<T> &rhs,
+                              af_mat_prop optLhs, af_mat_prop optRhs) {
     UNUSED(optRhs);
 
-    // Similar Operations to GEMM
-    sparse_operation_t lOpts = toSparseTranspose(optLhs);
-
-    int lRowDim = (lOpts == SPARSE_OPERATION_NON_TRANSPOSE) ? 0 : 1;
-
-    static const int rColDim = 1;
-
-    const dim4 &lDims = lhs.dims();
-    const dim4 &rDims = rhs.dims();
-    int M             = lDims[lRowDim];
-    int N             = rDims[rColDim];
-
-    Array<T> out = createValueArray<T>(af::dim4(M, N, 1, 1), scalar<T>(0));
-
-    auto func = [=](Param<T> output, CParam<T> values, CParam<int> rowIdx,
-                    CParam<int> colIdx, CParam<T> right) {
-        int ldb = right.strides(1);
-        int ldc = output.strides(1);
-
-        if (rDims[rColDim] == 1) {
-            if (lOpts == SPARSE_OPERATION_NON_TRANSPOSE) {
-                mv<T, false>(output, values, rowIdx, colIdx, right, M);
-            } else if (lOpts == SPARSE_OPERATION_TRANSPOSE) {
-                mtv<T, false>(output, values, rowIdx, colIdx, right, M);
-            } else if (lOpts == SPARSE_OPERATION_CONJUGATE_TRANSPOSE) {
-                mtv<T, true>(output, values, rowIdx, colIdx, right, M);
-            }
-        } else {
-            if (lOpts == SPARSE_OPERATION_NON_TRANSPOSE) {
-                mm<T, false>(output, values, rowIdx, colIdx, right, M, N, ldb,
-                             ldc);
-            } else if (lOpts == SPARSE_OPERATION_TRANSPOSE) {
-                mtm<T, false>(output, values, rowIdx, colIdx, right, M, N, ldb,
-                              ldc);
-            } else if (lOpts == SPARSE_OPERATION_CONJUGATE_TRANSPOSE) {
-                mtm<T, true>(output, values, rowIdx, colIdx, right, M, N, ldb,
-                             ldc);
-            }
+    const common::SparseArray<T> left =
+        (optLhs == AF_MAT_NONE
+             ? lhs
+             : sparseTranspose(lhs, optLhs == AF_MAT_CTRANS));
+    left.eval();
+    rhs.eval();
+
+    const int M = left.dims()[0];
+    const int N = rhs.dims()[1];
+
+    // Count the entries of every row of the output to size it
+    Array<int> rowIdx = createEmptyArray<int>(dim4(M + 1));
+    getQueue().enqueue(kernel::spgemmSymbolic, rowIdx, left.getRowIdx(),
+                       left.getColIdx(), rhs.getRowIdx(), rhs.getColIdx(), N);
+    getQueue().sync();
+
+    int *rowPtr = rowIdx.get();
+    dim_t nNZ   = 0;
+    for (int i = 0; i < M; i++) {
+        nNZ += rowPtr[i + 1];
+        if (nNZ > std::numeric_limits<int>::max()) {
+            AF_ERROR("Sparse matmul output has too many non zero elements",
+                     AF_ERR_NOT_SUPPORTED);
         }
-    };
-
-    const Array<T> values   = lhs.getValues();
-    const Array<int> rowIdx = lhs.getRowIdx();
-    const Array<int> colIdx = lhs.getColIdx();
+        rowPtr[i + 1] = static_cast<int>(nNZ);
+    }
 
-    getQueue().enqueue(func, out, values, rowIdx, colIdx, rhs);
+    Array<T> values   = createEmptyArray<T>(dim4(nNZ));
+    Array<int> colIdx = createEmptyArray<int>(dim4(nNZ));
+    getQueue().enqueue(kernel::spgemmNumeric<T>, values, colIdx, rowIdx,
+                       left.getValues(), left.getRowIdx(), left.getColIdx(),
+                       rhs.getValues(), rhs.getRowIdx(), rhs.getColIdx(), N);
 
-    return out;
+    return common::createArrayDataSparseArray<T>(dim4(M, N), values, rowIdx,
+                                                 colIdx, AF_STORAGE_CSR);
 }
 
-#endif  // #if USE_MKL
-
 #define INSTANTIATE_SPARSE(T)                                            \
     template Array<T> matmul<T>(const common::SparseArray<T> &lhs,       \
                                 const Array<T> &rhs, af_mat_prop optLhs, \
-                                af_mat_prop optRhs);
+                                af_mat_prop optRhs);                     \
+    template common::SparseArray<T> matmul<T>(                           \
+        const common::SparseArray<T> &lhs,                               \
+        const common::SparseArray<T> &rhs, af_mat_prop optLhs,           \
+        af_mat_prop optRhs);
 
 INSTANTIATE_SPARSE(float)
 INSTANTIATE_SPARSE(double)
@@ -17,4 +17,11 @@ template<typename T>
 Array<T> matmul(const common::SparseArray<T>& lhs, const Array<T>& rhs,
                 af_mat_prop optLhs, af_mat_prop optRhs);
 
+/// Multiplies two CSR matrices into a CSR matrix. \p optLhs may transpose
+/// \p lhs, \p optRhs must be AF_MAT_NONE.
+template<typename T>
+common::SparseArray<T> matmul(const common::SparseArray<T>& lhs,
+                              const common::SparseArray<T>& rhs,
+                              af_mat_prop optLhs, af_mat_prop optRhs);
+
 }
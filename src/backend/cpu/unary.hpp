@@ -12,6 +12,7 @@
 #include <err_cpu.hpp>
 #include <jit/UnaryNode.hpp>
 #include <optypes.hpp>
+#include <simd.hpp>
 #include <cmath>
 
 namespace cpu {
@@ -83,6 +84,35 @@ UNARY_OP_FN(bitnot, ~)
 #undef UNARY_OP
 #undef UNARY_OP_FN
 
+// half is computed in float so it shares the float kernels
+#define UNARY_SIMD_OP(T, op)                                     \
+    template<>                                                   \
+    struct UnOp<T, T, af_##op##_t> {                             \
+        void eval(jit::array<compute_t<T>> &out,                 \
+                  const jit::array<compute_t<T>> &in, int lim) { \
+            simd::op(out.data(), in.data(), lim);                \
+        }                                                        \
+    };
+
+#define UNARY_SIMD_OP_FLOAT(op) \
+    UNARY_SIMD_OP(float, op)    \
+    UNARY_SIMD_OP(common::half, op)
+
+UNARY_SIMD_OP_FLOAT(sin)
+UNARY_SIMD_OP_FLOAT(cos)
+UNARY_SIMD_OP_FLOAT(tanh)
+UNARY_SIMD_OP_FLOAT(exp)
+UNARY_SIMD_OP_FLOAT(sigmoid)
+UNARY_SIMD_OP_FLOAT(log)
+UNARY_SIMD_OP_FLOAT(sqrt)
+UNARY_SIMD_OP_FLOAT(rsqrt)
+
+UNARY_SIMD_OP(double, sqrt)
+UNARY_SIMD_OP(double, rsqrt)
+
+#undef UNARY_SIMD_OP_FLOAT
+#undef UNARY_SIMD_OP
+
 template<typename T, af_op_t op>
 Array<T> unaryOp(const Array<T> &in, dim4 outDim = dim4(-1, -1, -1, -1)) {
     using UnaryNode = jit::UnaryNode<T, T, op>;
@@ -11,6 +11,7 @@
 #include <af/constants.h>
 #include <algorithm>
 #include <cmath>
+#include <vector>
 #include "backend.hpp"
 
 namespace cpu {
@@ -26,6 +27,21 @@ static inline dim_t trimIndex(int const& idx, dim_t const& len) {
     return ret_val;
 }
 
+/// Returns the offsets of the \p count elements selected along a dimension
+/// of length \p len. The elements are the indices in \p idx, or the
+/// positions from \p begin when \p idx is null. The indices are trimmed with
+/// trimIndex and multiplied by \p stride.
+static inline std::vector<dim_t> indexOffsets(const uint* idx, dim_t begin,
+                                              dim_t count, dim_t len,
+                                              dim_t stride) {
+    std::vector<dim_t> offsets(count);
+    for (dim_t i = 0; i < count; ++i) {
+        const int pos = static_cast<int>(idx ? idx[i] : i + begin);
+        offsets[i]    = trimIndex(pos, len) * stride;
+    }
+    return offsets;
+}
+
 static inline unsigned getIdx(af::dim4 const& strides, int i, int j = 0,
                               int k = 0, int l = 0) {
     return (l * strides[3] + k * strides[2] + j * strides[1] + i * strides[0]);
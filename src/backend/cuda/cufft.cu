@@ -62,40 +62,26 @@ const char *_cufftGetResultString(cufftResult res) {
 SharedPlan findPlan(int rank, int *n, int *inembed, int istride, int idist,
                     int *onembed, int ostride, int odist, cufftType type,
                     int batch) {
-    // create the key string
-    char key_str_temp[64];
-    sprintf(key_str_temp, "%d:", rank);
-
-    std::string key_string(key_str_temp);
-
-    for (int r = 0; r < rank; ++r) {
-        sprintf(key_str_temp, "%d:", n[r]);
-        key_string.append(std::string(key_str_temp));
-    }
+    common::FFTPlanKey key;
+    key.rank  = rank;
+    key.type  = static_cast<int>(type);
+    key.batch = batch;
+    for (int r = 0; r < rank; ++r) { key.n[r] = n[r]; }
 
     if (inembed != NULL) {
-        for (int r = 0; r < rank; ++r) {
-            sprintf(key_str_temp, "%d:", inembed[r]);
-            key_string.append(std::string(key_str_temp));
-        }
-        sprintf(key_str_temp, "%d:%d:", istride, idist);
-        key_string.append(std::string(key_str_temp));
+        for (int r = 0; r < rank; ++r) { key.inembed[r] = inembed[r]; }
+        key.istride = istride;
+        key.idist   = idist;
     }
 
     if (onembed != NULL) {
-        for (int r = 0; r < rank; ++r) {
-            sprintf(key_str_temp, "%d:", onembed[r]);
-            key_string.append(std::string(key_str_temp));
-        }
-        sprintf(key_str_temp, "%d:%d:", ostride, odist);
-        key_string.append(std::string(key_str_temp));
+        for (int r = 0; r < rank; ++r) { key.onembed[r] = onembed[r]; }
+        key.ostride = ostride;
+        key.odist   = odist;
     }
 
-    sprintf(key_str_temp, "%d:%d", (int)type, batch);
-    key_string.append(std::string(key_str_temp));
-
     PlanCache &planner = cuda::fftManager();
-    SharedPlan retVal  = planner.find(key_string);
+    SharedPlan retVal  = planner.find(key);
 
     if (retVal) return retVal;
 
@@ -115,7 +101,7 @@ SharedPlan findPlan(int rank, int *n, int *inembed, int istride, int idist,
         free(p);
     });
     // push the plan into plan cache
-    planner.push(key_string, retVal);
+    planner.push(key, retVal);
 
     return retVal;
 }
@@ -371,7 +371,8 @@ void DeviceManager::resetMemoryManager() {
     // Replace with default memory manager
     std::unique_ptr<MemoryManagerBase> mgr(
         new common::DefaultMemoryManager(getDeviceCount(), common::MAX_BUFFERS,
-                                         AF_MEM_DEBUG || AF_CUDA_MEM_DEBUG));
+                                         AF_MEM_DEBUG || AF_CUDA_MEM_DEBUG,
+                                         true));
     setMemoryManager(std::move(mgr));
 }
 
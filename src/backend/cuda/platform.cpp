@@ -416,7 +416,7 @@ MemoryManagerBase &memoryManager() {
         // By default, create an instance of the default memory manager
         inst.memManager = std::make_unique<common::DefaultMemoryManager>(
             getDeviceCount(), common::MAX_BUFFERS,
-            AF_MEM_DEBUG || AF_CUDA_MEM_DEBUG);
+            AF_MEM_DEBUG || AF_CUDA_MEM_DEBUG, true);
         // Set the memory manager's device memory manager
         std::unique_ptr<cuda::Allocator> deviceMemoryManager(
             new cuda::Allocator());
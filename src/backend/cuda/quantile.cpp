@@ -0,0 +1,43 @@
+/*******************************************************
+ * Copyright (c) 2026, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <quantile.hpp>
+
+#include <Array.hpp>
+#include <common/quantile.hpp>
+
+#include <vector>
+
+using std::vector;
+
+namespace cuda {
+
+template<typename T, typename To>
+Array<To> quantile(const Array<T> &in, const vector<double> &probs,
+                   const int dim) {
+    return common::quantileBySort<T, To>(in, probs, dim);
+}
+
+#define INSTANTIATE(T)                                                   \
+    template Array<float> quantile<T, float>(                            \
+        const Array<T> &in, const vector<double> &probs, const int dim); \
+    template Array<double> quantile<T, double>(                          \
+        const Array<T> &in, const vector<double> &probs, const int dim);
+
+INSTANTIATE(double)
+INSTANTIATE(float)
+INSTANTIATE(int)
+INSTANTIATE(uint)
+INSTANTIATE(short)
+INSTANTIATE(ushort)
+INSTANTIATE(uchar)
+
+#undef INSTANTIATE
+
+}  // namespace cuda
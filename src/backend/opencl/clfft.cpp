@@ -13,10 +13,8 @@
 #include <af/defines.h>
 
 #include <memory>
-#include <string>
 
 using std::make_unique;
-using std::string;
 
 namespace opencl {
 const char *_clfftGetResultString(clfftStatus st) {
@@ -95,42 +93,31 @@ SharedPlan findPlan(clfftLayout iLayout, clfftLayout oLayout, clfftDim rank,
                     size_t *clLengths, size_t *istrides, size_t idist,
                     size_t *ostrides, size_t odist, clfftPrecision precision,
                     size_t batch) {
-    // create the key string
-    char key_str_temp[64];
-    sprintf(key_str_temp, "%d:%d:%d:", iLayout, oLayout, rank);
-
-    string key_string(key_str_temp);
-
-    /* WARNING: DO NOT CHANGE sprintf format specifier */
+    common::FFTPlanKey key;
+    key.rank  = static_cast<int>(rank);
+    key.type  = static_cast<int>(precision);
+    key.flags = (static_cast<int>(iLayout) << 8) | static_cast<int>(oLayout);
+    key.batch = static_cast<long long>(batch);
     for (int r = 0; r < rank; ++r) {
-        sprintf(key_str_temp, SIZE_T_FRMT_SPECIFIER ":", clLengths[r]);
-        key_string.append(std::string(key_str_temp));
+        key.n[r] = static_cast<long long>(clLengths[r]);
     }
 
     if (istrides != NULL) {
         for (int r = 0; r < rank; ++r) {
-            sprintf(key_str_temp, SIZE_T_FRMT_SPECIFIER ":", istrides[r]);
-            key_string.append(std::string(key_str_temp));
+            key.inembed[r] = static_cast<long long>(istrides[r]);
         }
-        sprintf(key_str_temp, SIZE_T_FRMT_SPECIFIER ":", idist);
-        key_string.append(std::string(key_str_temp));
+        key.idist = static_cast<long long>(idist);
     }
 
     if (ostrides != NULL) {
         for (int r = 0; r < rank; ++r) {
-            sprintf(key_str_temp, SIZE_T_FRMT_SPECIFIER ":", ostrides[r]);
-            key_string.append(std::string(key_str_temp));
+            key.onembed[r] = static_cast<long long>(ostrides[r]);
         }
-        sprintf(key_str_temp, SIZE_T_FRMT_SPECIFIER ":", odist);
-        key_string.append(std::string(key_str_temp));
+        key.odist = static_cast<long long>(odist);
     }
 
-    sprintf(key_str_temp, "%d:" SIZE_T_FRMT_SPECIFIER,
-            static_cast<int>(precision), batch);
-    key_string.append(std::string(key_str_temp));
-
     PlanCache &planner = opencl::fftManager();
-    SharedPlan retVal  = planner.find(key_string);
+    SharedPlan retVal  = planner.find(key);
 
     if (retVal) { return retVal; }
 
@@ -173,7 +160,7 @@ SharedPlan findPlan(clfftLayout iLayout, clfftLayout oLayout, clfftDim rank,
 #endif
     });
     // push the plan into plan cache
-    planner.push(key_string, retVal);
+    planner.push(key, retVal);
 
     return retVal;
 }
@@ -0,0 +1,21 @@
+/*******************************************************
+ * Copyright (c) 2026, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#pragma once
+#include <Array.hpp>
+
+#include <vector>
+
+namespace opencl {
+/// Returns the quantiles \p probs of \p in along \p dim. The quantiles are
+/// stored along \p dim in the order of \p probs.
+template<typename T, typename To>
+Array<To> quantile(const Array<T> &in, const std::vector<double> &probs,
+                   const int dim);
+}  // namespace opencl
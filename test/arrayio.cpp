@@ -125,3 +125,41 @@ TEST(ArrayIO, Save) {
     ASSERT_ARRAYS_EQ(a, aread);
     ASSERT_ARRAYS_EQ(b, bread);
 }
+
+TEST(ArrayIO, AppendMany) {
+    const int narrays = 40;
+    for (int i = 0; i < narrays; i++) {
+        const string key = "arr" + std::to_string(i);
+        ASSERT_EQ(i, saveArray(key.c_str(), constant(i, 3, i + 1),
+                               "arr_many.af", i > 0));
+    }
+
+    ASSERT_EQ(27, af::readArrayCheck("arr_many.af", "arr27"));
+    ASSERT_EQ(-1, af::readArrayCheck("arr_many.af", "arr40"));
+    ASSERT_ARRAYS_EQ(constant(27, 3, 28), readArray("arr_many.af", "arr27"));
+    ASSERT_ARRAYS_EQ(constant(12, 3, 13), readArray("arr_many.af", 12u));
+}
+
+TEST(ArrayIO, ReadRange) {
+    array a = af::randu(20, 30, 3);
+    array b = af::randu(5, 7, 2, 4, s32);
+
+    saveArray("a", a, "arr_range.af");
+    saveArray("b", b, "arr_range.af", true);
+
+    using af::seq;
+    using af::span;
+    ASSERT_ARRAYS_EQ(a(seq(3, 7), span, span),
+                     readArray("arr_range.af", 0, 0, 3, 7));
+    ASSERT_ARRAYS_EQ(a(span, seq(5, 9), span),
+                     readArray("arr_range.af", 0, 1, 5, 9));
+    ASSERT_ARRAYS_EQ(a(span, span, 2), readArray("arr_range.af", 0, 2, 2, 2));
+    ASSERT_ARRAYS_EQ(b(span, span, span, seq(1, 3)),
+                     readArray("arr_range.af", 1, 3, 1, 3));
+    ASSERT_ARRAYS_EQ(b(span, seq(0, 6), span, span),
+                     readArray("arr_range.af", 1, 1, 0, 6));
+
+    ASSERT_THROW(readArray("arr_range.af", 0, 1, 5, 30), af::exception);
+    ASSERT_THROW(readArray("arr_range.af", 0, 1, 6, 5), af::exception);
+    ASSERT_THROW(readArray("arr_range.af", 2, 1, 0, 0), af::exception);
+}
@@ -1037,3 +1037,24 @@ TEST(Index, ISSUE_2533) {
 
     ASSERT_VEC_ARRAY_EQ(gold, dim4(5, 10), a);
 }
+
+TEST(Assign, SeqRowsArrayColumns) {
+    array a = randu(64, 16);
+    array b = randu(32, 3);
+    vector<float> ha(a.elements()), hb(b.elements());
+    a.host(&ha[0]);
+    b.host(&hb[0]);
+
+    unsigned hidx[] = {15, 2, 9};
+    array idx(3, hidx);
+    a(seq(8, 39), idx) = b;
+
+    for (int j = 0; j < 3; ++j) {
+        for (int i = 0; i < 32; ++i) {
+            ha[hidx[j] * 64 + 8 + i] = hb[j * 32 + i];
+        }
+    }
+    vector<float> out(a.elements());
+    a.host(&out[0]);
+    ASSERT_EQ(ha, out);
+}
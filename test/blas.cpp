@@ -415,11 +415,45 @@ INSTANTIATE_TEST_CASE_P(
         ),
     print_blas_params);
 
+INSTANTIATE_TEST_CASE_P(
+    SmallBatch, MatrixMultiplyBatch,
+    ::testing::Values(
+        // clang-format off
+            //          M    N    K  ld2  ld3  rd2  rd3  type
+            blas_params( 3,   3,   3, 100,   3, 100,   3,  f32),
+            blas_params( 3,   1,   3, 100,   3, 100,   3,  f32),
+            blas_params( 4,   4,   4,  50,   7,  50,   7,  f32),
+            blas_params( 4,   1,   4,  50,   7,   1,   1,  f32),
+            blas_params( 5,   7,   2,  10,   1,  10,   1,  c32),
+            blas_params( 8,   3,   6,   1,   1,  20,   2,  f32),
+            blas_params(16,  16,  16,  20,   2,  20,   2,  f32),
+            blas_params(16,   9,  13,   1,   4,   9,   4,  c32)
+        // clang-format on
+        ),
+    print_blas_params);
+
 TEST_P(MatrixMultiplyBatch, Batched) {
     array out = matmul(lhs, rhs);
     ASSERT_ARRAYS_NEAR(gold, out, 1e-3);
 }
 
+TEST(MatrixMultiply, SmallBatchedTranspose) {
+    const af_mat_prop opts[] = {AF_MAT_NONE, AF_MAT_TRANS, AF_MAT_CTRANS};
+    array a                  = randu(4, 4, 30, c32);
+    array b                  = randu(4, 4, 30, c32);
+
+    for (int l = 0; l < 3; l++) {
+        for (int r = 0; r < 3; r++) {
+            array c = matmul(a, b, opts[l], opts[r]);
+            for (int i = 0; i < 30; i++) {
+                array res = matmul(a(span, span, i), b(span, span, i),
+                                   opts[l], opts[r]);
+                ASSERT_ARRAYS_NEAR(res, c(span, span, i), 1e-5);
+            }
+        }
+    }
+}
+
 float alpha = 1.f;
 float beta  = 0.f;
 
@@ -74,6 +74,36 @@ void choleskyTester(const int n, double eps, bool is_upper) {
                 eps);
 }
 
+template<typename T>
+void choleskyBatchTester(const int n, const int batch, double eps,
+                         bool is_upper) {
+    SUPPORTED_TYPE_CHECK(T);
+    if (noLAPACKTests()) return;
+    // Only the CPU backend factorizes batches
+    if (af::getActiveBackend() != AF_BACKEND_CPU) return;
+
+    dtype ty = (dtype)dtype_traits<T>::af_type;
+    dim4 dims(n, n, batch);
+
+    array a  = cpu_randu<T>(dims);
+    array in = matmul(a, a, AF_MAT_CTRANS, AF_MAT_NONE) +
+               10 * n * identity(dims, ty);
+
+    array out;
+    ASSERT_EQ(0, cholesky(out, in, is_upper));
+
+    array re = is_upper ? matmul(out, out, AF_MAT_CTRANS, AF_MAT_NONE)
+                        : matmul(out, out, AF_MAT_NONE, AF_MAT_CTRANS);
+
+    ASSERT_EQ(dims, out.dims());
+    ASSERT_NEAR(0, max<typename dtype_traits<T>::base_type>(abs(in - re)),
+                eps);
+
+    // The first matrix that is not positive definite is reported
+    in(0, 0, batch / 2) = -1;
+    ASSERT_EQ(1, cholesky(out, in, is_upper));
+}
+
 template<typename T>
 class Cholesky : public ::testing::Test {};
 
@@ -134,3 +164,15 @@ TYPED_TEST(Cholesky, LowerMultipleOfTwo) {
 TYPED_TEST(Cholesky, LowerMultipleOfTwoLarge) {
     choleskyTester<TypeParam>(1024, eps<TypeParam>(), false);
 }
+
+TYPED_TEST(Cholesky, UpperBatch) {
+    choleskyBatchTester<TypeParam>(8, 300, eps<TypeParam>(), true);
+}
+
+TYPED_TEST(Cholesky, LowerBatch) {
+    choleskyBatchTester<TypeParam>(8, 300, eps<TypeParam>(), false);
+}
+
+TYPED_TEST(Cholesky, LowerBatchLarge) {
+    choleskyBatchTester<TypeParam>(48, 6, eps<TypeParam>(), false);
+}
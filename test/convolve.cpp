@@ -519,6 +519,31 @@ TEST(Convolve, separable_CPP) {
     }
 }
 
+TEST(Convolve, SeparableFilter2D_CPP) {
+    // Whole numbers keep both paths exact
+    array signal = af::floor(randu(37, 29, 3) * 10);
+    array col    = af::floor(randu(5) * 5) + 1;
+    array row    = af::floor(randu(5) * 5) + 1;
+    array filter = af::matmulNT(col, row);
+
+    for (af_conv_mode mode : {AF_CONV_DEFAULT, AF_CONV_EXPAND}) {
+        array gold = convolve(col, row, signal, mode);
+        array out  = convolve2(signal, filter, mode, AF_CONV_SPATIAL);
+        ASSERT_ARRAYS_EQ(gold, out);
+    }
+}
+
+TEST(Convolve, SpatialMatchesFrequency2D_CPP) {
+    array signal = randu(61, 47, 2);
+    array filter = randu(7, 7);
+
+    for (af_conv_mode mode : {AF_CONV_DEFAULT, AF_CONV_EXPAND}) {
+        array gold = convolve2(signal, filter, mode, AF_CONV_FREQ);
+        array out  = convolve2(signal, filter, mode, AF_CONV_SPATIAL);
+        ASSERT_ARRAYS_NEAR(gold, out, 1e-4);
+    }
+}
+
 TEST(Convolve, Docs_Unified_Wrapper) {
     // This unit test doesn't necessarily need to function
     // accuracy as convolve is merely a wrapper to
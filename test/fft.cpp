@@ -39,6 +39,7 @@ using af::ifftInPlace;
 using af::moddims;
 using af::randu;
 using af::seq;
+using af::setFFTPlanCacheSize;
 using af::span;
 using std::abs;
 using std::endl;
@@ -913,3 +914,38 @@ TEST_P(FFTC2R3D, InPlaceIFFT3MatchesOutOfPlace) {
 
     ASSERT_ARRAYS_EQ(a, b);
 }
+
+TEST(FFT, PlanCacheReuse) {
+    const dim4 shapes[] = {dim4(64), dim4(100, 3), dim4(16, 16), dim4(64),
+                           dim4(100, 3), dim4(30, 20, 2)};
+    vector<array> inputs, gold;
+    for (const dim4 &shape : shapes) {
+        inputs.push_back(randu(shape, c32));
+        gold.push_back(fft(inputs.back()));
+    }
+
+    // Plans evicted from the cache and plans reused from it give the same
+    // results as the first transforms
+    for (size_t cacheSize : {size_t(0), size_t(1), size_t(3), size_t(5)}) {
+        setFFTPlanCacheSize(cacheSize);
+        for (int pass = 0; pass < 2; ++pass) {
+            for (size_t i = 0; i < inputs.size(); ++i) {
+                ASSERT_ARRAYS_EQ(gold[i], fft(inputs[i]));
+            }
+        }
+    }
+    setFFTPlanCacheSize(5);
+}
+
+TEST(FFT, PlanCacheUnalignedInput) {
+    array a = randu(1025, 4, c32);
+
+    // Sub-arrays start at a different alignment than the arrays the cached
+    // plans were created with
+    for (int offset = 0; offset < 4; ++offset) {
+        array in = a(seq(offset, 1023 + offset), span);
+        array b  = in.copy();
+        ASSERT_ARRAYS_NEAR(fft(b), fft(in), 1e-3);
+        ASSERT_ARRAYS_NEAR(ifft(fft(in)), in, 1e-4);
+    }
+}
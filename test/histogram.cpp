@@ -282,3 +282,27 @@ TEST(histogram, LargeBins) {
 
     for (int i = 0; i < nbins; i++) { ASSERT_EQ(hH[i], 0u); }
 }
+
+TEST(histogram, BatchedUchar) {
+    const int nbins = 64;
+    array A         = (255 * randu(300, 200, 3)).as(u8);
+    array H         = histogram(A, nbins, 0, 255);
+    ASSERT_EQ(dim4(nbins, 1, 3), H.dims());
+
+    vector<unsigned char> hA(A.elements());
+    A.host(hA.data());
+
+    vector<unsigned> hH(H.elements());
+    H.host(hH.data());
+
+    const float step = 255.f / nbins;
+    for (int k = 0; k < 3; k++) {
+        for (int i = 0; i < 300 * 200; i++) {
+            int bin = (int)(hA[k * 300 * 200 + i] / step);
+            bin     = std::min(bin, nbins - 1);
+            hH[k * nbins + bin] -= 1;
+        }
+    }
+
+    for (size_t i = 0; i < hH.size(); i++) { ASSERT_EQ(hH[i], 0u); }
+}
@@ -2033,3 +2033,70 @@ TEST_F(IndexDocs, AssignmentRaceCondition) {
 }
 
 // clang-format on
+
+TEST(Index, SeqRowsArrayColumns) {
+    array a = randu(100, 20, 3);
+    vector<float> ha(a.elements());
+    a.host(&ha[0]);
+
+    unsigned hidx[] = {3, 0, 19, 3};
+    array idx(4, hidx);
+    array b = a(seq(10, 59), idx, span);
+    ASSERT_EQ(dim4(50, 4, 3), b.dims());
+
+    vector<float> hb(b.elements());
+    b.host(&hb[0]);
+    for (int k = 0; k < 3; ++k) {
+        for (int j = 0; j < 4; ++j) {
+            for (int i = 0; i < 50; ++i) {
+                ASSERT_EQ(ha[(k * 20 + hidx[j]) * 100 + 10 + i],
+                          hb[(k * 4 + j) * 50 + i])
+                    << "at (" << i << ", " << j << ", " << k << ")";
+            }
+        }
+    }
+}
+
+TEST(Index, ArrayRowsSeqColumns) {
+    array a = randu(30, 40);
+    vector<float> ha(a.elements());
+    a.host(&ha[0]);
+
+    unsigned hidx[] = {29, 1, 7, 7, 0};
+    array idx(5, hidx);
+    array b = a(idx, seq(5, 34));
+    ASSERT_EQ(dim4(5, 30), b.dims());
+
+    vector<float> hb(b.elements());
+    b.host(&hb[0]);
+    for (int j = 0; j < 30; ++j) {
+        for (int i = 0; i < 5; ++i) {
+            ASSERT_EQ(ha[(j + 5) * 30 + hidx[i]], hb[j * 5 + i])
+                << "at (" << i << ", " << j << ")";
+        }
+    }
+}
+
+TEST(Index, ArrayRowsInArithmetic) {
+    array a = randu(40, 6);
+    array b = randu(5, 6);
+    vector<float> ha(a.elements());
+    vector<float> hb(b.elements());
+    a.host(&ha[0]);
+    b.host(&hb[0]);
+
+    unsigned hidx[] = {39, 0, 12, 12, 3};
+    array idx(5, hidx);
+    array c = a(idx, span) * 2 + b;
+    ASSERT_EQ(dim4(5, 6), c.dims());
+
+    vector<float> hc(c.elements());
+    c.host(&hc[0]);
+    for (int j = 0; j < 6; ++j) {
+        for (int i = 0; i < 5; ++i) {
+            ASSERT_FLOAT_EQ(ha[j * 40 + hidx[i]] * 2 + hb[j * 5 + i],
+                            hc[j * 5 + i])
+                << "at (" << i << ", " << j << ")";
+        }
+    }
+}
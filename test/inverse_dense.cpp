@@ -54,6 +54,25 @@ void inverseTester(const int m, const int n, double eps) {
                 eps);
 }
 
+template<typename T>
+void inverseBatchTester(const int n, const int batch, double eps) {
+    SUPPORTED_TYPE_CHECK(T);
+    if (noLAPACKTests()) return;
+    // Only the CPU backend inverts batches
+    if (af::getActiveBackend() != AF_BACKEND_CPU) return;
+
+    dim4 dims(n, n, batch);
+    array I2 = identity(dims, (dtype)dtype_traits<T>::af_type);
+    // Diagonally dominant so that every matrix of the batch is invertible
+    array A  = cpu_randu<T>(dims) + n * I2;
+
+    array IA = inverse(A);
+    array I  = matmul(A, IA);
+
+    ASSERT_EQ(dims, IA.dims());
+    ASSERT_NEAR(0, max<typename dtype_traits<T>::base_type>(abs(I - I2)), eps);
+}
+
 template<typename T>
 class Inverse : public ::testing::Test {};
 
@@ -90,3 +109,11 @@ TYPED_TEST(Inverse, Square) {
 TYPED_TEST(Inverse, SquareMultiplePowerOfTwo) {
     inverseTester<TypeParam>(2048, 2048, eps<TypeParam>());
 }
+
+TYPED_TEST(Inverse, SquareBatch) {
+    inverseBatchTester<TypeParam>(4, 1000, eps<TypeParam>());
+}
+
+TYPED_TEST(Inverse, SquareBatchLarge) {
+    inverseBatchTester<TypeParam>(33, 12, eps<TypeParam>());
+}
@@ -12,6 +12,7 @@
 #include <af/algorithm.h>
 #include <af/arith.h>
 #include <af/array.h>
+#include <af/backend.h>
 #include <af/data.h>
 #include <af/device.h>
 #include <af/gfor.h>
@@ -380,6 +381,212 @@ TEST(JIT, LinearLarge) {
     for (size_t i = 0; i < hc.size(); i++) { ASSERT_EQ(hc[i], v3); }
 }
 
+TEST(JIT, MultiOutputLargeStrided) {
+    // dim0 is not a multiple of the CPU JIT vector length and the input is a
+    // strided view so every output row is evaluated in several pieces
+    const int d0 = 1001;
+    const int d1 = 700;
+    array in     = randu(1200, d1);
+    array a      = in(seq(d0), af::span);
+    array b      = randu(d0, d1);
+
+    array common = a * b;
+    array c      = common + 2;
+    array d      = common - a;
+    eval(c, d);
+
+    vector<float> ha(a.elements());
+    vector<float> hb(b.elements());
+    vector<float> hc(c.elements());
+    vector<float> hd(d.elements());
+    a.host(ha.data());
+    b.host(hb.data());
+    c.host(hc.data());
+    d.host(hd.data());
+
+    for (size_t i = 0; i < ha.size(); i++) {
+        float prod = ha[i] * hb[i];
+        ASSERT_FLOAT_EQ(hc[i], prod + 2) << " at " << i;
+        ASSERT_FLOAT_EQ(hd[i], prod - ha[i]) << " at " << i;
+    }
+}
+
+TEST(JIT, CpuNumThreads) {
+    af_backend active_backend;
+    ASSERT_SUCCESS(af_get_active_backend(&active_backend));
+    if (active_backend != AF_BACKEND_CPU) { return; }
+
+    // Every thread evaluates its own copy of the tree. The results must not
+    // depend on how the work is split.
+    array a   = randu(1003, 517);
+    array b   = randu(1003, 517);
+    array big = randu(1200, 517);
+    array s   = big(seq(1003), af::span);
+
+    af::setCpuNumThreads(1);
+    array lin   = af::sin(a) * b + 2;
+    array strd  = af::exp(s - b) / (a + 1);
+    array multi = a * b - s;
+    array other = multi + af::sqrt(a);
+    eval(lin, strd);
+    eval(multi, other);
+
+    for (int nthreads : {2, 5}) {
+        af::setCpuNumThreads(nthreads);
+        array lin2   = af::sin(a) * b + 2;
+        array strd2  = af::exp(s - b) / (a + 1);
+        array multi2 = a * b - s;
+        array other2 = multi2 + af::sqrt(a);
+        eval(lin2, strd2);
+        eval(multi2, other2);
+
+        ASSERT_ARRAYS_EQ(lin, lin2);
+        ASSERT_ARRAYS_EQ(strd, strd2);
+        ASSERT_ARRAYS_EQ(multi, multi2);
+        ASSERT_ARRAYS_EQ(other, other2);
+    }
+    af::setCpuNumThreads(0);
+}
+
+#if !defined(_WIN32)
+// The compiled engine of the CPU JIT is enabled by AF_CPU_JIT_COMPILE, which
+// is read every time a tree is evaluated. Trees which can't be compiled, for
+// example because no compiler is installed, fall back to the interpreter.
+class CompiledJIT : public ::testing::Test {
+   protected:
+    void SetUp() {
+        af_backend active_backend;
+        ASSERT_SUCCESS(af_get_active_backend(&active_backend));
+        cpu = active_backend == AF_BACKEND_CPU;
+    }
+
+    void TearDown() { setCompiled(false); }
+
+    void setCompiled(bool enabled) {
+        if (enabled) {
+            setenv("AF_CPU_JIT_COMPILE", "1", 1);
+        } else {
+            unsetenv("AF_CPU_JIT_COMPILE");
+        }
+    }
+
+    bool cpu;
+};
+
+TEST_F(CompiledJIT, Linear) {
+    if (!cpu) { return; }
+    array a = randu(1000, 300);
+    array b = randu(1000, 300);
+
+    array gold     = a * b + 3 - a / (b + 1);
+    array goldMath = af::sqrt(a) + af::exp(b) * af::sin(a);
+    eval(gold, goldMath);
+
+    setCompiled(true);
+    array out     = a * b + 3 - a / (b + 1);
+    array outMath = af::sqrt(a) + af::exp(b) * af::sin(a);
+    eval(out, outMath);
+
+    ASSERT_ARRAYS_EQ(gold, out);
+    ASSERT_ARRAYS_NEAR(goldMath, outMath, 1e-5);
+}
+
+// Covers the polynomial ranges, the overflow of exp and the large arguments
+// of cos
+static array transcendental(const array &x) {
+    return af::exp(x) + af::log(af::abs(x) + 1e-3) * af::sin(x) -
+           af::cos(x * 100) + af::tanh(x) * af::sigmoid(x) +
+           af::rsqrt(af::abs(x) + 1);
+}
+
+TEST_F(CompiledJIT, Transcendental) {
+    if (!cpu) { return; }
+    array a = (randu(1000, 100) - 0.5) * 200;
+    array d = (randu(1000, 100, f64) - 0.5) * 200;
+
+    array gold  = transcendental(a);
+    array goldD = transcendental(d);
+    eval(gold, goldD);
+
+    setCompiled(true);
+    array out  = transcendental(a);
+    array outD = transcendental(d);
+    eval(out, outD);
+
+    // Both engines use the same float approximations
+    ASSERT_ARRAYS_EQ(gold, out);
+    ASSERT_ARRAYS_EQ(goldD, outD);
+}
+
+TEST_F(CompiledJIT, LinearIntegers) {
+    if (!cpu) { return; }
+    array a = (randu(517, 33) * 1000).as(s32);
+    array b = (randu(517, 33) * 1000).as(s32) + 1;
+
+    array gold = (a * 3 - b) % 7 + (a > b);
+    gold.eval();
+
+    setCompiled(true);
+    array out = (a * 3 - b) % 7 + (a > b);
+    out.eval();
+
+    ASSERT_ARRAYS_EQ(gold, out);
+}
+
+TEST_F(CompiledJIT, NonLinear) {
+    if (!cpu) { return; }
+    array big = randu(1200, 517);
+    array s   = big(seq(1003), af::span);
+    array b   = randu(1003, 517);
+
+    array gold = s * 2 - b / (s + 1);
+    gold.eval();
+
+    setCompiled(true);
+    array out = s * 2 - b / (s + 1);
+    out.eval();
+
+    ASSERT_ARRAYS_EQ(gold, out);
+}
+
+TEST_F(CompiledJIT, BroadcastBuffers) {
+    if (!cpu) { return; }
+    array col = randu(301);
+    array row = randu(1, 77);
+    array m   = randu(301, 77, 3);
+
+    array gold = tile(col, 1, 77, 3) * m + tile(row, 301, 1, 3);
+    gold.eval();
+
+    setCompiled(true);
+    array out = tile(col, 1, 77, 3) * m + tile(row, 301, 1, 3);
+    out.eval();
+
+    ASSERT_ARRAYS_EQ(gold, out);
+}
+
+TEST_F(CompiledJIT, MultipleOutputs) {
+    if (!cpu) { return; }
+    array big = randu(1200, 300);
+    array a   = big(seq(1001), af::span);
+    array b   = randu(1001, 300);
+
+    array common = a * b;
+    array c      = common + 2;
+    array d      = common - a;
+    eval(c, d);
+
+    setCompiled(true);
+    array common2 = a * b;
+    array c2      = common2 + 2;
+    array d2      = common2 - a;
+    eval(c2, d2);
+
+    ASSERT_ARRAYS_EQ(c, c2);
+    ASSERT_ARRAYS_EQ(d, d2);
+}
+#endif
+
 TEST(JIT, NonLinearBuffers1) {
     array a  = randu(5, 5);
     array a0 = a;
@@ -185,6 +185,34 @@ void luTester(const int m, const int n, double eps) {
         eps);
 }
 
+template<typename T>
+void luBatchTester(const int m, const int n, const int batch, double eps) {
+    SUPPORTED_TYPE_CHECK(T);
+    if (noLAPACKTests()) return;
+    // Only the CPU backend factorizes batches
+    if (af::getActiveBackend() != AF_BACKEND_CPU) return;
+    typedef typename dtype_traits<T>::base_type BT;
+
+    array a_orig = cpu_randu<T>(dim4(m, n, batch));
+
+    array l, u, pivot;
+    lu(l, u, pivot, a_orig);
+
+    const int mn = std::min(m, n);
+    ASSERT_EQ(dim4(m, mn, batch), l.dims());
+    ASSERT_EQ(dim4(mn, n, batch), u.dims());
+    ASSERT_EQ(dim4(m, 1, batch), pivot.dims());
+
+    for (int i = 0; i < batch; i++) {
+        array li, ui, pi;
+        lu(li, ui, pi, a_orig(span, span, i));
+
+        ASSERT_EQ(count<uint>(pi == pivot(span, span, i)), pi.elements());
+        ASSERT_NEAR(0, max<BT>(abs(li - l(span, span, i))), eps);
+        ASSERT_NEAR(0, max<BT>(abs(ui - u(span, span, i))), eps);
+    }
+}
+
 template<typename T>
 double eps();
 
@@ -236,6 +264,14 @@ TYPED_TEST(LU, RectangularMultipleOfTwoLarge1) {
     luTester<TypeParam>(512, 1024, eps<TypeParam>());
 }
 
+TYPED_TEST(LU, SquareBatch) {
+    luBatchTester<TypeParam>(6, 6, 64, eps<TypeParam>());
+}
+
+TYPED_TEST(LU, RectangularBatch) {
+    luBatchTester<TypeParam>(40, 24, 4, eps<TypeParam>());
+}
+
 TEST(LU, NullLowerOutput) {
     if (noLAPACKTests()) return;
     dim4 dims(3, 3);
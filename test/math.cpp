@@ -14,7 +14,9 @@
 #include <af/exception.h>
 #include <af/random.h>
 
+#include <cmath>
 #include <complex>
+#include <limits>
 
 // This makes the macros cleaner
 using af::array;
@@ -146,3 +148,39 @@ TEST(MathTests, Not) {
     af_free_host(ha);
     af_free_host(hb);
 }
+
+TEST(MathTests, SpecialValuesFloat) {
+    const float inf = std::numeric_limits<float>::infinity();
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    const float vals[] = {0.f,    -0.f,   inf,   -inf, nan,  1e-30f,
+                          0.625f, -0.7f,  20.f,  -20.f, 88.f, 89.f,
+                          -87.5f, -110.f, 100.f, -100.f};
+    vector<float> h_in(vals, vals + sizeof(vals) / sizeof(vals[0]));
+    array in(h_in.size(), &h_in.front());
+
+#define CHECK_SPECIAL(func)                                                \
+    {                                                                      \
+        vector<float> h_out(h_in.size());                                  \
+        func(in).host(&h_out.front());                                     \
+        for (size_t i = 0; i < h_in.size(); i++) {                         \
+            float gold = std::func(h_in[i]);                               \
+            if (std::isnan(gold)) {                                        \
+                EXPECT_TRUE(std::isnan(h_out[i])) << #func << " " << i;    \
+            } else if (std::isinf(gold) || gold == 0.f) {                  \
+                EXPECT_EQ(gold, h_out[i]) << #func << " " << i;            \
+            } else {                                                       \
+                EXPECT_NEAR(gold, h_out[i], flt_err * std::fabs(gold))     \
+                    << #func << " " << i;                                  \
+            }                                                              \
+        }                                                                  \
+    }
+
+    CHECK_SPECIAL(exp)
+    CHECK_SPECIAL(log)
+    CHECK_SPECIAL(sqrt)
+    CHECK_SPECIAL(sin)
+    CHECK_SPECIAL(cos)
+    CHECK_SPECIAL(tanh)
+
+#undef CHECK_SPECIAL
+}
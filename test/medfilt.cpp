@@ -12,6 +12,7 @@
 #include <testHelpers.hpp>
 #include <af/dim4.hpp>
 #include <af/traits.hpp>
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -464,3 +465,108 @@ TEST(MedianFilter1d, GFOR) {
         ASSERT_EQ(max<double>(abs(c_ii - b_ii)) < 1E-5, true);
     }
 }
+
+/// Filters the columns of \p in with windows of \p w_len rows and \p w_wid
+/// columns by sorting every window
+template<typename T>
+vector<T> medfiltReference(const vector<T>& in, const dim4& dims, int w_len,
+                           int w_wid, af_border_type pad) {
+    const int nrows = static_cast<int>(dims[0]);
+    const int ncols = static_cast<int>(dims[1]);
+    const int nimgs = static_cast<int>(dims[2]);
+
+    // Reads the padded input the same way as the symmetric and zero padding
+    auto at = [&](int r, int c, int img) -> T {
+        if (pad == AF_PAD_ZERO) {
+            if (r < 0 || r >= nrows || c < 0 || c >= ncols) return T(0);
+        } else {
+            r = r < 0 ? -r : (r >= nrows ? 2 * (nrows - 1) - r : r);
+            c = c < 0 ? -c : (c >= ncols ? 2 * (ncols - 1) - c : c);
+        }
+        return in[(img * ncols + c) * nrows + r];
+    };
+
+    vector<T> gold(in.size());
+    vector<T> window;
+    for (int img = 0; img < nimgs; ++img) {
+        for (int c = 0; c < ncols; ++c) {
+            for (int r = 0; r < nrows; ++r) {
+                window.clear();
+                for (int j = 0; j < w_wid; ++j) {
+                    for (int i = 0; i < w_len; ++i) {
+                        window.push_back(
+                            at(r + i - w_len / 2, c + j - w_wid / 2, img));
+                    }
+                }
+                std::sort(window.begin(), window.end());
+                const size_t off = window.size() / 2;
+                gold[(img * ncols + c) * nrows + r] =
+                    window.size() % 2 ? window[off]
+                                      : T((window[off] + window[off - 1]) / 2);
+            }
+        }
+    }
+    return gold;
+}
+
+template<typename T>
+vector<T> medfiltReferenceInput(const dim4& dims) {
+    vector<T> in(dims.elements());
+    for (size_t i = 0; i < in.size(); ++i) {
+        in[i] = static_cast<T>((i * 7919 + (i >> 3) * 104729) % 97);
+    }
+    return in;
+}
+
+template<typename T>
+void medfiltReferenceTest(dim_t w_len, dim_t w_wid, af_border_type pad) {
+    SUPPORTED_TYPE_CHECK(T);
+
+    const dim4 dims(37, 29, 2);
+    const vector<T> in   = medfiltReferenceInput<T>(dims);
+    const vector<T> gold = medfiltReference(in, dims, static_cast<int>(w_len),
+                                            static_cast<int>(w_wid), pad);
+
+    af::array input(dims, in.data());
+    af::array output = medfilt2(input, w_len, w_wid, pad);
+    ASSERT_VEC_ARRAY_EQ(gold, dims, output);
+}
+
+TYPED_TEST(MedianFilter, ZERO_PAD_5x5_Reference) {
+    medfiltReferenceTest<TypeParam>(5, 5, AF_PAD_ZERO);
+}
+
+TYPED_TEST(MedianFilter, SYMMETRIC_PAD_7x7_Reference) {
+    medfiltReferenceTest<TypeParam>(7, 7, AF_PAD_SYM);
+}
+
+TYPED_TEST(MedianFilter, SYMMETRIC_PAD_15x15_Reference) {
+    medfiltReferenceTest<TypeParam>(15, 15, AF_PAD_SYM);
+}
+
+// Every column and batch is filtered separately
+template<typename T>
+void medfilt1ReferenceTest(dim_t w_wid, af_border_type pad) {
+    SUPPORTED_TYPE_CHECK(T);
+
+    const dim4 dims(37, 29, 2);
+    const vector<T> in   = medfiltReferenceInput<T>(dims);
+    const vector<T> gold =
+        medfiltReference(in, dims, static_cast<int>(w_wid), 1, pad);
+
+    af::array input(dims, in.data());
+    af::array output = medfilt1(input, w_wid, pad);
+    ASSERT_VEC_ARRAY_EQ(gold, dims, output);
+}
+
+TYPED_TEST(MedianFilter1d, ZERO_PAD_5_Reference) {
+    medfilt1ReferenceTest<TypeParam>(5, AF_PAD_ZERO);
+}
+
+TYPED_TEST(MedianFilter1d, SYMMETRIC_PAD_9_Reference) {
+    medfilt1ReferenceTest<TypeParam>(9, AF_PAD_SYM);
+}
+
+TYPED_TEST(MedianFilter1d, SYMMETRIC_PAD_31_Reference) {
+    medfilt1ReferenceTest<TypeParam>(31, AF_PAD_SYM);
+}
@@ -17,10 +17,16 @@
 #include <af/random.h>
 #include <af/statistics.h>
 
+#include <type_traits>
+
 using af::array;
 using af::dtype;
 using af::dtype_traits;
+using af::max;
 using af::median;
+using af::min;
+using af::percentile;
+using af::quantile;
 using af::randu;
 using af::seq;
 using af::span;
@@ -169,3 +175,101 @@ TEST(Median, TwoElements) {
     af::array gold = mean(in);
     ASSERT_ARRAYS_EQ(gold, out);
 }
+
+template<typename T>
+void quantile_test(int nx, int ny, const int dim, const vector<double>& probs) {
+    SUPPORTED_TYPE_CHECK(T);
+    // Only double inputs use double probabilities and outputs
+    typedef typename std::conditional<std::is_same<T, double>::value, double,
+                                      float>::type Tp;
+    const vector<Tp> h_probs(probs.begin(), probs.end());
+    array a = generateArray<T>(nx, ny, 1, 1);
+
+    // Verification against the sorted columns, interpolating linearly
+    array sa = sort(a, 0);
+    vector<T> h_sorted(sa.elements());
+    sa.host(h_sorted.data());
+    const vector<double> h_sa(h_sorted.begin(), h_sorted.end());
+
+    const dim_t n     = sa.dims(0);
+    const dim_t ncols = sa.dims(1);
+    vector<double> gold(probs.size() * ncols);
+    for (dim_t c = 0; c < ncols; ++c) {
+        for (size_t p = 0; p < probs.size(); ++p) {
+            const double h  = static_cast<double>(h_probs[p]) * (n - 1);
+            const dim_t lo  = static_cast<dim_t>(h);
+            const double lv = h_sa[c * n + lo];
+            const double hv = lo + 1 < n ? h_sa[c * n + lo + 1] : lv;
+            gold[c * probs.size() + p] = lv + (h - lo) * (hv - lv);
+        }
+    }
+
+    array out = quantile(dim == 1 ? a.T() : a,
+                         array(h_probs.size(), h_probs.data()), dim);
+    if (dim == 1) { out = out.T(); }
+    ASSERT_EQ(probs.size(), out.dims(0));
+    ASSERT_EQ(ncols, out.dims(1));
+
+    vector<Tp> h_out(out.elements());
+    out.host(h_out.data());
+    for (size_t i = 0; i < gold.size(); ++i) {
+        ASSERT_NEAR(gold[i], h_out[i], 1e-5 * (1 + std::abs(gold[i])))
+            << "at index " << i;
+    }
+}
+
+TEST(Quantile, Float_Columns) {
+    quantile_test<float>(1000, 7, 0, {0.0, 0.1, 0.25, 0.5, 0.9, 1.0});
+}
+
+TEST(Quantile, Float_Rows) {
+    quantile_test<float>(783, 5, 1, {0.75, 0.33, 0.5});
+}
+
+TEST(Quantile, Double_Columns) {
+    quantile_test<double>(1001, 3, 0, {0.01, 0.5, 0.99});
+}
+
+TEST(Quantile, Int_Columns) { quantile_test<int>(500, 4, 0, {0.2, 0.8}); }
+
+TEST(Quantile, Uint_Rows) { quantile_test<uint>(257, 9, 1, {0.5}); }
+
+TEST(Quantile, Extremes) {
+    array a = randu(100, 10);
+
+    float p[] = {0.f, 1.f};
+    array out = quantile(a, array(2, p), 0);
+    ASSERT_ARRAYS_EQ(min(a, 0), out.row(0));
+    ASSERT_ARRAYS_EQ(max(a, 0), out.row(1));
+}
+
+TEST(Quantile, MatchesMedian) {
+    array a = randu(101, 6);
+
+    float p   = 0.5f;
+    array out = quantile(a, array(1, &p), 0);
+    ASSERT_ARRAYS_EQ(median(a, 0), out);
+}
+
+TEST(Percentile, MatchesQuantile) {
+    array a = randu(200, 3);
+
+    float percents[] = {5.f, 50.f, 95.f};
+    float probs[]    = {0.05f, 0.5f, 0.95f};
+    ASSERT_ARRAYS_NEAR(quantile(a, array(3, probs), 0),
+                       percentile(a, array(3, percents), 0), 1e-6);
+}
+
+TEST(Quantile, InvalidProbability) {
+    af_array in = 0, probs = 0, out = 0;
+    dim_t dims  = 10;
+    ASSERT_SUCCESS(af_randu(&in, 1, &dims, f32));
+
+    float p   = 1.5f;
+    dim_t one = 1;
+    ASSERT_SUCCESS(af_create_array(&probs, &p, 1, &one, f32));
+    ASSERT_EQ(AF_ERR_ARG, af_quantile(&out, in, probs, 0));
+
+    ASSERT_SUCCESS(af_release_array(probs));
+    ASSERT_SUCCESS(af_release_array(in));
+}
@@ -15,7 +15,9 @@
 #include <af/memory.h>
 #include <af/traits.hpp>
 
+#include <cstdlib>
 #include <memory>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
@@ -1110,3 +1112,207 @@ TEST(Memory, SNIPPET_AllocCPU) {
         ASSERT_EQ(*dptr, 5.0f);
     }
 }
+
+#if !defined(_WIN32)
+// The size classes of the default memory manager are enabled by
+// AF_MEM_SIZE_CLASSES, which is read when the manager is created. Buffers
+// are carved out of segments of 1 MB on the CPU backend.
+class MemorySizeClasses : public ::testing::Test {
+   protected:
+    const size_t segment_bytes = 1 << 20;
+    bool cpu;
+
+    void SetUp() override {
+        af_backend active_backend;
+        ASSERT_SUCCESS(af_get_active_backend(&active_backend));
+        cpu = active_backend == AF_BACKEND_CPU;
+        if (!cpu) { return; }
+
+        deviceGC();
+        setenv("AF_MEM_SIZE_CLASSES", "1", 1);
+        ASSERT_SUCCESS(af_unset_memory_manager());
+    }
+
+    void TearDown() override {
+        if (!cpu) { return; }
+        deviceGC();
+        unsetenv("AF_MEM_SIZE_CLASSES");
+        af_unset_memory_manager();
+    }
+};
+
+TEST_F(MemorySizeClasses, SplitAndMerge) {
+    if (!cpu) { return; }
+    size_t alloc_bytes, alloc_buffers;
+    size_t lock_bytes, lock_buffers;
+
+    // Both buffers are split from the same segment and the requests are
+    // rounded up to their size classes
+    void *a = allocV2(4096);
+    void *b = allocV2(5000);
+
+    deviceMemInfo(&alloc_bytes, &alloc_buffers, &lock_bytes, &lock_buffers);
+    ASSERT_EQ(alloc_buffers, 1u);
+    ASSERT_EQ(alloc_bytes, segment_bytes);
+    ASSERT_EQ(lock_buffers, 2u);
+    ASSERT_EQ(lock_bytes, 4096u + 5120u);
+
+    freeV2(a);
+    freeV2(b);
+
+    deviceMemInfo(&alloc_bytes, &alloc_buffers, &lock_bytes, &lock_buffers);
+    ASSERT_EQ(alloc_buffers, 1u);
+    ASSERT_EQ(lock_buffers, 0u);
+    ASSERT_EQ(lock_bytes, 0u);
+
+    // The released buffers are merged back into the whole segment
+    void *c = allocV2(segment_bytes);
+
+    deviceMemInfo(&alloc_bytes, &alloc_buffers, &lock_bytes, &lock_buffers);
+    ASSERT_EQ(alloc_buffers, 1u);
+    ASSERT_EQ(alloc_bytes, segment_bytes);
+    ASSERT_EQ(lock_buffers, 1u);
+    ASSERT_EQ(lock_bytes, segment_bytes);
+
+    freeV2(c);
+}
+
+TEST_F(MemorySizeClasses, GarbageCollection) {
+    if (!cpu) { return; }
+    size_t alloc_bytes, alloc_buffers;
+    size_t lock_bytes, lock_buffers;
+
+    void *a     = allocV2(4096);
+    void *b     = allocV2(4096);
+    void *large = allocV2(3 * segment_bytes);
+
+    deviceMemInfo(&alloc_bytes, &alloc_buffers, &lock_bytes, &lock_buffers);
+    ASSERT_EQ(alloc_buffers, 2u);
+    ASSERT_EQ(alloc_bytes, 4 * segment_bytes);
+
+    // A segment is only freed when none of its buffers is in use
+    freeV2(a);
+    freeV2(large);
+    deviceGC();
+
+    deviceMemInfo(&alloc_bytes, &alloc_buffers, &lock_bytes, &lock_buffers);
+    ASSERT_EQ(alloc_buffers, 1u);
+    ASSERT_EQ(alloc_bytes, segment_bytes);
+    ASSERT_EQ(lock_buffers, 1u);
+    ASSERT_EQ(lock_bytes, 4096u);
+
+    freeV2(b);
+    deviceGC();
+
+    deviceMemInfo(&alloc_bytes, &alloc_buffers, &lock_bytes, &lock_buffers);
+    ASSERT_EQ(alloc_buffers, 0u);
+    ASSERT_EQ(alloc_bytes, 0u);
+    ASSERT_EQ(lock_buffers, 0u);
+    ASSERT_EQ(lock_bytes, 0u);
+}
+
+TEST_F(MemorySizeClasses, UserLock) {
+    if (!cpu) { return; }
+    size_t alloc_bytes, alloc_buffers;
+    size_t lock_bytes, lock_buffers;
+
+    void *ptr = nullptr;
+    {
+        array a = randu(1000);
+        a.lock();
+        ASSERT_TRUE(a.isLocked());
+        a.unlock();
+        ASSERT_FALSE(a.isLocked());
+
+        // The device pointer stays locked after the array is released
+        ptr = a.device<float>();
+        ASSERT_TRUE(a.isLocked());
+    }
+
+    deviceMemInfo(&alloc_bytes, &alloc_buffers, &lock_bytes, &lock_buffers);
+    ASSERT_EQ(lock_buffers, 1u);
+    ASSERT_EQ(lock_bytes, 4096u);
+
+    deviceGC();
+    deviceMemInfo(&alloc_bytes, &alloc_buffers, &lock_bytes, &lock_buffers);
+    ASSERT_EQ(alloc_buffers, 1u);
+
+    freeV2(ptr);
+
+    deviceMemInfo(&alloc_bytes, &alloc_buffers, &lock_bytes, &lock_buffers);
+    ASSERT_EQ(lock_buffers, 0u);
+    ASSERT_EQ(lock_bytes, 0u);
+}
+
+TEST_F(MemorySizeClasses, FreeOnAnotherThread) {
+    if (!cpu) { return; }
+    size_t alloc_bytes, alloc_buffers;
+    size_t lock_bytes, lock_buffers;
+
+    // The second buffer is split from the segment of the first thread
+    void *a = nullptr;
+    std::thread([&a] { a = allocV2(4096); }).join();
+    void *b = allocV2(4096);
+
+    deviceMemInfo(&alloc_bytes, &alloc_buffers, &lock_bytes, &lock_buffers);
+    ASSERT_EQ(alloc_buffers, 1u);
+    ASSERT_EQ(lock_buffers, 2u);
+
+    std::thread([b] { freeV2(b); }).join();
+    freeV2(a);
+
+    deviceMemInfo(&alloc_bytes, &alloc_buffers, &lock_bytes, &lock_buffers);
+    ASSERT_EQ(lock_buffers, 0u);
+    ASSERT_EQ(lock_bytes, 0u);
+
+    // The buffers were merged back into the segment whichever thread
+    // released them, so a third thread gets all of it
+    void *c = nullptr;
+    std::thread([&c, this] { c = allocV2(segment_bytes); }).join();
+
+    deviceMemInfo(&alloc_bytes, &alloc_buffers, &lock_bytes, &lock_buffers);
+    ASSERT_EQ(alloc_buffers, 1u);
+    ASSERT_EQ(alloc_bytes, segment_bytes);
+    ASSERT_EQ(lock_buffers, 1u);
+
+    freeV2(c);
+    deviceGC();
+
+    deviceMemInfo(&alloc_bytes, &alloc_buffers, &lock_bytes, &lock_buffers);
+    ASSERT_EQ(alloc_buffers, 0u);
+    ASSERT_EQ(alloc_bytes, 0u);
+}
+
+TEST_F(MemorySizeClasses, Counters) {
+    if (!cpu) { return; }
+    size_t alloc_bytes, alloc_buffers;
+    size_t lock_bytes, lock_buffers;
+
+    vector<void *> ptrs;
+    size_t expected = 0;
+    for (size_t bytes = 1; bytes <= (256 << 10); bytes *= 3) {
+        ptrs.push_back(allocV2(bytes));
+
+        // Sizes up to 1 KB share a class and the larger ones are rounded up
+        // to a quarter of their power of two
+        size_t grid = 256;
+        while (grid * 8 < bytes) { grid *= 2; }
+        expected += bytes <= 1024 ? 1024 : (bytes + grid - 1) / grid * grid;
+
+        deviceMemInfo(&alloc_bytes, &alloc_buffers, &lock_bytes,
+                      &lock_buffers);
+        ASSERT_EQ(lock_buffers, ptrs.size());
+        ASSERT_EQ(lock_bytes, expected);
+        ASSERT_EQ(alloc_buffers, 1u);
+        ASSERT_EQ(alloc_bytes, segment_bytes);
+    }
+
+    ASSERT_NO_THROW(af::printMemInfo("Size classes"));
+
+    for (void *ptr : ptrs) { freeV2(ptr); }
+    deviceMemInfo(&alloc_bytes, &alloc_buffers, &lock_bytes, &lock_buffers);
+    ASSERT_EQ(lock_buffers, 0u);
+    ASSERT_EQ(lock_bytes, 0u);
+    ASSERT_EQ(alloc_bytes, segment_bytes);
+}
+#endif
@@ -473,6 +473,88 @@ TEST_P(KNearestNeighborsTest, SingleQTests) {
     ASSERT_ARRAYS_NEAR(distances_gold, distances, 1e-5);
 }
 
+TEST(KNearestNeighbours, LongFeaturesMatchBruteForce) {
+    const int nfeat  = 96;
+    const int nquery = 40;
+    const int ntrain = 1500;
+    const int k      = 6;
+
+    array query = randu(nfeat, nquery);
+    array train = randu(nfeat, ntrain);
+
+    // Distances from every training sample (rows) to every query (columns)
+    array diff = af::tile(af::moddims(query, nfeat, 1, nquery), 1, ntrain) -
+                 af::tile(train, 1, 1, nquery);
+    array all  = af::moddims(af::sum(diff * diff, 0), ntrain, nquery);
+    array sortedDist, sortedIdx;
+    af::sort(sortedDist, sortedIdx, all, 0);
+
+    array indices, distances;
+    nearestNeighbour(indices, distances, query, train, 0, k, AF_SSD);
+
+    ASSERT_ARRAYS_EQ(sortedIdx(af::seq(k), af::span), indices);
+    ASSERT_ARRAYS_NEAR(sortedDist(af::seq(k), af::span), distances, 1e-4);
+
+    nearestNeighbour(indices, distances, query.T(), train.T(), 1, k, AF_SSD);
+
+    ASSERT_ARRAYS_EQ(sortedIdx(af::seq(k), af::span), indices);
+    ASSERT_ARRAYS_NEAR(sortedDist(af::seq(k), af::span), distances, 1e-4);
+}
+
+TEST(AnnIndex, AllListsProbedMatchesNearestNeighbour) {
+    const int nfeat  = 8;
+    const int nquery = 50;
+    const int ntrain = 2000;
+    const int nlists = 16;
+    const int k      = 5;
+
+    array query = randu(nfeat, nquery);
+    array train = randu(nfeat, ntrain);
+
+    array gold_idx, gold_dist;
+    nearestNeighbour(gold_idx, gold_dist, query, train, 0, k, AF_SSD);
+
+    af::annIndex index(train, 0, nlists, AF_SSD);
+    array idx, dist;
+    af::annSearch(idx, dist, query, index, k, nlists);
+
+    ASSERT_ARRAYS_EQ(gold_idx, idx);
+    ASSERT_ARRAYS_NEAR(gold_dist, dist, 1e-5);
+
+    af::annIndex indexT(train.T(), 1, nlists, AF_SSD);
+    af::annSearch(idx, dist, query.T(), indexT, k, nlists);
+
+    ASSERT_ARRAYS_EQ(gold_idx, idx);
+    ASSERT_ARRAYS_NEAR(gold_dist, dist, 1e-5);
+}
+
+TEST(AnnIndex, SaveAndRead) {
+    const int nfeat = 4;
+
+    array query = randu(nfeat, 20);
+    array train = randu(nfeat, 600);
+
+    af::annIndex index(train, 0, 8, AF_SAD);
+    af::saveAnnIndex("ann_index.af", index);
+    af::annIndex loaded = af::readAnnIndex("ann_index.af");
+
+    array idx, dist, gold_idx, gold_dist;
+    af::annSearch(gold_idx, gold_dist, query, index, 3, 2);
+    af::annSearch(idx, dist, query, loaded, 3, 2);
+
+    ASSERT_ARRAYS_EQ(gold_idx, idx);
+    ASSERT_ARRAYS_EQ(gold_dist, dist);
+}
+
+TEST(AnnIndex, InvalidProbeCount) {
+    array train = randu(4, 100);
+    array query = randu(4, 1);
+
+    af::annIndex index(train, 0, 4);
+    array idx, dist;
+    ASSERT_THROW(af::annSearch(idx, dist, query, index, 1, 0), af::exception);
+}
+
 TEST(KNearestNeighbours, InvalidNegativeK) {
     const int ntrain = 500;
     const int nquery = 1;
@@ -412,3 +412,71 @@ TYPED_TEST(RandomEngineSeed, threefrySeedUniform) {
 TYPED_TEST(RandomEngineSeed, mersenneSeedUniform) {
     testRandomEngineSeed<TypeParam>(AF_RANDOM_ENGINE_MERSENNE_GP11213);
 }
+
+TEST(RandomEngine, CpuNumThreadsSameSequence) {
+    af_backend active_backend;
+    ASSERT_SUCCESS(af_get_active_backend(&active_backend));
+    if (active_backend != AF_BACKEND_CPU) { return; }
+
+    const randomEngineType types[] = {AF_RANDOM_ENGINE_PHILOX_4X32_10,
+                                      AF_RANDOM_ENGINE_THREEFRY_2X32_16};
+    const int elem = 1000003;
+    for (randomEngineType type : types) {
+        af::setCpuNumThreads(1);
+        randomEngine r1(type, 1234);
+        array u1 = randu(elem, f32, r1);
+        array n1 = randn(elem, f32, r1);
+        array d1 = randn(elem, f64, r1);
+
+        af::setCpuNumThreads(4);
+        randomEngine r4(type, 1234);
+        ASSERT_ARRAYS_EQ(u1, randu(elem, f32, r4));
+        ASSERT_ARRAYS_EQ(n1, randn(elem, f32, r4));
+        ASSERT_ARRAYS_EQ(d1, randn(elem, f64, r4));
+    }
+    af::setCpuNumThreads(0);
+}
+
+// The first normal values of each engine on the CPU backend. float normals
+// use the vectorized approximations of log, sin and cos. They are checked so
+// that changes of the sequences are noticed.
+TEST(RandomEngine, CpuNormalGoldValues) {
+    af_backend active_backend;
+    ASSERT_SUCCESS(af_get_active_backend(&active_backend));
+    if (active_backend != AF_BACKEND_CPU) { return; }
+
+    const int elem = 16;
+    // clang-format off
+    const float philox[elem] = {
+          0.403536618f,   -1.43955731f,   0.176860377f,   -1.92702579f,
+          0.200814635f,   -1.73797309f, -0.0654226616f,   -1.23001969f,
+          -0.48705247f,  0.0726885349f,  0.0130311288f,  -0.756964266f,
+          0.441677749f,   0.320181996f,  -0.629538476f,  -0.847497761f};
+    const float threefry[elem] = {
+          -1.33066416f, -0.0722546428f,   -1.05807972f,   0.215890199f,
+        -0.0355747044f,   0.194184512f,   -1.00551951f,    1.53775263f,
+          0.214094922f,     1.6962024f,   0.745528042f,   -0.27886948f,
+           1.10979891f,   0.345659494f,    1.86231756f,    1.27111542f};
+    const float mersenne[elem] = {
+         -0.323636889f,    0.28797254f,  -0.713371933f,   0.795596898f,
+         -0.686863422f, 0.00734464172f,   0.724749386f,   0.899392426f,
+         -0.744789124f,   0.303690553f,    1.44115531f,   0.988853514f,
+        -0.0844678432f,  -0.795993447f,   0.892347455f,   -1.04189432f};
+    // clang-format on
+
+    const randomEngineType types[] = {AF_RANDOM_ENGINE_PHILOX_4X32_10,
+                                      AF_RANDOM_ENGINE_THREEFRY_2X32_16,
+                                      AF_RANDOM_ENGINE_MERSENNE_GP11213};
+    const float *gold[] = {philox, threefry, mersenne};
+    for (int t = 0; t < 3; ++t) {
+        randomEngine r(types[t], 1234);
+        array out = randn(elem, f32, r);
+
+        vector<float> h(elem);
+        out.host(&h[0]);
+        for (int i = 0; i < elem; ++i) {
+            ASSERT_FLOAT_EQ(gold[t][i], h[i])
+                << "engine " << types[t] << " at " << i;
+        }
+    }
+}
@@ -305,6 +305,49 @@ TEST(Reduce, Test_count_Scalar_MaxDim) {
     ASSERT_EQ(count(A, 3).scalar<unsigned int>(), largeDim);
 }
 
+// Shapes that split the reduced dimension into several blocks
+TEST(Reduce, SumBlockedAllDims) {
+    const dim4 shapes[] = {dim4(70000, 3, 2, 1), dim4(3, 40000, 2, 1),
+                           dim4(1100, 2, 300, 2), dim4(5, 2, 3, 9000)};
+    for (const dim4 &dims : shapes) {
+        array in = (randu(dims) * 10).as(s32);
+        vector<int> h_in(in.elements());
+        in.host(&h_in.front());
+
+        for (int d = 0; d < 4; d++) {
+            dim4 odims = dims;
+            odims[d]   = 1;
+            vector<int> gold(odims.elements(), 0);
+            for (dim_t w = 0; w < dims[3]; w++) {
+                for (dim_t z = 0; z < dims[2]; z++) {
+                    for (dim_t y = 0; y < dims[1]; y++) {
+                        for (dim_t x = 0; x < dims[0]; x++) {
+                            dim_t o[4] = {x, y, z, w};
+                            o[d]       = 0;
+                            dim_t oidx = o[0] + odims[0] * (o[1] + odims[1] *
+                                         (o[2] + odims[2] * o[3]));
+                            gold[oidx] += h_in[x + dims[0] * (y + dims[1] *
+                                               (z + dims[2] * w))];
+                        }
+                    }
+                }
+            }
+            ASSERT_VEC_ARRAY_EQ(gold, odims, sum(in, d));
+        }
+
+        // The sub-array skips the first element of every column so it isn't
+        // linear
+        double total = 0, subTotal = 0;
+        for (size_t i = 0; i < h_in.size(); i++) {
+            total += h_in[i];
+            if (i % dims[0] != 0) { subTotal += h_in[i]; }
+        }
+        ASSERT_EQ(total, sum<double>(in));
+        ASSERT_EQ(subTotal,
+                  sum<double>(in(seq(1, dims[0] - 1), span, span, span)));
+    }
+}
+
 #define CPP_REDUCE_TESTS(FN, FNAME, Ti, To)                                    \
     TEST(Reduce, Test_##FN##_CPP) {                                            \
         cppReduceTest<Ti, To, FN>(string(TEST_DIR "/reduce/" #FNAME ".test")); \
@@ -266,3 +266,35 @@ TEST(Regions, NoComponentImage) {
     for (int i = 0; i < sz; ++i)
         ASSERT_FLOAT_EQ(gold[i], output[i]) << " mismatch at i=" << i << endl;
 }
+
+TEST(Regions, Volume) {
+    if (af::getActiveBackend() != AF_BACKEND_CPU) { return; }
+
+    // Two pairs of voxels that only touch along an edge, and a single voxel
+    // in the last corner
+    const int d0 = 5, d1 = 3, d2 = 3;
+    auto at      = [=](int i, int j, int k) { return i + d0 * (j + d1 * k); };
+    vector<char> input(d0 * d1 * d2, 0);
+    input[at(0, 0, 0)] = input[at(0, 0, 1)] = 1;
+    input[at(1, 1, 1)] = input[at(1, 1, 2)] = 1;
+    input[at(4, 2, 2)]                      = 1;
+
+    array in = array(d0, d1, d2, input.data());
+
+    vector<float> output(input.size());
+    regions(in, AF_CONNECTIVITY_4).host(output.data());
+    vector<float> gold(input.size(), 0.0f);
+    gold[at(0, 0, 0)] = gold[at(0, 0, 1)] = 1.0f;
+    gold[at(1, 1, 1)] = gold[at(1, 1, 2)] = 2.0f;
+    gold[at(4, 2, 2)]                     = 3.0f;
+    for (size_t i = 0; i < gold.size(); ++i) {
+        ASSERT_FLOAT_EQ(gold[i], output[i]) << " mismatch at i=" << i;
+    }
+
+    regions(in, AF_CONNECTIVITY_8).host(output.data());
+    gold[at(1, 1, 1)] = gold[at(1, 1, 2)] = 1.0f;
+    gold[at(4, 2, 2)]                     = 2.0f;
+    for (size_t i = 0; i < gold.size(); ++i) {
+        ASSERT_FLOAT_EQ(gold[i], output[i]) << " mismatch at i=" << i;
+    }
+}
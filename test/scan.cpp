@@ -17,6 +17,7 @@
 #include <algorithm>
 #include <iostream>
 #include <iterator>
+#include <limits>
 #include <string>
 #include <utility>
 #include <vector>
@@ -345,3 +346,41 @@ TEST(Scan, ExclusiveSum2D_Dim3) {
 
     ASSERT_ARRAYS_EQ(gold, out);
 }
+
+TEST(Scan, InclusiveSumDim1Strided) {
+    const int nrows = 3000;
+    const int ncols = 40;
+    vector<int> h_in(nrows * ncols);
+    for (size_t i = 0; i < h_in.size(); ++i) { h_in[i] = i % 13 - 6; }
+
+    array full(nrows, ncols, &h_in.front());
+    array in  = full(af::seq(1, nrows - 2), af::span);
+    array out = scan(in, 1, AF_BINARY_ADD, true);
+
+    vector<int> h_gold((nrows - 2) * ncols);
+    for (int j = 0; j < ncols; ++j) {
+        for (int i = 0; i < nrows - 2; ++i) {
+            const int prev = j > 0 ? h_gold[(j - 1) * (nrows - 2) + i] : 0;
+            h_gold[j * (nrows - 2) + i] = prev + h_in[j * nrows + i + 1];
+        }
+    }
+
+    ASSERT_VEC_ARRAY_EQ(h_gold, dim4(nrows - 2, ncols), out);
+}
+
+TEST(Scan, ExclusiveMinLong) {
+    const int in_size = 200000;
+    vector<int> h_in(in_size);
+    for (int i = 0; i < in_size; ++i) { h_in[i] = (i * 7919) % 100003; }
+
+    vector<int> h_gold(in_size);
+    h_gold[0] = std::numeric_limits<int>::max();
+    for (int i = 1; i < in_size; ++i) {
+        h_gold[i] = std::min(h_gold[i - 1], h_in[i - 1]);
+    }
+
+    array in(in_size, &h_in.front());
+    array out = scan(in, 0, AF_BINARY_MIN, false);
+
+    ASSERT_VEC_ARRAY_EQ(h_gold, dim4(in_size), out);
+}
@@ -236,3 +236,25 @@ TEST(ScanByKey, FixOverflowWrite) {
 
     ASSERT_EQ(prior, valsAF(0).scalar<float>());
 }
+
+TEST(ScanByKey, LongSegments) {
+    const int SIZE = 150000;
+    vector<int> keys(SIZE);
+    vector<int> vals(SIZE);
+    for (int i = 0; i < SIZE; ++i) {
+        keys[i] = i / 40000;
+        vals[i] = i % 5;
+    }
+
+    vector<int> gold(SIZE);
+    for (int i = 0; i < SIZE; ++i) {
+        const bool start = i == 0 || keys[i] != keys[i - 1];
+        gold[i]          = start ? 0 : gold[i - 1] + vals[i - 1];
+    }
+
+    array out = af::scanByKey(array(SIZE, keys.data()),
+                              array(SIZE, vals.data()), 0, AF_BINARY_ADD,
+                              false);
+
+    ASSERT_VEC_ARRAY_EQ(gold, dim4(SIZE), out);
+}
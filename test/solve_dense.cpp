@@ -45,6 +45,45 @@ double eps<cdouble>() {
     return 1e-5;
 }
 
+template<typename T>
+void solveBatchTester(const int m, const int n, const int k, const int batch,
+                      const af_mat_prop options, double eps,
+                      bool use_lu = false) {
+    SUPPORTED_TYPE_CHECK(T);
+    if (noLAPACKTests()) return;
+    // Only the CPU backend solves batches
+    if (af::getActiveBackend() != AF_BACKEND_CPU) return;
+    typedef typename af::dtype_traits<T>::base_type BT;
+
+    // Diagonally dominant so that every system of the batch is well posed
+    af::dim4 dims(m, n, batch);
+    af::dtype ty = (af::dtype)af::dtype_traits<T>::af_type;
+    af::array A  = cpu_randu<T>(dims) + std::max(m, n) * af::identity(dims, ty);
+    if (options & AF_MAT_UPPER) { A = af::upper(A); }
+    af::array X0 = cpu_randu<T>(af::dim4(n, k, batch));
+    af::array B0 = af::matmul(A, X0);
+
+    af::array X1;
+    if (use_lu) {
+        af::array A_lu, pivot;
+        af::lu(A_lu, pivot, A);
+        X1 = af::solveLU(A_lu, pivot, B0);
+    } else {
+        X1 = af::solve(A, B0, options);
+    }
+    ASSERT_EQ(af::dim4(n, k, batch), X1.dims());
+    ASSERT_NEAR(0, af::max<BT>(af::abs(B0 - af::matmul(A, X1))), eps);
+
+    // Every slice matches the system solved on its own
+    for (int i = 0; i < batch; i += 7) {
+        af::array Ai = A(af::span, af::span, i);
+        af::array Bi = B0(af::span, af::span, i);
+        af::array Xi = af::solve(Ai, Bi, options);
+        ASSERT_NEAR(0, af::max<BT>(af::abs(Xi - X1(af::span, af::span, i))),
+                    eps);
+    }
+}
+
 TYPED_TEST(Solve, Square) {
     solveTester<TypeParam>(100, 100, 10, eps<TypeParam>());
 }
@@ -139,6 +178,27 @@ TYPED_TEST(Solve, TriangleLowerMultipleOfTwoLarge) {
     solveTriangleTester<TypeParam>(2048, 512, false, eps<TypeParam>());
 }
 
+TYPED_TEST(Solve, SquareBatch) {
+    solveBatchTester<TypeParam>(4, 4, 3, 500, AF_MAT_NONE, eps<TypeParam>());
+}
+
+TYPED_TEST(Solve, SquareBatchLarge) {
+    solveBatchTester<TypeParam>(40, 40, 8, 10, AF_MAT_NONE, eps<TypeParam>());
+}
+
+TYPED_TEST(Solve, LeastSquaresOverDeterminedBatch) {
+    solveBatchTester<TypeParam>(12, 8, 2, 50, AF_MAT_NONE, eps<TypeParam>());
+}
+
+TYPED_TEST(Solve, LUBatch) {
+    solveBatchTester<TypeParam>(7, 7, 2, 200, AF_MAT_NONE, eps<TypeParam>(),
+                                true);
+}
+
+TYPED_TEST(Solve, TriangleUpperBatch) {
+    solveBatchTester<TypeParam>(16, 16, 4, 100, AF_MAT_UPPER, eps<TypeParam>());
+}
+
 #if !defined(AF_OPENCL)
 int nextTargetDeviceId() {
     static int nextId = 0;
@@ -13,8 +13,10 @@
 #include <af/defines.h>
 #include <af/dim4.hpp>
 #include <af/traits.hpp>
+#include <algorithm>
 #include <complex>
 #include <iostream>
+#include <limits>
 #include <string>
 #include <vector>
 
@@ -226,3 +228,31 @@ TEST(Sort, CPPDim2) {
     // Delete
     delete[] sxData;
 }
+
+TEST(Sort, LargeColumn) {
+    // Long enough to be split between the threads of the CPU backend
+    const int nElems = 300000;
+    array input      = af::randn(nElems) * 1e6;
+
+    vector<float> gold(nElems);
+    input.host(&gold.front());
+    std::sort(gold.begin(), gold.end());
+    ASSERT_VEC_ARRAY_EQ(gold, dim4(nElems), sort(input, 0, true));
+
+    std::reverse(gold.begin(), gold.end());
+    ASSERT_VEC_ARRAY_EQ(gold, dim4(nElems), sort(input, 0, false));
+}
+
+TEST(Sort, SignedKeysAndInfinities) {
+    const float inf   = std::numeric_limits<float>::infinity();
+    const float in[]  = {3.f, -inf, -2.5f, 0.f, inf, -1e-30f, 7.f, -2.5f};
+    const float out[] = {-inf, -2.5f, -2.5f, -1e-30f, 0.f, 3.f, 7.f, inf};
+
+    array sorted = sort(array(8, in), 0, true);
+    ASSERT_VEC_ARRAY_EQ(vector<float>(out, out + 8), dim4(8), sorted);
+
+    const int iin[]  = {5, -3, 0, -2147483647 - 1, 2147483647, -3};
+    const int iout[] = {2147483647, 5, 0, -3, -3, -2147483647 - 1};
+    ASSERT_VEC_ARRAY_EQ(vector<int>(iout, iout + 6), dim4(6),
+                        sort(array(6, iin), 0, false));
+}
@@ -13,9 +13,11 @@
 #include <af/defines.h>
 #include <af/dim4.hpp>
 #include <af/traits.hpp>
+#include <algorithm>
 #include <complex>
 #include <iostream>
 #include <string>
+#include <utility>
 #include <vector>
 
 using af::array;
@@ -196,3 +198,40 @@ TEST(SortByKey, CPPDim2) {
     ASSERT_VEC_ARRAY_EQ(tests[resultIdx0], idims, out_keys);
     ASSERT_VEC_ARRAY_EQ(tests[resultIdx1], idims, out_vals);
 }
+
+TEST(SortByKey, StableAlongDim1) {
+    // Many equal keys so that the order of the values shows whether the
+    // sort is stable
+    const int nrows = 3;
+    const int ncols = 5000;
+    vector<short> hkeys(nrows * ncols);
+    for (int i = 0; i < nrows * ncols; i++) { hkeys[i] = (i * 7919) % 13 - 6; }
+
+    array keys(nrows, ncols, &hkeys.front());
+    array vals = af::range(dim4(nrows, ncols), 1, u32);
+
+    array out_keys, out_vals;
+    sort(out_keys, out_vals, keys, vals, 1, false);
+
+    vector<short> gkeys(nrows * ncols);
+    vector<unsigned> gvals(nrows * ncols);
+    for (int r = 0; r < nrows; r++) {
+        vector<std::pair<short, unsigned> > column(ncols);
+        for (int c = 0; c < ncols; c++) {
+            column[c] = std::make_pair(hkeys[c * nrows + r], (unsigned)c);
+        }
+        std::stable_sort(
+            column.begin(), column.end(),
+            [](const std::pair<short, unsigned>& lhs,
+               const std::pair<short, unsigned>& rhs) {
+                return lhs.first > rhs.first;
+            });
+        for (int c = 0; c < ncols; c++) {
+            gkeys[c * nrows + r] = column[c].first;
+            gvals[c * nrows + r] = column[c].second;
+        }
+    }
+
+    ASSERT_VEC_ARRAY_EQ(gkeys, dim4(nrows, ncols), out_keys);
+    ASSERT_VEC_ARRAY_EQ(gvals, dim4(nrows, ncols), out_vals);
+}
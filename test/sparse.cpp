@@ -48,6 +48,57 @@ SPARSE_TESTS(cdouble, 1E-5)
 
 #undef SPARSE_TESTS
 
+// Most rows are empty and a few are dense, so the rows cannot be split evenly
+TEST(Sparse, IrregularRows) {
+    const int n = 3000;
+    array A     = af::constant(0, n, n);
+
+    A(af::seq(0, n - 1, 300), span) = randu(10, n);
+    A(1234, span)                   = randu(1, n);
+    A(2999, 17)                     = 1;
+
+    array sA = af::sparse(A, AF_STORAGE_CSR);
+
+    for (int k = 1; k <= 11; k += 10) {
+        array B = randu(n, k);
+        ASSERT_NEAR(0, calc_norm(matmul(A, B), matmul(sA, B)), 1E-3);
+        ASSERT_NEAR(0,
+                    calc_norm(matmul(A, B, AF_MAT_TRANS),
+                              matmul(sA, B, AF_MAT_TRANS)),
+                    1E-3);
+    }
+}
+
+#define SPARSE_SPARSE_TESTS(T, eps)                                  \
+    TEST(Sparse, SparseSparse_##T##Square) {                         \
+        sparseSparseTester<T>(500, 500, 500, 5, AF_MAT_NONE, eps);   \
+    }                                                                \
+    TEST(Sparse, SparseSparse_##T##Rect) {                           \
+        sparseSparseTester<T>(300, 700, 211, 3, AF_MAT_NONE, eps);   \
+    }                                                                \
+    TEST(Sparse, SparseSparse_##T##RectDense) {                      \
+        sparseSparseTester<T>(100, 100, 100, 1, AF_MAT_NONE, eps);   \
+    }                                                                \
+    TEST(Sparse, SparseSparse_##T##Trans) {                          \
+        sparseSparseTester<T>(300, 700, 211, 3, AF_MAT_TRANS, eps);  \
+    }                                                                \
+    TEST(Sparse, SparseSparse_##T##CTrans) {                         \
+        sparseSparseTester<T>(300, 700, 211, 3, AF_MAT_CTRANS, eps); \
+    }                                                                \
+    TEST(Sparse, SparseTranspose_##T) {                              \
+        sparseArrayTransposeTester<T>(453, 751, 5, false);           \
+    }                                                                \
+    TEST(Sparse, SparseConjugateTranspose_##T) {                     \
+        sparseArrayTransposeTester<T>(453, 751, 5, true);            \
+    }
+
+SPARSE_SPARSE_TESTS(float, 1E-3)
+SPARSE_SPARSE_TESTS(double, 1E-5)
+SPARSE_SPARSE_TESTS(cfloat, 1E-3)
+SPARSE_SPARSE_TESTS(cdouble, 1E-5)
+
+#undef SPARSE_SPARSE_TESTS
+
 #define CREATE_TESTS(STYPE) \
     TEST(Sparse, Create_##STYPE) { createFunction<STYPE>(); }
 
@@ -59,6 +110,12 @@ CREATE_TESTS(AF_STORAGE_COO)
 TEST(Sparse, Create_AF_STORAGE_CSC) {
     array d = identity(3, 3);
 
+    // The CPU backend creates CSC arrays
+    if (af::getActiveBackend() == AF_BACKEND_CPU) {
+        createFunction<AF_STORAGE_CSC>();
+        return;
+    }
+
     af_array out = 0;
     ASSERT_EQ(AF_ERR_ARG,
               af_create_sparse_array_from_dense(&out, d.get(), AF_STORAGE_CSC));
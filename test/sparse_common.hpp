@@ -145,6 +145,66 @@ static void sparseTransposeTester(const int m, const int n, const int k,
     }
 }
 
+template<typename T>
+static void sparseSparseTester(const int m, const int n, const int k,
+                               int factor, af_mat_prop optLhs, double eps) {
+    af::deviceGC();
+
+    SUPPORTED_TYPE_CHECK(T);
+
+    // Only the CPU backend multiplies two sparse arrays
+    if (af::getActiveBackend() != AF_BACKEND_CPU) return;
+
+    af::array A = optLhs == AF_MAT_NONE ? cpu_randu<T>(af::dim4(m, n))
+                                        : cpu_randu<T>(af::dim4(n, m));
+    af::array B = cpu_randu<T>(af::dim4(n, k));
+
+    A = makeSparse<T>(A, factor);
+    B = makeSparse<T>(B, factor);
+
+    // Result of GEMM
+    af::array dRes = matmul(A, B, optLhs, AF_MAT_NONE);
+
+    // Sparse x sparse matmul returns a CSR array
+    af::array sA   = af::sparse(A, AF_STORAGE_CSR);
+    af::array sB   = af::sparse(B, AF_STORAGE_CSR);
+    af::array sRes = matmul(sA, sB, optLhs, AF_MAT_NONE);
+
+    ASSERT_TRUE(sRes.issparse());
+    ASSERT_EQ(AF_STORAGE_CSR, sparseGetStorage(sRes));
+
+    // Verify Results
+    af::array res = af::dense(sRes);
+    ASSERT_NEAR(0, calc_norm(real(dRes), real(res)), eps);
+    ASSERT_NEAR(0, calc_norm(imag(dRes), imag(res)), eps);
+}
+
+template<typename T>
+static void sparseArrayTransposeTester(const int m, const int n, int factor,
+                                       bool conjugate) {
+    SUPPORTED_TYPE_CHECK(T);
+
+    // Only the CPU backend transposes sparse arrays
+    if (af::getActiveBackend() != AF_BACKEND_CPU) return;
+
+    af::array A = cpu_randu<T>(af::dim4(m, n));
+    A           = makeSparse<T>(A, factor);
+
+    af::array sA  = af::sparse(A, AF_STORAGE_CSR);
+    af::array sAt = af::transpose(sA, conjugate);
+
+    ASSERT_TRUE(sAt.issparse());
+    ASSERT_EQ(AF_STORAGE_CSR, sparseGetStorage(sAt));
+    ASSERT_EQ(sparseGetNNZ(sA), sparseGetNNZ(sAt));
+
+    // The indices of the transpose are sorted, as are the ones of a sparse
+    // array created from a dense one
+    af::array gold = af::sparse(af::transpose(A, conjugate), AF_STORAGE_CSR);
+    ASSERT_ARRAYS_EQ(sparseGetRowIdx(gold), sparseGetRowIdx(sAt));
+    ASSERT_ARRAYS_EQ(sparseGetColIdx(gold), sparseGetColIdx(sAt));
+    ASSERT_ARRAYS_EQ(sparseGetValues(gold), sparseGetValues(sAt));
+}
+
 template<typename T>
 static void convertCSR(const int M, const int N, const double ratio,
                        int targetDevice = -1) {
@@ -128,11 +128,38 @@ CONVERT_TESTS(double, AF_STORAGE_CSR, AF_STORAGE_COO)
 CONVERT_TESTS(cfloat, AF_STORAGE_CSR, AF_STORAGE_COO)
 CONVERT_TESTS(cdouble, AF_STORAGE_CSR, AF_STORAGE_COO)
 
+// Only the CPU backend supports CSC
+#define CSC_CONVERT_TESTS_TYPES(T, STYPE, DTYPE, SUFFIX, M, N, F) \
+    TEST(SPARSE_CONVERT, T##_##STYPE##_##DTYPE##_##SUFFIX) {      \
+        if (af::getActiveBackend() != AF_BACKEND_CPU) return;     \
+        sparseConvertTester<T, STYPE, DTYPE>(M, N, F);            \
+    }                                                             \
+    TEST(SPARSE_CONVERT, T##_##DTYPE##_##STYPE##_##SUFFIX) {      \
+        if (af::getActiveBackend() != AF_BACKEND_CPU) return;     \
+        sparseConvertTester<T, DTYPE, STYPE>(M, N, F);            \
+    }
+
+#define CSC_CONVERT_TESTS(T, STYPE)                                     \
+    CSC_CONVERT_TESTS_TYPES(T, STYPE, AF_STORAGE_CSC, 1, 1000, 1000, 5) \
+    CSC_CONVERT_TESTS_TYPES(T, STYPE, AF_STORAGE_CSC, 2, 237, 411, 5)
+
+CSC_CONVERT_TESTS(float, AF_STORAGE_CSR)
+CSC_CONVERT_TESTS(double, AF_STORAGE_CSR)
+CSC_CONVERT_TESTS(cfloat, AF_STORAGE_CSR)
+CSC_CONVERT_TESTS(cdouble, AF_STORAGE_CSR)
+CSC_CONVERT_TESTS(float, AF_STORAGE_COO)
+CSC_CONVERT_TESTS(cdouble, AF_STORAGE_COO)
+
+#undef CSC_CONVERT_TESTS
+#undef CSC_CONVERT_TESTS_TYPES
 #undef CONVERT_TESTS
 #undef CONVERT_TESTS_TYPES
 
 // Test to check failure with CSC
 TEST(SPARSE_CONVERT, CSC_ARG_ERROR) {
+    // The CPU backend supports CSC
+    if (af::getActiveBackend() == AF_BACKEND_CPU) return;
+
     const int m = 100, n = 28, factor = 5;
 
     array A = cpu_randu<float>(dim4(m, n));
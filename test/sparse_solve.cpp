@@ -0,0 +1,169 @@
+/*******************************************************
+ * Copyright (c) 2026, ArrayFire
+ * All rights reserved.
+ *
+ * This file is distributed under 3-clause BSD license.
+ * The complete license agreement can be obtained at:
+ * http://arrayfire.com/licenses/BSD-3-Clause
+ ********************************************************/
+
+#include <gtest/gtest.h>
+#include <sparse_common.hpp>
+#include <testHelpers.hpp>
+
+using af::array;
+using af::dim4;
+using af::dtype_traits;
+
+template<typename T>
+class SparseSolve : public ::testing::Test {};
+
+typedef ::testing::Types<float, cfloat, double, cdouble> TestTypes;
+TYPED_TEST_CASE(SparseSolve, TestTypes);
+
+/// Returns the largest residual norm of the columns of A X - B relative to
+/// the norm of the column of B
+static double relativeResidual(const array &A, const array &X,
+                               const array &B) {
+    array r  = af::abs(af::matmul(A, X) - B);
+    array b  = af::abs(B);
+    array rn = af::sqrt(af::sum(r * r));
+    array bn = af::sqrt(af::sum(b * b));
+    return af::max<double>(rn / bn);
+}
+
+template<typename T>
+static void sparseSolveTester(const int n, const int nrhs,
+                              const af_sparse_solver solver,
+                              const af_preconditioner precond,
+                              const bool hermitian) {
+    SUPPORTED_TYPE_CHECK(T);
+    typedef typename dtype_traits<T>::base_type BT;
+    const af::dtype ty = (af::dtype)dtype_traits<T>::af_type;
+    const double tol   = sizeof(BT) == sizeof(float) ? 1e-5 : 1e-10;
+    const int maxIter  = 500;
+
+    // Diagonally dominant, and positive definite when Hermitian
+    array A = makeSparse<T>(cpu_randu<T>(dim4(n, n)), 7);
+    if (hermitian) { A = A + af::transpose(A, true); }
+    A = A + n * af::identity(n, n, ty);
+
+    array sA = af::sparse(A, AF_STORAGE_CSR);
+    array B  = cpu_randu<T>(dim4(n, nrhs));
+
+    int iterations = 0;
+    array X = af::sparseSolve(sA, B, solver, precond, tol, maxIter, 30, NULL,
+                              NULL, &iterations);
+
+    ASSERT_EQ(B.dims(), X.dims());
+    ASSERT_FALSE(X.issparse());
+    ASSERT_GT(iterations, 0);
+    ASSERT_LT(iterations, maxIter);
+    ASSERT_LT(relativeResidual(A, X, B), 10 * tol);
+}
+
+#define SPARSE_SOLVE_TESTS(SOLVER, HERMITIAN)                              \
+    TYPED_TEST(SparseSolve, SOLVER##_None) {                               \
+        sparseSolveTester<TypeParam>(500, 1, AF_SPARSE_SOLVER_##SOLVER,    \
+                                     AF_PRECONDITIONER_NONE, HERMITIAN);   \
+    }                                                                      \
+    TYPED_TEST(SparseSolve, SOLVER##_Jacobi) {                             \
+        sparseSolveTester<TypeParam>(500, 3, AF_SPARSE_SOLVER_##SOLVER,    \
+                                     AF_PRECONDITIONER_JACOBI, HERMITIAN); \
+    }                                                                      \
+    TYPED_TEST(SparseSolve, SOLVER##_ILU0) {                               \
+        sparseSolveTester<TypeParam>(500, 3, AF_SPARSE_SOLVER_##SOLVER,    \
+                                     AF_PRECONDITIONER_ILU0, HERMITIAN);   \
+    }
+
+SPARSE_SOLVE_TESTS(CG, true)
+SPARSE_SOLVE_TESTS(BICGSTAB, false)
+SPARSE_SOLVE_TESTS(GMRES, false)
+
+#undef SPARSE_SOLVE_TESTS
+
+TEST(SparseSolve, GMRESShortRestart) {
+    SUPPORTED_TYPE_CHECK(double);
+    array A = makeSparse<double>(cpu_randu<double>(dim4(300, 300)), 5);
+    A       = A + 10 * af::identity(300, 300, f64);
+
+    int iterations = 0;
+    array B        = cpu_randu<double>(dim4(300, 2));
+    array X = af::sparseSolve(af::sparse(A), B, AF_SPARSE_SOLVER_GMRES,
+                              AF_PRECONDITIONER_ILU0, 1e-10, 1000, 4, NULL,
+                              NULL, &iterations);
+
+    ASSERT_LT(iterations, 1000);
+    ASSERT_LT(relativeResidual(A, X, B), 1e-9);
+}
+
+static int stopAfterThree(void *userData, int iteration,
+                          const double *residuals, int nrhs) {
+    int *calls = static_cast<int *>(userData);
+    EXPECT_EQ(++*calls, iteration);
+    EXPECT_EQ(2, nrhs);
+    EXPECT_GE(residuals[0], 0.0);
+    return iteration == 3;
+}
+
+TEST(SparseSolve, CallbackStops) {
+    array A = makeSparse<float>(cpu_randu<float>(dim4(200, 200)), 7);
+    A       = A + af::transpose(A) + 200 * af::identity(200, 200);
+
+    int calls      = 0;
+    int iterations = 0;
+    af::sparseSolve(af::sparse(A), cpu_randu<float>(dim4(200, 2)),
+                    AF_SPARSE_SOLVER_CG, AF_PRECONDITIONER_NONE, 0, 100, 30,
+                    stopAfterThree, &calls, &iterations);
+
+    ASSERT_EQ(3, calls);
+    ASSERT_EQ(3, iterations);
+}
+
+TEST(SparseSolve, ZeroRHS) {
+    array A = 4 * af::identity(10, 10);
+    array B = af::constant(0, 10, 2);
+
+    int iterations = -1;
+    array X = af::sparseSolve(af::sparse(A), B, AF_SPARSE_SOLVER_CG,
+                              AF_PRECONDITIONER_NONE, 1e-6, 100, 30, NULL,
+                              NULL, &iterations);
+
+    ASSERT_EQ(0, iterations);
+    ASSERT_EQ(0, af::max<float>(af::abs(X)));
+}
+
+TEST(SparseSolve, DenseMatrix) {
+    array A = af::identity(10, 10);
+    array B = af::constant(1, 10);
+
+    af_array out = 0;
+    ASSERT_EQ(AF_ERR_ARG,
+              af_sparse_solve(&out, NULL, A.get(), B.get(),
+                              AF_SPARSE_SOLVER_CG, AF_PRECONDITIONER_NONE,
+                              1e-6, 100, 30, NULL, NULL));
+}
+
+TEST(SparseSolve, SizeMismatch) {
+    array A = af::sparse(af::identity(10, 10));
+    array B = af::constant(1, 11);
+
+    af_array out = 0;
+    ASSERT_EQ(AF_ERR_SIZE,
+              af_sparse_solve(&out, NULL, A.get(), B.get(),
+                              AF_SPARSE_SOLVER_CG, AF_PRECONDITIONER_NONE,
+                              1e-6, 100, 30, NULL, NULL));
+}
+
+TEST(SparseSolve, ZeroDiagonalPreconditioner) {
+    float h[] = {0, 1, 1, 0};
+    array A   = af::sparse(array(2, 2, h));
+    array B   = af::constant(1, 2);
+
+    af_array out = 0;
+    ASSERT_EQ(AF_ERR_ARG,
+              af_sparse_solve(&out, NULL, A.get(), B.get(),
+                              AF_SPARSE_SOLVER_GMRES,
+                              AF_PRECONDITIONER_JACOBI, 1e-6, 100, 30, NULL,
+                              NULL));
+}
@@ -713,6 +713,45 @@ TEST(Threading, Sparse) {
         if (tests[testId].joinable()) tests[testId].join();
 }
 
+TEST(Threading, CpuNumThreads) {
+    af_backend active_backend;
+    ASSERT_SUCCESS(af_get_active_backend(&active_backend));
+
+    if (active_backend != AF_BACKEND_CPU) {
+        int nthreads = 0;
+        ASSERT_EQ(AF_ERR_NOT_SUPPORTED, af_set_cpu_num_threads(2));
+        ASSERT_EQ(AF_ERR_NOT_SUPPORTED, af_get_cpu_num_threads(&nthreads));
+        return;
+    }
+
+    array in     = randu(97, 89, 7);
+    array filter = randu(5, 3);
+    array mask   = constant(1, 3, 3);
+
+    // The results must not depend on how the work is split
+    setCpuNumThreads(1);
+    ASSERT_EQ(1, getCpuNumThreads());
+    array conv   = convolve2(in, filter);
+    array median = medfilt(in, 5, 5);
+    array dil    = dilate(in, mask);
+    array scaled = resize(in, 131, 67, AF_INTERP_BILINEAR);
+    array total  = sum(in, 0);
+
+    for (int nthreads : {3, 8}) {
+        setCpuNumThreads(nthreads);
+        ASSERT_EQ(nthreads, getCpuNumThreads());
+        ASSERT_ARRAYS_EQ(conv, convolve2(in, filter));
+        ASSERT_ARRAYS_EQ(median, medfilt(in, 5, 5));
+        ASSERT_ARRAYS_EQ(dil, dilate(in, mask));
+        ASSERT_ARRAYS_EQ(scaled, resize(in, 131, 67, AF_INTERP_BILINEAR));
+        ASSERT_ARRAYS_EQ(total, sum(in, 0));
+    }
+
+    // Restores the default
+    setCpuNumThreads(0);
+    ASSERT_LE(1, getCpuNumThreads());
+}
+
 TEST(Threading, DISABLED_MemoryManagerStressTest) {
     vector<std::thread> threads;
     for (int i = 0; i < THREAD_COUNT; i++) {